@@ -7,12 +7,20 @@ License: No restrictions, use this as you need.
 """
 
 import argparse
+import array
 import json
+import mmap
+import struct
 import sys
 
 from xml.etree import ElementTree
 from fnmatch import fnmatch
 
+try:
+    from collections.abc import Sequence
+except ImportError:
+    from collections import Sequence
+
 EXIT_CODE = 0
 
 current_dumpfile_suppressions = []
@@ -429,7 +437,7 @@ class Function:
         self.tokenDefId = element.get('tokenDef')
         self.name = element.get('name')
         self.type = element.get('type')
-        isVirtual = element.get('isVirtual')
+        isVirtual = element.get('hasVirtualSpecifier')
         self.isVirtual = (isVirtual and isVirtual == 'true')
         isImplicitlyVirtual = element.get('isImplicitlyVirtual')
         self.isImplicitlyVirtual = (isImplicitlyVirtual and isImplicitlyVirtual == 'true')
@@ -858,10 +866,28 @@ class CppcheckData:
 
     def __init__(self, filename):
         """
-        :param filename: Path to Cppcheck dump file
+        :param filename: Path to Cppcheck dump file, xml or binary
         """
         self.filename = filename
 
+        self._binary = None
+        if BinaryDump.isBinaryDump(filename):
+            self._binary = BinaryDump(filename)
+            self.platform = self._binary.platform()
+            self.rawTokens = self._binary.rawTokens()
+            self.suppressions = self._binary.suppressions()
+        else:
+            self._parseHeader()
+
+        global current_dumpfile_suppressions
+        current_dumpfile_suppressions = self.suppressions
+
+    def _parseHeader(self):
+        """
+        Parse the platform, the raw tokens and the suppressions of a xml dump file
+        """
+        self.rawTokens = []
+        self.suppressions = []
         files = []  # source files for elements occurred in this configuration
         platform_done = False
         rawtokens_done = False
@@ -890,9 +916,6 @@ class CppcheckData:
                     self.suppressions.append(Suppression(suppressions_node))
                 suppressions_done = True
 
-        global current_dumpfile_suppressions
-        current_dumpfile_suppressions = self.suppressions
-
         # Set links between rawTokens.
         for i in range(len(self.rawTokens)-1):
             self.rawTokens[i+1].previous = self.rawTokens[i]
@@ -910,6 +933,11 @@ class CppcheckData:
         Create and return iterator for the available Configuration objects.
         The iterator loops over all Configurations in the dump file tree, in document order.
         """
+        if self._binary:
+            for cfg in self._binary.iterconfigurations():
+                yield cfg
+            return
+
         cfg = None
         cfg_arguments = []  # function arguments for Configuration node initialization
         cfg_function = None
@@ -1018,6 +1046,517 @@ class CppcheckData:
         )
 
 
+class _Lazy(object):
+    """
+    Attribute of the objects of a binary dump. It is read from the tables
+    on first access and then stored in the object.
+    """
+
+    def __init__(self, compute):
+        self.compute = compute
+        self.name = None
+
+    def __set_name__(self, owner, name):
+        self.name = name
+
+    def __get__(self, obj, objtype=None):
+        if obj is None:
+            return self
+        value = self.compute(obj)
+        setattr(obj, self.name, value)
+        return value
+
+
+def _id(prefix, row):
+    if row < 0:
+        return None
+    return prefix + str(row)
+
+
+class _LazyList(Sequence):
+    """
+    Read-only list that creates its items on first access
+    """
+
+    def __init__(self, count, item):
+        self._count = count
+        self._item = item
+
+    def __len__(self):
+        return self._count
+
+    def __getitem__(self, index):
+        if isinstance(index, slice):
+            return [self._item(i) for i in range(*index.indices(self._count))]
+        if index < 0:
+            index += self._count
+        if index < 0 or index >= self._count:
+            raise IndexError('list index out of range')
+        return self._item(index)
+
+
+# Bits of the token flags in binary dumps, see lib/binarydump.h
+_TOKEN_KIND_MASK = 0x7
+_TOKEN_NAME = 1
+_TOKEN_NUMBER = 2
+_TOKEN_STRING = 3
+_TOKEN_CHAR = 4
+_TOKEN_OP = 6
+_TOKEN_UNSIGNED = 1 << 3
+_TOKEN_SIGNED = 1 << 4
+_TOKEN_INT = 1 << 5
+_TOKEN_FLOAT = 1 << 6
+_TOKEN_ARITHMETICAL_OP = 1 << 7
+_TOKEN_ASSIGNMENT_OP = 1 << 8
+_TOKEN_COMPARISON_OP = 1 << 9
+_TOKEN_LOGICAL_OP = 1 << 10
+_TOKEN_EXPANDED_MACRO = 1 << 11
+_TOKEN_SPLITTED_VAR_DECL_COMMA = 1 << 12
+_TOKEN_SPLITTED_VAR_DECL_EQ = 1 << 13
+
+_FUNCTION_FLAGS = (('hasVirtualSpecifier', 1 << 0), ('isImplicitlyVirtual', 1 << 1), ('isStatic', 1 << 2))
+
+_VARIABLE_FLAGS = (('isArgument', 1 << 0), ('isArray', 1 << 1), ('isClass', 1 << 2), ('isConst', 1 << 3),
+                   ('isExtern', 1 << 4), ('isLocal', 1 << 5), ('isPointer', 1 << 6), ('isReference', 1 << 7),
+                   ('isStatic', 1 << 8))
+
+
+def _tokenFlag(test):
+    return _Lazy(lambda tok: test(tok._column('flags')))
+
+
+def _tokenKind(kind):
+    return _tokenFlag(lambda flags: (flags & _TOKEN_KIND_MASK) == kind)
+
+
+def _tokenBit(bit):
+    return _tokenFlag(lambda flags: (flags & bit) != 0)
+
+
+def _tokenRef(column, get):
+    return _Lazy(lambda tok: get(tok._cfg, tok._column(column)))
+
+
+def _tokenId(column, prefix):
+    return _Lazy(lambda tok: _id(prefix, tok._column(column)))
+
+
+class _BinaryToken(Token):
+    """
+    Token of a binary dump, the attributes are read when they are accessed
+    """
+
+    def __init__(self, cfg, index):
+        self._cfg = cfg
+        self._index = index
+        self.Id = _id('t', index)
+
+    def _column(self, name):
+        return self._cfg._tokens[name][self._index]
+
+    str = _Lazy(lambda tok: tok._cfg._dump.string(tok._column('str')))
+    file = _Lazy(lambda tok: tok._cfg._dump.string(tok._column('file')))
+    linenr = _Lazy(lambda tok: tok._column('linenr'))
+    column = _Lazy(lambda tok: tok._column('column'))
+    next = _Lazy(lambda tok: tok._cfg.token(tok._index + 1))
+    previous = _Lazy(lambda tok: tok._cfg.token(tok._index - 1))
+    originalName = _Lazy(lambda tok: tok._cfg._dump.string(tok._column('originalName')) or None)
+
+    isName = _tokenKind(_TOKEN_NAME)
+    isNumber = _tokenKind(_TOKEN_NUMBER)
+    isString = _tokenKind(_TOKEN_STRING)
+    isChar = _tokenKind(_TOKEN_CHAR)
+    isOp = _tokenKind(_TOKEN_OP)
+    isUnsigned = _tokenBit(_TOKEN_UNSIGNED)
+    isSigned = _tokenBit(_TOKEN_SIGNED)
+    isInt = _tokenBit(_TOKEN_INT)
+    isFloat = _tokenBit(_TOKEN_FLOAT)
+    isArithmeticalOp = _tokenBit(_TOKEN_ARITHMETICAL_OP)
+    isAssignmentOp = _tokenBit(_TOKEN_ASSIGNMENT_OP)
+    isComparisonOp = _tokenBit(_TOKEN_COMPARISON_OP)
+    isLogicalOp = _tokenBit(_TOKEN_LOGICAL_OP)
+    isExpandedMacro = _tokenBit(_TOKEN_EXPANDED_MACRO)
+    isSplittedVarDeclComma = _tokenBit(_TOKEN_SPLITTED_VAR_DECL_COMMA)
+    isSplittedVarDeclEq = _tokenBit(_TOKEN_SPLITTED_VAR_DECL_EQ)
+    strlen = _Lazy(lambda tok: tok._column('strlen') if tok.isString else None)
+    varId = _Lazy(lambda tok: tok._column('varId') or None)
+
+    scope = _tokenRef('scope', lambda cfg, row: cfg.scope(row))
+    scopeId = _tokenId('scope', 's')
+    link = _tokenRef('link', lambda cfg, row: cfg.token(row))
+    linkId = _tokenId('link', 't')
+    variable = _tokenRef('variable', lambda cfg, row: cfg.variable(row))
+    variableId = _tokenId('variable', 'v')
+    function = _tokenRef('function', lambda cfg, row: cfg.function(row))
+    functionId = _tokenId('function', 'f')
+    typeScope = _tokenRef('typeScope', lambda cfg, row: cfg.scope(row))
+    typeScopeId = _tokenId('typeScope', 's')
+    astParent = _tokenRef('astParent', lambda cfg, row: cfg.token(row))
+    astParentId = _tokenId('astParent', 't')
+    astOperand1 = _tokenRef('astOperand1', lambda cfg, row: cfg.token(row))
+    astOperand1Id = _tokenId('astOperand1', 't')
+    astOperand2 = _tokenRef('astOperand2', lambda cfg, row: cfg.token(row))
+    astOperand2Id = _tokenId('astOperand2', 't')
+    values = _Lazy(lambda tok: tok._cfg.tokenValues(tok._index))
+    valuesId = _Lazy(lambda tok: _id('vf', tok._index) if tok._column('valueCount') else None)
+    valueType = _Lazy(lambda tok: tok._cfg.valueType(tok._index))
+
+
+class _BinaryRawToken(Token):
+    """
+    Raw token of a binary dump, the attributes are read when they are accessed
+    """
+
+    def __init__(self, dump, index):
+        self._dump = dump
+        self._index = index
+
+    def _column(self, name):
+        return self._dump._rawTokens[name][self._index]
+
+    str = _Lazy(lambda tok: tok._dump.string(tok._column('str')))
+    file = _Lazy(lambda tok: tok._dump.string(tok._column('file')))
+    linenr = _Lazy(lambda tok: tok._column('linenr'))
+    column = _Lazy(lambda tok: tok._column('column'))
+    next = _Lazy(lambda tok: tok._dump.rawToken(tok._index + 1))
+    previous = _Lazy(lambda tok: tok._dump.rawToken(tok._index - 1))
+
+
+class _BinaryTable(object):
+    """
+    Table of a binary dump. Only the column headers are read, the columns
+    are mapped when they are accessed.
+    """
+
+    def __init__(self, dump, offset):
+        self._dump = dump
+        self.rows, count = struct.unpack_from('<II', dump._mmap, offset)
+        self._columns = {}
+        self._arrays = {}
+        data = offset + 8 + 24 * count
+        for i in range(count):
+            header = offset + 8 + 24 * i
+            name = dump._mmap[header:header + 16].rstrip(b'\0').decode('ascii')
+            typecode = chr(dump._mmap[header + 16])
+            self._columns[name] = (typecode, data)
+            size = self.rows * BinaryDump.ITEM_SIZE[typecode]
+            data += size + (8 - size % 8) % 8
+
+    def __len__(self):
+        return self.rows
+
+    def __getitem__(self, name):
+        column = self._arrays.get(name)
+        if column is None:
+            typecode, offset = self._columns[name]
+            column = self._dump.array(typecode, offset, self.rows)
+            self._arrays[name] = column
+        return column
+
+
+class _BinaryConfiguration(Configuration):
+    """
+    Configuration of a binary dump. The tokens, scopes, functions,
+    variables and values are created when they are accessed.
+    """
+
+    def __init__(self, dump, offset, size):
+        self._dump = dump
+        tables = dict((tag, _BinaryTable(dump, start)) for tag, start, _ in dump.sections(offset, offset + size))
+        info = tables['INFO']
+        self.name = dump.string(info['name'][0])
+        self.standards = Standards()
+        self.standards.c = dump.string(info['c'][0])
+        self.standards.cpp = dump.string(info['cpp'][0])
+
+        self._directives = tables['DIRS']
+        self._tokens = tables['TOKS']
+        self._scopes = tables['SCOP']
+        self._scopeVariables = tables['SVAR']
+        self._functions = tables['FUNC']
+        self._functionArguments = tables['FARG']
+        self._variables = tables['VARS']
+        self._values = tables['VALS']
+        self._objects = {}
+
+        self.directives = _LazyList(len(self._directives), self.directive)
+        self.tokenlist = _LazyList(len(self._tokens), self.token)
+        self.scopes = _LazyList(len(self._scopes), self.scope)
+        self.functions = _LazyList(len(self._functions), self.function)
+        self.variables = _LazyList(len(self._variables), self.variable)
+
+    @property
+    def valueflow(self):
+        valueCounts = self._tokens['valueCount']
+        rows = [row for row in range(len(self._tokens)) if valueCounts[row]]
+        return _LazyList(len(rows), lambda index: self._valueFlow(rows[index]))
+
+    def token(self, row):
+        if row < 0 or row >= len(self._tokens):
+            return None
+        key = ('t', row)
+        tok = self._objects.get(key)
+        if tok is None:
+            tok = _BinaryToken(self, row)
+            self._objects[key] = tok
+        return tok
+
+    def directive(self, row):
+        table = self._directives
+        return Directive({'str': self._dump.string(table['str'][row]),
+                          'file': self._dump.string(table['file'][row]),
+                          'linenr': table['linenr'][row]})
+
+    def scope(self, row):
+        if row < 0:
+            return None
+        key = ('s', row)
+        scope = self._objects.get(key)
+        if scope is not None:
+            return scope
+        table = self._scopes
+        scope = Scope({'id': _id('s', row),
+                       'className': self._dump.string(table['className'][row]) or None,
+                       'type': self._dump.string(table['type'][row])})
+        self._objects[key] = scope
+        scope.bodyStartId = _id('t', table['bodyStart'][row])
+        scope.bodyStart = self.token(table['bodyStart'][row])
+        scope.bodyEndId = _id('t', table['bodyEnd'][row])
+        scope.bodyEnd = self.token(table['bodyEnd'][row])
+        scope.nestedInId = _id('s', table['nestedIn'][row])
+        scope.nestedIn = self.scope(table['nestedIn'][row])
+        scope.functionId = _id('f', table['function'][row])
+        scope.function = self.function(table['function'][row])
+        variables = self._scopeVariables['variable']
+        start = table['varlist'][row]
+        scope.varlistId = [_id('v', variables[i]) for i in range(start, start + table['varCount'][row])]
+        scope.varlist = [self.variable(variables[i]) for i in range(start, start + table['varCount'][row])]
+        return scope
+
+    def function(self, row):
+        if row < 0:
+            return None
+        key = ('f', row)
+        function = self._objects.get(key)
+        if function is not None:
+            return function
+        table = self._functions
+        attributes = {'id': _id('f', row),
+                      'tokenDef': _id('t', table['tokenDef'][row]),
+                      'name': self._dump.string(table['name'][row]),
+                      'type': self._dump.string(table['type'][row])}
+        for name, bit in _FUNCTION_FLAGS:
+            if table['flags'][row] & bit:
+                attributes[name] = 'true'
+        function = Function(attributes, None)
+        self._objects[key] = function
+        function.nestedIn = self.scope(table['nestedIn'][row])
+        function.tokenDef = self.token(table['tokenDef'][row])
+        variables = self._functionArguments['variable']
+        start = table['args'][row]
+        for nr in range(table['argCount'][row]):
+            function.argumentId[nr + 1] = _id('v', variables[start + nr])
+            function.argument[nr + 1] = self.variable(variables[start + nr])
+        return function
+
+    def variable(self, row):
+        if row < 0:
+            return None
+        key = ('v', row)
+        variable = self._objects.get(key)
+        if variable is not None:
+            return variable
+        table = self._variables
+        attributes = {'id': _id('v', row),
+                      'nameToken': _id('t', table['nameToken'][row]),
+                      'typeStartToken': _id('t', table['typeStartToken'][row]),
+                      'typeEndToken': _id('t', table['typeEndToken'][row]),
+                      'access': self._dump.string(table['access'][row]),
+                      'scope': _id('s', table['scope'][row]),
+                      'constness': table['constness'][row]}
+        for name, bit in _VARIABLE_FLAGS:
+            attributes[name] = 'true' if table['flags'][row] & bit else 'false'
+        variable = Variable(attributes)
+        self._objects[key] = variable
+        variable.nameToken = self.token(table['nameToken'][row])
+        variable.typeStartToken = self.token(table['typeStartToken'][row])
+        variable.typeEndToken = self.token(table['typeEndToken'][row])
+        variable.scope = self.scope(table['scope'][row])
+        return variable
+
+    def valueType(self, row):
+        tokens = self._tokens
+        vtType = self._dump.string(tokens['vtType'][row])
+        if not vtType:
+            return None
+        valueType = ValueType({'valueType-type': vtType,
+                               'valueType-sign': self._dump.string(tokens['vtSign'][row]) or None,
+                               'valueType-bits': tokens['vtBits'][row],
+                               'valueType-typeScope': _id('s', tokens['vtTypeScope'][row]),
+                               'valueType-originalTypeName': self._dump.string(tokens['vtOriginalType'][row]) or None,
+                               'valueType-constness': tokens['vtConstness'][row],
+                               'valueType-pointer': tokens['vtPointer'][row]})
+        valueType.typeScope = self.scope(tokens['vtTypeScope'][row])
+        return valueType
+
+    def tokenValues(self, row):
+        """
+        List of the values of a token, None if it has no values
+        """
+        count = self._tokens['valueCount'][row]
+        if not count:
+            return None
+        key = ('vf', row)
+        values = self._objects.get(key)
+        if values is None:
+            start = self._tokens['values'][row]
+            unsigned = self._dump.string(self._tokens['vtSign'][row]) == 'unsigned'
+            values = [self._value(i, unsigned) for i in range(start, start + count)]
+            self._objects[key] = values
+        return values
+
+    def _value(self, row, unsigned):
+        table = self._values
+        valueType = self._dump.string(table['type'][row])
+        attributes = {self._dump.string(table['kind'][row]): 'true'}
+        if table['conditionLine'][row]:
+            attributes['condition-line'] = table['conditionLine'][row]
+        if valueType == 'intvalue':
+            intvalue = table['int'][row]
+            if unsigned and intvalue < 0:
+                intvalue += 1 << 64
+            attributes['intvalue'] = intvalue
+        elif valueType == 'tokvalue':
+            attributes['tokvalue'] = _id('t', table['tok'][row])
+        elif valueType == 'floatvalue':
+            attributes['floatvalue'] = table['float'][row]
+        elif valueType == 'container-size':
+            attributes['container-size'] = table['int'][row]
+        return Value(attributes)
+
+    def _valueFlow(self, row):
+        valueFlow = ValueFlow({'id': _id('vf', row)})
+        valueFlow.values = self.tokenValues(row)
+        return valueFlow
+
+
+class BinaryDump(object):
+    """
+    Reader of the binary dump files written with --dump-format=binary, see
+    lib/binarydump.h for the format. The file is mapped into memory, tables
+    are decoded and objects are created when they are accessed. It provides
+    the same classes as the xml dump, but integers and floats in values are
+    numbers instead of strings. Requires Python 3.6.
+    """
+
+    MAGIC = b'LCPPCDMP'
+    VERSION = 1
+    ITEM_SIZE = {'i': 4, 'I': 4, 'q': 8, 'd': 8}
+
+    @staticmethod
+    def isBinaryDump(filename):
+        with open(filename, 'rb') as f:
+            return f.read(len(BinaryDump.MAGIC)) == BinaryDump.MAGIC
+
+    def __init__(self, filename):
+        # The lazy attributes of the objects need __set_name__
+        if sys.version_info < (3, 6):
+            raise RuntimeError('%s: reading binary dumps requires Python 3.6 or later' % filename)
+        with open(filename, 'rb') as f:
+            self._mmap = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        self._data = memoryview(self._mmap)
+        if self._mmap[0:8] != self.MAGIC:
+            raise ValueError('%s is no binary dump file' % filename)
+        version = struct.unpack_from('<I', self._mmap, 8)[0]
+        if version != self.VERSION:
+            raise ValueError('%s: unsupported binary dump version %d' % (filename, version))
+
+        self._sections = self.sections(16, len(self._mmap))
+        strings = [start for tag, start, _ in self._sections if tag == 'STRS']
+        if not strings:
+            raise ValueError('%s: incomplete binary dump file' % filename)
+        count = struct.unpack_from('<I', self._mmap, strings[0])[0]
+        self._stringOffsets = self.array('I', strings[0] + 8, count + 1)
+        self._stringData = strings[0] + 8 + 4 * (count + 1)
+        self._strings = {0: ''}
+        self._rawTokens = self._table('RAWT')
+        self._rawTokenObjects = {}
+
+    def sections(self, offset, end):
+        """
+        List of (tag, payload offset, payload size) of the sections between offset and end
+        """
+        sections = []
+        while offset + 16 <= end:
+            tag = self._mmap[offset:offset + 4].decode('ascii')
+            size = struct.unpack_from('<Q', self._mmap, offset + 8)[0]
+            sections.append((tag, offset + 16, size))
+            offset += 16 + size
+        return sections
+
+    def array(self, typecode, offset, count):
+        """
+        Numbers at given offset, mapped without copy on little endian machines
+        """
+        view = self._data[offset:offset + count * self.ITEM_SIZE[typecode]]
+        if sys.byteorder == 'little':
+            return view.cast(typecode)
+        values = array.array(typecode)
+        values.frombytes(view.tobytes())
+        values.byteswap()
+        return values
+
+    def string(self, index):
+        value = self._strings.get(index)
+        if value is None:
+            start = self._stringData + self._stringOffsets[index]
+            end = self._stringData + self._stringOffsets[index + 1]
+            value = self._mmap[start:end].decode('utf-8', 'replace')
+            self._strings[index] = value
+        return value
+
+    def _table(self, tag):
+        for name, start, _ in self._sections:
+            if name == tag:
+                return _BinaryTable(self, start)
+        return None
+
+    def platform(self):
+        table = self._table('PLAT')
+        attributes = {'name': self.string(table['name'][0])}
+        for name in ('char_bit', 'short_bit', 'int_bit', 'long_bit', 'long_long_bit', 'pointer_bit'):
+            attributes[name] = table[name][0]
+        return Platform(attributes)
+
+    def rawToken(self, row):
+        if row < 0 or row >= len(self._rawTokens):
+            return None
+        tok = self._rawTokenObjects.get(row)
+        if tok is None:
+            tok = _BinaryRawToken(self, row)
+            self._rawTokenObjects[row] = tok
+        return tok
+
+    def rawTokens(self):
+        return _LazyList(len(self._rawTokens), self.rawToken)
+
+    def suppressions(self):
+        table = self._table('SUPP')
+        suppressions = []
+        for row in range(len(table)):
+            lineNumber = table['lineNumber'][row]
+            suppressions.append(Suppression({'errorId': self.string(table['errorId'][row]),
+                                             'fileName': self.string(table['fileName'][row]) or None,
+                                             'lineNumber': lineNumber if lineNumber >= 0 else None,
+                                             'symbolName': self.string(table['symbolName'][row]) or None}))
+        return suppressions
+
+    def iterconfigurations(self):
+        for tag, start, size in self._sections:
+            if tag == 'CONF':
+                yield _BinaryConfiguration(self, start, size)
+
+
 # Get function arguments
 def getArgumentsRecursive(tok, arguments):
     if tok is None:
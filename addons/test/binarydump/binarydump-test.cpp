@@ -0,0 +1,26 @@
+#define LIMIT 10
+
+struct Base {
+    virtual ~Base() {}
+    virtual int get() const = 0;
+    static int count;
+};
+
+struct Derived : public Base {
+    int get() const override { return value; }
+    int value = 3;
+};
+
+int f(int a, int, const char *s) {
+    int x = a + 1;
+    unsigned int u = 4000000000U;
+    double d = 1.5;
+    if (x > LIMIT)
+        return s[0];
+    for (int i = 0; i < 3; ++i)
+        x += i;
+#ifdef EXTRA
+    x *= 2;
+#endif
+    return x + (int)d + (int)u;
+}
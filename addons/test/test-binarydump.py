@@ -0,0 +1,99 @@
+# Running the test with Python 3:
+# Command in cppcheck directory:
+# PYTHONPATH=./addons python3 -m pytest addons/test/test-binarydump.py
+
+import sys
+
+import pytest
+
+import cppcheckdata
+
+from .util import dump_create, dump_remove
+
+
+TEST_SOURCE_FILE = './addons/test/binarydump/binarydump-test.cpp'
+
+TOKEN_FLAGS = ['isName', 'isUnsigned', 'isSigned', 'isNumber', 'isInt', 'isFloat', 'isString', 'isChar',
+               'isOp', 'isArithmeticalOp', 'isAssignmentOp', 'isComparisonOp', 'isLogicalOp',
+               'isExpandedMacro', 'isSplittedVarDeclComma', 'isSplittedVarDeclEq']
+
+VARIABLE_FLAGS = ['isArgument', 'isArray', 'isClass', 'isConst', 'isExtern', 'isLocal', 'isPointer',
+                  'isReference', 'isStatic']
+
+
+def describe(data):
+    """
+    Contents of a dump, the objects refer to each other by their position
+    in the lists of the configuration because the ids differ between the formats.
+    """
+    result = [('platform', data.platform.name, data.platform.char_bit, data.platform.int_bit),
+              ('rawTokens', [(tok.str, tok.file, tok.linenr, tok.column) for tok in data.rawTokens])]
+    for cfg in data.iterconfigurations():
+        index = {}
+        for prefix, items in (('t', cfg.tokenlist), ('s', cfg.scopes), ('f', cfg.functions), ('v', cfg.variables)):
+            for nr, item in enumerate(items):
+                index[id(item)] = prefix + str(nr)
+
+        def ref(obj):
+            return None if obj is None else index.get(id(obj), 'unlisted')
+
+        def values(tok):
+            if not tok.values:
+                return None
+            return [(v.valueKind, v.intvalue, ref(v.tokvalue), v.floatvalue and float(v.floatvalue),
+                     v.containerSize and int(v.containerSize), v.condition, v.inconclusive) for v in tok.values]
+
+        def valueType(tok):
+            vt = tok.valueType
+            if vt is None:
+                return None
+            return (vt.type, vt.sign, vt.bits, vt.constness, vt.pointer, vt.originalTypeName, ref(vt.typeScope))
+
+        result.append(('configuration', cfg.name))
+        result.append(('directives', [(d.str, d.file, d.linenr) for d in cfg.directives]))
+        for tok in cfg.tokenlist:
+            result.append(('token', tok.str, tok.file, tok.linenr, tok.column, tok.varId, tok.strlen,
+                           [flag for flag in TOKEN_FLAGS if getattr(tok, flag)],
+                           ref(tok.link), ref(tok.scope), ref(tok.variable), ref(tok.function), ref(tok.typeScope),
+                           ref(tok.astParent), ref(tok.astOperand1), ref(tok.astOperand2),
+                           values(tok), valueType(tok)))
+        for scope in cfg.scopes:
+            result.append(('scope', scope.type, scope.className, ref(scope.bodyStart), ref(scope.bodyEnd),
+                           ref(scope.nestedIn), ref(scope.function), [ref(var) for var in scope.varlist]))
+        for function in cfg.functions:
+            result.append(('function', function.name, function.type, ref(function.tokenDef), ref(function.nestedIn),
+                           function.isVirtual, function.isImplicitlyVirtual, function.isStatic,
+                           sorted((nr, ref(var)) for nr, var in function.argument.items())))
+        for var in cfg.variables:
+            result.append(('variable', ref(var.nameToken), ref(var.typeStartToken), ref(var.typeEndToken),
+                           var.access, ref(var.scope), var.constness,
+                           [flag for flag in VARIABLE_FLAGS if getattr(var, flag)]))
+    return result
+
+
+@pytest.mark.skipif(sys.version_info < (3, 6), reason='reading binary dumps requires Python 3.6')
+def test_binary_dump_matches_xml_dump():
+    dump_create(TEST_SOURCE_FILE)
+    try:
+        xml = describe(cppcheckdata.CppcheckData(TEST_SOURCE_FILE + '.dump'))
+    finally:
+        dump_remove(TEST_SOURCE_FILE)
+
+    dump_create(TEST_SOURCE_FILE, '--dump-format=binary')
+    try:
+        binary = describe(cppcheckdata.CppcheckData(TEST_SOURCE_FILE + '.dump'))
+    finally:
+        dump_remove(TEST_SOURCE_FILE)
+
+    assert len(binary) == len(xml)
+    for expected, actual in zip(xml, binary):
+        assert actual == expected
+
+    # Every configuration is dumped, with the virtual functions and the unnamed argument
+    assert [entry[1] for entry in xml if entry[0] == 'configuration'] == ['', 'EXTRA']
+    functions = [entry for entry in xml if entry[0] == 'function'][:4]
+    assert [(f[1], f[2], bool(f[5]), bool(f[6])) for f in functions] == [('f', 'Function', False, False),
+                                                                          ('Base', 'Destructor', True, False),
+                                                                          ('get', 'Function', True, False),
+                                                                          ('get', 'Function', False, True)]
+    assert 'unlisted' not in [var for _, var in functions[0][8]]
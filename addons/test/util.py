@@ -6,6 +6,7 @@ import os
 
 def find_cppcheck_binary():
     possible_locations = [
+        "./lcppc",
         "./cppcheck",
         "./build/bin/cppcheck",
         r".\bin\cppcheck.exe",
@@ -20,7 +21,7 @@ def find_cppcheck_binary():
 
 def dump_create(fpath, *argv):
     cppcheck_binary = find_cppcheck_binary()
-    cmd = [cppcheck_binary, "--dump", "--quiet", fpath] + list(argv)
+    cmd = [cppcheck_binary, "--dump", "-o=findings", fpath] + list(argv)
     p = subprocess.Popen(cmd)
     p.communicate()
     if p.returncode != 0:
@@ -29,7 +30,7 @@ def dump_create(fpath, *argv):
 
 
 def dump_remove(fpath):
-    subprocess.Popen(["rm", "-f", fpath + ".dump"])
+    subprocess.call(["rm", "-f", fpath + ".dump"])
 
 
 def convert_json_output(raw_json_strings):
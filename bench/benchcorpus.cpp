@@ -0,0 +1,65 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Macro benchmarks: complete analysis of the files of a corpus
+
+#include "benchcorpus.h"
+
+#include "benchsuite.h"
+#include "cppcheck.h"
+#include "ctu.h"
+#include "filelister.h"
+#include "path.h"
+#include "pathmatch.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+
+namespace {
+    class CorpusBenchmark : public Benchmark {
+    public:
+        CorpusBenchmark(const std::string& name, const std::vector<std::pair<std::string, std::size_t>>& files)
+            : Benchmark(name), mFiles(files) {}
+
+        void run() override {
+            CppCheck cppcheck(errorLogger(), settings(), project(), false);
+            for (const std::pair<std::string, std::size_t>& file : mFiles) {
+                CTU::CTUInfo ctu(file.first, file.second, emptyString);
+                cppcheck.check(&ctu);
+            }
+        }
+
+    private:
+        const std::vector<std::pair<std::string, std::size_t>> mFiles;
+    };
+}
+
+std::size_t addCorpusBenchmarks(const std::string& directory)
+{
+    std::map<std::string, std::size_t> files;
+    FileLister::recursiveAddFiles(files, Path::toNativeSeparators(directory), PathMatch(std::vector<std::string>()));
+
+    const std::vector<std::string> basePaths(1, Path::fromNativeSeparators(directory));
+    for (std::map<std::string, std::size_t>::const_iterator it = files.cbegin(); it != files.cend(); ++it)
+        BenchmarkRegistry::add(new CorpusBenchmark("corpus/" + Path::getRelativePath(Path::fromNativeSeparators(it->first), basePaths), {*it}));
+    if (files.size() > 1)
+        BenchmarkRegistry::add(new CorpusBenchmark("corpus", std::vector<std::pair<std::string, std::size_t>>(files.cbegin(), files.cend())));
+    return files.size();
+}
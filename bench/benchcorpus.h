@@ -0,0 +1,32 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef benchcorpusH
+#define benchcorpusH
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Register macro benchmarks that check the source files of given directory
+ * with all checks enabled: one per file and one for the whole corpus.
+ * @return number of files found
+ */
+std::size_t addCorpusBenchmarks(const std::string& directory);
+
+#endif // benchcorpusH
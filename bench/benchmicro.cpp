@@ -0,0 +1,255 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Micro benchmarks: single phases of the analysis on generated code
+
+#include "benchsuite.h"
+
+#include "settings.h"
+#include "token.h"
+#include "tokenize.h"
+
+#include <simplecpp.h>
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+/** Deterministic C++ code with templates, classes, loops, conditions and allocations */
+static std::string generateCode(int units)
+{
+    std::ostringstream code;
+    code << "#define MAX(a, b) ((a) > (b) ? (a) : (b))\n";
+    for (int i = 0; i < units; ++i) {
+        code << "template<class T> struct Box" << i << " {\n"
+             << "    T value;\n"
+             << "    explicit Box" << i << "(T v) : value(v) {}\n"
+             << "    T get() const { return value; }\n"
+             << "};\n"
+             << "class Shape" << i << " {\n"
+             << "public:\n"
+             << "    virtual ~Shape" << i << "() {}\n"
+             << "    virtual int area(int scale) const { return scale * mData[" << i % 8 << "]; }\n"
+             << "private:\n"
+             << "    int mData[" << 8 + i % 8 << "];\n"
+             << "};\n"
+             << "int compute" << i << "(int n, const int *data) {\n"
+             << "    Box" << i << "<int> box(n);\n"
+             << "    int sum = 0;\n"
+             << "    for (int j = 0; j < n; ++j) {\n"
+             << "        if (data[j] > " << i << ")\n"
+             << "            sum += MAX(data[j], box.get());\n"
+             << "        else if (data[j] == 0)\n"
+             << "            break;\n"
+             << "    }\n"
+             << "    char *buf = (char *)malloc(n + 1);\n"
+             << "    if (!buf)\n"
+             << "        return -1;\n"
+             << "    buf[n] = 0;\n"
+             << "    free(buf);\n"
+             << "    return sum;\n"
+             << "}\n";
+    }
+    return code.str();
+}
+
+static const std::string& sourceCode()
+{
+    static const std::string code = generateCode(200);
+    return code;
+}
+
+/** The generated code with the macros expanded, as the tokenizer gets it */
+static const std::string& preprocessedCode()
+{
+    static const std::string code = []() {
+        std::vector<std::string> files;
+        std::istringstream istr(sourceCode());
+        const simplecpp::TokenList tokens(istr, files, "bench.cpp");
+        std::map<std::string, simplecpp::TokenList*> filedata;
+        simplecpp::TokenList output(files);
+        simplecpp::preprocess(output, tokens, files, filedata, simplecpp::DUI());
+        simplecpp::cleanup(filedata);
+        return output.stringify();
+    }();
+    return code;
+}
+
+
+class BenchSimplecppLexer : public Benchmark {
+public:
+    BenchSimplecppLexer() : Benchmark("simplecpp::TokenList") {}
+
+    void run() override {
+        std::vector<std::string> files;
+        std::istringstream istr(sourceCode());
+        const simplecpp::TokenList tokens(istr, files, "bench.cpp");
+    }
+};
+
+REGISTER_BENCHMARK(BenchSimplecppLexer)
+
+
+class BenchSimplecppPreprocess : public Benchmark {
+public:
+    BenchSimplecppPreprocess() : Benchmark("simplecpp::preprocess") {}
+
+    void setUp() override {
+        std::istringstream istr(sourceCode());
+        mTokens.reset(new simplecpp::TokenList(istr, mFiles, "bench.cpp"));
+    }
+
+    void run() override {
+        std::map<std::string, simplecpp::TokenList*> filedata;
+        simplecpp::TokenList output(mFiles);
+        simplecpp::preprocess(output, *mTokens, mFiles, filedata, simplecpp::DUI());
+        simplecpp::cleanup(filedata);
+    }
+
+    void tearDown() override {
+        mTokens.reset();
+        mFiles.clear();
+    }
+
+private:
+    std::vector<std::string> mFiles;
+    std::unique_ptr<simplecpp::TokenList> mTokens;
+};
+
+REGISTER_BENCHMARK(BenchSimplecppPreprocess)
+
+
+class BenchSimplifyTokenList1 : public Benchmark {
+public:
+    BenchSimplifyTokenList1() : Benchmark("Tokenizer::simplifyTokenList1") {}
+
+    void setUp() override {
+        mTokenizer.reset(new Tokenizer(&settings(), &project(), &errorLogger()));
+        std::istringstream istr(preprocessedCode());
+        mTokenizer->createTokens(istr, "bench.cpp");
+        mTokenizer->simplifyTokens0(emptyString);
+    }
+
+    void run() override {
+        mTokenizer->simplifyTokenList1("bench.cpp");
+    }
+
+    void tearDown() override {
+        mTokenizer.reset();
+    }
+
+private:
+    std::unique_ptr<Tokenizer> mTokenizer;
+};
+
+REGISTER_BENCHMARK(BenchSimplifyTokenList1)
+
+
+/**
+ * Builds one analysis layer. The layers before it are built in setUp(),
+ * run() builds the given layer.
+ */
+class AnalysisLayerBenchmark : public Benchmark {
+public:
+    AnalysisLayerBenchmark(const std::string& name, Tokenizer::AnalysisLayer prepared, Tokenizer::AnalysisLayer timed)
+        : Benchmark(name), mPrepared(prepared), mTimed(timed) {}
+
+    void setUp() override {
+        mTokenizer.reset(new Tokenizer(&settings(), &project(), &errorLogger()));
+        mTokenizer->setAnalysisLayer(mPrepared);
+        std::istringstream istr(preprocessedCode());
+        mTokenizer->tokenize(istr, "bench.cpp");
+    }
+
+    void run() override {
+        mTokenizer->buildAnalysisLayers(mTimed);
+    }
+
+    void tearDown() override {
+        mTokenizer.reset();
+    }
+
+private:
+    const Tokenizer::AnalysisLayer mPrepared;
+    const Tokenizer::AnalysisLayer mTimed;
+    std::unique_ptr<Tokenizer> mTokenizer;
+};
+
+class BenchCreateAst : public AnalysisLayerBenchmark {
+public:
+    BenchCreateAst() : AnalysisLayerBenchmark("TokenList::createAst", Tokenizer::AnalysisLayer::None, Tokenizer::AnalysisLayer::Ast) {}
+};
+
+REGISTER_BENCHMARK(BenchCreateAst)
+
+class BenchSymbolDatabase : public AnalysisLayerBenchmark {
+public:
+    BenchSymbolDatabase() : AnalysisLayerBenchmark("SymbolDatabase", Tokenizer::AnalysisLayer::Ast, Tokenizer::AnalysisLayer::Symbols) {}
+};
+
+REGISTER_BENCHMARK(BenchSymbolDatabase)
+
+class BenchValueFlow : public AnalysisLayerBenchmark {
+public:
+    BenchValueFlow() : AnalysisLayerBenchmark("ValueFlow::setValues", Tokenizer::AnalysisLayer::ValueTypes, Tokenizer::AnalysisLayer::ValueFlow) {}
+};
+
+REGISTER_BENCHMARK(BenchValueFlow)
+
+
+class BenchTokenMatch : public Benchmark {
+public:
+    BenchTokenMatch() : Benchmark("Token::Match"), mMatches(0) {}
+
+    void setUp() override {
+        if (mTokenizer)
+            return;
+        mTokenizer.reset(new Tokenizer(&settings(), &project(), &errorLogger()));
+        std::istringstream istr(preprocessedCode());
+        mTokenizer->tokenize(istr, "bench.cpp");
+    }
+
+    void run() override {
+        // Typical patterns of the checks: literal tokens, alternatives, commands and varids
+        std::size_t matches = 0;
+        for (const Token *tok = mTokenizer->tokens(); tok; tok = tok->next()) {
+            if (Token::Match(tok, "%var% = malloc|calloc|realloc ("))
+                ++matches;
+            if (Token::Match(tok, "if|while ( !| %var% )"))
+                ++matches;
+            if (Token::Match(tok, "%name% [ %num% ] ="))
+                ++matches;
+            if (Token::Match(tok, "return %any% ;"))
+                ++matches;
+            if (tok->varId() && Token::Match(tok, "%varid% . %name% (", tok->varId()))
+                ++matches;
+        }
+        mMatches = matches;
+    }
+
+private:
+    std::size_t mMatches;
+    std::unique_ptr<Tokenizer> mTokenizer;
+};
+
+REGISTER_BENCHMARK(BenchTokenMatch)
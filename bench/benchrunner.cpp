@@ -0,0 +1,120 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchcorpus.h"
+#include "benchsuite.h"
+#include "errorlogger.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+static void printHelp()
+{
+    std::cout << "Usage: benchrunner [OPTIONS] [BenchmarkName ...]\n"
+              "Runs the benchmarks whose name contains one of the given names, all if none is given.\n"
+              "Options:\n"
+              "    --warmup=<n>      Untimed iterations before the measurement (default 2)\n"
+              "    --iterations=<n>  Timed iterations (default 10)\n"
+              "    --corpus=<dir>    Source files checked by the corpus benchmarks (default test/synthetic)\n"
+              "    --json=<file>     Write the results as JSON to given file\n"
+              "    --list            List the benchmarks\n";
+}
+
+static bool parseCount(const char arg[], std::size_t& count)
+{
+    char* end = nullptr;
+    const long long value = std::strtoll(arg, &end, 10);
+    if (end == arg || *end != '\0' || value < 0)
+        return false;
+    count = static_cast<std::size_t>(value);
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    try {
+        BenchmarkRunner runner;
+        std::string corpus = "test/synthetic";
+        std::string json;
+        bool list = false;
+        std::vector<std::string> filters;
+
+        for (int i = 1; i < argc; ++i) {
+            const char* arg = argv[i];
+            if (std::strncmp(arg, "--warmup=", 9) == 0) {
+                if (!parseCount(arg + 9, runner.warmup)) {
+                    std::cerr << "benchrunner: argument to '--warmup=' is not a valid count." << std::endl;
+                    return EXIT_FAILURE;
+                }
+            } else if (std::strncmp(arg, "--iterations=", 13) == 0) {
+                if (!parseCount(arg + 13, runner.iterations) || runner.iterations == 0) {
+                    std::cerr << "benchrunner: argument to '--iterations=' is not a valid count." << std::endl;
+                    return EXIT_FAILURE;
+                }
+            } else if (std::strncmp(arg, "--corpus=", 9) == 0)
+                corpus = arg + 9;
+            else if (std::strncmp(arg, "--json=", 7) == 0)
+                json = arg + 7;
+            else if (std::strcmp(arg, "--list") == 0)
+                list = true;
+            else if (std::strcmp(arg, "-h") == 0 || std::strcmp(arg, "--help") == 0) {
+                printHelp();
+                return EXIT_SUCCESS;
+            } else if (arg[0] == '-') {
+                std::cerr << "benchrunner: unrecognized command line option: \"" << arg << "\"." << std::endl;
+                return EXIT_FAILURE;
+            } else
+                filters.emplace_back(arg);
+        }
+
+        if (!BenchmarkRunner::initialize(argv[0])) {
+            std::cerr << "benchrunner: Failed to load std.cfg." << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (!corpus.empty() && addCorpusBenchmarks(corpus) == 0)
+            std::cerr << "benchrunner: No source files found in corpus '" << corpus << "'." << std::endl;
+
+        if (list) {
+            for (const std::unique_ptr<Benchmark>& benchmark : BenchmarkRegistry::benchmarks())
+                std::cout << benchmark->name() << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        const std::vector<BenchmarkResult> results = runner.run(filters, std::cout);
+        if (!json.empty()) {
+            std::ofstream fout(json);
+            if (!fout.is_open()) {
+                std::cerr << "benchrunner: Failed to open '" << json << "' for writing." << std::endl;
+                return EXIT_FAILURE;
+            }
+            BenchmarkRunner::writeJson(fout, results, runner.warmup);
+        }
+        return EXIT_SUCCESS;
+    } catch (const InternalError& e) {
+        std::cout << e.errorMessage << std::endl;
+    } catch (const std::exception& error) {
+        std::cout << error.what() << std::endl;
+    }
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,170 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchsuite.h"
+
+#include "library.h"
+#include "settings.h"
+#include "utils.h"
+#include "version.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+
+namespace {
+    class NullErrorLogger : public ErrorLogger {
+    public:
+        void reportOut(const std::string &outmsg) override {
+            (void)outmsg;
+        }
+        void reportErr(const ErrorMessage &msg) override {
+            (void)msg;
+        }
+    };
+}
+
+Settings& Benchmark::settings()
+{
+    static Settings settings;
+    return settings;
+}
+
+Project& Benchmark::project()
+{
+    static Project project;
+    return project;
+}
+
+ErrorLogger& Benchmark::errorLogger()
+{
+    static NullErrorLogger errorLogger;
+    return errorLogger;
+}
+
+
+BenchmarkResult BenchmarkResult::compute(const std::string& name, std::vector<double> samples)
+{
+    BenchmarkResult result{name, samples.size(), 0, 0, 0, 0, 0};
+    if (samples.empty())
+        return result;
+
+    std::sort(samples.begin(), samples.end());
+    result.min = samples.front();
+    result.max = samples.back();
+    const std::size_t middle = samples.size() / 2;
+    result.median = (samples.size() % 2) ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+
+    double sum = 0;
+    for (const double sample : samples)
+        sum += sample;
+    result.mean = sum / samples.size();
+
+    if (samples.size() > 1) {
+        double squares = 0;
+        for (const double sample : samples)
+            squares += (sample - result.mean) * (sample - result.mean);
+        result.stddev = std::sqrt(squares / (samples.size() - 1));
+    }
+    return result;
+}
+
+
+std::vector<std::unique_ptr<Benchmark>>& BenchmarkRegistry::benchmarks()
+{
+    static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+    return benchmarks;
+}
+
+
+bool BenchmarkRunner::initialize(const char exename[])
+{
+    Project& project = Benchmark::project();
+    if (project.library.load(exename, "std.cfg").errorcode != Library::OK &&
+        project.library.load(exename, "cfg/std.cfg").errorcode != Library::OK)
+        return false;
+    project.libraries.emplace("std");
+    project.severity.fill();
+    return true;
+}
+
+static bool matches(const std::string& name, const std::vector<std::string>& filters)
+{
+    if (filters.empty())
+        return true;
+    return std::any_of(filters.cbegin(), filters.cend(), [&](const std::string& filter) {
+        return name.find(filter) != std::string::npos;
+    });
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::run(const std::vector<std::string>& filters, std::ostream& out) const
+{
+    std::vector<BenchmarkResult> results;
+
+    std::size_t width = 0;
+    for (const std::unique_ptr<Benchmark>& benchmark : BenchmarkRegistry::benchmarks()) {
+        if (matches(benchmark->name(), filters))
+            width = std::max(width, benchmark->name().size());
+    }
+
+    out << std::fixed << std::setprecision(3);
+    for (const std::unique_ptr<Benchmark>& benchmark : BenchmarkRegistry::benchmarks()) {
+        if (!matches(benchmark->name(), filters))
+            continue;
+
+        std::vector<double> samples;
+        samples.reserve(iterations);
+        for (std::size_t i = 0; i < warmup + iterations; ++i) {
+            benchmark->setUp();
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            benchmark->run();
+            const std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+            benchmark->tearDown();
+            if (i >= warmup)
+                samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+
+        results.push_back(BenchmarkResult::compute(benchmark->name(), samples));
+        const BenchmarkResult& result = results.back();
+        out << benchmark->name() << ": " << std::string(width - benchmark->name().size(), ' ')
+            << "median " << result.median / 1e6 << " ms, "
+            << "min " << result.min / 1e6 << " ms, "
+            << "mean " << result.mean / 1e6 << " ms +- " << result.stddev / 1e6 << " ms" << std::endl;
+    }
+    return results;
+}
+
+void BenchmarkRunner::writeJson(std::ostream& out, const std::vector<BenchmarkResult>& results, std::size_t warmup)
+{
+    out << std::fixed << std::setprecision(0);
+    out << "{\"version\":\"" CPPCHECK_VERSION_STRING "\",\"warmup\":" << warmup << ",\"unit\":\"ns\",\"benchmarks\":[";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        out << (i ? ",\n" : "\n")
+            << "{\"name\":" << toJsonString(result.name)
+            << ",\"iterations\":" << result.iterations
+            << ",\"min\":" << result.min
+            << ",\"median\":" << result.median
+            << ",\"mean\":" << result.mean
+            << ",\"max\":" << result.max
+            << ",\"stddev\":" << result.stddev << '}';
+    }
+    out << "\n]}\n";
+}
@@ -0,0 +1,111 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef benchsuiteH
+#define benchsuiteH
+
+#include "errorlogger.h"
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class Project;
+class Settings;
+
+/**
+ * @brief A repeatable measurement. Only run() is timed, setUp() and
+ * tearDown() are called around every iteration to prepare the input and
+ * release the results.
+ */
+class Benchmark {
+public:
+    explicit Benchmark(const std::string& name) : mName(name) {}
+    virtual ~Benchmark() {}
+
+    const std::string& name() const {
+        return mName;
+    }
+
+    virtual void setUp() {}
+    virtual void run() = 0;
+    virtual void tearDown() {}
+
+    /** Settings shared by all benchmarks */
+    static Settings& settings();
+    /** Project shared by all benchmarks, with std.cfg loaded and all severities enabled */
+    static Project& project();
+    /** Discards all messages */
+    static ErrorLogger& errorLogger();
+
+private:
+    const std::string mName;
+};
+
+/** @brief Statistics of the timed iterations of a benchmark, in nanoseconds */
+struct BenchmarkResult {
+    std::string name;
+    std::size_t iterations;
+    double min;
+    double max;
+    double mean;
+    double median;
+    double stddev;
+
+    static BenchmarkResult compute(const std::string& name, std::vector<double> samples);
+};
+
+class BenchmarkRegistry {
+public:
+    static std::vector<std::unique_ptr<Benchmark>>& benchmarks();
+
+    static void add(Benchmark* benchmark) {
+        benchmarks().emplace_back(benchmark);
+    }
+};
+
+template<class T>
+class BenchmarkRegistrar {
+public:
+    BenchmarkRegistrar() {
+        BenchmarkRegistry::add(new T);
+    }
+};
+
+#define REGISTER_BENCHMARK( CLASSNAME ) namespace { BenchmarkRegistrar<CLASSNAME> registrar##CLASSNAME; }
+
+/** @brief Runs the registered benchmarks and reports the statistics */
+class BenchmarkRunner {
+public:
+    BenchmarkRunner() : warmup(2), iterations(10) {}
+
+    /** Load the libraries, false if std.cfg is not found */
+    static bool initialize(const char exename[]);
+
+    /** Run the benchmarks whose name contains one of the filters, all if there are none */
+    std::vector<BenchmarkResult> run(const std::vector<std::string>& filters, std::ostream& out) const;
+
+    static void writeJson(std::ostream& out, const std::vector<BenchmarkResult>& results, std::size_t warmup);
+
+    std::size_t warmup;
+    std::size_t iterations;
+};
+
+#endif // benchsuiteH
@@ -0,0 +1,281 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "analysisserver.h"
+
+#include "config.h"
+#include "cppcheck.h"
+#include "ctu.h"
+#include "filelister.h"
+#include "importproject.h"
+#include "preprocessor.h"
+#include "settings.h"
+#include "utils.h"
+
+#include <simplecpp.h>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+AnalysisServer::AnalysisServer(Settings& settings, Project& project, const ImportProject& importProject)
+    : mSettings(settings), mProject(project), mImportProject(importProject), mOut(nullptr), mRunning(false), mShutdown(false)
+{
+}
+
+int AnalysisServer::run(std::istream& in, std::ostream& out)
+{
+    mOut = &out;
+    mShutdown = false;
+    std::thread workerThread(&AnalysisServer::worker, this);
+
+    int ret = EXIT_SUCCESS;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty())
+            continue;
+
+        const std::string::size_type sep = line.find(' ');
+        const std::string command = line.substr(0, sep);
+        const std::string argument = (sep == std::string::npos) ? emptyString : line.substr(sep + 1);
+
+        if (command == "quit") {
+            std::lock_guard<std::mutex> lock(mQueueSync);
+            mQueue.clear();
+            if (mRunning)
+                mRunningCancellation.cancel();
+            break;
+        }
+
+        if (argument.empty()) {
+            write("{\"event\":\"error\",\"message\":" + toJsonString("Missing argument in request '" + line + "'") + "}");
+            continue;
+        }
+
+        if (command == "check") {
+            enqueue(Request{argument, emptyString, true});
+        } else if (command == "buffer") {
+            // buffer <size> <file>: the file name is last so that it may contain spaces
+            std::istringstream iss(argument);
+            std::size_t size;
+            std::string file;
+            if (!(iss >> size) || !std::getline(iss >> std::ws, file) || file.empty()) {
+                write("{\"event\":\"error\",\"message\":" + toJsonString("Malformed request '" + line + "'") + "}");
+                ret = EXIT_FAILURE;
+                break;
+            }
+            std::string content(size, '\0');
+            if (size > 0 && !in.read(&content[0], size)) {
+                write("{\"event\":\"error\",\"message\":" + toJsonString("Unexpected end of input in buffer for '" + file + "'") + "}");
+                ret = EXIT_FAILURE;
+                break;
+            }
+            enqueue(Request{file, std::move(content), false});
+        } else if (command == "cancel") {
+            cancel(argument);
+        } else {
+            write("{\"event\":\"error\",\"message\":" + toJsonString("Unknown request '" + command + "'") + "}");
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mQueueSync);
+        mShutdown = true;
+    }
+    mQueueCondition.notify_all();
+    workerThread.join();
+
+    mOut = nullptr;
+    return ret;
+}
+
+void AnalysisServer::enqueue(Request&& request)
+{
+    {
+        std::lock_guard<std::mutex> lock(mQueueSync);
+        for (std::list<Request>::iterator it = mQueue.begin(); it != mQueue.end();) {
+            if (it->file == request.file)
+                it = mQueue.erase(it);
+            else
+                ++it;
+        }
+        if (mRunning && mRunningFile == request.file)
+            mRunningCancellation.cancel();
+        mQueue.emplace_back(std::move(request));
+    }
+    mQueueCondition.notify_one();
+}
+
+void AnalysisServer::cancel(const std::string& file)
+{
+    std::lock_guard<std::mutex> lock(mQueueSync);
+    for (std::list<Request>::iterator it = mQueue.begin(); it != mQueue.end();) {
+        if (it->file == file)
+            it = mQueue.erase(it);
+        else
+            ++it;
+    }
+    if (mRunning && mRunningFile == file)
+        mRunningCancellation.cancel();
+}
+
+void AnalysisServer::worker()
+{
+    for (;;) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mQueueSync);
+            mQueueCondition.wait(lock, [this]() {
+                return mShutdown || !mQueue.empty();
+            });
+            if (mQueue.empty())
+                return;
+            request = std::move(mQueue.front());
+            mQueue.pop_front();
+            mRunningFile = request.file;
+            mRunning = true;
+            mRunningCancellation.reset();
+        }
+
+        process(request);
+    }
+}
+
+void AnalysisServer::process(Request& request)
+{
+    const std::string file = toJsonString(request.file);
+    write("{\"event\":\"started\",\"file\":" + file + "}");
+
+    bool readError = false;
+    if (request.fromDisk) {
+        std::ifstream fin(request.file, std::ios::binary);
+        if (fin)
+            request.content.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+        else
+            readError = true;
+    }
+
+    const FileSettings* const fileSettings = mImportProject.getFileSettings(request.file);
+    const std::size_t contentHash = std::hash<std::string>()(request.content);
+    const std::map<std::string, CachedResult>::const_iterator cached = mCache.find(request.file);
+    const bool fromCache = !readError && cached != mCache.cend() &&
+                           cached->second.contentHash == contentHash && includesUnchanged(cached->second.includeChecksums);
+
+    mCurrentErrors.clear();
+    std::map<std::string, std::uint32_t> includeChecksums;
+    if (fromCache) {
+        for (const ErrorMessage& msg : cached->second.errors)
+            reportErr(msg);
+    } else if (!readError) {
+        CTU::CTUInfo ctu(request.file, request.content.size(), emptyString);
+        ctu.fileSettings = fileSettings;
+        CppCheck cppcheck(*this, mSettings, mProject, true);
+        cppcheck.setCancellationToken(&mRunningCancellation);
+        cppcheck.setIncludeChecksums(&includeChecksums);
+        cppcheck.check(&ctu, request.content);
+    }
+
+    bool cancelled;
+    {
+        std::lock_guard<std::mutex> lock(mQueueSync);
+        cancelled = mRunningCancellation.cancelled();
+        mRunning = false;
+        mRunningFile.clear();
+    }
+
+    if (readError) {
+        write("{\"event\":\"error\",\"file\":" + file + ",\"message\":" + toJsonString("Could not open file") + "}");
+    } else if (cancelled) {
+        mCache.erase(request.file);
+    } else if (!fromCache) {
+        CachedResult& result = mCache[request.file];
+        result.contentHash = contentHash;
+        result.includeChecksums.swap(includeChecksums);
+        result.errors.swap(mCurrentErrors);
+    }
+
+    write("{\"event\":\"done\",\"file\":" + file +
+          ",\"cancelled\":" + (cancelled ? "true" : "false") +
+          ",\"cached\":" + (fromCache ? "true" : "false") + "}");
+}
+
+bool AnalysisServer::includesUnchanged(const std::map<std::string, std::uint32_t>& includeChecksums)
+{
+    for (std::map<std::string, std::uint32_t>::const_iterator it = includeChecksums.cbegin(); it != includeChecksums.cend(); ++it) {
+        // Taken before the header is read, a later modification gets a later time stamp
+        const std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
+        const std::chrono::system_clock::time_point lastWriteTime = FileLister::lastWriteTime(it->first);
+        if (lastWriteTime == std::chrono::system_clock::time_point())
+            return false;
+
+        std::uint32_t checksum;
+        const std::map<std::string, HeaderChecksum>::const_iterator header = mHeaders.find(it->first);
+        if (header != mHeaders.cend() && header->second.lastWriteTime == lastWriteTime) {
+            checksum = header->second.checksum;
+        } else {
+            // Only the modified header is tokenized, the files it includes are checked by their own entries
+            std::ifstream fin(it->first);
+            std::vector<std::string> files;
+            const simplecpp::TokenList tokens(fin, files, it->first);
+            checksum = Preprocessor::calculateChecksum(tokens);
+            // A second modification within the resolution of the time stamp would go unnoticed,
+            // so the checksum of a just modified header is not remembered
+            if (now - lastWriteTime > std::chrono::seconds(1))
+                mHeaders[it->first] = HeaderChecksum{lastWriteTime, checksum};
+        }
+        if (checksum != it->second)
+            return false;
+    }
+    return true;
+}
+
+void AnalysisServer::write(const std::string& line)
+{
+    std::lock_guard<std::mutex> lock(mOutputSync);
+    *mOut << line << std::endl;
+}
+
+void AnalysisServer::reportOut(const std::string &outmsg)
+{
+    write("{\"event\":\"log\",\"message\":" + toJsonString(outmsg) + "}");
+}
+
+void AnalysisServer::reportErr(const ErrorMessage &msg)
+{
+    mCurrentErrors.push_back(msg);
+
+    std::ostringstream line;
+    line << "{\"event\":\"finding\",\"file\":" << toJsonString(mRunningFile);
+    if (!msg.callStack.empty()) {
+        const ErrorMessage::FileLocation& loc = msg.callStack.back();
+        line << ",\"location\":" << toJsonString(loc.getFile()) << ",\"line\":" << loc.line << ",\"column\":" << loc.column;
+    }
+    line << ",\"severity\":" << toJsonString(Severity::toString(msg.severity))
+         << ",\"inconclusive\":" << (msg.certainty == Certainty::inconclusive ? "true" : "false")
+         << ",\"id\":" << toJsonString(msg.id)
+         << ",\"message\":" << toJsonString(mSettings.verbose ? msg.verboseMessage() : msg.shortMessage())
+         << '}';
+    write(line.str());
+}
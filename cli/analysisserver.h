@@ -0,0 +1,126 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANALYSISSERVER_H
+#define ANALYSISSERVER_H
+
+#include "errorlogger.h"
+#include "settings.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <list>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+class ImportProject;
+
+/// @addtogroup CLI
+/// @{
+
+/**
+ * @brief Resident analysis mode (--server).
+ *
+ * Requests are read line by line from an input stream, results are written
+ * as one JSON object per line. The Project (and thereby the loaded
+ * libraries) stays alive between requests, so a request only pays for the
+ * analysis of the file itself.
+ *
+ * Requests:
+ *  - check <file>            analyse a file from disk
+ *  - buffer <size> <file>    analyse the following <size> bytes as content of <file>
+ *  - cancel <file>           drop queued requests for <file> and stop a running one
+ *  - quit                    cancel all work and exit
+ *
+ * A new request for a file cancels older, not yet finished requests for
+ * the same file. End of input finishes queued requests and exits. Files
+ * of an imported project (--project) are checked with their build
+ * configuration.
+ */
+class AnalysisServer : public ErrorLogger {
+public:
+    AnalysisServer(Settings& settings, Project& project, const ImportProject& importProject);
+
+    /**
+     * Serve requests until "quit" or end of input.
+     * @return EXIT_SUCCESS, or EXIT_FAILURE on a malformed request stream
+     */
+    int run(std::istream& in, std::ostream& out);
+
+    void reportOut(const std::string &outmsg) override;
+    void reportErr(const ErrorMessage &msg) override;
+
+private:
+    struct Request {
+        std::string file;
+        std::string content;
+        bool fromDisk;
+    };
+
+    /** Results of the last completed analysis of a file */
+    struct CachedResult {
+        std::size_t contentHash;
+        /** Checksums of the tokens of the included files, a changed header invalidates the results */
+        std::map<std::string, std::uint32_t> includeChecksums;
+        std::list<ErrorMessage> errors;
+    };
+
+    /** Checksum of the tokens of a header, valid while the header is not modified */
+    struct HeaderChecksum {
+        std::chrono::system_clock::time_point lastWriteTime;
+        std::uint32_t checksum;
+    };
+
+    void worker();
+    void process(Request& request);
+    bool includesUnchanged(const std::map<std::string, std::uint32_t>& includeChecksums);
+    void enqueue(Request&& request);
+    void cancel(const std::string& file);
+    void write(const std::string& line);
+
+    Settings& mSettings;
+    Project& mProject;
+    const ImportProject& mImportProject;
+    std::ostream* mOut;
+
+    std::mutex mQueueSync;
+    std::condition_variable mQueueCondition;
+    std::list<Request> mQueue;
+    std::string mRunningFile;
+    bool mRunning;
+    /** Cancels the running request only, reset for each request */
+    CancellationToken mRunningCancellation;
+    bool mShutdown;
+
+    std::mutex mOutputSync;
+
+    /** Only accessed by the worker thread */
+    std::map<std::string, CachedResult> mCache;
+    /** Shared by all files that include a header, so it is only read again when it is modified */
+    std::map<std::string, HeaderChecksum> mHeaders;
+    std::list<ErrorMessage> mCurrentErrors;
+};
+
+/// @}
+
+#endif // ANALYSISSERVER_H
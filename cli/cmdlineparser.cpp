@@ -44,6 +44,17 @@
 #include <tinyxml2.h>
 #endif
 
+/** Read a number that must not be negative, "-1" would wrap around */
+template<class T>
+static bool readUnsigned(const char* str, T& value)
+{
+    std::istringstream iss(str);
+    iss >> std::ws;
+    if (iss.peek() == '-')
+        return false;
+    return static_cast<bool>(iss >> value);
+}
+
 static void addFilesToList(const std::string& fileList, std::vector<std::string>& pathNames)
 {
     // To keep things initially simple, if the file can't be opened, just be silent and move on.
@@ -103,6 +114,7 @@ CmdLineParser::CmdLineParser(Settings* settings, Project* project)
     , mShowVersion(false)
     , mShowErrorMessages(false)
     , mExitAfterPrint(false)
+    , mServer(false)
 {
 }
 
@@ -300,9 +312,25 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
             else if (std::strncmp(argv[i], "--addon=", 8) == 0)
                 mProject->addons.emplace_back(argv[i]+8);
 
+            // Maximum number of concurrent addon processes
+            else if (std::strncmp(argv[i], "--addon-jobs=", 13) == 0) {
+                if (!readUnsigned(13+argv[i], mSettings->addonJobs)) {
+                    printMessage("cppcheck: argument to '--addon-jobs=' is not a non-negative number.");
+                    return false;
+                }
+            }
+
             else if (std::strncmp(argv[i],"--addon-python=", 15) == 0)
                 mSettings->addonPython.assign(argv[i]+15);
 
+            // Time limit of an addon
+            else if (std::strncmp(argv[i], "--addon-timeout=", 16) == 0) {
+                if (!readUnsigned(16+argv[i], mSettings->addonTimeout)) {
+                    printMessage("cppcheck: argument to '--addon-timeout=' is not a non-negative number.");
+                    return false;
+                }
+            }
+
             // Check configuration
             else if (std::strcmp(argv[i], "--check-config") == 0)
                 mSettings->checkConfiguration = true;
@@ -364,6 +392,18 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
             else if (std::strcmp(argv[i], "--dump") == 0)
                 mSettings->dump = true;
 
+            else if (std::strncmp(argv[i], "--dump-format=", 14) == 0) {
+                const std::string format(14+argv[i]);
+                if (format == "xml")
+                    mSettings->dumpFormat = Settings::DUMP_XML;
+                else if (format == "binary")
+                    mSettings->dumpFormat = Settings::DUMP_BINARY;
+                else {
+                    printMessage("cppcheck: error: unknown dump format '" + format + "'. Supported formats are 'xml' and 'binary'.");
+                    return false;
+                }
+            }
+
             else if (std::strncmp(argv[i], "--severity=", 11) == 0) {
                 const std::string errmsg = parseEnableList(argv[i] + 11, parseEnableList_setSeverity);
                 if (!errmsg.empty()) {
@@ -621,10 +661,53 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
             else if (std::strncmp(argv[i], "--max-ctu-depth=", 16) == 0)
                 mProject->maxCtuDepth = std::atoi(argv[i] + 16);
 
+            // Time budget per file
+            else if (std::strncmp(argv[i], "--max-file-time=", 16) == 0) {
+                if (!readUnsigned(16+argv[i], mSettings->maxFileTime)) {
+                    printMessage("cppcheck: argument to '--max-file-time=' is not a non-negative number.");
+                    return false;
+                }
+            }
+
+            // Memory budget per file
+            else if (std::strncmp(argv[i], "--max-file-memory=", 18) == 0) {
+                if (!readUnsigned(18+argv[i], mSettings->maxFileMemory)) {
+                    printMessage("cppcheck: argument to '--max-file-memory=' is not a non-negative number.");
+                    return false;
+                }
+            }
+
+            // Format of the results
+            else if (std::strncmp(argv[i], "--output-format=", 16) == 0) {
+                const std::string format(16+argv[i]);
+                if (format == "text")
+                    mSettings->outputFormat = Settings::OUTPUT_TEXT;
+                else if (format == "xml")
+                    mSettings->outputFormat = Settings::OUTPUT_XML;
+                else if (format == "sarif")
+                    mSettings->outputFormat = Settings::OUTPUT_SARIF;
+                else if (format == "json")
+                    mSettings->outputFormat = Settings::OUTPUT_JSON;
+                else {
+                    printMessage("cppcheck: error: unknown output format '" + format + "'. Supported formats are 'text', 'xml', 'sarif' and 'json'.");
+                    return false;
+                }
+                mSettings->xml = (mSettings->outputFormat == Settings::OUTPUT_XML);
+            }
+
             // Write results in file
             else if (std::strncmp(argv[i], "--output-file=", 14) == 0)
                 mProject->outputFile = Path::simplifyPath(Path::fromNativeSeparators(argv[i] + 14));
 
+            // Measurements of each file
+            else if (std::strncmp(argv[i], "--perf-report=", 14) == 0) {
+                mSettings->perfReport = Path::fromNativeSeparators(argv[i] + 14);
+                if (mSettings->perfReport.empty()) {
+                    printMessage("cppcheck: error: no file name given to '--perf-report='.");
+                    return false;
+                }
+            }
+
             // Specify platform
             else if (std::strncmp(argv[i], "--platform=", 11) == 0) {
                 const std::string platform(11+argv[i]);
@@ -652,6 +735,15 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 }
             }
 
+            // Import build configurations from a compilation database
+            else if (std::strncmp(argv[i], "--project=", 10) == 0) {
+                mProjectFile = Path::fromNativeSeparators(argv[i] + 10);
+                if (mProjectFile.empty()) {
+                    printMessage("cppcheck: error: no project file given for '--project='.");
+                    return false;
+                }
+            }
+
             // Output relative paths
             else if (std::strcmp(argv[i], "-rp") == 0 || std::strcmp(argv[i], "--relative-paths") == 0)
                 mSettings->relativePaths = true;
@@ -729,6 +821,11 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
             }
 #endif
 
+            // Resident analysis mode, requests are read from stdin
+            else if (std::strcmp(argv[i], "--server") == 0) {
+                mServer = true;
+            }
+
             // show timing information..
             else if (std::strncmp(argv[i], "--showtime=", 11) == 0) {
                 const std::string showtimeMode = argv[i] + 11;
@@ -849,8 +946,10 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
             }
 
             // Write results in results.xml
-            else if (std::strcmp(argv[i], "--xml") == 0)
+            else if (std::strcmp(argv[i], "--xml") == 0) {
                 mSettings->xml = true;
+                mSettings->outputFormat = Settings::OUTPUT_XML;
+            }
 
             // Define the XML file version (and enable XML output)
             else if (std::strncmp(argv[i], "--xml-version=", 14) == 0) {
@@ -870,6 +969,7 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
 
                 // Enable also XML if version is set
                 mSettings->xml = true;
+                mSettings->outputFormat = Settings::OUTPUT_XML;
             }
 
             else {
@@ -921,8 +1021,19 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
         return true;
     }
 
+    // The resident memory of the process includes the allocations of the other threads
+    if (mSettings->maxFileMemory && mSettings->jobs != 1) {
+        printMessage("cppcheck: error: --max-file-memory can not be used with -j, the memory is measured for the whole process.");
+        return false;
+    }
+
     // Print error only if we have "real" command and expect files
-    if (!mExitAfterPrint && mPathNames.empty()) {
+    if (!mProjectFile.empty() && !mPathNames.empty()) {
+        printMessage("cppcheck: error: --project cannot be used in conjunction with source files.");
+        return false;
+    }
+
+    if (!mExitAfterPrint && !mServer && mPathNames.empty() && mProjectFile.empty()) {
         printMessage("cppcheck: No C or C++ source files found.");
         return false;
     }
@@ -953,11 +1064,19 @@ void CmdLineParser::printHelp()
               "    --addon=<addon>\n"
               "                         Execute addon. i.e. --addon=cert. If options must be\n"
               "                         provided a json configuration is needed.\n"
+              "    --addon-jobs=<n>     Maximum number of addon processes that run at the same\n"
+              "                         time. The addons of a file run in parallel, and the\n"
+              "                         checking goes on with the next files meanwhile. The\n"
+              "                         default is one per hardware thread.\n"
               "    --addon-python=<python interpreter>\n"
               "                         You can specify the python interpreter either in the\n"
               "                         addon json files or through this command line option.\n"
               "                         If not present, Cppcheck will try \"python3\" first and\n"
               "                         then \"python\".\n"
+              "    --addon-timeout=<sec>\n"
+              "                         An addon that runs longer than this on a file is\n"
+              "                         stopped and reported as an internal error. The default\n"
+              "                         is 0, no limit.\n"
               "    --certainty=<id>\n"
               "    -c=<id>              Enables messages of given level of certainty. The\n"
               "                         available ids are:\n"
@@ -994,6 +1113,11 @@ void CmdLineParser::printHelp()
               "    --dump               Dump xml data for each translation unit. The dump\n"
               "                         files have the extension .dump and contain ast,\n"
               "                         tokenlist, symboldatabase, valueflow.\n"
+              "    --dump-format=<format>\n"
+              "                         Format of the dump files, also of the ones written\n"
+              "                         for the addons: 'xml' (default) or 'binary'. The\n"
+              "                         binary format is smaller and faster to write and\n"
+              "                         to load, addons/cppcheckdata.py reads both.\n"
               "    -D<ID>               Define preprocessor symbol. Unless --max-configs or\n"
               "                         --force is used, " PROGRAMNAME " will only check the given\n"
               "                         configuration when -D is used.\n"
@@ -1072,7 +1196,23 @@ void CmdLineParser::printHelp()
               "    --max-ctu-depth=N    Max depth in whole program analysis. The default value\n"
               "                         is 2. A larger value will mean more errors can be found\n"
               "                         but also means the analysis will be slower.\n"
+              "    --max-file-memory=<MB>\n"
+              "                         Memory budget for the analysis of a single file. When\n"
+              "                         more than half of it is used, the analysis is reduced\n"
+              "                         step by step. When it is used up, the analysis of the\n"
+              "                         file is aborted. The memory is measured for the whole\n"
+              "                         process, so this can not be combined with -j. Default\n"
+              "                         is '0' (unlimited).\n"
+              "    --max-file-time=<sec>\n"
+              "                         Time budget for the analysis of a single file. It is\n"
+              "                         applied like --max-file-memory. Default is '0'\n"
+              "                         (unlimited).\n"
               "    --output-file=<file> Write results to file, rather than standard error.\n"
+              "    --output-format=<format>\n"
+              "                         Format of the results: 'text' (default, see\n"
+              "                         --template), 'xml' (same as --xml), 'sarif' (SARIF\n"
+              "                         2.1.0) or 'json' (one JSON object per line). Results\n"
+              "                         are ordered by file, independent of -j.\n"
               "    --max-configs=<limit>\n"
               "                         Maximum number of configurations to check in a file\n"
               "                         before skipping it. Default is '12'. If used together\n"
@@ -1093,6 +1233,12 @@ void CmdLineParser::printHelp()
               "                          * config\n"
               "                                  Check " PROGRAMNAME " configuration.\n"
               "                         Default is: -o=findings,status\n"
+              "    --perf-report=<file>\n"
+              "                         Write the measurements of each checked file to\n"
+              "                         <file>, one JSON object per line: wall and CPU time,\n"
+              "                         memory growth (not with -j), token and configuration\n"
+              "                         counts and the time spent in each phase and check. A\n"
+              "                         line is written as soon as a file is checked.\n"
               "    --platform=<type>, --platform=<file>\n"
               "                         Specifies platform specific types and sizes. The\n"
               "                         available builtin platforms are:\n"
@@ -1113,6 +1259,11 @@ void CmdLineParser::printHelp()
               "                                 further assumptions.\n"
               "                          * unspecified\n"
               "                                 Unknown type sizes\n"
+              "    --project=<file>     Import the build configuration of the source files from\n"
+              "                         a compilation database (compile_commands.json). Each\n"
+              "                         file is checked once, with the defines, include paths\n"
+              "                         and language it is compiled with. The parsed database\n"
+              "                         is cached in the --cppcheck-build-dir.\n"
               "    -rp, --relative-paths\n"
               "    -rp=<paths>, --relative-paths=<paths>\n"
               "                         Use relative paths in output. When given, <paths> are\n"
@@ -1127,6 +1278,12 @@ void CmdLineParser::printHelp()
               "    --rule-file=<file>   Use given rule file. For more information, see:\n"
               "                         http://sourceforge.net/projects/cppcheck/files/Articles/\n"
 #endif
+              "    --server             Keep running and analyse the files requested on stdin.\n"
+              "                         Each line is one request: 'check <file>',\n"
+              "                         'buffer <size> <file>' followed by <size> bytes of\n"
+              "                         file content, 'cancel <file>' or 'quit'. Results are\n"
+              "                         written to stdout as one JSON object per line. A new\n"
+              "                         request for a file cancels the previous one.\n"
               "    --std=<id>           Set standard.\n"
               "                         The available options are:\n"
               "                          * c89\n"
@@ -89,6 +89,20 @@ public:
         return mExitAfterPrint;
     }
 
+    /**
+     * Return the compilation database given with --project=.
+     */
+    const std::string& getProjectFile() const {
+        return mProjectFile;
+    }
+
+    /**
+     * Return if analysis requests are read from stdin (--server).
+     */
+    bool getServerMode() const {
+        return mServer;
+    }
+
     /**
      * Return a list of paths user wants to ignore.
      */
@@ -124,6 +138,8 @@ private:
     bool mShowVersion;
     bool mShowErrorMessages;
     bool mExitAfterPrint;
+    bool mServer;
+    std::string mProjectFile;
     std::string mVSConfig;
 };
 
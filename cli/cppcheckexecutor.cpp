@@ -19,15 +19,20 @@
 
 #include "cppcheckexecutor.h"
 
+#include "analysisserver.h"
 #include "analyzerinfo.h"
 #include "cmdlineparser.h"
 #include "config.h"
 #include "cppcheck.h"
 #include "filelister.h"
+#include "importproject.h"
 #include "library.h"
 #include "path.h"
 #include "pathmatch.h"
+#include "perfreport.h"
 #include "preprocessor.h"
+#include "progress.h"
+#include "reportwriter.h"
 #include "settings.h"
 #include "suppressions.h"
 #include "threadexecutor.h"
@@ -41,8 +46,11 @@
 #include <cstdlib> // EXIT_SUCCESS and EXIT_FAILURE
 #include <cstring>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <list>
+#include <sstream>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -81,12 +89,13 @@
 /*static*/ FILE* CppCheckExecutor::mExceptionOutput = stdout;
 
 CppCheckExecutor::CppCheckExecutor()
-    : mLatestProgressOutputTime(0), mErrorOutput(nullptr), mShowAllErrors(false)
+    : mFoundFiles(0), mFilteredFiles(0), mLatestStageOutput(0), mErrorOutput(nullptr), mShowAllErrors(false), mServerMode(false)
 {
 }
 
 CppCheckExecutor::~CppCheckExecutor()
 {
+    mReportWriter.reset();
     delete mErrorOutput;
 }
 
@@ -151,41 +160,25 @@ bool CppCheckExecutor::parseFromArgs(CppCheck *cppcheck, int argc, const char* c
         std::cout << "cppcheck: Please use --suppress for ignoring results from the header files." << std::endl;
     }
 
-    const std::vector<std::string>& pathnames = parser.getPathNames();
-
-#if defined(_WIN32)
-    // For Windows we want case-insensitive path matching
-    const bool caseSensitive = false;
-#else
-    const bool caseSensitive = true;
-#endif
-    std::map<std::string, std::size_t> files;
-    if (!pathnames.empty()) {
-        // Execute recursiveAddFiles() to each given file parameter
-        const PathMatch matcher(ignored, caseSensitive);
-        for (const std::string &pathname : pathnames)
-            FileLister::recursiveAddFiles(files, Path::toNativeSeparators(pathname), mProject.library.markupExtensions(), matcher);
-    }
-
-    if (files.empty()) {
-        std::cout << "cppcheck: error: could not find or open any of the paths given." << std::endl;
-        if (!ignored.empty())
-            std::cout << "cppcheck: Maybe all paths were ignored?" << std::endl;
-        return false;
-    } else if (!mProject.fileFilter.empty()) {
-        for (std::map<std::string, std::size_t>::const_iterator i = files.begin(); i != files.end();) {
-            if (matchglob(mProject.fileFilter, i->first))
-                i = files.erase(i);
-            else
-                ++i;
-        }
-        if (files.empty()) {
-            std::cout << "cppcheck: error: could not find any files matching the filter." << std::endl;
+    // Import build configurations
+    if (!parser.getProjectFile().empty()) {
+        const std::string errmsg = mImportProject.importCompileCommands(parser.getProjectFile(), mProject.buildDir);
+        if (!errmsg.empty()) {
+            std::cout << "cppcheck: error: " << errmsg << std::endl;
             return false;
         }
+        mImportProject.addProjectSettings(mProject);
     }
 
-    mAnalyzerInformation.createCTUs(mProject.buildDir, files);
+    // Files are given by the requests in server mode
+    if (parser.getServerMode()) {
+        mServerMode = true;
+        return true;
+    }
+
+    // The files are discovered while checking
+    mPathNames = parser.getPathNames();
+    mIgnoredPaths = ignored;
 
     return true;
 }
@@ -349,7 +342,7 @@ static void print_stacktrace(FILE* output, bool demangling, int maxdepth, bool l
 #endif
 }
 
-static const size_t MYSTACKSIZE = 16*1024+SIGSTKSZ; // wild guess about a reasonable buffer
+static const size_t MYSTACKSIZE = 16*1024+32768; // wild guess about a reasonable buffer (SIGSTKSZ is no compile time constant in recent glibc)
 static char mytstack[MYSTACKSIZE]= {0}; // alternative stack for signal handler
 static bool bStackBelowHeap=false; // lame attempt to locate heap vs. stack address space. See CppCheckExecutor::check_wrapper()
 
@@ -893,20 +886,52 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
         }
     }
 
-    if (mSettings.output.isEnabled(Output::progress))
-        mLatestProgressOutputTime = std::time(nullptr);
+    if (mServerMode) {
+        AnalysisServer server(mSettings, mProject, mImportProject);
+        return server.run(std::cin, std::cout);
+    }
 
     if (!mProject.outputFile.empty()) {
         mErrorOutput = new std::ofstream(mProject.outputFile);
     }
 
-    if (mSettings.xml) {
-        reportErr(ErrorMessage::getXMLHeader());
+    std::ofstream perfReportFile;
+    std::unique_ptr<PerformanceReport> perfReport;
+    if (!mSettings.perfReport.empty()) {
+        perfReportFile.open(mSettings.perfReport);
+        if (!perfReportFile.is_open()) {
+            std::cout << "cppcheck: error: could not open the performance report '" << mSettings.perfReport << "' for writing." << std::endl;
+            return EXIT_FAILURE;
+        }
+        perfReport.reset(new PerformanceReport(perfReportFile));
     }
 
+    startReportWriter();
+
     // Check, possibly using multiple processes
     ThreadExecutor executor(mAnalyzerInformation.getCTUs(), mSettings, mProject, *this);
+    executor.setReportWriter(mReportWriter.get());
+    executor.setPerformanceReport(perfReport.get());
+    executor.startDiscovery();
+    std::exception_ptr discoveryError;
+    std::thread discovery(&CppCheckExecutor::discoverFiles, this, std::ref(executor), std::ref(discoveryError));
     unsigned int returnValue = executor.checkSync();
+    discovery.join();
+    if (discoveryError)
+        std::rethrow_exception(discoveryError);
+
+    // No report is written when there was nothing to check
+    if (mFilteredFiles == 0)
+        mReportWriter->discard();
+    if (mFoundFiles == 0) {
+        std::cout << "cppcheck: error: could not find or open any of the paths given." << std::endl;
+        if (!mIgnoredPaths.empty())
+            std::cout << "cppcheck: Maybe all paths were ignored?" << std::endl;
+        return EXIT_FAILURE;
+    } else if (mFilteredFiles == 0) {
+        std::cout << "cppcheck: error: could not find any files matching the filter." << std::endl;
+        return EXIT_FAILURE;
+    }
 
     if (cppcheck.analyseWholeProgram(mAnalyzerInformation))
         returnValue++;
@@ -943,9 +968,8 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
         }
     }
 
-    if (mSettings.xml) {
-        reportErr(ErrorMessage::getXMLFooter());
-    }
+    mReportWriter->finish();
+    mReportWriter.reset();
 
     if (returnValue)
         return mSettings.exitCode;
@@ -976,6 +1000,98 @@ static inline std::string ansiToOEM(const std::string &msg, bool doConvert)
 #define ansiToOEM(msg, doConvert) (msg)
 #endif
 
+#ifdef _WIN32
+/** Text written to the console is converted to the OEM code page */
+class ConsoleTextReportSink : public TextReportSink {
+public:
+    explicit ConsoleTextReportSink(const Settings& settings) : TextReportSink(settings) {}
+
+protected:
+    std::string format(const ErrorMessage& msg) const override {
+        return ansiToOEM(TextReportSink::format(msg), true);
+    }
+};
+#endif
+
+void CppCheckExecutor::startReportWriter()
+{
+    switch (mSettings.outputFormat) {
+    case Settings::OUTPUT_XML:
+        mReportSink.reset(new XmlReportSink);
+        break;
+    case Settings::OUTPUT_SARIF:
+        mReportSink.reset(new SarifReportSink(mSettings));
+        break;
+    case Settings::OUTPUT_JSON:
+        mReportSink.reset(new JsonLinesReportSink(mSettings));
+        break;
+    case Settings::OUTPUT_TEXT:
+#ifdef _WIN32
+        if (!mErrorOutput) {
+            mReportSink.reset(new ConsoleTextReportSink(mSettings));
+            break;
+        }
+#endif
+        mReportSink.reset(new TextReportSink(mSettings));
+        break;
+    }
+
+    if (mErrorOutput)
+        mReportWriter.reset(new ReportWriter(*mReportSink, *mErrorOutput, mSettings.verbose));
+    else
+        mReportWriter.reset(new ReportWriter(*mReportSink, std::cerr, mSettings.verbose));
+}
+
+void CppCheckExecutor::discoverFiles(ThreadExecutor& executor, std::exception_ptr& error)
+{
+#if defined(_WIN32)
+    // For Windows we want case-insensitive path matching
+    const bool caseSensitive = false;
+#else
+    const bool caseSensitive = true;
+#endif
+
+    mFoundFiles = 0;
+    mFilteredFiles = 0;
+    try {
+        const PathMatch matcher(mIgnoredPaths, caseSensitive);
+        // A file can be reached from several of the given paths
+        std::set<std::string> found;
+        std::list<CTU::CTUInfo> ctus;
+        mAnalyzerInformation.beginCTUs(mProject.buildDir);
+        const FileLister::FileCallback addFile = [&](const std::string &file, std::size_t size) {
+            if (Settings::terminated() || !found.insert(file).second)
+                return;
+            ++mFoundFiles;
+            if (!mProject.fileFilter.empty() && matchglob(mProject.fileFilter, file))
+                return;
+            ++mFilteredFiles;
+            mAnalyzerInformation.createCTU(ctus, file, size);
+            if (!mImportProject.fileSettings.empty())
+                ctus.back().fileSettings = mImportProject.getFileSettings(file);
+            executor.addCTUs(ctus);
+        };
+
+        if (!mPathNames.empty()) {
+            // Execute recursiveAddFiles() to each given file parameter
+            for (const std::string &pathname : mPathNames)
+                FileLister::recursiveAddFiles(addFile, Path::toNativeSeparators(pathname), mProject.library.markupExtensions(), matcher);
+        } else {
+            // Check the files of the imported project
+            for (std::map<std::string, FileSettings>::const_iterator it = mImportProject.fileSettings.cbegin(); it != mImportProject.fileSettings.cend(); ++it)
+                FileLister::recursiveAddFiles(addFile, Path::toNativeSeparators(it->first), mProject.library.markupExtensions(), matcher);
+        }
+
+        // Only a complete discovery tells which analyzer files are stale
+        mAnalyzerInformation.endCTUs();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    // Also after an exception, the executor waits for the end of the discovery
+    executor.finishDiscovery();
+}
+
 void CppCheckExecutor::reportErr(const std::string &errmsg)
 {
     // Alert only about unique errors
@@ -995,45 +1111,71 @@ void CppCheckExecutor::reportOut(const std::string &outmsg)
     std::cout << ansiToOEM(outmsg, true) << std::endl;
 }
 
-void CppCheckExecutor::reportProgress(const std::string &filename, const char stage[], const std::size_t value)
+static std::string formatSize(double bytes)
 {
-    (void)filename;
-
-    if (!mLatestProgressOutputTime)
-        return;
-
-    // Report progress messages every 10 seconds
-    const std::time_t currentTime = std::time(nullptr);
-    if (currentTime >= (mLatestProgressOutputTime + 10)) {
-        mLatestProgressOutputTime = currentTime;
-
-        // format a progress message
-        std::ostringstream ostr;
-        ostr << "progress: "
-             << stage
-             << ' ' << value << '%';
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    if (bytes >= 1024 * 1024)
+        oss << bytes / (1024 * 1024) << " MiB";
+    else
+        oss << bytes / 1024 << " KiB";
+    return oss.str();
+}
 
-        // Report progress message
-        reportOut(ostr.str());
-    }
+static std::string formatDuration(double seconds)
+{
+    const long s = static_cast<long>(seconds + 0.5);
+    std::ostringstream oss;
+    if (s >= 3600)
+        oss << s / 3600 << "h " << (s % 3600) / 60 << "m";
+    else if (s >= 60)
+        oss << s / 60 << "m " << s % 60 << "s";
+    else
+        oss << s << "s";
+    return oss.str();
 }
 
-void CppCheckExecutor::reportStatus(std::size_t fileindex, std::size_t filecount, std::size_t sizedone, std::size_t sizetotal)
+void CppCheckExecutor::reportProgressStatus(const ProgressStatus& status)
 {
-    if (filecount > 1) {
-        std::ostringstream oss;
-        const long percentDone = (sizetotal > 0) ? static_cast<long>(static_cast<long double>(sizedone) / sizetotal * 100) : 0;
-        oss << fileindex << '/' << filecount
+    std::ostringstream oss;
+    if (status.totalFiles > 1) {
+        const long percentDone = (status.totalBytes > 0) ? static_cast<long>(static_cast<long double>(status.bytes) / status.totalBytes * 100) : 0;
+        oss << status.files << '/' << status.totalFiles
             << " files checked " << percentDone
             << "% done";
-        std::cout << oss.str() << std::endl;
+        if (!status.done) {
+            oss << ", " << formatSize(status.bytesPerSecond) << "/s, "
+                << std::fixed << std::setprecision(1) << status.filesPerSecond << " files/s";
+            if (status.eta >= 0)
+                oss << ", ETA " << formatDuration(status.eta);
+        }
     }
+
+    // Stages of the files that take long, every 10 seconds
+    if (!status.done && status.elapsed >= mLatestStageOutput + 10) {
+        bool printed = false;
+        for (const ProgressStatus::Active& active : status.active) {
+            if (active.seconds < 10 || !active.stage)
+                continue;
+            if (oss.tellp() > 0)
+                oss << '\n';
+            oss << "progress: " << Path::toNativeSeparators(active.file) << ' ' << active.stage << ' ' << active.value << '%';
+            printed = true;
+        }
+        if (printed)
+            mLatestStageOutput = status.elapsed;
+    }
+
+    if (oss.tellp() > 0)
+        reportOut(oss.str());
 }
 
 void CppCheckExecutor::reportErr(const ErrorMessage &msg)
 {
     if (mShowAllErrors) {
         reportOut(msg.toXML());
+    } else if (mReportWriter) {
+        mReportWriter->report(msg);
     } else if (mSettings.xml) {
         reportErr(msg.toXML());
     } else {
@@ -23,15 +23,22 @@
 #include "errorlogger.h"
 #include "settings.h"
 #include "analyzerinfo.h"
+#include "importproject.h"
 
 #include <cstdio>
 #include <ctime>
+#include <exception>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 class CppCheck;
 class Library;
+class ReportSink;
+class ReportWriter;
+class ThreadExecutor;
 
 /**
  * This class works as an example of how CppCheck can be used in external
@@ -76,17 +83,12 @@ public:
     /** xml output of errors */
     void reportErr(const ErrorMessage &msg) override;
 
-    void reportProgress(const std::string &filename, const char stage[], const std::size_t value) override;
-
     /**
-     * Information about how many files have been checked
-     *
-     * @param fileindex This many files have been checked.
-     * @param filecount This many files there are in total.
-     * @param sizedone The sum of sizes of the files checked.
-     * @param sizetotal The total sizes of the files.
+     * Prints how many files have been checked, the throughput and the
+     * estimated remaining time. The stage of files that take long is
+     * printed every 10 seconds.
      */
-    void reportStatus(std::size_t fileindex, std::size_t filecount, std::size_t sizedone, std::size_t sizetotal) override;
+    void reportProgressStatus(const ProgressStatus& status) override;
 
     /**
      * @param exception_output Output file
@@ -158,6 +160,18 @@ private:
     */
     int check_internal(CppCheck& cppcheck, int argc, const char* const argv[]);
 
+    /**
+     * Start writing results in the format given by --output-format
+     */
+    void startReportWriter();
+
+    /**
+     * Find the files to check and pass them to the executor, which checks
+     * them while the rest is being discovered. Runs in its own thread, an
+     * exception is passed back in 'error'.
+     */
+    void discoverFiles(ThreadExecutor& executor, std::exception_ptr& error);
+
     /**
      * Settings of this instance
      */
@@ -179,9 +193,26 @@ private:
     AnalyzerInformation mAnalyzerInformation;
 
     /**
-     * Report progress time
+     * Paths given on the command line and paths ignored with -i
+     */
+    std::vector<std::string> mPathNames;
+    std::vector<std::string> mIgnoredPaths;
+
+    /**
+     * Number of files found, and of those not excluded by --file-filter
      */
-    std::time_t mLatestProgressOutputTime;
+    std::size_t mFoundFiles;
+    std::size_t mFilteredFiles;
+
+    /**
+     * Build configurations imported with --project
+     */
+    ImportProject mImportProject;
+
+    /**
+     * When the stages of the files being checked were printed, in seconds since the start
+     */
+    double mLatestStageOutput;
 
     /**
      * Output file name for exception handler
@@ -193,10 +224,21 @@ private:
      */
     std::ofstream *mErrorOutput;
 
+    /**
+     * Formats and writes results while files are checked
+     */
+    std::unique_ptr<ReportSink> mReportSink;
+    std::unique_ptr<ReportWriter> mReportWriter;
+
     /**
      * Has --errorlist been given?
      */
     bool mShowAllErrors;
+
+    /**
+     * Has --server been given?
+     */
+    bool mServerMode;
 };
 
 #endif // CPPCHECKEXECUTOR_H
@@ -21,17 +21,64 @@
 #include "../lib/cppcheck.h"
 #include "../lib/analyzerinfo.h"
 #include "../lib/threadexecutor.h"
+#include "../lib/filelister.h"
 #include "../lib/path.h"
+#include "../lib/pathmatch.h"
 #include "../lib/version.h"
 
+#include <chrono>
+#include <list>
+#include <thread>
+#include <vector>
+
+
+/** A running check. Owns everything the checking threads use. */
+struct CheckExecutor::Job {
+    explicit Job(const Project& project_)
+        : id(++count), project(project_), executor(analyzerInformation.getCTUs(), settings, project, *errorlogger) {
+        settings.output.enable(Output::progress);
+        executor.setProgressInterval(std::chrono::milliseconds(100));
+        executor.setCancellationToken(&cancellation);
+    }
+    ~Job() {
+        if (discovery.joinable())
+            discovery.join();
+        if (checking.joinable())
+            checking.join();
+    }
+
+    static std::size_t count;
+
+    const std::size_t id;
+    CancellationToken cancellation;
+    Project project;
+    AnalyzerInformation analyzerInformation;
+    ThreadExecutor executor;
+    std::thread discovery;
+    std::thread checking;
+};
+
+std::size_t CheckExecutor::Job::count = 0;
+
+/** Build dir of the checked buffers, created on first use */
+static wxString bufferBuildDir;
+
+static const wxString& getBufferBuildDir()
+{
+    if (bufferBuildDir.empty()) {
+        bufferBuildDir = wxFileName(wxStandardPaths::Get().GetTempDir(), wxString::Format("lcppc-buffers-%lu", wxGetProcessId())).GetFullPath();
+        if (!wxFileName::Mkdir(bufferBuildDir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL))
+            bufferBuildDir.clear();
+    }
+    return bufferBuildDir;
+}
 
 ErrorLogger* CheckExecutor::errorlogger = nullptr;
+std::unique_ptr<CheckExecutor::Job> CheckExecutor::job;
 Settings CheckExecutor::settings;
-static size_t libcount = 0;
 
 bool tryLoadLibrary(Library& destination, const char* basepath, const char* filename)
 {
-    libcount++;
     const Library::Error err = destination.load(basepath, filename);
 
     if (err.errorcode != Library::OK) {
@@ -43,7 +90,6 @@ bool tryLoadLibrary(Library& destination, const char* basepath, const char* file
 
 void CheckExecutor::init(Project& project)
 {
-    libcount = 0;
     wxString exepath = wxStandardPaths::Get().GetExecutablePath();
 
     // Load libraries
@@ -77,34 +123,92 @@ void CheckExecutor::init(Project& project)
     }
 }
 
-void CheckExecutor::check(Project& project, const wxString& directory)
+void CheckExecutor::start(std::function<void()> onFinished)
 {
-    AnalyzerInformation analyzerInformation;
-
-    CppCheck cppcheck(*errorlogger, settings, project, false);
-
-    ThreadExecutor executor(analyzerInformation.getCTUs(), settings, project, *errorlogger);
-    executor.checkSync();
+    const std::size_t id = job->id;
+    Job* const running = job.get();
+    running->checking = running->executor.checkAsync([id, running, onFinished](unsigned int) {
+        // The whole program analysis must not block the GUI either
+        if (!running->cancellation.cancelled()) {
+            CppCheck cppcheck(*errorlogger, settings, running->project, false);
+            cppcheck.setCancellationToken(&running->cancellation);
+            cppcheck.analyseWholeProgram(running->analyzerInformation);
+        }
 
-    cppcheck.analyseWholeProgram(analyzerInformation);
+        wxTheApp->CallAfter([id, onFinished]() {
+            // The job is gone if wait() was called in the meantime
+            if (!job || job->id != id)
+                return;
+            job.reset();
+            onFinished();
+        });
+    });
 }
-void CheckExecutor::check(Project& project, const wxString& filename, const wxString& code)
+
+void CheckExecutor::wait()
 {
-    std::size_t status_init = libcount * 1024; // Assume initialization is equivalent to a 1024 bytes file per library loaded
-    std::size_t status_wpa = (std::size_t)(code.size() * 0.02); // Assume whole program analysis is 2% of runtime
+    job.reset();
+}
 
-    AnalyzerInformation analyzerInformation;
-    CTU::CTUInfo& ctu = analyzerInformation.addCTU(filename.ToStdString(), code.size(), emptyString);
+void CheckExecutor::cancel()
+{
+    if (!job)
+        return;
+    job->cancellation.cancel();
+    job.reset();
+}
 
-    CppCheck cppcheck(*errorlogger, settings, project, false);
+void CheckExecutor::cleanup()
+{
+    cancel();
+    if (!bufferBuildDir.empty())
+        wxFileName::Rmdir(bufferBuildDir, wxPATH_RMDIR_RECURSIVE);
+}
 
-    errorlogger->reportStatus(1, 1, status_init, status_init + status_wpa + code.size());
+void CheckExecutor::check(const Project& project, const wxString& directory, std::function<void()> onFinished)
+{
+    wait();
+    job.reset(new Job(project));
+
+    // Files are checked while the directory is searched
+    Job* const running = job.get();
+    running->executor.startDiscovery();
+    running->discovery = std::thread([running](const std::string& path) {
+        const CancellationToken::Scope cancellation(&running->cancellation);
+#if defined(_WIN32)
+        const bool caseSensitive = false;
+#else
+        const bool caseSensitive = true;
+#endif
+        const PathMatch matcher(std::vector<std::string>(), caseSensitive);
+        std::list<CTU::CTUInfo> ctus;
+        running->analyzerInformation.beginCTUs(running->project.buildDir);
+        const FileLister::FileCallback addFile = [&](const std::string& file, std::size_t size) {
+            if (Settings::terminated())
+                return;
+            running->analyzerInformation.createCTU(ctus, file, size);
+            running->executor.addCTUs(ctus);
+        };
+        FileLister::recursiveAddFiles(addFile, Path::toNativeSeparators(path), running->project.library.markupExtensions(), matcher);
+        running->analyzerInformation.endCTUs();
+        running->executor.finishDiscovery();
+    }, directory.ToStdString());
+
+    start(onFinished);
+}
 
-    cppcheck.check(&ctu, code.ToStdString());
+void CheckExecutor::check(const Project& project, const wxString& filename, const wxString& code, std::function<void()> onFinished)
+{
+    wait();
+    job.reset(new Job(project));
 
-    errorlogger->reportStatus(1, 1, status_init + code.size(), status_init + status_wpa + code.size());
+    job->project.buildDir = getBufferBuildDir().ToStdString();
 
-    cppcheck.analyseWholeProgram(analyzerInformation);
+    const std::string content = code.ToStdString();
+    job->analyzerInformation.beginCTUs(job->project.buildDir);
+    job->analyzerInformation.createCTU(job->analyzerInformation.getCTUs(), filename.ToStdString(), content.size());
+    job->analyzerInformation.endCTUs();
+    job->executor.addFileContent(filename.ToStdString(), content);
 
-    errorlogger->reportStatus(1, 1, status_init + status_wpa + code.size(), status_init + status_wpa + code.size());
+    start(onFinished);
 }
@@ -20,12 +20,24 @@
 #include "precompiled.h"
 #include "../lib/settings.h"
 
+#include <functional>
+#include <memory>
+
 class ErrorLogger;
 
 
+/**
+ * Runs the checks in background threads. Only one check runs at a time,
+ * the results are reported to the ErrorLogger from the checking threads.
+ */
 class CheckExecutor {
     static ErrorLogger* errorlogger;
 
+    struct Job;
+    static std::unique_ptr<Job> job;
+
+    static void start(std::function<void()> onFinished);
+
 public:
     static Settings settings;
 
@@ -33,6 +45,23 @@ public:
         errorlogger = errorLogger;
     }
     static void init(Project& project);
-    static void check(Project& project, const wxString& directory);
-    static void check(Project& project, const wxString& filename, const wxString& code);
+
+    /** Start checking the files in given directory, onFinished is called in the GUI thread when done */
+    static void check(const Project& project, const wxString& directory, std::function<void()> onFinished);
+    /**
+     * Start checking given code, onFinished is called in the GUI thread when
+     * done. The results are kept in a temporary build dir, so a buffer whose
+     * tokens did not change since the last check is not analysed again.
+     */
+    static void check(const Project& project, const wxString& filename, const wxString& code, std::function<void()> onFinished);
+
+    static bool isRunning() {
+        return job != nullptr;
+    }
+    /** Block until a running check is finished, onFinished is not called */
+    static void wait();
+    /** Abort a running check, onFinished is not called */
+    static void cancel();
+    /** Cancel checking and remove the temporary files */
+    static void cleanup();
 };
@@ -66,7 +66,8 @@ wxBEGIN_EVENT_TABLE(MainWindow, wxFrame)
     EVT_MENU(ID_LCPPC_SETTINGS, MainWindow::OnLCppCSettings)
     EVT_MENU(wxID_EXIT, MainWindow::OnExit)
     EVT_MENU(wxID_ABOUT, MainWindow::OnAbout)
-    EVT_TREELIST_SELECTION_CHANGED(ID_RESULTSTREE, MainWindow::OnResultSelect)
+    EVT_CLOSE(MainWindow::OnClose)
+    EVT_DATAVIEW_SELECTION_CHANGED(ID_RESULTSTREE, MainWindow::OnResultSelect)
 wxEND_EVENT_TABLE()
 
 MainWindow::MainWindow(const wxPoint& pos, const wxSize& size)
@@ -135,7 +136,7 @@ MainWindow::MainWindow(const wxPoint& pos, const wxSize& size)
     codeView->SetEditable(false);
 
     wxBoxSizer* sizer2 = new wxBoxSizer(wxVERTICAL);
-    sizer2->Add(errorlogger->getResultsTree(), 4, wxALL | wxEXPAND, 0);
+    sizer2->Add(errorlogger->getResultsView(), 4, wxALL | wxEXPAND, 0);
     sizer2->Add(new wxStaticLine(panel, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLI_VERTICAL), 0, wxDOWN | wxEXPAND, 1);
     sizer2->Add(verboseMessage, 1, wxRIGHT | wxLEFT | wxEXPAND, 3);
     sizer2->Add(new wxStaticLine(panel, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLI_VERTICAL), 0, wxUP | wxDOWN | wxEXPAND, 1);
@@ -158,6 +159,12 @@ void MainWindow::OnExit(wxCommandEvent&)
 {
     Close(true);
 }
+void MainWindow::OnClose(wxCloseEvent& event)
+{
+    // The checking threads report to the results list
+    CheckExecutor::cleanup();
+    event.Skip();
+}
 void MainWindow::OnLCppCSettings(wxCommandEvent&)
 {
     SettingsWindow dialog(this, CheckExecutor::settings);
@@ -183,12 +190,12 @@ void MainWindow::OnScratchpad(wxCommandEvent&)
 void MainWindow::OnCheckDirectory(wxCommandEvent&)
 {
     wxDirDialog dlg(this, _("Choose directory"), wxEmptyString, wxDD_DEFAULT_STYLE | wxDD_DIR_MUST_EXIST);
-    if (dlg.ShowModal() == wxID_OK) {
-    }
+    if (dlg.ShowModal() == wxID_OK)
+        CheckDirectory(dlg.GetPath());
 }
-void MainWindow::OnResultSelect(wxTreeListEvent& event)
+void MainWindow::OnResultSelect(wxDataViewEvent& event)
 {
-    const UIErrorMessage* msg = dynamic_cast<const UIErrorMessage*>(errorlogger->getResultsTree()->GetItemData(event.GetItem()));
+    const ErrorMessage* msg = errorlogger->getMessage(event.GetItem());
     if (msg) {
         verboseMessage->SetValue(msg->verboseMessage());
         if (msg->callStack.empty())
@@ -205,18 +212,40 @@ void MainWindow::EnableChecking()
     reCheckItem->Enable();
 }
 
-void MainWindow::CheckScratchpad()
+void MainWindow::StartChecking()
 {
     verboseMessage->SetValue("");
     errorlogger->clear();
+    errorlogger->startDelivery();
+    checkItem->Enable(false);
+    reCheckItem->Enable(false);
+    SetStatusText(_("Checking..."));
+}
+
+void MainWindow::OnCheckFinished()
+{
+    errorlogger->stopDelivery();
+    if (scratchpad)
+        EnableChecking();
+    SetStatusText(_("Checking finished."));
+}
 
+void MainWindow::CheckScratchpad()
+{
     if (!scratchpad)
         return;
 
+    // The results of the running check are outdated
+    CheckExecutor::cancel();
+
+    StartChecking();
+
     Project project;
     scratchpad->fillProject(project);
     CheckExecutor::init(project);
-    CheckExecutor::check(project, project.enforcedLang == Project::CPP ? "scratch.cpp" : "scratch.c", scratchpad->getText());
+    CheckExecutor::check(project, project.enforcedLang == Project::CPP ? "scratch.cpp" : "scratch.c", scratchpad->getText(), [this]() {
+        OnCheckFinished();
+    });
 
     codeView->SetEditable(true);
     codeView->SetText(scratchpad->getText());
@@ -226,3 +255,17 @@ void MainWindow::CheckScratchpad()
 void MainWindow::CheckProject()
 {
 }
+
+void MainWindow::CheckDirectory(const wxString& directory)
+{
+    if (CheckExecutor::isRunning())
+        return;
+
+    StartChecking();
+
+    Project project;
+    CheckExecutor::init(project);
+    CheckExecutor::check(project, directory, [this]() {
+        OnCheckFinished();
+    });
+}
@@ -39,15 +39,20 @@ public:
 
     void CheckScratchpad();
     void CheckProject();
+    void CheckDirectory(const wxString& directory);
 
 private:
+    void StartChecking();
+    void OnCheckFinished();
+
     void OnScratchpad(wxCommandEvent& event);
     void OnCheckDirectory(wxCommandEvent& event);
     void OnCheck(wxCommandEvent& event);
     void OnReCheck(wxCommandEvent& event);
     void OnLCppCSettings(wxCommandEvent& event);
     void OnExit(wxCommandEvent& event);
+    void OnClose(wxCloseEvent& event);
     void OnAbout(wxCommandEvent& event);
-    void OnResultSelect(wxTreeListEvent& event);
+    void OnResultSelect(wxDataViewEvent& event);
     wxDECLARE_EVENT_TABLE();
 };
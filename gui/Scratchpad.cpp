@@ -22,11 +22,15 @@
 #include "../lib/settings.h"
 
 enum {
-    ID_CHECK = 50
+    ID_CHECK = 50, ID_RECHECK_TIMER
 };
 
+// Time without typing before the code is checked again, in milliseconds
+static const int recheckDelay = 500;
+
 wxBEGIN_EVENT_TABLE(Scratchpad, wxFrame)
     EVT_BUTTON(ID_CHECK, Scratchpad::OnCheck)
+    EVT_TIMER(ID_RECHECK_TIMER, Scratchpad::OnRecheckTimer)
 wxEND_EVENT_TABLE()
 
 static const char* stdStrings[] = { "C++20", "C++17", "C++14", "C++11", "C++03", "C11", "C99", "C89" };
@@ -39,6 +43,7 @@ static const cppcheck::Platform::PlatformType platforms[] = {
 Scratchpad::Scratchpad(MainWindow& parent_, const wxPoint& pos, const wxSize& size)
     : wxFrame(&parent_, wxID_ANY, _("Scratchpad"), pos, size)
     , parent(parent_)
+    , recheckTimer(this, ID_RECHECK_TIMER)
 {
     SetMinSize(wxSize(400, 400));
     wxPanel* panel = new wxPanel(this);
@@ -48,6 +53,7 @@ Scratchpad::Scratchpad(MainWindow& parent_, const wxPoint& pos, const wxSize& si
         "int main() {\n"
         "\treturn 0;\n"
         "}");
+    code->Bind(wxEVT_STC_CHANGE, &Scratchpad::OnCodeChanged, this);
 
     severities[0] = new wxCheckBox(panel, wxID_ANY, _("Error"));
     severities[1] = new wxCheckBox(panel, wxID_ANY, _("Warning"));
@@ -79,6 +85,9 @@ Scratchpad::Scratchpad(MainWindow& parent_, const wxPoint& pos, const wxSize& si
 #endif
     platform = new wxComboBox(panel, wxID_ANY, defaultplatform, wxDefaultPosition, wxDefaultSize, wxArrayString(sizeof(platformStrings) / sizeof(*platformStrings), platformStrings));
 
+    checkWhileTyping = new wxCheckBox(panel, wxID_ANY, _("Check while typing"));
+    checkWhileTyping->Set3StateValue(wxCHK_CHECKED);
+
     wxBoxSizer* sizer2 = new wxBoxSizer(wxVERTICAL);
     sizer2->Add(code, 1, wxALL | wxEXPAND, 0);
     wxBoxSizer* sizer3 = new wxBoxSizer(wxVERTICAL);
@@ -105,6 +114,7 @@ Scratchpad::Scratchpad(MainWindow& parent_, const wxPoint& pos, const wxSize& si
     sizer3->Add(new wxStaticText(panel, wxID_ANY, _("Platform:")), 0, wxALL | wxEXPAND, 1);
     sizer3->Add(platform, 0, wxLEFT | wxRIGHT | wxEXPAND, 1);
     sizer3->AddStretchSpacer();
+    sizer3->Add(checkWhileTyping, 0, wxLEFT | wxRIGHT | wxEXPAND, 1);
     sizer3->Add(new wxButton(panel, ID_CHECK, _("Check")), 0, wxALL | wxEXPAND, 0);
 
     wxBoxSizer* sizer1 = new wxBoxSizer(wxHORIZONTAL);
@@ -121,6 +131,20 @@ Scratchpad::Scratchpad(MainWindow& parent_, const wxPoint& pos, const wxSize& si
 }
 
 void Scratchpad::OnCheck(wxCommandEvent&)
+{
+    recheckTimer.Stop();
+    parent.CheckScratchpad();
+}
+
+void Scratchpad::OnCodeChanged(wxStyledTextEvent& event)
+{
+    // Restarting the timer checks once the user pauses typing
+    if (checkWhileTyping->IsChecked())
+        recheckTimer.StartOnce(recheckDelay);
+    event.Skip();
+}
+
+void Scratchpad::OnRecheckTimer(wxTimerEvent&)
 {
     parent.CheckScratchpad();
 }
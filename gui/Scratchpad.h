@@ -39,8 +39,12 @@ private:
     wxTextCtrl* undefines;
     wxComboBox* language;
     wxComboBox* platform;
+    wxCheckBox* checkWhileTyping;
+    wxTimer recheckTimer;
 
     void OnCheck(wxCommandEvent& event);
+    void OnCodeChanged(wxStyledTextEvent& event);
+    void OnRecheckTimer(wxTimerEvent& event);
 
     wxDECLARE_EVENT_TABLE();
 };
@@ -18,20 +18,119 @@
 
 #include "UIErrorLogger.h"
 
+#include <algorithm>
+#include <utility>
+
+
+// Batches are delivered to the results list at most this often
+static const int flushInterval = 200;
+
+void ResultsModel::GetValueByRow(wxVariant& variant, unsigned int row, unsigned int col) const
+{
+    if (row >= results.size()) {
+        variant = wxString();
+        return;
+    }
+    const ErrorMessage& msg = results[row];
+    switch (col) {
+    case ColFile:
+        variant = msg.callStack.empty() ? wxString("-") : wxString(msg.callStack.back().getFile());
+        break;
+    case ColLine:
+        variant = msg.callStack.empty() ? wxString() : wxString(std::to_string(msg.callStack.back().line));
+        break;
+    case ColSeverity:
+        variant = wxString(Severity::toString(msg.severity));
+        break;
+    case ColCertainty:
+        variant = wxString(Certainty::toString(msg.certainty));
+        break;
+    case ColMessage:
+        variant = wxString(msg.shortMessage());
+        break;
+    }
+}
+
+const ErrorMessage* ResultsModel::getMessage(const wxDataViewItem& item) const
+{
+    if (!item.IsOk())
+        return nullptr;
+    const unsigned int row = GetRow(item);
+    return row < results.size() ? &results[row] : nullptr;
+}
+
+void ResultsModel::append(std::vector<ErrorMessage>& messages)
+{
+    // Only the new rows are announced, the control keeps the existing rows and the selection
+    for (ErrorMessage& msg : messages) {
+        results.push_back(std::move(msg));
+        RowAppended();
+    }
+}
+
+void ResultsModel::clear()
+{
+    results.clear();
+    Reset(0);
+}
+
 
 UIErrorLogger::UIErrorLogger(wxWindow* parent, wxWindowID id, wxGauge* progress_)
-    : control(new wxTreeListCtrl(parent, id)), progress(progress_)
+    : control(new wxDataViewCtrl(parent, id, wxDefaultPosition, wxDefaultSize, wxDV_SINGLE | wxDV_ROW_LINES))
+    , model(new ResultsModel)
+    , progress(progress_)
+    , timer(*this)
+    , sizeDone(0)
+    , sizeTotal(0)
 {
-    control->AppendColumn(_("File"), wxCOL_WIDTH_AUTOSIZE, wxALIGN_LEFT, wxCOL_RESIZABLE | wxCOL_SORTABLE);
-    control->AppendColumn(_("Line"), wxCOL_WIDTH_AUTOSIZE, wxALIGN_LEFT, wxCOL_RESIZABLE);
-    control->AppendColumn(_("Severity"), wxCOL_WIDTH_AUTOSIZE, wxALIGN_LEFT, wxCOL_RESIZABLE | wxCOL_SORTABLE);
-    control->AppendColumn(_("Certainty"), wxCOL_WIDTH_AUTOSIZE, wxALIGN_LEFT, wxCOL_RESIZABLE | wxCOL_SORTABLE);
-    control->AppendColumn(_("Short Message"), wxCOL_WIDTH_AUTOSIZE, wxALIGN_LEFT, wxCOL_RESIZABLE | wxCOL_SORTABLE);
+    control->AssociateModel(model.get());
+    // Fixed widths, autosizing would measure every row
+    control->AppendTextColumn(_("File"), ResultsModel::ColFile, wxDATAVIEW_CELL_INERT, 250, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    control->AppendTextColumn(_("Line"), ResultsModel::ColLine, wxDATAVIEW_CELL_INERT, 60, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    control->AppendTextColumn(_("Severity"), ResultsModel::ColSeverity, wxDATAVIEW_CELL_INERT, 90, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    control->AppendTextColumn(_("Certainty"), ResultsModel::ColCertainty, wxDATAVIEW_CELL_INERT, 90, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    control->AppendTextColumn(_("Short Message"), ResultsModel::ColMessage, wxDATAVIEW_CELL_INERT, 400, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
 }
 
 void UIErrorLogger::clear()
 {
-    control->DeleteAllItems();
+    {
+        std::lock_guard<std::mutex> lock(pendingSync);
+        pending.clear();
+    }
+    model->clear();
+    sizeDone = 0;
+    sizeTotal = 0;
+    progress->SetValue(0);
+}
+
+void UIErrorLogger::startDelivery()
+{
+    timer.Start(flushInterval);
+}
+
+void UIErrorLogger::stopDelivery()
+{
+    timer.Stop();
+    flush();
+}
+
+void UIErrorLogger::flush()
+{
+    std::vector<ErrorMessage> batch;
+    {
+        std::lock_guard<std::mutex> lock(pendingSync);
+        batch.swap(pending);
+    }
+    if (!batch.empty())
+        model->append(batch);
+
+    // Bytes can exceed the range of the gauge, show per mille
+    const std::size_t total = sizeTotal;
+    if (total > 0) {
+        progress->SetRange(1000);
+        progress->SetValue(static_cast<int>(std::min<std::size_t>(sizeDone, total) * 1000 / total));
+    }
 }
 
 void UIErrorLogger::reportOut(const std::string& outmsg)
@@ -40,20 +139,12 @@ void UIErrorLogger::reportOut(const std::string& outmsg)
 
 void UIErrorLogger::reportErr(const ErrorMessage& msg)
 {
-    wxTreeListItem item;
-    if (!msg.callStack.empty()) {
-        item = control->AppendItem(control->GetRootItem(), msg.callStack.back().getFile());
-        control->SetItemText(item, 1, std::to_string(msg.callStack.back().line));
-    } else
-        item = control->AppendItem(control->GetRootItem(), "-");
-    control->SetItemText(item, 2, Severity::toString(msg.severity));
-    control->SetItemText(item, 3, Certainty::toString(msg.certainty));
-    control->SetItemText(item, 4, msg.shortMessage());
-    control->SetItemData(item, new UIErrorMessage(msg));
+    std::lock_guard<std::mutex> lock(pendingSync);
+    pending.push_back(msg);
 }
 
 void UIErrorLogger::reportStatus(std::size_t fileindex, std::size_t filecount, std::size_t sizedone, std::size_t sizetotal)
 {
-    progress->SetRange(sizetotal);
-    progress->SetValue(sizedone);
+    sizeDone = sizedone;
+    sizeTotal = sizetotal;
 }
@@ -20,24 +20,73 @@
 #include "precompiled.h"
 #include "../lib/errorlogger.h"
 
-class UIErrorMessage : public wxTreeItemData, public ErrorMessage {
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+/** Findings shown in the results list. Rows are created on demand, only the visible ones are rendered. */
+class ResultsModel : public wxDataViewVirtualListModel {
+    std::vector<ErrorMessage> results;
 public:
-    UIErrorMessage() = default;
-    UIErrorMessage(const UIErrorMessage&) = default;
-    UIErrorMessage(const ErrorMessage& msg) : ErrorMessage(msg) {};
+    enum Column { ColFile, ColLine, ColSeverity, ColCertainty, ColMessage, ColumnCount };
+
+    unsigned int GetColumnCount() const final {
+        return ColumnCount;
+    }
+    wxString GetColumnType(unsigned int) const final {
+        return "string";
+    }
+    void GetValueByRow(wxVariant& variant, unsigned int row, unsigned int col) const final;
+    bool SetValueByRow(const wxVariant&, unsigned int, unsigned int) final {
+        return false;
+    }
+
+    const ErrorMessage* getMessage(const wxDataViewItem& item) const;
+    void append(std::vector<ErrorMessage>& messages);
+    void clear();
 };
 
+/**
+ * Collects the results of the checking threads. They are queued and
+ * moved to the results list in batches by a timer in the GUI thread.
+ */
 class UIErrorLogger : public ErrorLogger {
-    wxTreeListCtrl* control;
+    class FlushTimer : public wxTimer {
+        UIErrorLogger& logger;
+    public:
+        explicit FlushTimer(UIErrorLogger& logger_) : logger(logger_) {}
+        void Notify() final {
+            logger.flush();
+        }
+    };
+
+    wxDataViewCtrl* control;
+    wxObjectDataPtr<ResultsModel> model;
     wxSharedPtr<wxGauge> progress;
+    FlushTimer timer;
+
+    std::mutex pendingSync;
+    std::vector<ErrorMessage> pending;
+    std::atomic<std::size_t> sizeDone;
+    std::atomic<std::size_t> sizeTotal;
+
+    void flush();
 public:
     UIErrorLogger(wxWindow* parent, wxWindowID id, wxGauge* progress_);
 
-    wxTreeListCtrl* getResultsTree() {
+    wxDataViewCtrl* getResultsView() {
         return control;
     }
+    const ErrorMessage* getMessage(const wxDataViewItem& item) const {
+        return model->getMessage(item);
+    }
     void clear();
 
+    /** Show the results periodically while checking */
+    void startDelivery();
+    /** Show the remaining results, call when checking is finished */
+    void stopDelivery();
+
     void reportOut(const std::string& outmsg) final;
     void reportErr(const ErrorMessage& msg) final;
     void reportStatus(std::size_t fileindex, std::size_t filecount, std::size_t sizedone, std::size_t sizetotal) final;
@@ -23,13 +23,14 @@
 #ifndef WX_PRECOMP
 #include <wx/wx.h>
 #endif
-#include <wx/treelist.h>
 #include <wx/treectrl.h>
+#include <wx/dataview.h>
 #include <wx/statline.h>
 #include <wx/stc/stc.h>
 #include <wx/cmdline.h>
 #include <wx/config.h>
 #include <wx/stdpaths.h>
+#include <wx/filename.h>
 #include <wx/aboutdlg.h>
 #include <wx/propdlg.h>
 #include <wx/bookctrl.h>
@@ -0,0 +1,350 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "addonexecutor.h"
+
+#include "mathlib.h"
+#include "settings.h"
+
+#define PICOJSON_USE_INT64
+#include <picojson.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <memory>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#endif
+
+
+void AddonOutputReader::feed(const char* data, std::size_t size)
+{
+    const char* const end = data + size;
+    while (data < end) {
+        const char* const newline = std::find(data, end, '\n');
+        mPending.append(data, newline);
+        if (newline == end)
+            break;
+        line(mPending);
+        mPending.clear();
+        data = newline + 1;
+    }
+}
+
+void AddonOutputReader::finish()
+{
+    if (!mPending.empty())
+        line(mPending);
+    mPending.clear();
+}
+
+/** Message of an addon result, false if it is not a valid result */
+static bool parseResult(const std::string& text, ErrorMessage& errmsg)
+{
+    picojson::value res;
+    const std::string err = picojson::parse(res, text);
+    if (!err.empty() || !res.is<picojson::object>())
+        return false;
+    const picojson::object& obj = res.get<picojson::object>();
+
+    const picojson::object::const_iterator fileName = obj.find("file");
+    const picojson::object::const_iterator lineNumber = obj.find("linenr");
+    const picojson::object::const_iterator column = obj.find("column");
+    const picojson::object::const_iterator addon = obj.find("addon");
+    const picojson::object::const_iterator errorId = obj.find("errorId");
+    const picojson::object::const_iterator message = obj.find("message");
+    const picojson::object::const_iterator severity = obj.find("severity");
+    for (const picojson::object::const_iterator& it : { fileName, addon, errorId, message, severity }) {
+        if (it == obj.cend() || !it->second.is<std::string>())
+            return false;
+    }
+    for (const picojson::object::const_iterator& it : { lineNumber, column }) {
+        if (it == obj.cend() || !it->second.is<int64_t>())
+            return false;
+    }
+
+    errmsg.callStack.emplace_back(ErrorMessage::FileLocation(fileName->second.get<std::string>(),
+                                  lineNumber->second.get<int64_t>(),
+                                  column->second.get<int64_t>()));
+    errmsg.id = addon->second.get<std::string>() + "-" + errorId->second.get<std::string>();
+    errmsg.setmsg(message->second.get<std::string>());
+    errmsg.severity = Severity::fromString(severity->second.get<std::string>());
+    errmsg.file0 = fileName->second.get<std::string>();
+    return true;
+}
+
+void AddonOutputReader::line(const std::string& text)
+{
+    if (!mInvalidOutput.empty()) {
+        mInvalidOutput += '\n' + text;
+        return;
+    }
+    if (text.empty() || text.compare(0, 9, "Checking ") == 0)
+        return;
+    if (text[0] == '{') {
+        ErrorMessage errmsg;
+        if (parseResult(text, errmsg)) {
+            if (errmsg.severity != Severity::SeverityType::none)
+                mCallback(errmsg);
+            return;
+        }
+    }
+    mInvalidOutput = text;
+}
+
+
+std::string AddonExecutor::Command::toString() const
+{
+    std::string cmd;
+    for (std::size_t i = 0; i <= args.size(); ++i) {
+        const std::string& arg = (i == 0) ? exe : args[i - 1];
+        if (i > 0)
+            cmd += ' ';
+        if (arg.find(' ') != std::string::npos)
+            cmd += '\"' + arg + '\"';
+        else
+            cmd += arg;
+    }
+    return cmd;
+}
+
+struct AddonExecutor::RunningTask {
+    explicit RunningTask(Task t) : task(std::move(t)), remaining(task.commands.size()) {}
+
+    Task task;
+    /** Serializes the callbacks */
+    std::mutex mutex;
+    std::size_t remaining;
+};
+
+AddonExecutor::AddonExecutor(unsigned int processes, std::chrono::seconds timeout)
+    : mTimeout(timeout), mTasks(0), mStop(false)
+{
+    if (processes == 0)
+        processes = std::max(1U, std::thread::hardware_concurrency());
+    mThreads.reserve(processes);
+    for (unsigned int i = 0; i < processes; ++i)
+        mThreads.emplace_back(&AddonExecutor::run, this);
+}
+
+AddonExecutor::~AddonExecutor()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mJobAdded.notify_all();
+    for (std::thread& thread : mThreads)
+        thread.join();
+}
+
+void AddonExecutor::submit(Task task)
+{
+    if (task.commands.empty()) {
+        if (task.done)
+            task.done();
+        return;
+    }
+
+    const std::shared_ptr<RunningTask> running = std::make_shared<RunningTask>(std::move(task));
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        // Dump files of waiting addons pile up if the addons are slower than the analysis
+        mQueueShrunk.wait(lock, [this]() {
+            return mQueue.size() < mThreads.size();
+        });
+        ++mTasks;
+        for (std::size_t command = 0; command < running->task.commands.size(); ++command)
+            mQueue.push_back(Job{running, command});
+    }
+    mJobAdded.notify_all();
+}
+
+void AddonExecutor::wait()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mTaskDone.wait(lock, [this]() {
+        return mTasks == 0;
+    });
+}
+
+void AddonExecutor::run()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (;;) {
+        mJobAdded.wait(lock, [this]() {
+            return mStop || !mQueue.empty();
+        });
+        if (mQueue.empty())
+            return;
+        const Job job = mQueue.front();
+        mQueue.pop_front();
+        lock.unlock();
+        mQueueShrunk.notify_all();
+
+        RunningTask& task = *job.task;
+        execute(task, task.task.commands[job.command]);
+
+        bool done;
+        {
+            std::lock_guard<std::mutex> taskLock(task.mutex);
+            done = --task.remaining == 0;
+        }
+        if (done && task.task.done)
+            task.task.done();
+
+        lock.lock();
+        if (done) {
+            --mTasks;
+            mTaskDone.notify_all();
+        }
+    }
+}
+
+void AddonExecutor::execute(RunningTask& task, const Command& command)
+{
+    const CancellationToken::Scope cancellation(task.task.cancellationToken);
+    if (Settings::terminated())
+        return;
+
+    AddonOutputReader reader([&task](const ErrorMessage& errmsg) {
+        std::lock_guard<std::mutex> lock(task.mutex);
+        if (task.task.report)
+            task.task.report(errmsg);
+    });
+    const auto fail = [&task](const std::string& msg) {
+        std::lock_guard<std::mutex> lock(task.mutex);
+        if (task.task.failed)
+            task.task.failed(msg);
+    };
+
+#ifdef _WIN32
+    // No timeout, the pipe of _popen() can not be polled
+    const std::string cmd = "\"" + command.toString() + " 2>&1\"";
+    std::unique_ptr<FILE, decltype(&_pclose)> pipe(_popen(cmd.c_str(), "r"), _pclose);
+    if (!pipe) {
+        fail("Failed to execute addon (command: '" + command.toString() + "')");
+        return;
+    }
+    char buffer[4096];
+    std::size_t size;
+    while (!Settings::terminated() && (size = std::fread(buffer, 1, sizeof(buffer), pipe.get())) > 0)
+        reader.feed(buffer, size);
+#else
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(command.exe.c_str()));
+    for (const std::string& arg : command.args)
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    // The pipe must not leak into processes started concurrently, they would keep it open
+    int fds[2];
+#ifdef __linux__
+    if (pipe2(fds, O_CLOEXEC) != 0) {
+#else
+    if (pipe(fds) != 0 || fcntl(fds[0], F_SETFD, FD_CLOEXEC) != 0 || fcntl(fds[1], F_SETFD, FD_CLOEXEC) != 0) {
+#endif
+        fail("Failed to execute addon (command: '" + command.toString() + "'): " + std::strerror(errno));
+        return;
+    }
+
+    // stdout and stderr of the addon go to the pipe
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDERR_FILENO);
+    pid_t pid;
+    const int spawnError = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+    if (spawnError != 0) {
+        close(fds[0]);
+        fail("Failed to execute addon (command: '" + command.toString() + "')");
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + mTimeout;
+    bool timedOut = false;
+    bool killed = false;
+    char buffer[4096];
+    for (;;) {
+        // Wake up regularly to notice a termination
+        std::chrono::milliseconds interval(100);
+        if (mTimeout.count() > 0) {
+            const std::chrono::steady_clock::duration remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining <= std::chrono::steady_clock::duration::zero()) {
+                timedOut = true;
+                break;
+            }
+            interval = std::min(interval, std::chrono::duration_cast<std::chrono::milliseconds>(remaining) + std::chrono::milliseconds(1));
+        }
+        if (Settings::terminated()) {
+            killed = true;
+            break;
+        }
+
+        pollfd pfd{fds[0], POLLIN, 0};
+        const int ready = poll(&pfd, 1, static_cast<int>(interval.count()));
+        if (ready < 0 && errno != EINTR)
+            break;
+        if (ready <= 0)
+            continue;
+        const ssize_t size = read(fds[0], buffer, sizeof(buffer));
+        if (size < 0 && errno == EINTR)
+            continue;
+        if (size <= 0)
+            break;
+        reader.feed(buffer, static_cast<std::size_t>(size));
+    }
+    close(fds[0]);
+
+    if (timedOut || killed)
+        kill(pid, SIGKILL);
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+
+    if (killed)
+        return;
+    if (timedOut) {
+        fail("Addon timed out after " + MathLib::toString(mTimeout.count()) + " seconds (command: '" + command.toString() + "')");
+        return;
+    }
+    // The process could not execute the addon
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 127 && reader.invalidOutput().empty()) {
+        fail("Failed to execute addon (command: '" + command.toString() + "')");
+        return;
+    }
+#endif
+
+    reader.finish();
+    if (!reader.invalidOutput().empty())
+        fail("Failed to execute '" + command.toString() + "'. " + reader.invalidOutput());
+}
@@ -0,0 +1,150 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef addonexecutorH
+#define addonexecutorH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+#include "errorlogger.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class CancellationToken;
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Reads the output of an addon as it arrives. Every complete line
+ * is handled at once: results (json objects) are parsed into messages,
+ * "Checking ..." lines are skipped. Any other output means the addon
+ * failed, it is collected for the error message.
+ */
+class CPPCHECKLIB AddonOutputReader {
+public:
+    typedef std::function<void(const ErrorMessage&)> Callback;
+
+    explicit AddonOutputReader(const Callback& callback) : mCallback(callback) {}
+
+    /** Handle the complete lines of given output, the rest is kept for the next call */
+    void feed(const char* data, std::size_t size);
+
+    /** End of the output, handles an unterminated last line */
+    void finish();
+
+    /** Output from the first invalid line on, empty if the addon did not fail */
+    const std::string& invalidOutput() const {
+        return mInvalidOutput;
+    }
+
+private:
+    void line(const std::string& text);
+
+    Callback mCallback;
+    std::string mPending;
+    std::string mInvalidOutput;
+};
+
+/**
+ * @brief Runs addon processes concurrently. A task holds the addons of
+ * one file; its addons run in parallel with each other and with the
+ * tasks of other files, up to the given number of processes. The output
+ * of each process is read incrementally by an AddonOutputReader.
+ */
+class CPPCHECKLIB AddonExecutor {
+public:
+    /** An addon process, the arguments are passed without a shell */
+    struct Command {
+        std::string exe;
+        std::vector<std::string> args;
+
+        /** Command line for messages */
+        std::string toString() const;
+    };
+
+    /** The addons of one file. The callbacks of a task are never called concurrently. */
+    struct Task {
+        Task() : cancellationToken(nullptr) {}
+
+        std::vector<Command> commands;
+        /** Result of an addon, called while the addon is running */
+        std::function<void(const ErrorMessage&)> report;
+        /** An addon could not be executed, timed out or printed invalid output */
+        std::function<void(const std::string&)> failed;
+        /** All addons are finished, called last */
+        std::function<void()> done;
+        /** The addons are killed when it is cancelled, nullptr if they can only be stopped by Settings::terminate() */
+        const CancellationToken* cancellationToken;
+    };
+
+    /**
+     * @param processes Maximum number of concurrent addon processes, 0 means one per hardware thread
+     * @param timeout Maximum run time of one addon, zero means unlimited
+     */
+    AddonExecutor(unsigned int processes, std::chrono::seconds timeout);
+    /** Waits for the submitted tasks */
+    ~AddonExecutor();
+    AddonExecutor(const AddonExecutor&) = delete;
+    void operator=(const AddonExecutor&) = delete;
+
+    /**
+     * Start the addons of a task. Returns at once unless there is a backlog
+     * of addons that are not started yet, then it waits until it shrinks.
+     * A task without commands is done immediately.
+     */
+    void submit(Task task);
+
+    /** Wait until all submitted tasks are done */
+    void wait();
+
+private:
+    struct RunningTask;
+    struct Job {
+        std::shared_ptr<RunningTask> task;
+        std::size_t command;
+    };
+
+    void run();
+    void execute(RunningTask& task, const Command& command);
+
+    const std::chrono::seconds mTimeout;
+    std::vector<std::thread> mThreads;
+    std::deque<Job> mQueue;
+    /** Submitted tasks that are not done */
+    std::size_t mTasks;
+    bool mStop;
+    std::mutex mMutex;
+    std::condition_variable mJobAdded;
+    std::condition_variable mQueueShrunk;
+    std::condition_variable mTaskDone;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // addonexecutorH
@@ -42,17 +42,23 @@ static std::string getFilename(const std::string &fullpath)
 
 void AnalyzerInformation::createCTUs(const std::string &buildDir, const std::map<std::string, std::size_t>& sourcefiles)
 {
-    if (buildDir.empty()) {
-        for (auto it = sourcefiles.cbegin(); it != sourcefiles.cend(); ++it)
-            mFileInfo.emplace_back(it->first, it->second, emptyString);
+    beginCTUs(buildDir);
+    for (auto it = sourcefiles.cbegin(); it != sourcefiles.cend(); ++it)
+        createCTU(mFileInfo, it->first, it->second);
+    endCTUs();
+}
+
+void AnalyzerInformation::beginCTUs(const std::string &buildDir)
+{
+    mBuildDir = buildDir;
+    mExistingFiles.clear();
+    mFileCount.clear();
+    if (buildDir.empty())
         return;
-    }
 
     const std::string filesTxt(buildDir + "/files.txt");
-    std::map<std::string, unsigned int> fileCount;
 
     // Read existing files.txt
-    std::map<std::string, std::string> existingFiles;
     std::ifstream fin(filesTxt);
     std::string filesTxtLine;
     while (std::getline(fin, filesTxtLine)) {
@@ -65,33 +71,48 @@ void AnalyzerInformation::createCTUs(const std::string &buildDir, const std::map
             continue;
 
         std::string filename = filesTxtLine.substr(0, firstColon);
-        existingFiles[filesTxtLine.substr(lastColon+1)] = filename;
-        ++fileCount[filename.substr(0, filename.rfind('.'))];
+        mExistingFiles[filesTxtLine.substr(lastColon+1)] = filename;
+        ++mFileCount[filename.substr(0, filename.rfind('.'))];
     }
     fin.close();
 
     // Create new files.txt
-    std::ofstream fout(filesTxt);
-    for (auto it = sourcefiles.cbegin(); it != sourcefiles.cend(); ++it) {
-        const std::string path = Path::simplifyPath(Path::fromNativeSeparators(it->first));
-        auto file = existingFiles.find(path);
-        bool existing = (file != existingFiles.cend());
-        std::string afile;
-        if (existing) {
-            afile = file->second;
-            existingFiles.erase(path);
-        } else {
-            const std::string filename = getFilename(it->first);
-            afile = filename + ".a" + std::to_string(++fileCount[filename]);
-        }
-
-        fout << afile << "::" << path << '\n';
-        mFileInfo.emplace_back(it->first, it->second, buildDir + '/' + afile);
-        mFileInfo.back().analyzerfileExists = existing;
+    mFilesTxt.open(filesTxt);
+}
+
+void AnalyzerInformation::createCTU(std::list<CTU::CTUInfo>& ctus, const std::string& sourcefile, std::size_t filesize)
+{
+    if (mBuildDir.empty()) {
+        ctus.emplace_back(sourcefile, filesize, emptyString);
+        return;
     }
 
+    const std::string path = Path::simplifyPath(Path::fromNativeSeparators(sourcefile));
+    auto file = mExistingFiles.find(path);
+    bool existing = (file != mExistingFiles.cend());
+    std::string afile;
+    if (existing) {
+        afile = file->second;
+        mExistingFiles.erase(file);
+    } else {
+        const std::string filename = getFilename(sourcefile);
+        afile = filename + ".a" + std::to_string(++mFileCount[filename]);
+    }
+
+    mFilesTxt << afile << "::" << path << '\n';
+    ctus.emplace_back(sourcefile, filesize, mBuildDir + '/' + afile);
+    ctus.back().analyzerfileExists = existing;
+}
+
+void AnalyzerInformation::endCTUs()
+{
+    if (mBuildDir.empty())
+        return;
+    mFilesTxt.close();
+
     // Remove stale analyzer files
-    for (auto it = existingFiles.cbegin(); it != existingFiles.cend(); ++it) {
-        std::remove(it->second.c_str());
+    for (auto it = mExistingFiles.cbegin(); it != mExistingFiles.cend(); ++it) {
+        std::remove((mBuildDir + '/' + it->second).c_str());
     }
+    mExistingFiles.clear();
 }
@@ -25,6 +25,8 @@
 #include "config.h"
 #include "ctu.h"
 
+#include <cstddef>
+#include <fstream>
 #include <list>
 #include <map>
 #include <string>
@@ -50,6 +52,18 @@ class ErrorMessage;
 class CPPCHECKLIB AnalyzerInformation {
 public:
     void createCTUs(const std::string &buildDir, const std::map<std::string, std::size_t>& sourcefiles);
+
+    /**
+     * @brief Start creating CTUs one by one, for files that are checked
+     * while they are being discovered. files.txt is rewritten as the
+     * files are added.
+     */
+    void beginCTUs(const std::string &buildDir);
+    /** Append the CTU of given source file to ctus, which need not be getCTUs() */
+    void createCTU(std::list<CTU::CTUInfo>& ctus, const std::string& sourcefile, std::size_t filesize);
+    /** All files are added, remove the analyzer files of files that are gone */
+    void endCTUs();
+
     CTU::CTUInfo& addCTU(const std::string& sourcefile, std::size_t filesize, const std::string& analyzerfile) {
         return mFileInfo.emplace_back(sourcefile, filesize, analyzerfile);
     }
@@ -61,6 +75,13 @@ public:
 private:
     /** File info used for whole program analysis */
     std::list<CTU::CTUInfo> mFileInfo;
+
+    std::string mBuildDir;
+    std::ofstream mFilesTxt;
+    /** Analyzer file names of the previous run, by source file */
+    std::map<std::string, std::string> mExistingFiles;
+    /** Number of analyzer files by base name */
+    std::map<std::string, unsigned int> mFileCount;
 };
 
 /// @}
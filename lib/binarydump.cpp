@@ -0,0 +1,525 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "binarydump.h"
+
+#include "mathlib.h"
+#include "preprocessor.h"
+#include "settings.h"
+#include "standards.h"
+#include "suppressions.h"
+#include "symboldatabase.h"
+#include "token.h"
+#include "tokenize.h"
+#include "valueflow.h"
+
+#include <simplecpp.h>
+
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+
+const char BinaryDump::magic[] = "LCPPCDMP";
+
+static void append(std::string& out, std::uint64_t value, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+/** Pad to the next multiple of 8 bytes */
+static void pad(std::string& out)
+{
+    out.append((8 - out.size() % 8) % 8, '\0');
+}
+
+/** @brief Columnar table, all cells are stored as 64 bit numbers until the table is written */
+class BinaryDump::Table {
+public:
+    Table(std::initializer_list<std::pair<const char*, char>> columns) : mRows(0) {
+        for (const std::pair<const char*, char>& column : columns)
+            mColumns.push_back(Column{column.first, column.second, std::string()});
+    }
+
+    /** Add a row, one value per column */
+    void add(std::initializer_list<std::int64_t> row) {
+        const std::int64_t* value = row.begin();
+        for (Column& column : mColumns)
+            append(column.data, static_cast<std::uint64_t>(*value++), column.type == 'i' ? 4 : 8);
+        ++mRows;
+    }
+
+    /** Bit pattern of a value of a 'd' column */
+    static std::int64_t real(double value) {
+        std::int64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    std::string data() const {
+        std::string out;
+        append(out, mRows, 4);
+        append(out, mColumns.size(), 4);
+        for (const Column& column : mColumns) {
+            char name[16] = {0};
+            std::strncpy(name, column.name, sizeof(name) - 1);
+            out.append(name, sizeof(name));
+            append(out, static_cast<unsigned char>(column.type), 4);
+            append(out, 0, 4);
+        }
+        for (const Column& column : mColumns) {
+            out += column.data;
+            pad(out);
+        }
+        return out;
+    }
+
+private:
+    struct Column {
+        const char* name;
+        char type;
+        std::string data;
+    };
+
+    std::vector<Column> mColumns;
+    std::size_t mRows;
+};
+
+BinaryDump::BinaryDump(std::ostream& out) : mOut(out)
+{
+    string(emptyString);
+
+    std::string header(magic, 8);
+    append(header, version, 4);
+    append(header, 0, 4);
+    mOut.write(header.data(), header.size());
+}
+
+std::int32_t BinaryDump::string(const std::string& str)
+{
+    const std::pair<std::unordered_map<std::string, std::int32_t>::const_iterator, bool> it =
+        mStringIndex.emplace(str, static_cast<std::int32_t>(mStrings.size()));
+    if (it.second)
+        mStrings.push_back(&it.first->first);
+    return it.first->second;
+}
+
+void BinaryDump::section(std::string& out, const char tag[], const std::string& payload)
+{
+    out.append(tag, 4);
+    append(out, 0, 4);
+    append(out, payload.size() + (8 - payload.size() % 8) % 8, 8);
+    out += payload;
+    pad(out);
+}
+
+void BinaryDump::platform(const Project& project)
+{
+    Table table{{"name", 'i'}, {"char_bit", 'i'}, {"short_bit", 'i'}, {"int_bit", 'i'},
+        {"long_bit", 'i'}, {"long_long_bit", 'i'}, {"pointer_bit", 'i'}};
+    table.add({string(project.platformString()), project.char_bit, project.short_bit, project.int_bit,
+               project.long_bit, project.long_long_bit, project.sizeof_pointer * project.char_bit});
+
+    std::string out;
+    section(out, "PLAT", table.data());
+    mOut.write(out.data(), out.size());
+}
+
+void BinaryDump::rawTokens(const simplecpp::TokenList& tokens, const std::vector<std::string>& files)
+{
+    Table table{{"file", 'i'}, {"linenr", 'i'}, {"column", 'i'}, {"str", 'i'}};
+    for (const simplecpp::Token* tok = tokens.cfront(); tok; tok = tok->next)
+        table.add({string(files[tok->location.fileIndex]), tok->location.line, tok->location.col, string(tok->str())});
+
+    std::string out;
+    section(out, "RAWT", table.data());
+    mOut.write(out.data(), out.size());
+}
+
+void BinaryDump::suppressions(const Suppressions& suppressions)
+{
+    Table table{{"errorId", 'i'}, {"fileName", 'i'}, {"lineNumber", 'i'}, {"symbolName", 'i'}};
+    for (const Suppressions::Suppression& suppression : suppressions.getSuppressions())
+        table.add({string(suppression.errorId), string(suppression.fileName), suppression.lineNumber, string(suppression.symbolName)});
+
+    std::string out;
+    section(out, "SUPP", table.data());
+    mOut.write(out.data(), out.size());
+}
+
+template<class T>
+static std::int64_t row(const std::unordered_map<const T*, std::int32_t>& rows, const T* ptr)
+{
+    if (!ptr)
+        return -1;
+    const typename std::unordered_map<const T*, std::int32_t>::const_iterator it = rows.find(ptr);
+    return it == rows.end() ? -1 : it->second;
+}
+
+template<class T>
+static void addRow(std::unordered_map<const T*, std::int32_t>& rows, std::vector<const T*>& order, const T* ptr)
+{
+    if (ptr && rows.emplace(ptr, static_cast<std::int32_t>(order.size())).second)
+        order.push_back(ptr);
+}
+
+static const char* scopeTypeName(Scope::ScopeType type)
+{
+    switch (type) {
+    case Scope::eGlobal:
+        return "Global";
+    case Scope::eClass:
+        return "Class";
+    case Scope::eStruct:
+        return "Struct";
+    case Scope::eUnion:
+        return "Union";
+    case Scope::eNamespace:
+        return "Namespace";
+    case Scope::eFunction:
+        return "Function";
+    case Scope::eIf:
+        return "If";
+    case Scope::eElse:
+        return "Else";
+    case Scope::eFor:
+        return "For";
+    case Scope::eWhile:
+        return "While";
+    case Scope::eDo:
+        return "Do";
+    case Scope::eSwitch:
+        return "Switch";
+    case Scope::eUnconditional:
+        return "Unconditional";
+    case Scope::eTry:
+        return "Try";
+    case Scope::eCatch:
+        return "Catch";
+    case Scope::eLambda:
+        return "Lambda";
+    case Scope::eEnum:
+        return "Enum";
+    }
+    return "Unknown";
+}
+
+static const char* functionTypeName(Function::Type type)
+{
+    switch (type) {
+    case Function::eConstructor:
+        return "Constructor";
+    case Function::eCopyConstructor:
+        return "CopyConstructor";
+    case Function::eMoveConstructor:
+        return "MoveConstructor";
+    case Function::eOperatorEqual:
+        return "OperatorEqual";
+    case Function::eDestructor:
+        return "Destructor";
+    case Function::eFunction:
+        return "Function";
+    case Function::eLambda:
+        return "Lambda";
+    }
+    return "Unknown";
+}
+
+static const char* accessName(AccessControl access)
+{
+    switch (access) {
+    case AccessControl::Public:
+        return "Public";
+    case AccessControl::Protected:
+        return "Protected";
+    case AccessControl::Private:
+        return "Private";
+    case AccessControl::Global:
+        return "Global";
+    case AccessControl::Namespace:
+        return "Namespace";
+    case AccessControl::Argument:
+        return "Argument";
+    case AccessControl::Local:
+        return "Local";
+    case AccessControl::Throw:
+        return "Throw";
+    }
+    return "Unknown";
+}
+
+/** Same names as the attributes of the xml dump */
+static const char* valueTypeName(ValueFlow::Value::ValueType type)
+{
+    switch (type) {
+    case ValueFlow::Value::INT:
+        return "intvalue";
+    case ValueFlow::Value::TOK:
+        return "tokvalue";
+    case ValueFlow::Value::FLOAT:
+        return "floatvalue";
+    case ValueFlow::Value::MOVED:
+        return "movedvalue";
+    case ValueFlow::Value::UNINIT:
+        return "uninit";
+    case ValueFlow::Value::CONTAINER_SIZE:
+        return "container-size";
+    case ValueFlow::Value::LIFETIME:
+        return "lifetime";
+    case ValueFlow::Value::BUFFER_SIZE:
+        return "buffer-size";
+    case ValueFlow::Value::ITERATOR_START:
+        return "iterator-start";
+    case ValueFlow::Value::ITERATOR_END:
+        return "iterator-end";
+    }
+    return "";
+}
+
+static const char* valueKindName(const ValueFlow::Value& value)
+{
+    if (value.isKnown())
+        return "known";
+    if (value.isPossible())
+        return "possible";
+    if (value.isImpossible())
+        return "impossible";
+    return "inconclusive";
+}
+
+static std::uint32_t tokenFlags(const Token* tok)
+{
+    std::uint32_t flags = BinaryDump::None;
+    if (tok->isName()) {
+        flags = BinaryDump::Name;
+        if (tok->isUnsigned())
+            flags |= BinaryDump::Unsigned;
+        else if (tok->isSigned())
+            flags |= BinaryDump::Signed;
+    } else if (tok->isNumber()) {
+        flags = BinaryDump::Number;
+        if (MathLib::isInt(tok->str()))
+            flags |= BinaryDump::Int;
+        if (MathLib::isFloat(tok->str()))
+            flags |= BinaryDump::Float;
+    } else if (tok->tokType() == Token::eString)
+        flags = BinaryDump::String;
+    else if (tok->tokType() == Token::eChar)
+        flags = BinaryDump::Char;
+    else if (tok->isBoolean())
+        flags = BinaryDump::Boolean;
+    else if (tok->isOp()) {
+        flags = BinaryDump::Op;
+        if (tok->isArithmeticalOp())
+            flags |= BinaryDump::ArithmeticalOp;
+        else if (tok->isAssignmentOp())
+            flags |= BinaryDump::AssignmentOp;
+        else if (tok->isComparisonOp())
+            flags |= BinaryDump::ComparisonOp;
+        else if (tok->tokType() == Token::eLogicalOp)
+            flags |= BinaryDump::LogicalOp;
+    }
+    if (tok->isExpandedMacro())
+        flags |= BinaryDump::ExpandedMacro;
+    if (tok->isSplittedVarDeclComma())
+        flags |= BinaryDump::SplittedVarDeclComma;
+    if (tok->isSplittedVarDeclEq())
+        flags |= BinaryDump::SplittedVarDeclEq;
+    return flags;
+}
+
+static const char* signName(ValueType::Sign sign)
+{
+    switch (sign) {
+    case ValueType::Sign::UNKNOWN_SIGN:
+        return "";
+    case ValueType::Sign::SIGNED:
+        return "signed";
+    case ValueType::Sign::UNSIGNED:
+        return "unsigned";
+    }
+    return "";
+}
+
+void BinaryDump::configuration(const std::string& cfg, const Standards& standards, const Preprocessor& preprocessor, const Tokenizer& tokenizer)
+{
+    const SymbolDatabase* const symbolDatabase = tokenizer.getSymbolDatabase();
+
+    // Assign the rows first, the tables refer to each other
+    std::unordered_map<const Token*, std::int32_t> tokenRows;
+    std::vector<const Token*> tokens;
+    for (const Token* tok = tokenizer.list.front(); tok; tok = tok->next())
+        addRow(tokenRows, tokens, tok);
+
+    std::unordered_map<const Scope*, std::int32_t> scopeRows;
+    std::vector<const Scope*> scopes;
+    std::unordered_map<const Function*, std::int32_t> functionRows;
+    std::vector<const Function*> functions;
+    std::unordered_map<const Variable*, std::int32_t> variableRows;
+    std::vector<const Variable*> variables;
+    for (const Variable* var : symbolDatabase->variableList())
+        addRow(variableRows, variables, var);
+    for (const Scope& scope : symbolDatabase->scopeList) {
+        addRow(scopeRows, scopes, &scope);
+        for (const Function& function : scope.functionList) {
+            addRow(functionRows, functions, &function);
+            for (const Variable& arg : function.argumentList)
+                addRow(variableRows, variables, &arg);
+        }
+        for (const Variable& var : scope.varlist)
+            addRow(variableRows, variables, &var);
+    }
+
+    Table info{{"name", 'i'}, {"c", 'i'}, {"cpp", 'i'}};
+    info.add({string(cfg), string(standards.getC()), string(standards.getCPP())});
+
+    Table directives{{"file", 'i'}, {"linenr", 'i'}, {"str", 'i'}};
+    for (const Directive& dir : preprocessor.getDirectives())
+        directives.add({string(dir.file), dir.linenr, string(dir.str)});
+
+    Table tokenTable{{"str", 'i'}, {"file", 'i'}, {"linenr", 'i'}, {"column", 'i'}, {"scope", 'i'}, {"flags", 'i'},
+        {"strlen", 'i'}, {"link", 'i'}, {"varId", 'i'}, {"variable", 'i'}, {"function", 'i'},
+        {"values", 'i'}, {"valueCount", 'i'}, {"typeScope", 'i'}, {"astParent", 'i'}, {"astOperand1", 'i'},
+        {"astOperand2", 'i'}, {"originalName", 'i'}, {"vtType", 'i'}, {"vtSign", 'i'}, {"vtBits", 'i'},
+        {"vtPointer", 'i'}, {"vtConstness", 'i'}, {"vtTypeScope", 'i'}, {"vtOriginalType", 'i'}};
+    Table values{{"token", 'i'}, {"type", 'i'}, {"int", 'q'}, {"tok", 'i'}, {"float", 'd'}, {"moved", 'i'},
+        {"conditionLine", 'i'}, {"kind", 'i'}};
+    std::int32_t valueCount = 0;
+    for (const Token* tok : tokens) {
+        const std::vector<ValueFlow::Value>& tokValues = tok->values();
+        for (const ValueFlow::Value& value : tokValues) {
+            values.add({tokenRows[tok], string(valueTypeName(value.valueType)), value.intvalue, row(tokenRows, value.tokvalue),
+                        Table::real(value.floatValue),
+                        string(value.valueType == ValueFlow::Value::MOVED ? ValueFlow::Value::toString(value.moveKind) : ""),
+                        value.condition ? static_cast<std::int64_t>(value.condition->linenr()) : 0,
+                        string(valueKindName(value))});
+        }
+
+        const ValueType* const vt = tok->valueType();
+        tokenTable.add({string(tok->str()), string(tokenizer.list.file(tok)), tok->linenr(), tok->column(),
+                        row(scopeRows, tok->scope()), tokenFlags(tok),
+                        tok->tokType() == Token::eString ? Token::getStrLength(tok) : 0,
+                        row(tokenRows, tok->link()), tok->varId(), row(variableRows, tok->variable()),
+                        row(functionRows, tok->function()),
+                        tokValues.empty() ? -1 : valueCount, static_cast<std::int64_t>(tokValues.size()),
+                        row(scopeRows, tok->type() ? tok->type()->classScope : nullptr),
+                        row(tokenRows, tok->astParent()), row(tokenRows, tok->astOperand1()), row(tokenRows, tok->astOperand2()),
+                        string(tok->originalName()),
+                        string(vt ? ValueType::typeToString(vt->type) : ""), string(vt ? signName(vt->sign) : ""), vt ? vt->bits : 0,
+                        vt ? vt->pointer : 0, vt ? vt->constness : 0,
+                        row(scopeRows, vt ? vt->typeScope : nullptr), string(vt ? vt->originalTypeName : emptyString)});
+        valueCount += static_cast<std::int32_t>(tokValues.size());
+    }
+
+    Table scopeTable{{"type", 'i'}, {"className", 'i'}, {"bodyStart", 'i'}, {"bodyEnd", 'i'}, {"nestedIn", 'i'},
+        {"function", 'i'}, {"varlist", 'i'}, {"varCount", 'i'}};
+    Table scopeVariables{{"variable", 'i'}};
+    std::int32_t scopeVariableCount = 0;
+    for (const Scope* scope : scopes) {
+        for (const Variable& var : scope->varlist)
+            scopeVariables.add({row(variableRows, &var)});
+        scopeTable.add({string(scopeTypeName(scope->type)), string(scope->className),
+                        row(tokenRows, scope->bodyStart), row(tokenRows, scope->bodyEnd),
+                        row(scopeRows, scope->nestedIn), row(functionRows, scope->function),
+                        scopeVariableCount, static_cast<std::int64_t>(scope->varlist.size())});
+        scopeVariableCount += static_cast<std::int32_t>(scope->varlist.size());
+    }
+
+    Table functionTable{{"tokenDef", 'i'}, {"name", 'i'}, {"type", 'i'}, {"flags", 'i'}, {"nestedIn", 'i'},
+        {"args", 'i'}, {"argCount", 'i'}};
+    Table functionArguments{{"variable", 'i'}};
+    std::int32_t argumentCount = 0;
+    for (const Function* function : functions) {
+        std::uint32_t flags = 0;
+        if (function->nestedIn->definedType) {
+            if (function->hasVirtualSpecifier())
+                flags |= Virtual;
+            else if (function->isImplicitlyVirtual())
+                flags |= ImplicitlyVirtual;
+        }
+        if (function->isStatic())
+            flags |= StaticFunction;
+        for (const Variable& arg : function->argumentList)
+            functionArguments.add({row(variableRows, &arg)});
+        functionTable.add({row(tokenRows, function->tokenDef), string(function->name()), string(functionTypeName(function->type)),
+                           flags, row(scopeRows, function->nestedIn), argumentCount, static_cast<std::int64_t>(function->argCount())});
+        argumentCount += static_cast<std::int32_t>(function->argCount());
+    }
+
+    Table variableTable{{"nameToken", 'i'}, {"typeStartToken", 'i'}, {"typeEndToken", 'i'}, {"access", 'i'},
+        {"scope", 'i'}, {"constness", 'i'}, {"flags", 'i'}};
+    for (const Variable* var : variables) {
+        std::uint32_t flags = 0;
+        if (var->isArgument())
+            flags |= Argument;
+        if (var->isArray())
+            flags |= Array;
+        if (var->isClass())
+            flags |= Class;
+        if (var->isConst())
+            flags |= Const;
+        if (var->isExtern())
+            flags |= Extern;
+        if (var->isLocal())
+            flags |= Local;
+        if (var->isPointer())
+            flags |= Pointer;
+        if (var->isReference())
+            flags |= Reference;
+        if (var->isStatic())
+            flags |= StaticVariable;
+        variableTable.add({row(tokenRows, var->nameToken()), row(tokenRows, var->typeStartToken()), row(tokenRows, var->typeEndToken()),
+                           string(accessName(var->accessControl())), row(scopeRows, var->scope()),
+                           var->valueType() ? var->valueType()->constness : 0, flags});
+    }
+
+    std::string payload;
+    section(payload, "INFO", info.data());
+    section(payload, "DIRS", directives.data());
+    section(payload, "TOKS", tokenTable.data());
+    section(payload, "SCOP", scopeTable.data());
+    section(payload, "SVAR", scopeVariables.data());
+    section(payload, "FUNC", functionTable.data());
+    section(payload, "FARG", functionArguments.data());
+    section(payload, "VARS", variableTable.data());
+    section(payload, "VALS", values.data());
+
+    std::string out;
+    section(out, "CONF", payload);
+    mOut.write(out.data(), out.size());
+}
+
+void BinaryDump::finish()
+{
+    std::string payload;
+    append(payload, mStrings.size(), 4);
+    append(payload, 0, 4);
+    std::uint64_t offset = 0;
+    for (const std::string* str : mStrings) {
+        append(payload, offset, 4);
+        offset += str->size();
+    }
+    append(payload, offset, 4);
+    for (const std::string* str : mStrings)
+        payload += *str;
+
+    std::string out;
+    section(out, "STRS", payload);
+    mOut.write(out.data(), out.size());
+    mOut.flush();
+}
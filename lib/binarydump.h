@@ -0,0 +1,140 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef binarydumpH
+#define binarydumpH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Preprocessor;
+class Project;
+class Suppressions;
+class Tokenizer;
+struct Standards;
+
+namespace simplecpp {
+    class TokenList;
+}
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Writes the data of --dump in a compact binary format, read by
+ * addons/cppcheckdata.py. It holds the same information as the xml dump.
+ *
+ * The file starts with the 8 byte magic "LCPPCDMP", the version (u32) and
+ * a reserved u32. Then follow sections: a 4 character tag, a reserved u32,
+ * the payload size (u64) and the payload. Sections are aligned to 8 bytes,
+ * all numbers are little endian.
+ *
+ * Top level sections are PLAT, RAWT and SUPP, one CONF per configuration
+ * and the string table STRS at the end. A CONF section contains the
+ * sections INFO, DIRS, TOKS, SCOP, SVAR, FUNC, FARG, VARS and VALS.
+ *
+ * All sections but STRS are tables: row count (u32), column count (u32),
+ * a header per column (16 byte name, u32 type 'i' (i32), 'q' (i64) or
+ * 'd' (f64), reserved u32) and then the data of each column. Strings are
+ * indexes into the string table, index 0 is the empty string. Tokens,
+ * scopes, functions and variables are referred to by their row, -1 is
+ * none.
+ *
+ * STRS contains the string count (u32), a reserved u32, count + 1 offsets
+ * (u32) and the utf-8 data of all strings.
+ */
+class CPPCHECKLIB BinaryDump {
+public:
+    static const char magic[];
+    static const std::uint32_t version = 1;
+
+    /** Bits of the "flags" column of the tokens, the lowest 3 bits are the TokenKind */
+    enum TokenKind : std::uint32_t { None, Name, Number, String, Char, Boolean, Op };
+    enum TokenFlag : std::uint32_t {
+        Unsigned = 1 << 3,
+        Signed = 1 << 4,
+        Int = 1 << 5,
+        Float = 1 << 6,
+        ArithmeticalOp = 1 << 7,
+        AssignmentOp = 1 << 8,
+        ComparisonOp = 1 << 9,
+        LogicalOp = 1 << 10,
+        ExpandedMacro = 1 << 11,
+        SplittedVarDeclComma = 1 << 12,
+        SplittedVarDeclEq = 1 << 13
+    };
+
+    /** Bits of the "flags" column of the functions */
+    enum FunctionFlag : std::uint32_t {
+        Virtual = 1 << 0,
+        ImplicitlyVirtual = 1 << 1,
+        StaticFunction = 1 << 2
+    };
+
+    /** Bits of the "flags" column of the variables */
+    enum VariableFlag : std::uint32_t {
+        Argument = 1 << 0,
+        Array = 1 << 1,
+        Class = 1 << 2,
+        Const = 1 << 3,
+        Extern = 1 << 4,
+        Local = 1 << 5,
+        Pointer = 1 << 6,
+        Reference = 1 << 7,
+        StaticVariable = 1 << 8
+    };
+
+    /** Writes the file header */
+    explicit BinaryDump(std::ostream& out);
+    BinaryDump(const BinaryDump&) = delete;
+    void operator=(const BinaryDump&) = delete;
+
+    void platform(const Project& project);
+    void rawTokens(const simplecpp::TokenList& tokens, const std::vector<std::string>& files);
+    void suppressions(const Suppressions& suppressions);
+
+    /** Dump a configuration, the value flow of the tokenizer must be set up */
+    void configuration(const std::string& cfg, const Standards& standards, const Preprocessor& preprocessor, const Tokenizer& tokenizer);
+
+    /** Write the string table, nothing can be written after it */
+    void finish();
+
+private:
+    class Table;
+
+    /** Index of given string in the string table */
+    std::int32_t string(const std::string& str);
+
+    static void section(std::string& out, const char tag[], const std::string& payload);
+
+    std::ostream& mOut;
+    std::unordered_map<std::string, std::int32_t> mStringIndex;
+    /** Keys of mStringIndex by index, the nodes of the map are stable */
+    std::vector<const std::string*> mStrings;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // binarydumpH
@@ -93,6 +93,25 @@ public:
     /** run checks, the token list is not simplified */
     virtual void runChecks(const Context& ctx) = 0;
 
+    /**
+     * Analysis data needed by runChecks(). Only the layers needed by the
+     * enabled checks are built.
+     */
+    virtual Tokenizer::AnalysisLayer analysisLayer() const {
+        return Tokenizer::AnalysisLayer::ValueFlow;
+    }
+
+    /**
+     * Severities of the findings reported by runChecks() and
+     * analyseWholeProgram(). The check is skipped if it can not report
+     * anything with the enabled severities.
+     */
+    virtual SimpleEnableGroup<Severity::SeverityType> severities() const {
+        SimpleEnableGroup<Severity::SeverityType> all;
+        all.fill();
+        return all;
+    }
+
     /** get error messages */
     virtual void getErrorMessages(const Context& ctx) const = 0;
 
@@ -53,6 +53,14 @@ public:
         check64BitPortability.pointerassignment();
     }
 
+    Tokenizer::AnalysisLayer analysisLayer() const override {
+        return Tokenizer::AnalysisLayer::ValueTypes;
+    }
+
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::portability};
+    }
+
     /** Check for pointer assignment */
     void pointerassignment();
 
@@ -52,6 +52,14 @@ public:
         checkAssert.assertWithSideEffects();
     }
 
+    Tokenizer::AnalysisLayer analysisLayer() const override {
+        return Tokenizer::AnalysisLayer::Symbols;
+    }
+
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::warning};
+    }
+
     void assertWithSideEffects();
 
 protected:
@@ -55,6 +55,10 @@ public:
         checkAutoVariables.autoVariables();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style};
+    }
+
     /** assign function argument */
     void assignFunctionArg();
 
@@ -62,6 +62,10 @@ public:
         checkBool.checkBitwiseOnBoolean();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style};
+    }
+
     /** @brief %Check for comparison of function returning bool*/
     void checkComparisonOfFuncReturningBool();
 
@@ -54,6 +54,14 @@ public:
         checkBoost.checkBoostForeachModification();
     }
 
+    Tokenizer::AnalysisLayer analysisLayer() const override {
+        return Tokenizer::AnalysisLayer::Symbols;
+    }
+
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error};
+    }
+
     /** @brief %Check for container modification while using the BOOST_FOREACH macro */
     void checkBoostForeachModification();
 
@@ -76,6 +76,10 @@ public:
         checkBufferOverrun.checkInsecureCmdLineArgs();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style, Severity::portability};
+    }
+
     void getErrorMessages(const Context& ctx) const override {
         CheckBufferOverrun c(ctx);
         c.arrayIndexError(nullptr, std::vector<Dimension>(), std::vector<const ValueFlow::Value *>());
@@ -530,7 +530,7 @@ void CheckClass::assignVar(unsigned int varid, const Scope *scope, std::vector<U
 {
     int count = 0;
 
-    for (std::list<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var, ++count) {
+    for (SegmentedList<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var, ++count) {
         if (var->declarationId() == varid) {
             usage[count].assign = true;
             return;
@@ -542,7 +542,7 @@ void CheckClass::initVar(unsigned int varid, const Scope *scope, std::vector<Usa
 {
     int count = 0;
 
-    for (std::list<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var, ++count) {
+    for (SegmentedList<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var, ++count) {
         if (var->declarationId() == varid) {
             usage[count].init = true;
             return;
@@ -572,7 +572,7 @@ bool CheckClass::isBaseClassFunc(const Token *tok, const Scope *scope)
 
         // Check if base class exists in database
         if (derivedFrom && derivedFrom->classScope) {
-            const std::list<Function>& functionList = derivedFrom->classScope->functionList;
+            const SegmentedList<Function>& functionList = derivedFrom->classScope->functionList;
 
             for (const Function &func : functionList) {
                 if (func.tokenDef->str() == tok->str())
@@ -1004,7 +1004,7 @@ static bool checkFunctionUsage(const Function *privfunc, const Scope* scope)
     if (!scope)
         return true; // Assume it is used, if scope is not seen
 
-    for (std::list<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
+    for (SegmentedList<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
         if (func->functionScope) {
             if (Token::Match(func->tokenDef, "%name% (")) {
                 for (const Token *ftok = func->tokenDef->tokAt(2); ftok && ftok->str() != ")"; ftok = ftok->next()) {
@@ -1310,7 +1310,7 @@ void CheckClass::operatorEq()
         return;
 
     for (const Scope * scope : mCtx.symbolDB->classAndStructScopes) {
-        for (std::list<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
+        for (SegmentedList<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
             if (func->type == Function::eOperatorEqual && func->access == AccessControl::Public) {
                 // skip "deleted" functions - cannot be called anyway
                 if (func->isDelete())
@@ -1363,7 +1363,7 @@ void CheckClass::operatorEqRetRefThis()
         return;
 
     for (const Scope * scope : mCtx.symbolDB->classAndStructScopes) {
-        for (std::list<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
+        for (SegmentedList<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
             if (func->type == Function::eOperatorEqual && func->hasBody()) {
                 // make sure return signature is correct
                 if (func->retType == func->nestedIn->definedType && func->tokenDef->strAt(-1) == "&") {
@@ -1407,7 +1407,7 @@ void CheckClass::checkReturnPtrThis(const Scope *scope, const Function *func, co
         if (tok->strAt(2) == "(" &&
             tok->linkAt(2)->next()->str() == ";") {
             // check if it is a member function
-            for (std::list<Function>::const_iterator it = scope->functionList.begin(); it != scope->functionList.end(); ++it) {
+            for (SegmentedList<Function>::const_iterator it = scope->functionList.begin(); it != scope->functionList.end(); ++it) {
                 // check for a regular function with the same name and a body
                 if (it->type == Function::eFunction && it->hasBody() &&
                     it->token->str() == tok->next()->str()) {
@@ -2197,7 +2197,7 @@ void CheckClass::initializerListOrder()
     for (const Scope * scope : mCtx.symbolDB->classAndStructScopes) {
 
         // iterate through all member functions looking for constructors
-        for (std::list<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
+        for (SegmentedList<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
             if (func->isConstructor() && func->hasBody()) {
                 // check for initializer list
                 const Token *tok = func->arg->link()->next();
@@ -2509,7 +2509,7 @@ void CheckClass::checkCopyCtorAndEqOperator()
     for (const Scope * scope : mCtx.symbolDB->classAndStructScopes) {
 
         bool hasNonStaticVars = false;
-        for (std::list<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
+        for (SegmentedList<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
             if (!var->isStatic()) {
                 hasNonStaticVars = true;
                 break;
@@ -82,6 +82,10 @@ public:
         checkClass.checkUnsafeClassRefMember();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style, Severity::performance, Severity::portability};
+    }
+
     /** @brief %Check that all class constructors are ok */
     void constructors();
 
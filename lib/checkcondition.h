@@ -67,6 +67,10 @@ public:
         checkCondition.checkModuloAlwaysTrueFalse();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::warning, Severity::style};
+    }
+
     /** mismatching assignment / comparison */
     void assignIf();
 
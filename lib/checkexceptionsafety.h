@@ -72,6 +72,10 @@ public:
         checkExceptionSafety.unhandledExceptionSpecification();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style};
+    }
+
     /** Don't throw exceptions in destructors */
     void destructors();
 
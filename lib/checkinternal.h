@@ -57,6 +57,14 @@ public:
         checkInternal.checkRedundantTokCheck();
     }
 
+    Tokenizer::AnalysisLayer analysisLayer() const override {
+        return Tokenizer::AnalysisLayer::Symbols;
+    }
+
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style};
+    }
+
     /** @brief %Check if a simple pattern is used inside Token::Match or Token::findmatch */
     void checkTokenMatchPatterns();
 
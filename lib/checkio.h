@@ -58,6 +58,10 @@ public:
         checkIO.invalidScanf();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::portability};
+    }
+
     /** @brief %Check for missusage of std::cout */
     void checkCoutCerrMisusage();
 
@@ -79,12 +79,12 @@ static bool isAutoDealloc(const Variable *var)
 
 void VarInfo::print()
 {
-    std::cout << "size=" << alloctype.size() << std::endl;
-    for (std::map<unsigned int, AllocInfo>::const_iterator it = alloctype.begin(); it != alloctype.end(); ++it) {
+    std::cout << "size=" << alloctype->size() << std::endl;
+    for (std::map<unsigned int, AllocInfo>::const_iterator it = alloctype->begin(); it != alloctype->end(); ++it) {
         std::string strusage;
         const std::map<unsigned int, std::string>::const_iterator use =
-            possibleUsage.find(it->first);
-        if (use != possibleUsage.end())
+            possibleUsage->find(it->first);
+        if (use != possibleUsage->end())
             strusage = use->second;
 
         std::string status;
@@ -109,17 +109,18 @@ void VarInfo::print()
         std::cout << "status=" << status << " "
                   << "alloctype='" << it->second.type << "' "
                   << "possibleUsage='" << strusage << "' "
-                  << "conditionalAlloc=" << (conditionalAlloc.find(it->first) != conditionalAlloc.end() ? "yes" : "no") << " "
-                  << "referenced=" << (referenced.find(it->first) != referenced.end() ? "yes" : "no") << " "
+                  << "conditionalAlloc=" << (conditionalAlloc->find(it->first) != conditionalAlloc->end() ? "yes" : "no") << " "
+                  << "referenced=" << (referenced->find(it->first) != referenced->end() ? "yes" : "no") << " "
                   << std::endl;
     }
 }
 
 void VarInfo::possibleUsageAll(const std::string &functionName)
 {
-    possibleUsage.clear();
-    for (std::map<unsigned int, AllocInfo>::const_iterator it = alloctype.begin(); it != alloctype.end(); ++it)
-        possibleUsage[it->first] = functionName;
+    std::map<unsigned int, std::string>& usage = possibleUsage.write();
+    usage.clear();
+    for (std::map<unsigned int, AllocInfo>::const_iterator it = alloctype->begin(); it != alloctype->end(); ++it)
+        usage[it->first] = functionName;
 }
 
 
@@ -190,13 +191,14 @@ void CheckLeakAutoVar::check()
         varInfo.conditionalAlloc.clear();
 
         // Clear reference arguments from varInfo..
-        std::map<unsigned int, VarInfo::AllocInfo>::iterator it = varInfo.alloctype.begin();
-        while (it != varInfo.alloctype.end()) {
+        std::map<unsigned int, VarInfo::AllocInfo> &alloctype = varInfo.alloctype.write();
+        std::map<unsigned int, VarInfo::AllocInfo>::iterator it = alloctype.begin();
+        while (it != alloctype.end()) {
             const Variable *var = mCtx.symbolDB->getVariableFromVarId(it->first);
             if (!var ||
                 (var->isArgument() && var->isReference()) ||
                 (!var->isArgument() && !var->isLocal()))
-                varInfo.alloctype.erase(it++);
+                alloctype.erase(it++);
             else
                 ++it;
         }
@@ -279,6 +281,22 @@ static const Token * isFunctionCall(const Token * nameToken)
     return nullptr;
 }
 
+/** Add the entries of source that are missing in dest, like std::map::merge() */
+template<class T>
+static void mergeShared(CopyOnWrite<T> &dest, const CopyOnWrite<T> &source)
+{
+    if (dest.shares(source) || source->empty())
+        return;
+    if (dest->empty()) {
+        dest = source;
+        return;
+    }
+    for (const typename T::value_type &entry : *source) {
+        if (dest->find(entry.first) == dest->end())
+            dest.write().insert(entry);
+    }
+}
+
 void CheckLeakAutoVar::checkScope(const Token * const startToken,
                                   VarInfo *varInfo,
                                   std::set<unsigned int> notzero,
@@ -288,9 +306,7 @@ void CheckLeakAutoVar::checkScope(const Token * const startToken,
     if (++recursiveCount > recursiveLimit)    // maximum number of "else if ()"
         throw InternalError(startToken, "Internal limit: CheckLeakAutoVar::checkScope() Maximum recursive count of 1000 reached.", InternalError::LIMIT);
 
-    std::map<unsigned int, VarInfo::AllocInfo> &alloctype = varInfo->alloctype;
-    std::map<unsigned int, std::string> &possibleUsage = varInfo->possibleUsage;
-    const std::set<unsigned int> conditionalAlloc(varInfo->conditionalAlloc);
+    const CopyOnWrite<std::set<unsigned int>> conditionalAlloc(varInfo->conditionalAlloc);
 
     // Parse all tokens
     const Token * const endToken = startToken->link();
@@ -362,7 +378,7 @@ void CheckLeakAutoVar::checkScope(const Token * const startToken,
                 continue;
 
             // Variable has already been allocated => error
-            if (conditionalAlloc.find(varTok->varId()) == conditionalAlloc.end())
+            if (conditionalAlloc->find(varTok->varId()) == conditionalAlloc->end())
                 leakIfAllocated(varTok, *varInfo);
             varInfo->erase(varTok->varId());
 
@@ -374,17 +390,17 @@ void CheckLeakAutoVar::checkScope(const Token * const startToken,
             if (Token::Match(fTok, "%type% (")) {
                 const Library::AllocFunc* f = mCtx.project->library.getAllocFuncInfo(fTok);
                 if (f && f->arg == -1) {
-                    VarInfo::AllocInfo& varAlloc = alloctype[varTok->varId()];
+                    VarInfo::AllocInfo& varAlloc = varInfo->alloctype.write()[varTok->varId()];
                     varAlloc.type = f->groupId;
                     varAlloc.status = VarInfo::ALLOC;
                     varAlloc.allocTok = fTok;
                 }
 
-                changeAllocStatusIfRealloc(alloctype, fTok, varTok);
+                changeAllocStatusIfRealloc(varInfo->alloctype, fTok, varTok);
             } else if (mCtx.tokenizer->isCPP() && Token::Match(varTok->tokAt(2), "new !!(")) {
                 const Token* tok2 = varTok->tokAt(2)->astOperand1();
                 const bool arrayNew = (tok2 && (tok2->str() == "[" || (tok2->str() == "(" && tok2->astOperand1() && tok2->astOperand1()->str() == "[")));
-                VarInfo::AllocInfo& varAlloc = alloctype[varTok->varId()];
+                VarInfo::AllocInfo& varAlloc = varInfo->alloctype.write()[varTok->varId()];
                 varAlloc.type = arrayNew ? NEW_ARRAY : NEW;
                 varAlloc.status = VarInfo::ALLOC;
                 varAlloc.allocTok = varTok->tokAt(2);
@@ -420,20 +436,20 @@ void CheckLeakAutoVar::checkScope(const Token * const startToken,
                     if (tokRightAstOperand && Token::Match(tokRightAstOperand->previous(), "%type% (")) {
                         const Library::AllocFunc* f = mCtx.project->library.getAllocFuncInfo(tokRightAstOperand->previous());
                         if (f && f->arg == -1) {
-                            VarInfo::AllocInfo& varAlloc = alloctype[innerTok->varId()];
+                            VarInfo::AllocInfo& varAlloc = varInfo->alloctype.write()[innerTok->varId()];
                             varAlloc.type = f->groupId;
                             varAlloc.status = VarInfo::ALLOC;
                             varAlloc.allocTok = tokRightAstOperand->previous();
                         } else {
                             // Fixme: warn about leak
-                            alloctype.erase(innerTok->varId());
+                            varInfo->alloctype.write().erase(innerTok->varId());
                         }
 
-                        changeAllocStatusIfRealloc(alloctype, innerTok->tokAt(2), varTok);
+                        changeAllocStatusIfRealloc(varInfo->alloctype, innerTok->tokAt(2), varTok);
                     } else if (mCtx.tokenizer->isCPP() && Token::Match(innerTok->tokAt(2), "new !!(")) {
                         const Token* tok2 = innerTok->tokAt(2)->astOperand1();
                         const bool arrayNew = (tok2 && (tok2->str() == "[" || (tok2->str() == "(" && tok2->astOperand1() && tok2->astOperand1()->str() == "[")));
-                        VarInfo::AllocInfo& varAlloc = alloctype[innerTok->varId()];
+                        VarInfo::AllocInfo& varAlloc = varInfo->alloctype.write()[innerTok->varId()];
                         varAlloc.type = arrayNew ? NEW_ARRAY : NEW;
                         varAlloc.status = VarInfo::ALLOC;
                         varAlloc.allocTok = innerTok->tokAt(2);
@@ -521,52 +537,52 @@ void CheckLeakAutoVar::checkScope(const Token * const startToken,
 
                 std::map<unsigned int, VarInfo::AllocInfo>::const_iterator it;
 
-                for (it = old.alloctype.begin(); it != old.alloctype.end(); ++it) {
+                for (it = old.alloctype->begin(); it != old.alloctype->end(); ++it) {
                     const int varId = it->first;
-                    if (old.conditionalAlloc.find(varId) == old.conditionalAlloc.end())
+                    if (old.conditionalAlloc->find(varId) == old.conditionalAlloc->end())
                         continue;
-                    if (varInfo1.alloctype.find(varId) == varInfo1.alloctype.end() ||
-                        varInfo2.alloctype.find(varId) == varInfo2.alloctype.end()) {
+                    if (varInfo1.alloctype->find(varId) == varInfo1.alloctype->end() ||
+                        varInfo2.alloctype->find(varId) == varInfo2.alloctype->end()) {
                         varInfo1.erase(varId);
                         varInfo2.erase(varId);
                     }
                 }
 
                 // Conditional allocation in varInfo1
-                for (it = varInfo1.alloctype.begin(); it != varInfo1.alloctype.end(); ++it) {
-                    if (varInfo2.alloctype.find(it->first) == varInfo2.alloctype.end() &&
-                        old.alloctype.find(it->first) == old.alloctype.end()) {
-                        varInfo->conditionalAlloc.insert(it->first);
+                for (it = varInfo1.alloctype->begin(); it != varInfo1.alloctype->end(); ++it) {
+                    if (varInfo2.alloctype->find(it->first) == varInfo2.alloctype->end() &&
+                        old.alloctype->find(it->first) == old.alloctype->end()) {
+                        varInfo->conditionalAlloc.write().insert(it->first);
                     }
                 }
 
                 // Conditional allocation in varInfo2
-                for (it = varInfo2.alloctype.begin(); it != varInfo2.alloctype.end(); ++it) {
-                    if (varInfo1.alloctype.find(it->first) == varInfo1.alloctype.end() &&
-                        old.alloctype.find(it->first) == old.alloctype.end()) {
-                        varInfo->conditionalAlloc.insert(it->first);
+                for (it = varInfo2.alloctype->begin(); it != varInfo2.alloctype->end(); ++it) {
+                    if (varInfo1.alloctype->find(it->first) == varInfo1.alloctype->end() &&
+                        old.alloctype->find(it->first) == old.alloctype->end()) {
+                        varInfo->conditionalAlloc.write().insert(it->first);
                     }
                 }
 
                 // Conditional allocation/deallocation
-                for (it = varInfo1.alloctype.begin(); it != varInfo1.alloctype.end(); ++it) {
-                    if (it->second.managed() && conditionalAlloc.find(it->first) != conditionalAlloc.end()) {
-                        varInfo->conditionalAlloc.erase(it->first);
+                for (it = varInfo1.alloctype->begin(); it != varInfo1.alloctype->end(); ++it) {
+                    if (it->second.managed() && conditionalAlloc->find(it->first) != conditionalAlloc->end()) {
+                        varInfo->conditionalAlloc.write().erase(it->first);
                         varInfo2.erase(it->first);
                     }
                 }
-                for (it = varInfo2.alloctype.begin(); it != varInfo2.alloctype.end(); ++it) {
-                    if (it->second.managed() && conditionalAlloc.find(it->first) != conditionalAlloc.end()) {
-                        varInfo->conditionalAlloc.erase(it->first);
+                for (it = varInfo2.alloctype->begin(); it != varInfo2.alloctype->end(); ++it) {
+                    if (it->second.managed() && conditionalAlloc->find(it->first) != conditionalAlloc->end()) {
+                        varInfo->conditionalAlloc.write().erase(it->first);
                         varInfo1.erase(it->first);
                     }
                 }
 
-                alloctype.merge(varInfo1.alloctype);
-                alloctype.merge(varInfo2.alloctype);
+                mergeShared(varInfo->alloctype, varInfo1.alloctype);
+                mergeShared(varInfo->alloctype, varInfo2.alloctype);
 
-                possibleUsage.merge(varInfo1.possibleUsage);
-                possibleUsage.merge(varInfo2.possibleUsage);
+                mergeShared(varInfo->possibleUsage, varInfo1.possibleUsage);
+                mergeShared(varInfo->possibleUsage, varInfo2.possibleUsage);
             }
         }
 
@@ -727,8 +743,8 @@ const Token * CheckLeakAutoVar::checkTokenInsideExpression(const Token * const t
     // Deallocation and then dereferencing pointer..
     if (tok->varId() > 0) {
         // TODO : Write a separate checker for this that uses valueFlowForward.
-        const std::map<unsigned int, VarInfo::AllocInfo>::const_iterator var = varInfo->alloctype.find(tok->varId());
-        if (var != varInfo->alloctype.end()) {
+        const std::map<unsigned int, VarInfo::AllocInfo>::const_iterator var = varInfo->alloctype->find(tok->varId());
+        if (var != varInfo->alloctype->end()) {
             bool unknown = false;
             if (var->second.status == VarInfo::DEALLOC && CheckNullPointer::isPointerDeRef(tok, unknown, mCtx.project) && !unknown) {
                 deallocUseError(tok, tok->str());
@@ -761,7 +777,7 @@ const Token * CheckLeakAutoVar::checkTokenInsideExpression(const Token * const t
                 }
             }
         } else if (Token::Match(tok->previous(), "& %name% = %var% ;")) {
-            varInfo->referenced.insert(tok->tokAt(2)->varId());
+            varInfo->referenced.write().insert(tok->tokAt(2)->varId());
         }
     }
 
@@ -784,11 +800,12 @@ const Token * CheckLeakAutoVar::checkTokenInsideExpression(const Token * const t
 }
 
 
-void CheckLeakAutoVar::changeAllocStatusIfRealloc(std::map<unsigned int, VarInfo::AllocInfo> &alloctype, const Token *fTok, const Token *retTok)
+void CheckLeakAutoVar::changeAllocStatusIfRealloc(CopyOnWrite<std::map<unsigned int, VarInfo::AllocInfo>> &allocations, const Token *fTok, const Token *retTok)
 {
     const Library::AllocFunc* f = mCtx.project->library.getReallocFuncInfo(fTok);
     if (f && f->arg == -1 && f->reallocArg > 0 && f->reallocArg <= numberOfArguments(fTok)) {
         const Token* argTok = getArguments(fTok).at(f->reallocArg - 1);
+        std::map<unsigned int, VarInfo::AllocInfo> &alloctype = allocations.write();
         VarInfo::AllocInfo& argAlloc = alloctype[argTok->varId()];
         VarInfo::AllocInfo& retAlloc = alloctype[retTok->varId()];
         if (argAlloc.type != 0 && argAlloc.type != f->groupId)
@@ -804,12 +821,11 @@ void CheckLeakAutoVar::changeAllocStatusIfRealloc(std::map<unsigned int, VarInfo
 
 void CheckLeakAutoVar::changeAllocStatus(VarInfo *varInfo, const VarInfo::AllocInfo& allocation, const Token* tok, const Token* arg)
 {
-    std::map<unsigned int, VarInfo::AllocInfo> &alloctype = varInfo->alloctype;
-    const std::map<unsigned int, VarInfo::AllocInfo>::iterator var = alloctype.find(arg->varId());
-    if (var != alloctype.end()) {
+    const std::map<unsigned int, VarInfo::AllocInfo>::const_iterator var = varInfo->alloctype->find(arg->varId());
+    if (var != varInfo->alloctype->end()) {
         if (allocation.status == VarInfo::NOALLOC) {
             // possible usage
-            varInfo->possibleUsage[arg->varId()] = tok->str();
+            varInfo->possibleUsage.write()[arg->varId()] = tok->str();
             if (var->second.status == VarInfo::DEALLOC && arg->previous()->str() == "&")
                 varInfo->erase(arg->varId());
         } else if (var->second.managed()) {
@@ -820,13 +836,15 @@ void CheckLeakAutoVar::changeAllocStatus(VarInfo *varInfo, const VarInfo::AllocI
             varInfo->erase(arg->varId());
         } else {
             // deallocation
-            var->second.status = allocation.status;
-            var->second.type = allocation.type;
-            var->second.allocTok = allocation.allocTok;
+            VarInfo::AllocInfo &varAlloc = varInfo->alloctype.write()[arg->varId()];
+            varAlloc.status = allocation.status;
+            varAlloc.type = allocation.type;
+            varAlloc.allocTok = allocation.allocTok;
         }
     } else if (allocation.status != VarInfo::NOALLOC) {
-        alloctype[arg->varId()].status = VarInfo::DEALLOC;
-        alloctype[arg->varId()].allocTok = tok;
+        VarInfo::AllocInfo &varAlloc = varInfo->alloctype.write()[arg->varId()];
+        varAlloc.status = VarInfo::DEALLOC;
+        varAlloc.allocTok = tok;
     }
 }
 
@@ -930,8 +948,8 @@ void CheckLeakAutoVar::functionCall(const Token *tokName, const Token *tokOpenin
 void CheckLeakAutoVar::leakIfAllocated(const Token *vartok,
                                        const VarInfo &varInfo)
 {
-    const std::map<unsigned int, VarInfo::AllocInfo> &alloctype = varInfo.alloctype;
-    const std::map<unsigned int, std::string> &possibleUsage = varInfo.possibleUsage;
+    const std::map<unsigned int, VarInfo::AllocInfo> &alloctype = *varInfo.alloctype;
+    const std::map<unsigned int, std::string> &possibleUsage = *varInfo.possibleUsage;
 
     const std::map<unsigned int, VarInfo::AllocInfo>::const_iterator var = alloctype.find(vartok->varId());
     if (var != alloctype.end() && var->second.status == VarInfo::ALLOC) {
@@ -946,16 +964,16 @@ void CheckLeakAutoVar::leakIfAllocated(const Token *vartok,
 
 void CheckLeakAutoVar::ret(const Token *tok, const VarInfo &varInfo)
 {
-    const std::map<unsigned int, VarInfo::AllocInfo> &alloctype = varInfo.alloctype;
-    const std::map<unsigned int, std::string> &possibleUsage = varInfo.possibleUsage;
+    const std::map<unsigned int, VarInfo::AllocInfo> &alloctype = *varInfo.alloctype;
+    const std::map<unsigned int, std::string> &possibleUsage = *varInfo.possibleUsage;
 
     for (std::map<unsigned int, VarInfo::AllocInfo>::const_iterator it = alloctype.begin(); it != alloctype.end(); ++it) {
         // don't warn if variable is conditionally allocated
-        if (!it->second.managed() && varInfo.conditionalAlloc.find(it->first) != varInfo.conditionalAlloc.end())
+        if (!it->second.managed() && varInfo.conditionalAlloc->find(it->first) != varInfo.conditionalAlloc->end())
             continue;
 
         // don't warn if there is a reference of the variable
-        if (varInfo.referenced.find(it->first) != varInfo.referenced.end())
+        if (varInfo.referenced->find(it->first) != varInfo.referenced->end())
             continue;
 
         const unsigned int varid = it->first;
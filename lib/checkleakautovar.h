@@ -50,10 +50,11 @@ public:
             return status < 0;
         }
     };
-    std::map<unsigned int, AllocInfo> alloctype;
-    std::map<unsigned int, std::string> possibleUsage;
-    std::set<unsigned int> conditionalAlloc;
-    std::set<unsigned int> referenced;
+    /** The state is forked at each branch. Copies share the members until they are modified. */
+    CopyOnWrite<std::map<unsigned int, AllocInfo>> alloctype;
+    CopyOnWrite<std::map<unsigned int, std::string>> possibleUsage;
+    CopyOnWrite<std::set<unsigned int>> conditionalAlloc;
+    CopyOnWrite<std::set<unsigned int>> referenced;
 
     void clear() {
         alloctype.clear();
@@ -63,10 +64,14 @@ public:
     }
 
     void erase(unsigned int varid) {
-        alloctype.erase(varid);
-        possibleUsage.erase(varid);
-        conditionalAlloc.erase(varid);
-        referenced.erase(varid);
+        if (alloctype->count(varid))
+            alloctype.write().erase(varid);
+        if (possibleUsage->count(varid))
+            possibleUsage.write().erase(varid);
+        if (conditionalAlloc->count(varid))
+            conditionalAlloc.write().erase(varid);
+        if (referenced->count(varid))
+            referenced.write().erase(varid);
     }
 
     void swap(VarInfo &other) {
@@ -106,6 +111,10 @@ public:
         checkLeakAutoVar.check();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style, Severity::information};
+    }
+
 private:
 
     /** check for leaks in all scopes */
@@ -131,7 +140,7 @@ private:
     void changeAllocStatus(VarInfo *varInfo, const VarInfo::AllocInfo& allocation, const Token* tok, const Token* arg);
 
     /** update allocation status if reallocation function */
-    void changeAllocStatusIfRealloc(std::map<unsigned int, VarInfo::AllocInfo> &alloctype, const Token *fTok, const Token *retTok);
+    void changeAllocStatusIfRealloc(CopyOnWrite<std::map<unsigned int, VarInfo::AllocInfo>> &allocations, const Token *fTok, const Token *retTok);
 
     /** return. either "return" or end of variable scope is seen */
     void ret(const Token *tok, const VarInfo &varInfo);
@@ -177,6 +177,10 @@ public:
         checkMemoryLeak.checkReallocUsage();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style};
+    }
+
     /**
      * Checking for a memory leak caused by improper realloc usage.
      */
@@ -238,6 +242,10 @@ public:
         checkMemoryLeak.check();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style};
+    }
+
     void check();
 
 private:
@@ -282,6 +290,10 @@ public:
         checkMemoryLeak.check();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style};
+    }
+
     void check();
 
 private:
@@ -321,6 +333,10 @@ public:
         checkMemoryLeak.check();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style};
+    }
+
     void check();
 
 private:
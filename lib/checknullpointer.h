@@ -59,6 +59,10 @@ public:
         checkNullPointer.nullConstantDereference();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning};
+    }
+
     /**
      * @brief parse a function call and extract information about variable usage
      * @param tok first token
@@ -3210,11 +3210,11 @@ void CheckOther::comparePointersError(const Token *tok, const ValueFlow::Value *
         verb = "Subtracting";
     if (v1) {
         errorPath.emplace_back(v1->tokvalue->variable()->nameToken(), "Variable declared here.");
-        errorPath.insert(errorPath.end(), v1->errorPath.begin(), v1->errorPath.end());
+        errorPath.splice(errorPath.end(), ErrorPath(v1->errorPath));
     }
     if (v2) {
         errorPath.emplace_back(v2->tokvalue->variable()->nameToken(), "Variable declared here.");
-        errorPath.insert(errorPath.end(), v2->errorPath.begin(), v2->errorPath.end());
+        errorPath.splice(errorPath.end(), ErrorPath(v2->errorPath));
     }
     errorPath.emplace_back(tok, emptyString);
     reportError(
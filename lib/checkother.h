@@ -100,6 +100,10 @@ public:
         checkOther.checkModuloOfOne();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style, Severity::performance, Severity::portability, Severity::debug};
+    }
+
     /** @brief Clarify calculation for ".. a * b ? .." */
     void clarifyCalculation();
 
@@ -55,6 +55,14 @@ public:
         checkPostfixOperator.postfixOperator();
     }
 
+    Tokenizer::AnalysisLayer analysisLayer() const override {
+        return Tokenizer::AnalysisLayer::Symbols;
+    }
+
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::performance};
+    }
+
     /** Check postfix operators */
     void postfixOperator();
 
@@ -60,6 +60,14 @@ public:
         checkSizeof.sizeofVoid();
     }
 
+    Tokenizer::AnalysisLayer analysisLayer() const override {
+        return Tokenizer::AnalysisLayer::ValueTypes;
+    }
+
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::warning, Severity::portability};
+    }
+
     /** @brief %Check for 'sizeof sizeof ..' */
     void sizeofsizeof();
 
@@ -985,7 +985,7 @@ void CheckStl::invalidContainerError(const Token *tok, const Token * contTok, co
     std::string method = contTok ? contTok->strAt(2) : "erase";
     errorPath.emplace_back(contTok, "After calling '" + method + "', iterators or references to the container's data may be invalid .");
     if (val)
-        errorPath.insert(errorPath.begin(), val->errorPath.begin(), val->errorPath.end());
+        errorPath.splice(errorPath.begin(), ErrorPath(val->errorPath));
     std::string msg = "Using " + lifetimeMessage(tok, val, errorPath);
     errorPath.emplace_back(tok, emptyString);
     reportError(errorPath, Severity::error, "invalidContainer", msg + " that may be invalid.", CWE664, inconclusive ? Certainty::inconclusive : Certainty::safe);
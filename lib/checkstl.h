@@ -90,6 +90,10 @@ public:
         checkStl.size();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style, Severity::performance};
+    }
+
     /** Accessing container out of bounds using ValueFlow */
     void outOfBounds();
 
@@ -60,6 +60,10 @@ public:
         checkString.checkAlwaysTrueOrFalseStringCompare();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning};
+    }
+
     /** @brief undefined behaviour, writing string literal */
     void stringLiteralWrite();
 
@@ -55,6 +55,10 @@ public:
         checkType.checkFloatToIntegerOverflow();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning, Severity::style, Severity::portability};
+    }
+
     /** @brief %Check for bitwise shift with too big right operand */
     void checkTooBigBitwiseShift();
 
@@ -68,6 +68,10 @@ public:
         checkUninitVar.valueFlowUninit();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::debug};
+    }
+
     /** Check for uninitialized variables */
     void check();
     void checkScope(const Scope* scope, const std::set<std::string> &arrayTypeDefs);
@@ -59,6 +59,10 @@ public:
         checkUnusedVar.checkFunctionVariableUsage();
     }
 
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::style, Severity::information};
+    }
+
     /** @brief %Check for unused function variables */
     void checkFunctionVariableUsage_iterateScopes(const Scope* const scope, Variables& variables);
     void checkFunctionVariableUsage();
@@ -50,6 +50,14 @@ public:
         check.va_list_usage();
     }
 
+    Tokenizer::AnalysisLayer analysisLayer() const override {
+        return Tokenizer::AnalysisLayer::Symbols;
+    }
+
+    SimpleEnableGroup<Severity::SeverityType> severities() const override {
+        return {Severity::error, Severity::warning};
+    }
+
     void va_start_argument();
     void va_list_usage();
 
@@ -18,12 +18,16 @@
  */
 #include "cppcheck.h"
 
+#include "addonexecutor.h"
+#include "binarydump.h"
 #include "check.h"
 #include "checkunusedfunctions.h"
 #include "ctu.h"
+#include "importproject.h"
 #include "library.h"
 #include "mathlib.h"
 #include "path.h"
+#include "perfreport.h"
 #include "platform.h"
 #include "preprocessor.h" // Preprocessor
 #include "suppressions.h"
@@ -37,6 +41,7 @@
 #include <simplecpp.h>
 #include <tinyxml2.h>
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <new>
 #include <set>
@@ -152,14 +157,6 @@ namespace {
     };
 }
 
-static std::string cmdFileName(std::string f)
-{
-    f = Path::toNativeSeparators(f);
-    if (f.find(" ") != std::string::npos)
-        return "\"" + f + "\"";
-    return f;
-}
-
 static std::vector<std::string> split(const std::string &str, const std::string &sep=" ")
 {
     std::vector<std::string> ret;
@@ -183,51 +180,46 @@ static std::vector<std::string> split(const std::string &str, const std::string
     return ret;
 }
 
-static std::string executeAddon(const AddonInfo &addonInfo,
-                                const std::string &defaultPythonExe,
-                                const std::string &dumpFile,
-                                std::function<bool(const std::string&, const std::vector<std::string>&, const std::string&, std::string*)> executeCommand)
+/** Python interpreter of the addons that do not configure one, detected once */
+static std::string detectPython(std::function<bool(const std::string&, const std::vector<std::string>&, const std::string&, std::string*)> executeCommand)
 {
-    const std::string redirect = "2>&1";
+#ifdef _WIN32
+    const char *p[] = { "python3.exe", "python.exe" };
+#else
+    const char *p[] = { "python3", "python" };
+#endif
+    for (size_t i = 0; i < sizeof(p)/sizeof(*p); ++i) {
+        std::string out;
+        if (executeCommand(p[i], { "--version" }, "2>&1", &out) && out.compare(0, 7, "Python ") == 0 && std::isdigit(out[7]))
+            return p[i];
+    }
+    return "";
+}
 
-    std::string pythonExe;
+static AddonExecutor::Command addonCommand(const AddonInfo &addonInfo,
+        const std::string &defaultPythonExe,
+        const std::string &dumpFile,
+        std::function<bool(const std::string&, const std::vector<std::string>&, const std::string&, std::string*)> executeCommand)
+{
+    AddonExecutor::Command command;
 
     if (!addonInfo.python.empty())
-        pythonExe = cmdFileName(addonInfo.python);
+        command.exe = Path::toNativeSeparators(addonInfo.python);
     else if (!defaultPythonExe.empty())
-        pythonExe = cmdFileName(defaultPythonExe);
+        command.exe = Path::toNativeSeparators(defaultPythonExe);
     else {
-#ifdef _WIN32
-        const char *p[] = { "python3.exe", "python.exe" };
-#else
-        const char *p[] = { "python3", "python" };
-#endif
-        for (size_t i = 0; i < sizeof(p)/sizeof(*p); ++i) {
-            std::string out;
-            if (executeCommand(p[i], { "--version" }, redirect, &out) && out.compare(0, 7, "Python ") == 0 && std::isdigit(out[7])) {
-                pythonExe = p[i];
-                break;
-            }
-        }
-        if (pythonExe.empty())
+        static const std::string detectedPythonExe = detectPython(executeCommand);
+        if (detectedPythonExe.empty())
             throw InternalError(nullptr, "Failed to auto detect python");
+        command.exe = detectedPythonExe;
     }
 
-    const std::string args = cmdFileName(addonInfo.scriptFile) + " --cli" + addonInfo.args + " " + cmdFileName(dumpFile);
-    std::string result;
-    if (!executeCommand(pythonExe, split(args), redirect, &result))
-        throw InternalError(nullptr, "Failed to execute addon (command: '" + pythonExe + " " + args + "')");
-
-    // Validate output..
-    std::istringstream istr(result);
-    std::string line;
-    while (std::getline(istr, line)) {
-        if (line.compare(0,9,"Checking ", 0, 9) != 0 && !line.empty() && line[0] != '{')
-            throw InternalError(nullptr, "Failed to execute '" + pythonExe + " " + args + "'. " + result);
-    }
-
-    // Valid results
-    return result;
+    command.args.push_back(Path::toNativeSeparators(addonInfo.scriptFile));
+    command.args.emplace_back("--cli");
+    for (const std::string &arg : split(addonInfo.args))
+        command.args.push_back(arg);
+    command.args.push_back(Path::toNativeSeparators(dumpFile));
+    return command;
 }
 
 /**
@@ -280,6 +272,13 @@ CppCheck::CppCheck(ErrorLogger &errorLogger,
     , mSuppressInternalErrorFound(false)
     , mUseGlobalSuppressions(useGlobalSuppressions)
     , mTooManyConfigs(false)
+    , mChecksPlanned(false)
+    , mPerformanceReport(nullptr)
+    , mFilePerformance(nullptr)
+    , mCancellationToken(nullptr)
+    , mIncludeChecksums(nullptr)
+    , mAddonExecutor(nullptr)
+    , mAddonLogger(nullptr)
 {
 }
 
@@ -309,13 +308,196 @@ unsigned int CppCheck::check(CTU::CTUInfo* ctu, const std::string &content)
     return checkCTU(ctu, iss);
 }
 
+namespace {
+    /** Measures the check of a file and writes the record to the performance report when the check ends */
+    class PerformanceRecorder {
+    public:
+        PerformanceRecorder(PerformanceReport* report, const CTU::CTUInfo* ctu, bool measureMemory, FilePerformance*& current)
+            : mReport(report), mCurrent(current), mStartMemory(0), mPeakMemory(0), mStartCpu(0) {
+            if (!mReport)
+                return;
+            mRecord.file = ctu->sourcefile;
+            mRecord.size = ctu->filesize;
+            mRecord.memoryMeasured = measureMemory;
+            if (measureMemory)
+                mStartMemory = mPeakMemory = FileBudget::currentMemoryUsage();
+            mStartCpu = FilePerformance::threadCpuSeconds();
+            mStart = std::chrono::steady_clock::now();
+            mCurrent = &mRecord;
+            Timer::record(&mRecord.phases);
+        }
+
+        ~PerformanceRecorder() {
+            if (!mReport)
+                return;
+            Timer::record(nullptr);
+            mCurrent = nullptr;
+            sampleMemory();
+            mRecord.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+            mRecord.cpuSeconds = FilePerformance::threadCpuSeconds() - mStartCpu;
+            if (mRecord.memoryMeasured)
+                mRecord.memoryGrowth = static_cast<int64_t>(mPeakMemory) - static_cast<int64_t>(mStartMemory);
+            mReport->write(mRecord);
+        }
+
+        /** Sample the resident memory between phases, the peak is reported */
+        void sampleMemory() {
+            if (mReport && mRecord.memoryMeasured)
+                mPeakMemory = std::max(mPeakMemory, FileBudget::currentMemoryUsage());
+        }
+
+    private:
+        PerformanceReport* const mReport;
+        FilePerformance*& mCurrent;
+        FilePerformance mRecord;
+        std::size_t mStartMemory;
+        std::size_t mPeakMemory;
+        double mStartCpu;
+        std::chrono::steady_clock::time_point mStart;
+    };
+}
+
+/**
+ * Filters of reported messages, shared by the checker and the addons:
+ * messages of library files, duplicates and suppressed messages are
+ * dropped. Updates the exit code and the list of reported messages.
+ * @param suppressed set if the message is suppressed
+ * @return true if the message is reported
+ */
+static bool acceptError(const ErrorMessage &msg, const Settings &settings, Project &project, bool useGlobalSuppressions,
+                        std::vector<std::string> &errorList, unsigned int &exitCode, bool &suppressed)
+{
+    suppressed = false;
+
+    if (!project.library.reportErrors(msg.file0))
+        return false;
+
+    const std::string errmsg = msg.toString(settings.verbose);
+    if (errmsg.empty())
+        return false;
+
+    // Alert only about unique errors
+    if (std::find(errorList.begin(), errorList.end(), errmsg) != errorList.end())
+        return false;
+
+    const Suppressions::ErrorMessage errorMessage = msg.toSuppressionsErrorMessage();
+
+    if (useGlobalSuppressions) {
+        if (project.nomsg.isSuppressed(errorMessage)) {
+            suppressed = true;
+            return false;
+        }
+    } else {
+        if (project.nomsg.isSuppressedLocal(errorMessage)) {
+            suppressed = true;
+            return false;
+        }
+    }
+
+    if (!project.nofail.isSuppressed(errorMessage) && !project.nomsg.isSuppressed(errorMessage)) {
+        exitCode = 1;
+    }
+
+    errorList.push_back(errmsg);
+    return true;
+}
+
+/**
+ * Reports the results of the addons of a file as they are parsed, with the
+ * filters of CppCheck::reportErr(). When the addons are deferred, this
+ * happens after checkCTU() returned, so it does not use the checker.
+ */
+class CppCheck::AddonResults {
+public:
+    AddonResults(const Settings& settings, Project& project, bool useGlobalSuppressions, ErrorLogger& errorLogger, CTU::CTUInfo* ctu, const std::string& dumpFile, const std::vector<std::string>& errorList)
+        : mSettings(settings), mProject(project), mUseGlobalSuppressions(useGlobalSuppressions), mErrorLogger(errorLogger), mCTU(ctu), mDumpFile(dumpFile), mErrorList(errorList), mCancellationToken(CancellationToken::current()), mExitCode(0), mFailed(false) {}
+
+    void report(const ErrorMessage& msg) {
+        bool suppressed;
+        if (!acceptError(msg, mSettings, mProject, mUseGlobalSuppressions, mErrorList, mExitCode, suppressed))
+            return;
+        mErrorLogger.reportErr(msg);
+        mCTU->reportErr(msg);
+    }
+
+    void failed(const std::string& msg) {
+        reportInternalError(mErrorLogger, mProject, mCTU->sourcefile, msg);
+        mExitCode = 1;
+        mFailed = true;
+    }
+
+    /** The addons are done. The dump and the analyzer information are kept if an addon failed, as when a check bails out. */
+    unsigned int finish() {
+        if (mFailed)
+            return mExitCode;
+        std::remove(mDumpFile.c_str());
+        const CancellationToken::Scope cancellation(mCancellationToken);
+        if (!mProject.buildDir.empty() && !Settings::terminated())
+            mCTU->writeFile();
+        return mExitCode;
+    }
+
+private:
+    const Settings& mSettings;
+    Project& mProject;
+    const bool mUseGlobalSuppressions;
+    ErrorLogger& mErrorLogger;
+    CTU::CTUInfo* const mCTU;
+    const std::string mDumpFile;
+    std::vector<std::string> mErrorList;
+    const CancellationToken* const mCancellationToken;
+    unsigned int mExitCode;
+    bool mFailed;
+};
+
+namespace {
+    /** Calls the callback of deferred addons if the check ends without starting them */
+    class DeferredAddons {
+    public:
+        DeferredAddons(AddonExecutor*& executor, ErrorLogger*& logger, std::function<void(unsigned int)>& done)
+            : executor(executor), logger(logger), mDone(std::move(done)) {
+            executor = nullptr;
+            logger = nullptr;
+            done = nullptr;
+        }
+
+        ~DeferredAddons() {
+            if (mDone)
+                mDone(0);
+        }
+
+        bool isDeferred() const {
+            return executor != nullptr;
+        }
+
+        /** The addons are started, the caller calls the callback when they are done */
+        std::function<void(unsigned int)> release() {
+            std::function<void(unsigned int)> done;
+            done.swap(mDone);
+            return done;
+        }
+
+        AddonExecutor* const executor;
+        ErrorLogger* const logger;
+
+    private:
+        std::function<void(unsigned int)> mDone;
+    };
+}
+
 unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
 {
+    DeferredAddons deferredAddons(mAddonExecutor, mAddonLogger, mAddonsDone);
+    const CancellationToken::Scope cancellation(mCancellationToken);
+    // The resident memory is measured for the process, with -j it also grows with the files of the other threads
+    PerformanceRecorder performance(mPerformanceReport, ctu, mSettings.jobs == 1, mFilePerformance);
     Timer timer0("CppCheck::checkCTU", mSettings.showtime);
 
     mCTU = ctu;
     mExitCode = 0;
     mSuppressInternalErrorFound = false;
+    if (mIncludeChecksums)
+        mIncludeChecksums->clear();
 
     // only show debug warnings for accepted C/C++ source files
     if (!Path::acceptFile(ctu->sourcefile))
@@ -324,22 +506,26 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
     if (Settings::terminated())
         return mExitCode;
 
+    // Build configuration of this file, if it is known (--project)
+    const FileSettings* const fileSettings = ctu->fileSettings;
+    const std::string& userDefines = fileSettings ? fileSettings->defines : mProject.userDefines;
+
     if (mSettings.output.isEnabled(Output::status)) {
         std::string fixedpath = Path::simplifyPath(ctu->sourcefile);
         fixedpath = Path::toNativeSeparators(fixedpath);
         mErrorLogger.reportOut(std::string("Checking ") + fixedpath + std::string("..."));
 
         if (mSettings.verbose) {
-            mErrorLogger.reportOut("Defines:" + mProject.userDefines);
+            mErrorLogger.reportOut("Defines:" + userDefines);
             std::string undefs;
-            for (const std::string& U : mProject.userUndefs) {
+            for (const std::string& U : (fileSettings ? fileSettings->undefs : mProject.userUndefs)) {
                 if (!undefs.empty())
                     undefs += ';';
                 undefs += ' ' + U;
             }
             mErrorLogger.reportOut("Undefines:" + undefs);
             std::string includePaths;
-            for (const std::string &I : mProject.includePaths)
+            for (const std::string &I : (fileSettings ? fileSettings->includePaths : mProject.includePaths))
                 includePaths += " -I" + I;
             mErrorLogger.reportOut("Includes:" + includePaths);
             mErrorLogger.reportOut(std::string("Platform:") + mProject.platformString());
@@ -348,11 +534,14 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
 
     try {
         Preprocessor preprocessor(mSettings, mProject, this);
+        preprocessor.setFileSettings(fileSettings);
         std::set<std::string> configurations;
 
         simplecpp::OutputList outputList;
         std::vector<std::string> files;
+        Timer timerTokens1("simplecpp::TokenList", mSettings.showtime);
         simplecpp::TokenList tokens1(fileStream, files, ctu->sourcefile, &outputList);
+        timerTokens1.stop();
 
         // If there is a syntax error, report it and stop
         for (const simplecpp::Output &output : outputList) {
@@ -391,11 +580,24 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
             }
         }
 
-        if (!preprocessor.loadFiles(tokens1, files))
+        Timer timerLoadFiles("Preprocessor::loadFiles", mSettings.showtime);
+        const bool loaded = preprocessor.loadFiles(tokens1, files);
+        timerLoadFiles.stop();
+        // The results also depend on the headers that were found when loading failed
+        if (mIncludeChecksums)
+            *mIncludeChecksums = preprocessor.calculateIncludeChecksums();
+        if (!loaded)
             return mExitCode;
 
+        if (mFilePerformance) {
+            for (const simplecpp::Token *tok = tokens1.cfront(); tok; tok = tok->next)
+                ++mFilePerformance->rawTokens;
+            performance.sampleMemory();
+        }
+
         // write dump file xml prolog
         std::ofstream fdump;
+        std::unique_ptr<BinaryDump> binaryDump;
         std::string dumpFile;
         if (mSettings.dump || !mProject.addons.empty()) {
             if (!mSettings.dumpFile.empty())
@@ -405,10 +607,19 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
             else
                 dumpFile = ctu->sourcefile + ".dump";
 
-            fdump.open(dumpFile);
-            if (fdump.is_open()) {
-                fdump << "<?xml version=\"1.0\"?>" << std::endl;
-                fdump << "<dumps>" << std::endl;
+            if (mSettings.dumpFormat == Settings::DUMP_BINARY) {
+                fdump.open(dumpFile, std::ios::binary);
+                if (fdump.is_open()) {
+                    binaryDump.reset(new BinaryDump(fdump));
+                    binaryDump->platform(mProject);
+                    binaryDump->rawTokens(tokens1, files);
+                }
+            } else {
+                fdump.open(dumpFile);
+            }
+            if (fdump.is_open() && !binaryDump) {
+                fdump << "<?xml version=\"1.0\"?>\n";
+                fdump << "<dumps>\n";
                 fdump << "  <platform"
                       << " name=\"" << mProject.platformString() << '\"'
                       << " char_bit=\"" << mProject.char_bit << '\"'
@@ -418,25 +629,28 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
                       << " long_long_bit=\"" << mProject.long_long_bit << '\"'
                       << " pointer_bit=\"" << (mProject.sizeof_pointer * mProject.char_bit) << '\"'
                       << "/>\n";
-                fdump << "  <rawtokens>" << std::endl;
+                fdump << "  <rawtokens>\n";
                 for (std::size_t i = 0; i < files.size(); ++i)
-                    fdump << "    <file index=\"" << i << "\" name=\"" << ErrorLogger::toxml(files[i]) << "\"/>" << std::endl;
+                    fdump << "    <file index=\"" << i << "\" name=\"" << ErrorLogger::toxml(files[i]) << "\"/>\n";
                 for (const simplecpp::Token *tok = tokens1.cfront(); tok; tok = tok->next) {
                     fdump << "    <tok "
                           << "fileIndex=\"" << tok->location.fileIndex << "\" "
                           << "linenr=\"" << tok->location.line << "\" "
                           << "column=\"" << tok->location.col << "\" "
                           << "str=\"" << ErrorLogger::toxml(tok->str()) << "\""
-                          << "/>" << std::endl;
+                          << "/>\n";
                 }
-                fdump << "  </rawtokens>" << std::endl;
+                fdump << "  </rawtokens>\n";
             }
         }
 
         // Parse comments and then remove them
         preprocessor.inlineSuppressions(tokens1);
         if ((mSettings.dump || !mProject.addons.empty()) && fdump.is_open()) {
-            mProject.nomsg.dump(fdump);
+            if (binaryDump)
+                binaryDump->suppressions(mProject.nomsg);
+            else
+                mProject.nomsg.dump(fdump);
         }
         tokens1.removeComments();
         preprocessor.removeComments();
@@ -446,13 +660,27 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
             std::ostringstream toolinfo;
             toolinfo << CPPCHECK_VERSION_STRING;
             toolinfo << mProject.severity.intValue() << ' ';
-            toolinfo << mProject.certainty.intValue();
-            toolinfo << mProject.userDefines;
+            toolinfo << mProject.certainty.intValue() << ' ';
+            toolinfo << mProject.platformString() << ' ' << mProject.standards.getC() << ' ' << mProject.standards.getCPP();
+            for (const Check *check : plannedChecks())
+                toolinfo << ' ' << check->name();
+            toolinfo << userDefines;
+            if (fileSettings) {
+                for (const std::string &U : fileSettings->undefs)
+                    toolinfo << " -U" << U;
+                for (const std::string &I : fileSettings->includePaths)
+                    toolinfo << " -I" << I;
+                for (const std::string &include : fileSettings->userIncludes)
+                    toolinfo << " --include=" << include;
+                toolinfo << " -x" << static_cast<int>(fileSettings->language);
+            }
             mProject.nomsg.dump(toolinfo);
 
             // Calculate checksum so it can be compared with old checksum / future checksums
             const uint32_t checksum = preprocessor.calculateChecksum(tokens1, toolinfo.str());
             if (ctu->tryLoadFromFile(checksum)) {
+                if (mFilePerformance)
+                    mFilePerformance->cached = true;
                 for (auto it = ctu->mErrors.cbegin(); it != ctu->mErrors.cend(); ++it)
                     reportErr(*it);
                 return mExitCode;  // known results => no need to reanalyze file
@@ -466,12 +694,15 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
         preprocessor.setPlatformInfo(&tokens1);
 
         // Get configurations..
-        if ((mProject.checkAllConfigurations && mProject.userDefines.empty()) || mProject.force) {
+        // The build configuration of an imported file is checked exactly once
+        if ((!fileSettings && mProject.checkAllConfigurations && userDefines.empty()) || mProject.force) {
             Timer t("Preprocessor::getConfigs", mSettings.showtime);
             configurations = preprocessor.getConfigs(tokens1);
         } else {
-            configurations.insert(mProject.userDefines);
+            configurations.insert(userDefines);
         }
+        if (mFilePerformance)
+            mFilePerformance->configurations = configurations.size();
 
         if (mSettings.checkConfiguration) {
             for (const std::string &config : configurations)
@@ -506,14 +737,19 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
             }
         }
 
+        FileBudget budget(mSettings.maxFileTime, mSettings.maxFileMemory);
+
+        // Build only the analysis data the enabled checks need
+        const Tokenizer::AnalysisLayer analysisLayer = requiredAnalysisLayer();
+
         std::set<uint64_t> checksums0;
         std::set<uint64_t> checksums1;
         unsigned int checkCount = 0;
         bool hasValidConfig = false;
         std::vector<std::string> configurationError;
         for (const std::string &currCfg : configurations) {
-            // bail out if terminated
-            if (Settings::terminated())
+            // bail out if terminated or if there is no budget left for another configuration
+            if (Settings::terminated() || budget.exhausted(("Configuration " + currCfg).c_str()))
                 break;
 
             // Check only a few configurations (default 12), after that bail out, unless --force
@@ -521,9 +757,9 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
             if (!mProject.force && ++checkCount > mProject.maxConfigs)
                 break;
 
-            if (!mProject.userDefines.empty()) {
-                mCurrentConfig = mProject.userDefines;
-                const std::vector<std::string> v1(split(mProject.userDefines, ";"));
+            if (!userDefines.empty()) {
+                mCurrentConfig = userDefines;
+                const std::vector<std::string> v1(split(userDefines, ";"));
                 for (const std::string &cfg: split(currCfg, ";")) {
                     if (std::find(v1.begin(), v1.end(), cfg) == v1.end()) {
                         mCurrentConfig += ";" + cfg;
@@ -555,12 +791,18 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
 
             Tokenizer tokenizer(&mSettings, &mProject, this);
             tokenizer.setPreprocessor(&preprocessor);
+            tokenizer.list.setFileSettings(fileSettings);
+            if (budget.isLimited())
+                tokenizer.setBudget(&budget);
+            tokenizer.setAnalysisLayer(analysisLayer);
 
             try {
                 // Create tokens, skip rest of iteration if failed
                 {
                     Timer timer("Tokenizer::createTokens", mSettings.showtime);
+                    Timer timerPreprocess("Preprocessor::preprocess", mSettings.showtime);
                     simplecpp::TokenList tokensP = preprocessor.preprocess(tokens1, mCurrentConfig, files, true);
+                    timerPreprocess.stop();
                     tokenizer.createTokens(std::move(tokensP));
                 }
                 hasValidConfig = true;
@@ -601,14 +843,19 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
 
                 // dump xml if --dump
                 if ((mSettings.dump || !mProject.addons.empty()) && fdump.is_open()) {
-                    fdump << "<dump cfg=\"" << ErrorLogger::toxml(mCurrentConfig) << "\">" << std::endl;
-                    fdump << "  <standards>" << std::endl;
-                    fdump << "    <c version=\"" << mProject.standards.getC() << "\"/>" << std::endl;
-                    fdump << "    <cpp version=\"" << mProject.standards.getCPP() << "\"/>" << std::endl;
-                    fdump << "  </standards>" << std::endl;
-                    preprocessor.dump(fdump);
-                    tokenizer.dump(fdump);
-                    fdump << "</dump>" << std::endl;
+                    tokenizer.buildAnalysisLayers(Tokenizer::AnalysisLayer::ValueFlow);
+                    if (binaryDump)
+                        binaryDump->configuration(mCurrentConfig, mProject.standards, preprocessor, tokenizer);
+                    else {
+                        fdump << "<dump cfg=\"" << ErrorLogger::toxml(mCurrentConfig) << "\">\n";
+                        fdump << "  <standards>\n";
+                        fdump << "    <c version=\"" << mProject.standards.getC() << "\"/>\n";
+                        fdump << "    <cpp version=\"" << mProject.standards.getCPP() << "\"/>\n";
+                        fdump << "  </standards>\n";
+                        preprocessor.dump(fdump);
+                        tokenizer.dump(fdump);
+                        fdump << "</dump>\n";
+                    }
                 }
 
                 // Skip if we already met the same simplified token list
@@ -621,8 +868,15 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
                     }
                 }
 
+                if (mFilePerformance) {
+                    ++mFilePerformance->checkedConfigurations;
+                    for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next())
+                        ++mFilePerformance->tokens;
+                }
+
                 // Check normal tokens
                 checkNormalTokens(tokenizer);
+                performance.sampleMemory();
 
             } catch (const simplecpp::Output &o) {
                 // #error etc during preprocessing
@@ -672,13 +926,21 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
             reportErr(errmsg);
         }
 
+        if (budget.tier() != FileBudget::FULL)
+            analysisBudgetMessage(Path::toNativeSeparators(ctu->sourcefile), &budget);
+
         // dumped all configs, close root </dumps> element now
-        if ((mSettings.dump || !mProject.addons.empty()) && fdump.is_open())
-            fdump << "</dumps>" << std::endl;
+        if ((mSettings.dump || !mProject.addons.empty()) && fdump.is_open()) {
+            if (binaryDump)
+                binaryDump->finish();
+            else
+                fdump << "</dumps>" << std::endl;
+        }
 
         if (!mProject.addons.empty()) {
             fdump.close();
 
+            AddonExecutor::Task task;
             for (const std::string &addon : mProject.addons) {
                 struct AddonInfo addonInfo;
                 const std::string &failedToGetAddonInfo = addonInfo.getAddonInfo(addon, mSettings.exename);
@@ -687,48 +949,41 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
                     mExitCode = 1;
                     continue;
                 }
-                const std::string results =
-                    executeAddon(addonInfo, mSettings.addonPython, dumpFile, executeCommand);
-                std::istringstream istr(results);
-                std::string line;
-
-                while (std::getline(istr, line)) {
-                    if (line.compare(0,1,"{") != 0)
-                        continue;
-
-                    picojson::value res;
-                    std::istringstream istr2(line);
-                    istr2 >> res;
-                    if (!res.is<picojson::object>())
-                        continue;
-
-                    picojson::object obj = res.get<picojson::object>();
-
-                    const std::string fileName = obj["file"].get<std::string>();
-                    const int64_t lineNumber = obj["linenr"].get<int64_t>();
-                    const int64_t column = obj["column"].get<int64_t>();
-
-                    ErrorMessage errmsg;
-
-                    errmsg.callStack.emplace_back(ErrorMessage::FileLocation(fileName, lineNumber, column));
-
-                    errmsg.id = obj["addon"].get<std::string>() + "-" + obj["errorId"].get<std::string>();
-                    const std::string text = obj["message"].get<std::string>();
-                    errmsg.setmsg(text);
-                    const std::string severity = obj["severity"].get<std::string>();
-                    errmsg.severity = Severity::fromString(severity);
-                    if (errmsg.severity == Severity::SeverityType::none)
-                        continue;
-                    errmsg.file0 = fileName;
+                task.commands.push_back(addonCommand(addonInfo, mSettings.addonPython, dumpFile, executeCommand));
+            }
 
-                    reportErr(errmsg);
+            // A fixed dump file is overwritten by the next check
+            const bool defer = deferredAddons.isDeferred() && mSettings.dumpFile.empty();
+            const std::shared_ptr<AddonResults> results = std::make_shared<AddonResults>(mSettings, mProject, mUseGlobalSuppressions, defer ? *deferredAddons.logger : mErrorLogger, ctu, dumpFile, mErrorList);
+            task.report = [results](const ErrorMessage &msg) {
+                results->report(msg);
+            };
+            task.failed = [results](const std::string &msg) {
+                results->failed(msg);
+            };
+            task.cancellationToken = CancellationToken::current();
+
+            if (defer) {
+                const std::function<void(unsigned int)> done = deferredAddons.release();
+                task.done = [results, done]() {
+                    done(results->finish());
+                };
+                deferredAddons.executor->submit(std::move(task));
+            } else {
+                // The addons of this file still run in parallel
+                unsigned int processes = std::max<unsigned int>(1U, task.commands.size());
+                if (mSettings.addonJobs > 0)
+                    processes = std::min(processes, mSettings.addonJobs);
+                {
+                    AddonExecutor executor(processes, std::chrono::seconds(mSettings.addonTimeout));
+                    executor.submit(std::move(task));
                 }
+                mExitCode |= results->finish();
             }
-            std::remove(dumpFile.c_str());
-        }
-
-        if (!mProject.buildDir.empty())
+        } else if (!mProject.buildDir.empty() && !Settings::terminated()) {
+            // The results of an aborted check are incomplete
             ctu->writeFile();
+        }
     } catch (const std::runtime_error &e) {
         internalError(ctu->sourcefile, e.what());
     } catch (const std::bad_alloc &e) {
@@ -744,11 +999,16 @@ unsigned int CppCheck::checkCTU(CTU::CTUInfo* ctu, std::istream& fileStream)
 }
 
 void CppCheck::internalError(const std::string &filename, const std::string &msg)
+{
+    reportInternalError(mErrorLogger, mProject, filename, msg);
+}
+
+void CppCheck::reportInternalError(ErrorLogger &errorLogger, const Project &project, const std::string &filename, const std::string &msg)
 {
     const std::string fixedpath = Path::toNativeSeparators(filename);
     const std::string fullmsg("Bailing out from checking " + fixedpath + " since there was an internal error: " + msg);
 
-    if (mProject.severity.isEnabled(Severity::information)) {
+    if (project.severity.isEnabled(Severity::information)) {
         const ErrorMessage::FileLocation loc1(filename, 0, 0);
         std::list<ErrorMessage::FileLocation> callstack(1, loc1);
 
@@ -759,10 +1019,10 @@ void CppCheck::internalError(const std::string &filename, const std::string &msg
                             "internalError",
                             Certainty::safe);
 
-        mErrorLogger.reportErr(errmsg);
+        errorLogger.reportErr(errmsg);
     } else {
         // Report on stdout
-        mErrorLogger.reportOut(fullmsg);
+        errorLogger.reportOut(fullmsg);
     }
 }
 
@@ -783,27 +1043,31 @@ void CppCheck::checkNormalTokens(const Tokenizer &tokenizer)
 {
     Context ctx(this, &mSettings, &mProject, &tokenizer);
 
+    // Checks that can not report anything are not run and collect no whole program information
+    const std::vector<Check *>& checks = plannedChecks();
+
     // Analyse the tokens..
-    mCTU->parseTokens(&tokenizer);
-    for (const Check *check : Check::instances()) {
+    if (!checks.empty())
+        mCTU->parseTokens(&tokenizer);
+    for (const Check *check : checks) {
+        if (tokenizer.isBudgetExhausted("Whole program analysis"))
+            break;
         Check::FileInfo *fi = check->getFileInfo(ctx);
         if (fi != nullptr) {
             mCTU->addCheckInfo(check->name(), fi);
         }
     }
 
-    // call all "runChecks" in all registered Check classes
-    for (Check *check : Check::instances()) {
+    // call all "runChecks" in the planned Check classes
+    for (Check *check : checks) {
         if (Settings::terminated())
             return;
 
-        if (Tokenizer::isMaxTime())
+        const std::string phase = check->name() + "::runChecks";
+        if (tokenizer.isBudgetExhausted(phase.c_str()))
             return;
 
-        if (!mProject.checks.isEnabled(check->name()))
-            continue;
-
-        Timer timerRunChecks(check->name() + "::runChecks", mSettings.showtime);
+        Timer timerRunChecks(phase, mSettings.showtime);
         check->runChecks(ctx);
     }
 
@@ -813,6 +1077,42 @@ void CppCheck::checkNormalTokens(const Tokenizer &tokenizer)
 
 //---------------------------------------------------------------------------
 
+const std::vector<Check *>& CppCheck::plannedChecks()
+{
+    if (mChecksPlanned)
+        return mPlannedChecks;
+    mChecksPlanned = true;
+
+    // Nothing is reported with --suppress=*, unless the suppression itself is reported as unmatched
+    if (mUseGlobalSuppressions && mProject.nomsg.isEverythingSuppressed() && !mProject.severity.isEnabled(Severity::information))
+        return mPlannedChecks;
+
+    // Checks report errors regardless of the enabled severities
+    SimpleEnableGroup<Severity::SeverityType> severities = mProject.severity;
+    severities.enable(Severity::error);
+    if (mSettings.debugwarnings)
+        severities.enable(Severity::debug);
+
+    for (Check *check : Check::instances()) {
+        if (mProject.checks.isEnabled(check->name()) && check->severities().isAnyEnabled(severities))
+            mPlannedChecks.push_back(check);
+    }
+    return mPlannedChecks;
+}
+
+Tokenizer::AnalysisLayer CppCheck::requiredAnalysisLayer()
+{
+    // Debug output shows all analysis data
+    if (mSettings.debugnormal || mSettings.debugwarnings)
+        return Tokenizer::AnalysisLayer::ValueFlow;
+
+    // Whole program analysis information is collected from the symbol database
+    Tokenizer::AnalysisLayer layer = Tokenizer::AnalysisLayer::Symbols;
+    for (const Check *check : plannedChecks())
+        layer = std::max(layer, check->analysisLayer());
+    return layer;
+}
+
 bool CppCheck::hasRule(const std::string &tokenlist) const
 {
 #ifdef HAVE_RULES
@@ -1155,42 +1455,47 @@ void CppCheck::purgedConfigurationMessage(const std::string &file, const std::st
     reportErr(errmsg);
 }
 
-//---------------------------------------------------------------------------
-
-void CppCheck::reportErr(const ErrorMessage &msg)
+void CppCheck::analysisBudgetMessage(const std::string &file, const FileBudget *budget)
 {
-    mSuppressInternalErrorFound = false;
-
-    if (!mProject.library.reportErrors(msg.file0))
-        return;
+    std::list<ErrorMessage::FileLocation> loclist;
+    if (!file.empty()) {
+        ErrorMessage::FileLocation location;
+        location.setfile(file);
+        loclist.push_back(location);
+    }
 
-    const std::string errmsg = msg.toString(mSettings.verbose);
-    if (errmsg.empty())
-        return;
+    const bool exhausted = budget && budget->tier() == FileBudget::EXHAUSTED;
+    std::string msg = "The analysis of the file was " + std::string(exhausted ? "aborted" : "reduced") +
+                      " because its time or memory budget ran low (--max-file-time, --max-file-memory).\n"
+                      "The analysis of the file was " + std::string(exhausted ? "aborted" : "reduced") +
+                      " because its time or memory budget ran low (--max-file-time, --max-file-memory). Some findings might be missing.";
+    if (budget) {
+        for (const std::pair<FileBudget::Tier, std::string>& cut : budget->cuts())
+            msg += "\n" + cut.second + ": " + FileBudget::tierName(cut.first);
+    }
 
-    // Alert only about unique errors
-    if (std::find(mErrorList.begin(), mErrorList.end(), errmsg) != mErrorList.end())
+    // Report on stdout if information messages are disabled
+    if (!file.empty() && !mProject.severity.isEnabled(Severity::information)) {
+        mErrorLogger.reportOut(file + ": " + msg.substr(0, msg.find('\n')));
         return;
+    }
 
-    const Suppressions::ErrorMessage errorMessage = msg.toSuppressionsErrorMessage();
+    ErrorMessage errmsg(loclist,
+                        emptyString,
+                        Severity::information,
+                        msg,
+                        "analysisBudget",
+                        Certainty::safe);
 
-    if (mUseGlobalSuppressions) {
-        if (mProject.nomsg.isSuppressed(errorMessage)) {
-            mSuppressInternalErrorFound = true;
-            return;
-        }
-    } else {
-        if (mProject.nomsg.isSuppressedLocal(errorMessage)) {
-            mSuppressInternalErrorFound = true;
-            return;
-        }
-    }
+    reportErr(errmsg);
+}
 
-    if (!mProject.nofail.isSuppressed(errorMessage) && !mProject.nomsg.isSuppressed(errorMessage)) {
-        mExitCode = 1;
-    }
+//---------------------------------------------------------------------------
 
-    mErrorList.push_back(errmsg);
+void CppCheck::reportErr(const ErrorMessage &msg)
+{
+    if (!acceptError(msg, mSettings, mProject, mUseGlobalSuppressions, mErrorList, mExitCode, mSuppressInternalErrorFound))
+        return;
 
     mErrorLogger.reportErr(msg);
     if (mCTU)
@@ -1222,6 +1527,8 @@ void CppCheck::getErrorMessages()
     mTooManyConfigs = true;
     tooManyConfigsError("",0U);
 
+    analysisBudgetMessage("", nullptr);
+
     Context ctx(this, &s, &p);
 
     // call all "getErrorMessages" in all registered Check classes
@@ -1234,6 +1541,7 @@ void CppCheck::getErrorMessages()
 
 bool CppCheck::analyseWholeProgram(AnalyzerInformation& analyzerInformation)
 {
+    const CancellationToken::Scope cancellation(mCancellationToken);
     bool errors = false;
 
     Context ctx(this, &mSettings, &mProject);
@@ -1246,7 +1554,10 @@ bool CppCheck::analyseWholeProgram(AnalyzerInformation& analyzerInformation)
         combinedCTU.functionCalls.insert(combinedCTU.functionCalls.end(), it->functionCalls.begin(), it->functionCalls.end());
         combinedCTU.nestedCalls.insert(combinedCTU.nestedCalls.end(), it->nestedCalls.begin(), it->nestedCalls.end());
     }
-    for (Check* check : Check::instances())
+    for (Check* check : plannedChecks()) {
+        if (Settings::terminated())
+            break;
         errors |= check->analyseWholeProgram(&combinedCTU, analyzerInformation, ctx);
+    }
     return errors && (mExitCode > 0);
 }
@@ -29,13 +29,19 @@
 #include "settings.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <istream>
 #include <vector>
 #include <map>
 #include <string>
+#include <utility>
 
+class AddonExecutor;
+class FileBudget;
+class PerformanceReport;
 class Tokenizer;
+struct FilePerformance;
 
 /// @addtogroup Core
 /// @{
@@ -90,6 +96,41 @@ public:
       */
     unsigned int check(CTU::CTUInfo* ctu, const std::string &content);
 
+    /** Write the measurements of every checked file to given report (--perf-report) */
+    void setPerformanceReport(PerformanceReport* performanceReport) {
+        mPerformanceReport = performanceReport;
+    }
+
+    /**
+     * @brief Stop checking when given token is cancelled. Without a token,
+     * the token installed in the calling thread applies, if any.
+     */
+    void setCancellationToken(CancellationToken* cancellationToken) {
+        mCancellationToken = cancellationToken;
+    }
+
+    /**
+     * @brief Store the checksum of the tokens of each file included by the
+     * checked file in given map, see Preprocessor::calculateIncludeChecksums().
+     * The map is left empty if the file is not preprocessed.
+     */
+    void setIncludeChecksums(std::map<std::string, std::uint32_t>* includeChecksums) {
+        mIncludeChecksums = includeChecksums;
+    }
+
+    /**
+     * @brief Don't wait for the addons of the next check. check() returns
+     * once they are started on given executor. Their messages are reported
+     * through given logger, which must stay valid until done is called with
+     * their exit code after the last addon finished. done is also called,
+     * with 0, if the check does not start any addon.
+     */
+    void deferAddons(AddonExecutor* executor, ErrorLogger* logger, std::function<void(unsigned int)> done) {
+        mAddonExecutor = executor;
+        mAddonLogger = logger;
+        mAddonsDone = std::move(done);
+    }
+
     /**
      * @brief Get reference to current settings.
      * @return a reference to current settings
@@ -114,9 +155,13 @@ public:
 
     /**
      * @brief Terminate checking. The checking will be terminated as soon as possible.
+     * Only this instance is stopped if it has a cancellation token, otherwise all checks.
      */
     void terminate() {
-        Settings::terminate();
+        if (mCancellationToken)
+            mCancellationToken->cancel();
+        else
+            Settings::terminate();
     }
 
     /**
@@ -127,6 +172,14 @@ public:
 
     void tooManyConfigsError(const std::string &file, const std::size_t numberOfConfigurations);
     void purgedConfigurationMessage(const std::string &file, const std::string& configuration);
+    void analysisBudgetMessage(const std::string &file, const FileBudget *budget);
+
+    /**
+     * @brief Checks that can report anything with the enabled checks,
+     * severities and suppressions. The plan is made once, when it is
+     * first needed, so the settings must not change after that.
+     */
+    const std::vector<Check *>& plannedChecks();
 
     /** Analyse whole program, run this after all TUs has been scanned.
      * Return true if an error is reported.
@@ -138,8 +191,12 @@ private:
     /** Are there "simple" rules */
     bool hasRule(const std::string &tokenlist) const;
 
+    /** Analysis layers needed by the enabled checks and the requested output */
+    Tokenizer::AnalysisLayer requiredAnalysisLayer();
+
     /** @brief There has been an internal error => Report information message */
     void internalError(const std::string &filename, const std::string &msg);
+    static void reportInternalError(ErrorLogger &errorLogger, const Project &project, const std::string &filename, const std::string &msg);
 
     /**
      * @brief Check a file using stream
@@ -206,6 +263,24 @@ private:
     /** Are there too many configs? */
     bool mTooManyConfigs;
 
+    bool mChecksPlanned;
+    std::vector<Check *> mPlannedChecks;
+
+    PerformanceReport* mPerformanceReport;
+    /** Measurements of the file being checked, nullptr if there is no report */
+    FilePerformance* mFilePerformance;
+
+    CancellationToken* mCancellationToken;
+
+    std::map<std::string, std::uint32_t>* mIncludeChecksums;
+
+    /** Deferred addons of the next check, see deferAddons() */
+    AddonExecutor* mAddonExecutor;
+    ErrorLogger* mAddonLogger;
+    std::function<void(unsigned int)> mAddonsDone;
+
+    class AddonResults;
+
     /**
      * Execute a shell command and read the output from it. Returns true if command terminated successfully.
      */
@@ -302,7 +302,7 @@ void CTU::CTUInfo::parseTokens(const Tokenizer *tokenizer)
                     functionCall.callArgumentExpression = argtok->expressionString();
                     functionCall.callArgValue = value.intvalue;
                     functionCall.warning = !value.errorSeverity();
-                    for (const ErrorPathItem &i : value.errorPath) {
+                    for (const ErrorPathItem &i : ErrorPath(value.errorPath)) {
                         ErrorMessage::FileLocation loc;
                         loc.setfile(tokenizer->list.file(i.first));
                         loc.line = i.first->linenr();
@@ -30,6 +30,7 @@
 #include <map>
 #include <list>
 
+class FileSettings;
 class Function;
 
 /// @addtogroup Core
@@ -114,7 +115,8 @@ namespace CTU {
             , analyzerfile(analyzerfile_)
             , analyzerfileExists(false)
             , filesize(filesize_)
-            , mChecksum(false) {
+            , mChecksum(false)
+            , fileSettings(nullptr) {
         }
         ~CTUInfo();
         void addCheckInfo(const std::string& check, Check::FileInfo* fileInfo);
@@ -130,6 +132,9 @@ namespace CTU {
         std::size_t filesize;
         uint32_t mChecksum;
 
+        /** Build configuration of this file (--project), nullptr if the Project options apply */
+        const FileSettings* fileSettings;
+
         std::list<ErrorMessage> mErrors;
 
         std::list<FunctionCall> functionCalls;
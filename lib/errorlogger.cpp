@@ -22,6 +22,7 @@
 #include "cppcheck.h"
 #include "mathlib.h"
 #include "path.h"
+#include "progress.h"
 #include "token.h"
 #include "tokenlist.h"
 #include "utils.h"
@@ -567,6 +568,11 @@ std::string ErrorMessage::toString(bool verbose, const std::string &templateForm
     return result;
 }
 
+void ErrorLogger::reportProgressStatus(const ProgressStatus& status)
+{
+    reportStatus(status.files, status.totalFiles, status.bytes, status.totalBytes);
+}
+
 bool ErrorLogger::reportUnmatchedSuppressions(const std::list<Suppressions::Suppression> &unmatched)
 {
     bool err = false;
@@ -46,6 +46,7 @@ static const struct CWE CWE_EXPIRED_POINTER_DEREFERENCE(825U);
 
 class Token;
 class TokenList;
+struct ProgressStatus;
 
 namespace tinyxml2 {
     class XMLElement;
@@ -293,6 +294,13 @@ public:
         (void)sizetotal;
     }
 
+    /**
+     * Progress of the run with throughput and estimated remaining time.
+     * It is reported at a fixed interval from a dedicated thread, while
+     * the files are checked. Calls reportStatus() by default.
+     */
+    virtual void reportProgressStatus(const ProgressStatus& status);
+
     /**
      * Report unmatched suppressions
      * @param unmatched list of unmatched suppressions (from Settings::Suppressions::getUnmatched(Local|Global)Suppressions)
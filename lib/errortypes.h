@@ -24,8 +24,13 @@
 
 #include "config.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
 #include <list>
+#include <memory>
 #include <string>
+#include <utility>
 
 /// @addtogroup Core
 /// @{
@@ -116,6 +121,52 @@ namespace Severity {
     CPPCHECKLIB SeverityType fromString(const std::string &severity);
 }
 
+/** @brief Set of enabled flags of an enum, e.g. the enabled severities */
+template<typename T>
+class SimpleEnableGroup {
+    uint32_t flags = 0;
+public:
+    SimpleEnableGroup() = default;
+    SimpleEnableGroup(std::initializer_list<T> enabled) {
+        for (const T flag : enabled)
+            enable(flag);
+    }
+
+    uint32_t intValue() const {
+        return flags;
+    }
+    void clear() {
+        flags = 0;
+    }
+    void fill() {
+        flags = 0xFFFFFFFF;
+    }
+    void setEnabledAll(bool enabled) {
+        if (enabled)
+            fill();
+        else
+            clear();
+    }
+    bool isEnabled(T flag) const {
+        return (flags & (1U << (uint32_t)flag)) != 0;
+    }
+    void enable(T flag) {
+        flags |= (1U << (uint32_t)flag);
+    }
+    void disable(T flag) {
+        flags &= ~(1U << (uint32_t)flag);
+    }
+    bool isAnyEnabled(const SimpleEnableGroup<T>& other) const {
+        return (flags & other.flags) != 0;
+    }
+    void setEnabled(T flag, bool enabled) {
+        if (enabled)
+            enable(flag);
+        else
+            disable(flag);
+    }
+};
+
 struct CPPCHECKLIB CWE {
     explicit constexpr CWE(unsigned short cweId) : id(cweId) {}
     unsigned short id;
@@ -124,6 +175,62 @@ struct CPPCHECKLIB CWE {
 typedef std::pair<const Token *, std::string> ErrorPathItem;
 typedef std::list<ErrorPathItem> ErrorPath;
 
+/**
+ * @brief Immutable, structurally shared error path.
+ *
+ * The items form a chain from the last item back to the first one. Copies
+ * share the chain and appending only adds a node for the new item, so a
+ * copy costs a reference count increment, no matter how long the path is.
+ * Use ErrorPath to modify or iterate the items.
+ */
+class CPPCHECKLIB SharedErrorPath {
+public:
+    SharedErrorPath() {}
+    SharedErrorPath(const ErrorPath& errorPath) {
+        for (const ErrorPathItem& item : errorPath)
+            push_back(item);
+    }
+
+    bool empty() const {
+        return !mLast;
+    }
+    std::size_t size() const {
+        return mLast ? mLast->size : 0;
+    }
+    void clear() {
+        mLast.reset();
+    }
+
+    const ErrorPathItem& back() const {
+        return mLast->item;
+    }
+
+    void push_back(const ErrorPathItem& item) {
+        mLast = std::make_shared<const Node>(mLast, item);
+    }
+    void emplace_back(const Token* tok, std::string info) {
+        mLast = std::make_shared<const Node>(mLast, ErrorPathItem(tok, std::move(info)));
+    }
+
+    /** Items from first to last */
+    operator ErrorPath() const {
+        ErrorPath errorPath;
+        for (const Node* node = mLast.get(); node; node = node->previous.get())
+            errorPath.push_front(node->item);
+        return errorPath;
+    }
+
+private:
+    struct Node {
+        Node(const std::shared_ptr<const Node>& prev, ErrorPathItem i)
+            : previous(prev), item(std::move(i)), size(prev ? prev->size + 1 : 1) {}
+        std::shared_ptr<const Node> previous;
+        ErrorPathItem item;
+        std::size_t size;
+    };
+    std::shared_ptr<const Node> mLast;
+};
+
 /// @}
 //---------------------------------------------------------------------------
 #endif // errortypesH
@@ -24,8 +24,21 @@
 #include "utils.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 
+void FileLister::recursiveAddFiles(std::map<std::string, std::size_t> &files, const std::string &path, const std::set<std::string> &extra, const PathMatch& ignored)
+{
+    addFiles(files, path, extra, true, ignored);
+}
+
+void FileLister::addFiles(std::map<std::string, std::size_t> &files, const std::string &path, const std::set<std::string> &extra, bool recursive, const PathMatch& ignored)
+{
+    addFiles([&files](const std::string &file, std::size_t size) {
+        files[file] = size;
+    }, path, extra, recursive, ignored);
+}
+
 #ifdef _WIN32
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -56,12 +69,7 @@ static BOOL myFileExists(const std::string& path)
     return PathFileExistsA(path.c_str()) && !PathIsDirectoryA(path.c_str());
 }
 
-void FileLister::recursiveAddFiles(std::map<std::string, std::size_t> &files, const std::string &path, const std::set<std::string> &extra, const PathMatch& ignored)
-{
-    addFiles(files, path, extra, true, ignored);
-}
-
-void FileLister::addFiles(std::map<std::string, std::size_t> &files, const std::string &path, const std::set<std::string> &extra, bool recursive, const PathMatch& ignored)
+void FileLister::addFiles(const FileCallback &addFile, const std::string &path, const std::set<std::string> &extra, bool recursive, const PathMatch& ignored)
 {
     const std::string cleanedPath = Path::toNativeSeparators(path);
 
@@ -120,16 +128,16 @@ void FileLister::addFiles(std::map<std::string, std::size_t> &files, const std::
 
                 // Limitation: file sizes are assumed to fit in a 'size_t'
 #ifdef _WIN64
-                files[nativename] = (static_cast<std::size_t>(ffd.nFileSizeHigh) << 32) | ffd.nFileSizeLow;
+                addFile(nativename, (static_cast<std::size_t>(ffd.nFileSizeHigh) << 32) | ffd.nFileSizeLow);
 #else
-                files[nativename] = ffd.nFileSizeLow;
+                addFile(nativename, ffd.nFileSizeLow);
 #endif
             }
         } else {
             // Directory
             if (recursive) {
                 if (!ignored.match(fname))
-                    FileLister::recursiveAddFiles(files, fname, extra, ignored);
+                    addFiles(addFile, fname, extra, true, ignored);
             }
         }
     } while (FindNextFileA(hFind, &ffd) != FALSE);
@@ -147,6 +155,17 @@ bool FileLister::fileExists(const std::string &path)
     return (myFileExists(path) != FALSE);
 }
 
+std::chrono::system_clock::time_point FileLister::lastWriteTime(const std::string &path)
+{
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data))
+        return std::chrono::system_clock::time_point();
+    // FILETIME counts 100ns intervals since 1601-01-01
+    const std::uint64_t intervals = (static_cast<std::uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+    const std::chrono::nanoseconds sinceEpoch((intervals - 116444736000000000ULL) * 100U);
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(sinceEpoch));
+}
+
 
 #else
 
@@ -158,45 +177,83 @@ bool FileLister::fileExists(const std::string &path)
 #undef __STRICT_ANSI__
 #endif
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include <dirent.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    /**
+     * Lists directory trees on a few threads, a directory is the unit of
+     * work. Entries are looked up relative to the open directory and only
+     * stat'ed if their type is unknown, or for the size of accepted files.
+     */
+    class DirectoryWalker {
+    public:
+        DirectoryWalker(const std::set<std::string> &extra, bool recursive, const PathMatch &ignored)
+            : mExtra(extra), mRecursive(recursive), mIgnored(ignored), mActive(0) {
+        }
 
+        void walk(const std::string &root, const FileLister::FileCallback &addFile) {
+            mPending.push_back(root);
+            const unsigned int threadCount = std::max(1U, std::min(std::thread::hardware_concurrency(), 8U));
+            std::vector<std::thread> threads;
+            for (unsigned int i = 1; i < threadCount; ++i)
+                threads.emplace_back(&DirectoryWalker::work, this, std::cref(addFile));
+            work(addFile);
+            for (std::thread &thread : threads)
+                thread.join();
+        }
 
-static void addFiles2(std::map<std::string, std::size_t> &files,
-                      const std::string &path,
-                      const std::set<std::string> &extra,
-                      bool recursive,
-                      const PathMatch& ignored
-                     )
-{
-    struct stat file_stat;
-    if (stat(path.c_str(), &file_stat) != -1) {
-        if ((file_stat.st_mode & S_IFMT) == S_IFDIR) {
-            DIR * dir = opendir(path.c_str());
-            if (!dir)
+    private:
+        void work(const FileLister::FileCallback &addFile) {
+            std::vector<std::pair<std::string, std::size_t>> found;
+            std::vector<std::string> subdirectories;
+            std::unique_lock<std::mutex> lock(mMutex);
+            for (;;) {
+                mCondition.wait(lock, [this]() {
+                    return !mPending.empty() || mActive == 0;
+                });
+                // Nothing pending and nobody who could add more
+                if (mPending.empty())
+                    break;
+                const std::string path = std::move(mPending.back());
+                mPending.pop_back();
+                ++mActive;
+                lock.unlock();
+
+                readDirectory(path, found, subdirectories);
+
+                lock.lock();
+                --mActive;
+                for (const std::pair<std::string, std::size_t> &file : found)
+                    addFile(file.first, file.second);
+                found.clear();
+                mPending.insert(mPending.end(), std::make_move_iterator(subdirectories.begin()), std::make_move_iterator(subdirectories.end()));
+                subdirectories.clear();
+                mCondition.notify_all();
+            }
+        }
+
+        void readDirectory(const std::string &path, std::vector<std::pair<std::string, std::size_t>> &found, std::vector<std::string> &subdirectories) const {
+            const int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd == -1)
                 return;
+            DIR * dir = fdopendir(fd);
+            if (!dir) {
+                close(fd);
+                return;
+            }
 
-            dirent * dir_result;
-            // make sure we reserve enough space for the readdir_r() buffer;
-            // according to POSIX:
-            //   The storage pointed to by entry shall be large enough for a
-            //   dirent with an array of char d_name members containing at
-            //   least {NAME_MAX}+1 elements.
-            // on some platforms, d_name is not a static sized-array but
-            // a pointer to space usually reserved right after the dirent
-            // struct; the union here allows to reserve the space and to
-            // provide a pointer to the right type that can be passed where
-            // needed without casts
-            union {
-                dirent entry;
-                char buf[sizeof(*dir_result) + (sizeof(dir_result->d_name) > 1 ? 0 : NAME_MAX + 1)];
-            } dir_result_buffer;
-            UNUSED(dir_result_buffer.buf); // do not trigger cppcheck itself on the "unused buf"
             std::string new_path;
-            new_path.reserve(path.length() + 100);// prealloc some memory to avoid constant new/deletes in loop
-
-            while ((readdir_r(dir, &dir_result_buffer.entry, &dir_result) == 0) && (dir_result != nullptr)) {
-
+            while (const dirent * dir_result = readdir(dir)) {
                 if ((std::strcmp(dir_result->d_name, ".") == 0) ||
                     (std::strcmp(dir_result->d_name, "..") == 0))
                     continue;
@@ -204,40 +261,65 @@ static void addFiles2(std::map<std::string, std::size_t> &files,
                 new_path = path + '/' + dir_result->d_name;
 
 #if defined(_DIRENT_HAVE_D_TYPE) || defined(_BSD_SOURCE)
-                bool path_is_directory = (dir_result->d_type == DT_DIR || (dir_result->d_type == DT_UNKNOWN && FileLister::isDirectory(new_path)));
+                const bool path_is_directory = (dir_result->d_type == DT_DIR || (dir_result->d_type == DT_UNKNOWN && isDirectoryAt(fd, dir_result->d_name)));
 #else
-                bool path_is_directory = FileLister::isDirectory(new_path);
+                const bool path_is_directory = isDirectoryAt(fd, dir_result->d_name);
 #endif
                 if (path_is_directory) {
-                    if (recursive && !ignored.match(new_path)) {
-                        addFiles2(files, new_path, extra, recursive, ignored);
-                    }
-                } else {
-                    if (Path::acceptFile(new_path, extra) && !ignored.match(new_path)) {
-                        stat(new_path.c_str(), &file_stat);
-                        files[new_path] = file_stat.st_size;
-                    }
+                    if (mRecursive && !mIgnored.match(new_path))
+                        subdirectories.push_back(new_path);
+                } else if (Path::acceptFile(new_path, mExtra) && !mIgnored.match(new_path)) {
+                    struct stat file_stat;
+                    found.emplace_back(new_path, fstatat(fd, dir_result->d_name, &file_stat, 0) == 0 ? file_stat.st_size : 0);
                 }
             }
+            // closes fd as well
             closedir(dir);
-        } else
-            files[path] = file_stat.st_size;
-    }
+        }
+
+        static bool isDirectoryAt(int fd, const char *name) {
+            struct stat file_stat;
+            return (fstatat(fd, name, &file_stat, 0) != -1 && (file_stat.st_mode & S_IFMT) == S_IFDIR);
+        }
+
+        const std::set<std::string> &mExtra;
+        const bool mRecursive;
+        const PathMatch &mIgnored;
+
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        /** Directories that are not read yet */
+        std::vector<std::string> mPending;
+        /** Number of directories being read */
+        int mActive;
+    };
 }
 
-void FileLister::recursiveAddFiles(std::map<std::string, std::size_t> &files, const std::string &path, const std::set<std::string> &extra, const PathMatch& ignored)
+static void addFiles2(const FileLister::FileCallback &addFile,
+                      const std::string &path,
+                      const std::set<std::string> &extra,
+                      bool recursive,
+                      const PathMatch& ignored
+                     )
 {
-    addFiles(files, path, extra, true, ignored);
+    struct stat file_stat;
+    if (stat(path.c_str(), &file_stat) != -1) {
+        if ((file_stat.st_mode & S_IFMT) == S_IFDIR) {
+            DirectoryWalker walker(extra, recursive, ignored);
+            walker.walk(path, addFile);
+        } else
+            addFile(path, file_stat.st_size);
+    }
 }
 
-void FileLister::addFiles(std::map<std::string, std::size_t> &files, const std::string &path, const std::set<std::string> &extra, bool recursive, const PathMatch& ignored)
+void FileLister::addFiles(const FileCallback &addFile, const std::string &path, const std::set<std::string> &extra, bool recursive, const PathMatch& ignored)
 {
     if (!path.empty()) {
         std::string corrected_path = path;
         if (endsWith(corrected_path, '/'))
             corrected_path.erase(corrected_path.end() - 1);
 
-        addFiles2(files, corrected_path, extra, recursive, ignored);
+        addFiles2(addFile, corrected_path, extra, recursive, ignored);
     }
 }
 
@@ -253,4 +335,18 @@ bool FileLister::fileExists(const std::string &path)
     return (stat(path.c_str(), &file_stat) != -1 && (file_stat.st_mode & S_IFMT) == S_IFREG);
 }
 
+std::chrono::system_clock::time_point FileLister::lastWriteTime(const std::string &path)
+{
+    struct stat file_stat;
+    if (stat(path.c_str(), &file_stat) == -1)
+        return std::chrono::system_clock::time_point();
+#if defined(__APPLE__)
+    const struct timespec &mtime = file_stat.st_mtimespec;
+#else
+    const struct timespec &mtime = file_stat.st_mtim;
+#endif
+    const std::chrono::nanoseconds sinceEpoch(static_cast<std::int64_t>(mtime.tv_sec) * 1000000000 + mtime.tv_nsec);
+    return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(sinceEpoch));
+}
+
 #endif
@@ -22,7 +22,9 @@
 
 #include "config.h"
 
+#include <chrono>
 #include <cstddef>
+#include <functional>
 #include <map>
 #include <set>
 #include <string>
@@ -74,6 +76,36 @@ public:
      */
     static void addFiles(std::map<std::string, std::size_t> &files, const std::string &path, const std::set<std::string> &extra, bool recursive, const PathMatch& ignored);
 
+    /**
+     * @brief Receives the name and size of each file found. It is called
+     * from the threads that read the directories, but never concurrently.
+     */
+    typedef std::function<void(const std::string &file, std::size_t size)> FileCallback;
+
+    /**
+     * @brief Recursively add source files, passing them to given callback
+     * as soon as they are found.
+     * @param addFile called for each file found, a file may be reported
+     *   more than once when reachable from several paths
+     * @param path root path
+     * @param extra Extra file extensions
+     * @param ignored ignored paths
+     */
+    static void recursiveAddFiles(const FileCallback &addFile, const std::string &path, const std::set<std::string> &extra, const PathMatch& ignored) {
+        addFiles(addFile, path, extra, true, ignored);
+    }
+
+    /**
+     * @brief (Recursively) add source files, passing them to given callback
+     * as soon as they are found.
+     * @param addFile called for each file found
+     * @param path root path
+     * @param extra Extra file extensions
+     * @param recursive Enable recursion
+     * @param ignored ignored paths
+     */
+    static void addFiles(const FileCallback &addFile, const std::string &path, const std::set<std::string> &extra, bool recursive, const PathMatch& ignored);
+
     /**
      * @brief Is given path a directory?
      * @return returns true if the path is a directory
@@ -85,6 +117,12 @@ public:
       * @return true if path points to file and the file exists.
       */
     static bool fileExists(const std::string &path);
+
+    /**
+     * @brief Time of the last modification of given file
+     * @return the time, or a default constructed time point if the file does not exist
+     */
+    static std::chrono::system_clock::time_point lastWriteTime(const std::string &path);
 };
 
 /// @}
@@ -566,6 +566,9 @@ Analyzer::Action valueFlowGenericForward(Token* start,
         const ValuePtr<Analyzer>& a,
         const Project* project)
 {
+    // Each ValueFlow pass runs this for many scopes, so a cancelled check stops quickly
+    if (Settings::terminated())
+        return Analyzer::Action::None;
     ForwardTraversal ft{a, project};
     ft.updateRange(start, end);
     return ft.actions;
@@ -573,6 +576,8 @@ Analyzer::Action valueFlowGenericForward(Token* start,
 
 Analyzer::Action valueFlowGenericForward(Token* start, const ValuePtr<Analyzer>& a, const Project* project)
 {
+    if (Settings::terminated())
+        return Analyzer::Action::None;
     ForwardTraversal ft{a, project};
     ft.updateRecursive(start);
     return ft.actions;
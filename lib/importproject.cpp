@@ -0,0 +1,306 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "importproject.h"
+
+#include "path.h"
+#include "utils.h"
+
+#define PICOJSON_USE_INT64
+#include <picojson.h>
+
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+
+
+static std::string resolvePath(const std::string &directory, std::string path)
+{
+    path = Path::fromNativeSeparators(Path::removeQuotationMarks(path));
+    if (!Path::isAbsolute(path))
+        path = directory + path;
+    return Path::simplifyPath(path);
+}
+
+std::vector<std::string> ImportProject::splitCommand(const std::string &command)
+{
+    std::vector<std::string> args;
+    std::string arg;
+    bool inArg = false;
+    char quote = '\0';
+    for (std::string::size_type pos = 0; pos < command.size(); ++pos) {
+        const char c = command[pos];
+        if (quote) {
+            if (c == quote)
+                quote = '\0';
+            else if (c == '\\' && quote == '\"' && pos + 1 < command.size() && (command[pos+1] == '\"' || command[pos+1] == '\\'))
+                arg += command[++pos];
+            else
+                arg += c;
+        } else if (c == '\"' || c == '\'') {
+            quote = c;
+            inArg = true;
+        } else if (c == '\\' && pos + 1 < command.size()) {
+            arg += command[++pos];
+            inArg = true;
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            if (inArg)
+                args.push_back(arg);
+            arg.clear();
+            inArg = false;
+        } else {
+            arg += c;
+            inArg = true;
+        }
+    }
+    if (inArg)
+        args.push_back(arg);
+    return args;
+}
+
+void ImportProject::parseCommand(const std::vector<std::string> &args, const std::string &directory, FileSettings &fs)
+{
+    if (args.empty())
+        return;
+
+    const std::string compiler = Path::getFilenameExtensionInLowerCase(args[0]) == ".exe" ?
+                                 Path::stripDirectoryPart(args[0].substr(0, args[0].size() - 4)) :
+                                 Path::stripDirectoryPart(args[0]);
+    const bool msvc = (compiler == "cl" || compiler == "clang-cl");
+    if (compiler.find("++") != std::string::npos)
+        fs.language = Project::CPP;
+
+    for (std::size_t i = 1; i < args.size(); ++i) {
+        const std::string &arg = args[i];
+        // The rest of the command line is passed to the linker
+        if (msvc && (arg == "/link" || arg == "-link"))
+            break;
+        if (arg.size() < 2 || !(arg[0] == '-' || (msvc && arg[0] == '/')))
+            continue;
+        // Linker option, not the define EBUG
+        if (msvc && arg.compare(1, 5, "DEBUG") == 0 && (arg.size() == 6 || arg[6] == ':'))
+            continue;
+
+        // Value of an option that is either attached ("-DX") or the next argument ("-D X")
+        const std::function<std::string(std::string::size_type)> value = [&](std::string::size_type len) {
+            if (arg.size() > len)
+                return arg.substr(len);
+            if (i + 1 < args.size())
+                return args[++i];
+            return std::string();
+        };
+
+        if (arg.compare(1, 7, "include") == 0 || (msvc && arg.compare(1, 2, "FI") == 0)) {
+            const std::string file = value(arg[1] == 'i' ? 8 : 3);
+            if (!file.empty())
+                fs.userIncludes.push_back(resolvePath(directory, file));
+        } else if (arg.compare(1, 7, "isystem") == 0 || arg.compare(1, 6, "iquote") == 0 || arg.compare(1, 9, "idirafter") == 0 || arg[1] == 'I') {
+            const std::string::size_type len = (arg[1] == 'I') ? 2 : (arg[2] == 's') ? 8 : (arg[2] == 'q') ? 7 : 10;
+            std::string path = value(len);
+            if (path.empty())
+                continue;
+            path = resolvePath(directory, path);
+            if (!endsWith(path, '/'))
+                path += '/';
+            fs.includePaths.push_back(path);
+        } else if (arg[1] == 'D') {
+            std::string define = value(2);
+            if (define.empty())
+                continue;
+            if (define.find('=') == std::string::npos)
+                define += "=1";
+            if (!fs.defines.empty())
+                fs.defines += ';';
+            fs.defines += define;
+        } else if (arg[1] == 'U') {
+            const std::string undef = value(2);
+            if (!undef.empty())
+                fs.undefs.insert(undef);
+        } else if (arg[1] == 'x' && !msvc) {
+            const std::string lang = value(2);
+            if (lang == "c" || lang == "c-header")
+                fs.language = Project::C;
+            else if (lang == "c++" || lang == "c++-header")
+                fs.language = Project::CPP;
+        } else if (msvc && (arg == "/TP" || arg == "-TP")) {
+            fs.language = Project::CPP;
+        } else if (msvc && (arg == "/TC" || arg == "-TC")) {
+            fs.language = Project::C;
+        }
+    }
+}
+
+std::string ImportProject::importCompileCommands(std::istream &istr)
+{
+    picojson::value compileCommands;
+    istr >> compileCommands;
+    const std::string& jsonError = picojson::get_last_error();
+    if (!jsonError.empty())
+        return "Failed to parse compilation database: " + jsonError;
+    if (!compileCommands.is<picojson::array>())
+        return "Failed to parse compilation database: expected an array of commands.";
+
+    for (const picojson::value &command : compileCommands.get<picojson::array>()) {
+        if (!command.is<picojson::object>())
+            continue;
+        const picojson::object &obj = command.get<picojson::object>();
+
+        const picojson::object::const_iterator fileIt = obj.find("file");
+        if (fileIt == obj.cend() || !fileIt->second.is<std::string>())
+            continue;
+
+        std::string directory;
+        const picojson::object::const_iterator dirIt = obj.find("directory");
+        if (dirIt != obj.cend() && dirIt->second.is<std::string>())
+            directory = Path::fromNativeSeparators(dirIt->second.get<std::string>());
+        if (directory.empty())
+            directory = Path::fromNativeSeparators(Path::getCurrentPath());
+        if (!endsWith(directory, '/'))
+            directory += '/';
+
+        std::vector<std::string> args;
+        const picojson::object::const_iterator argsIt = obj.find("arguments");
+        const picojson::object::const_iterator cmdIt = obj.find("command");
+        if (argsIt != obj.cend() && argsIt->second.is<picojson::array>()) {
+            for (const picojson::value &arg : argsIt->second.get<picojson::array>()) {
+                if (arg.is<std::string>())
+                    args.push_back(arg.get<std::string>());
+            }
+        } else if (cmdIt != obj.cend() && cmdIt->second.is<std::string>()) {
+            args = splitCommand(cmdIt->second.get<std::string>());
+        }
+
+        // A file that is compiled several times is checked with its first command
+        const std::string file = resolvePath(directory, fileIt->second.get<std::string>());
+        if (fileSettings.find(file) != fileSettings.end())
+            continue;
+        parseCommand(args, directory, fileSettings[file]);
+    }
+
+    return emptyString;
+}
+
+std::string ImportProject::importCompileCommands(const std::string &filename, const std::string &buildDir)
+{
+    std::ifstream fin(filename);
+    if (!fin.is_open())
+        return "Failed to open compilation database '" + filename + "'.";
+    const std::string content((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
+    // The cache is valid as long as the database content is unchanged
+    const std::string checksum = Path::simplifyPath(Path::fromNativeSeparators(filename)) + ':' +
+                                 std::to_string(content.size()) + ':' +
+                                 std::to_string(std::hash<std::string>()(content));
+    const std::string cacheFile = buildDir.empty() ? emptyString : (buildDir + "/compile_commands.cache");
+    if (!cacheFile.empty()) {
+        std::ifstream fcache(cacheFile);
+        if (fcache.is_open() && loadCache(fcache, checksum))
+            return emptyString;
+        fileSettings.clear();
+    }
+
+    std::istringstream istr(content);
+    const std::string errmsg = importCompileCommands(istr);
+    if (errmsg.empty() && !cacheFile.empty()) {
+        std::ofstream fout(cacheFile);
+        saveCache(fout, checksum);
+    }
+    return errmsg;
+}
+
+void ImportProject::addProjectSettings(const Project &project)
+{
+    for (std::map<std::string, FileSettings>::iterator it = fileSettings.begin(); it != fileSettings.end(); ++it) {
+        FileSettings &fs = it->second;
+        if (!project.userDefines.empty())
+            fs.defines = fs.defines.empty() ? project.userDefines : (project.userDefines + ';' + fs.defines);
+        fs.undefs.insert(project.userUndefs.cbegin(), project.userUndefs.cend());
+        fs.includePaths.insert(fs.includePaths.begin(), project.includePaths.cbegin(), project.includePaths.cend());
+        fs.userIncludes.insert(fs.userIncludes.end(), project.userIncludes.cbegin(), project.userIncludes.cend());
+        if (project.enforcedLang != Project::None)
+            fs.language = project.enforcedLang;
+    }
+}
+
+const FileSettings* ImportProject::getFileSettings(const std::string &file) const
+{
+    const std::map<std::string, FileSettings>::const_iterator it = fileSettings.find(Path::simplifyPath(Path::fromNativeSeparators(file)));
+    return (it == fileSettings.cend()) ? nullptr : &it->second;
+}
+
+// Cache format: first line is the checksum, then one line per item:
+// F <file>, D <defines>, U <undef>, I <include path>, i <forced include>, L <language>
+bool ImportProject::loadCache(std::istream &istr, const std::string &checksum)
+{
+    std::string line;
+    if (!std::getline(istr, line) || line != checksum)
+        return false;
+
+    FileSettings *fs = nullptr;
+    while (std::getline(istr, line)) {
+        if (line.size() < 2 || line[1] != ' ')
+            return false;
+        const std::string value = line.substr(2);
+        if (line[0] == 'F') {
+            fs = &fileSettings[value];
+            continue;
+        }
+        if (!fs)
+            return false;
+        switch (line[0]) {
+        case 'D':
+            fs->defines = value;
+            break;
+        case 'U':
+            fs->undefs.insert(value);
+            break;
+        case 'I':
+            fs->includePaths.push_back(value);
+            break;
+        case 'i':
+            fs->userIncludes.push_back(value);
+            break;
+        case 'L':
+            fs->language = (value == "c") ? Project::C : (value == "c++") ? Project::CPP : Project::None;
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+void ImportProject::saveCache(std::ostream &ostr, const std::string &checksum) const
+{
+    ostr << checksum << '\n';
+    for (std::map<std::string, FileSettings>::const_iterator it = fileSettings.cbegin(); it != fileSettings.cend(); ++it) {
+        const FileSettings &fs = it->second;
+        ostr << "F " << it->first << '\n';
+        if (!fs.defines.empty())
+            ostr << "D " << fs.defines << '\n';
+        for (const std::string &undef : fs.undefs)
+            ostr << "U " << undef << '\n';
+        for (const std::string &path : fs.includePaths)
+            ostr << "I " << path << '\n';
+        for (const std::string &include : fs.userIncludes)
+            ostr << "i " << include << '\n';
+        if (fs.language != Project::None)
+            ostr << "L " << (fs.language == Project::C ? "c" : "c++") << '\n';
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef importprojectH
+#define importprojectH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+#include "settings.h"
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Build configuration of a single source file, as it is compiled.
+ * When a CTU has file settings, they replace the -D/-U/-I/--include options
+ * of the Project and only this one configuration is checked.
+ */
+class CPPCHECKLIB FileSettings {
+public:
+    FileSettings() : language(Project::None) {}
+
+    /** @brief defines in the same format as Project::userDefines, e.g. "A=1;B=1" */
+    std::string defines;
+    std::set<std::string> undefs;
+    std::vector<std::string> includePaths;
+    std::vector<std::string> userIncludes;
+    Project::Language language;
+};
+
+/**
+ * @brief Importer for compilation databases (compile_commands.json).
+ */
+class CPPCHECKLIB ImportProject {
+public:
+    /**
+     * Load a compilation database. If buildDir is given, the parsed result is
+     * cached there and reused as long as the database is unchanged.
+     * @return empty string on success, otherwise an error message
+     */
+    std::string importCompileCommands(const std::string &filename, const std::string &buildDir);
+
+    /** Parse compile_commands.json content */
+    std::string importCompileCommands(std::istream &istr);
+
+    /** Add the -D/-U/-I/--include options given on the command line to all files */
+    void addProjectSettings(const Project &project);
+
+    /** Lookup settings of given file, nullptr if the file is not part of the project */
+    const FileSettings* getFileSettings(const std::string &file) const;
+
+    /** Source files and their settings, keyed by simplified path */
+    std::map<std::string, FileSettings> fileSettings;
+
+    /** Interpret a compiler command line, relative paths are resolved against directory */
+    static void parseCommand(const std::vector<std::string> &args, const std::string &directory, FileSettings &fs);
+
+    /** Split a shell command line into arguments */
+    static std::vector<std::string> splitCommand(const std::string &command);
+
+private:
+    bool loadCache(std::istream &istr, const std::string &checksum);
+    void saveCache(std::ostream &ostr, const std::string &checksum) const;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // importprojectH
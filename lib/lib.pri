@@ -3,8 +3,10 @@
 include($$PWD/pcrerules.pri)
 include($$PWD/../externals/externals.pri)
 INCLUDEPATH += $$PWD
-HEADERS += $${PWD}/analyzerinfo.h \
+HEADERS += $${PWD}/addonexecutor.h \
+           $${PWD}/analyzerinfo.h \
            $${PWD}/astutils.h \
+           $${PWD}/binarydump.h \
            $${PWD}/check.h \
            $${PWD}/check64bit.h \
            $${PWD}/checkassert.h \
@@ -37,14 +39,18 @@ HEADERS += $${PWD}/analyzerinfo.h \
            $${PWD}/errortypes.h \
            $${PWD}/filelister.h \
            $${PWD}/forwardanalyzer.h \
+           $${PWD}/importproject.h \
            $${PWD}/library.h \
            $${PWD}/mathlib.h \
            $${PWD}/path.h \
            $${PWD}/pathanalysis.h \
            $${PWD}/pathmatch.h \
+           $${PWD}/perfreport.h \
            $${PWD}/platform.h \
            $${PWD}/preprocessor.h \
            $${PWD}/programmemory.h \
+           $${PWD}/progress.h \
+           $${PWD}/reportwriter.h \
            $${PWD}/reverseanalyzer.h \
            $${PWD}/settings.h \
            $${PWD}/suppressions.h \
@@ -58,8 +64,10 @@ HEADERS += $${PWD}/analyzerinfo.h \
            $${PWD}/utils.h \
            $${PWD}/valueflow.h
 
-SOURCES += $${PWD}/analyzerinfo.cpp \
+SOURCES += $${PWD}/addonexecutor.cpp \
+           $${PWD}/analyzerinfo.cpp \
            $${PWD}/astutils.cpp \
+           $${PWD}/binarydump.cpp \
            $${PWD}/check.cpp \
            $${PWD}/check64bit.cpp \
            $${PWD}/checkassert.cpp \
@@ -92,14 +100,18 @@ SOURCES += $${PWD}/analyzerinfo.cpp \
            $${PWD}/errortypes.cpp \
            $${PWD}/filelister.cpp \
            $${PWD}/forwardanalyzer.cpp \
+           $${PWD}/importproject.cpp \
            $${PWD}/library.cpp \
            $${PWD}/mathlib.cpp \
            $${PWD}/path.cpp \
            $${PWD}/pathanalysis.cpp \
            $${PWD}/pathmatch.cpp \
+           $${PWD}/perfreport.cpp \
            $${PWD}/platform.cpp \
            $${PWD}/preprocessor.cpp \
            $${PWD}/programmemory.cpp \
+           $${PWD}/progress.cpp \
+           $${PWD}/reportwriter.cpp \
            $${PWD}/reverseanalyzer.cpp \
            $${PWD}/settings.cpp \
            $${PWD}/suppressions.cpp \
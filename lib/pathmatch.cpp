@@ -26,13 +26,82 @@
 #include <cctype>
 #include <cstddef>
 
+PathMatch::Trie::Trie()
+{
+    mNodes.push_back(Node{{}, false});
+}
+
+std::size_t PathMatch::Trie::child(std::size_t node, char c) const
+{
+    for (const std::pair<char, std::size_t> &child : mNodes[node].children) {
+        if (child.first == c)
+            return child.second;
+    }
+    return 0;
+}
+
+void PathMatch::Trie::add(const std::string &mask, bool reversed)
+{
+    std::size_t node = 0;
+    for (std::size_t i = 0; i < mask.size(); ++i) {
+        const char c = reversed ? mask[mask.size() - 1 - i] : mask[i];
+        std::size_t next = child(node, c);
+        if (next == 0) {
+            next = mNodes.size();
+            mNodes[node].children.emplace_back(c, next);
+            mNodes.push_back(Node{{}, false});
+        }
+        node = next;
+    }
+    mNodes[node].terminal = true;
+}
+
+bool PathMatch::Trie::matchPrefix(const std::string &str, std::size_t pos, std::size_t end) const
+{
+    std::size_t node = 0;
+    for (;;) {
+        if (mNodes[node].terminal)
+            return true;
+        if (pos == end)
+            return false;
+        node = child(node, str[pos++]);
+        if (node == 0)
+            return false;
+    }
+}
+
+bool PathMatch::Trie::matchSuffix(const std::string &str) const
+{
+    std::size_t node = 0;
+    for (std::size_t pos = str.size();;) {
+        if (mNodes[node].terminal)
+            return true;
+        if (pos == 0)
+            return false;
+        node = child(node, str[--pos]);
+        if (node == 0)
+            return false;
+    }
+}
+
+void PathMatch::CompiledMasks::add(const std::string &mask)
+{
+    if (endsWith(mask, '/'))
+        directories.add(mask, false);
+    else
+        files.add(mask, true);
+}
+
 PathMatch::PathMatch(const std::vector<std::string> &excludedPaths, bool caseSensitive)
-    : mExcludedPaths(excludedPaths), mCaseSensitive(caseSensitive)
+    : mCaseSensitive(caseSensitive)
 {
-    if (!mCaseSensitive)
-        for (std::vector<std::string>::iterator i = mExcludedPaths.begin(); i != mExcludedPaths.end(); ++i)
-            std::transform(i->begin(), i->end(), i->begin(), ::tolower);
-    mWorkingDirectory.push_back(Path::getCurrentPath());
+    const std::vector<std::string> workingDirectory(1, Path::getCurrentPath());
+    for (std::string mask : excludedPaths) {
+        if (!mCaseSensitive)
+            std::transform(mask.begin(), mask.end(), mask.begin(), ::tolower);
+        mAbsoluteMasks.add(mask);
+        mRelativeMasks.add(Path::isAbsolute(mask) ? Path::getRelativePath(mask, workingDirectory) : mask);
+    }
 }
 
 bool PathMatch::match(const std::string &path) const
@@ -40,41 +109,33 @@ bool PathMatch::match(const std::string &path) const
     if (path.empty())
         return false;
 
-    for (std::vector<std::string>::const_iterator i = mExcludedPaths.begin(); i != mExcludedPaths.end(); ++i) {
-        const std::string excludedPath((!Path::isAbsolute(path) && Path::isAbsolute(*i)) ? Path::getRelativePath(*i, mWorkingDirectory) : *i);
+    const CompiledMasks &masks = Path::isAbsolute(path) ? mAbsoluteMasks : mRelativeMasks;
 
-        std::string findpath = Path::fromNativeSeparators(path);
-        if (!mCaseSensitive)
-            std::transform(findpath.begin(), findpath.end(), findpath.begin(), ::tolower);
-
-        // Filtering directory name
-        if (endsWith(excludedPath,'/')) {
-            if (!endsWith(findpath,'/'))
-                findpath = removeFilename(findpath);
-
-            if (excludedPath.length() > findpath.length())
-                continue;
-            // Match relative paths starting with mask
-            // -isrc matches src/foo.cpp
-            if (findpath.compare(0, excludedPath.size(), excludedPath) == 0)
-                return true;
-            // Match only full directory name in middle or end of the path
-            // -isrc matches myproject/src/ but does not match
-            // myproject/srcfiles/ or myproject/mysrc/
-            if (findpath.find("/" + excludedPath) != std::string::npos)
-                return true;
-        }
-        // Filtering filename
-        else {
-            if (excludedPath.length() > findpath.length())
-                continue;
-            // Check if path ends with mask
-            // -ifoo.cpp matches (./)foo.c, src/foo.cpp and proj/src/foo.cpp
-            // -isrc/file.cpp matches src/foo.cpp and proj/src/foo.cpp
-            if (findpath.compare(findpath.size() - excludedPath.size(), findpath.size(), excludedPath) == 0)
-                return true;
+    std::string findpath = Path::fromNativeSeparators(path);
+    if (!mCaseSensitive)
+        std::transform(findpath.begin(), findpath.end(), findpath.begin(), ::tolower);
 
-        }
+    // Filtering filename
+    // Check if path ends with mask
+    // -ifoo.cpp matches (./)foo.c, src/foo.cpp and proj/src/foo.cpp
+    // -isrc/file.cpp matches src/foo.cpp and proj/src/foo.cpp
+    if (masks.files.matchSuffix(findpath))
+        return true;
+
+    // Filtering directory name
+    if (masks.directories.empty())
+        return false;
+    const std::size_t dirEnd = endsWith(findpath, '/') ? findpath.size() : (findpath.find_last_of('/') + 1);
+    // Match relative paths starting with mask
+    // -isrc matches src/foo.cpp
+    if (masks.directories.matchPrefix(findpath, 0, dirEnd))
+        return true;
+    // Match only full directory name in middle or end of the path
+    // -isrc matches myproject/src/ but does not match
+    // myproject/srcfiles/ or myproject/mysrc/
+    for (std::size_t pos = findpath.find('/'); pos < dirEnd; pos = findpath.find('/', pos + 1)) {
+        if (masks.directories.matchPrefix(findpath, pos + 1, dirEnd))
+            return true;
     }
     return false;
 }
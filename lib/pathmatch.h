@@ -22,7 +22,9 @@
 
 #include "config.h"
 
+#include <cstddef>
 #include <string>
+#include <utility>
 #include <vector>
 
 /// @addtogroup CLI
@@ -59,9 +61,47 @@ protected:
     static std::string removeFilename(const std::string &path);
 
 private:
-    std::vector<std::string> mExcludedPaths;
+    /** @brief Character trie of masks */
+    class Trie {
+    public:
+        Trie();
+
+        void add(const std::string &mask, bool reversed);
+
+        bool empty() const {
+            return mNodes.size() == 1 && !mNodes[0].terminal;
+        }
+
+        /** Is a mask a prefix of the characters [pos, end) of str? */
+        bool matchPrefix(const std::string &str, std::size_t pos, std::size_t end) const;
+
+        /** Is a reversed mask a suffix of str? */
+        bool matchSuffix(const std::string &str) const;
+
+    private:
+        struct Node {
+            std::vector<std::pair<char, std::size_t>> children;
+            bool terminal;
+        };
+
+        std::size_t child(std::size_t node, char c) const;
+
+        std::vector<Node> mNodes;
+    };
+
+    /** @brief Masks compiled into tries, directory masks match prefixes, file masks match suffixes */
+    struct CompiledMasks {
+        Trie directories;
+        Trie files;
+
+        void add(const std::string &mask);
+    };
+
+    /** Masks as given, used for absolute paths */
+    CompiledMasks mAbsoluteMasks;
+    /** Absolute masks relative to the working directory, used for relative paths */
+    CompiledMasks mRelativeMasks;
     bool mCaseSensitive;
-    std::vector<std::string> mWorkingDirectory;
 };
 
 /// @}
@@ -0,0 +1,92 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "perfreport.h"
+
+#include "utils.h"
+
+#include <ctime>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+
+std::string FilePerformance::toJson() const
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(6);
+    out << "{\"file\":" << toJsonString(file)
+        << ",\"size\":" << size
+        << ",\"cached\":" << (cached ? "true" : "false")
+        << ",\"wall\":" << wallSeconds
+        << ",\"cpu\":" << cpuSeconds;
+    if (memoryMeasured)
+        out << ",\"memoryGrowth\":" << memoryGrowth;
+    out << ",\"rawTokens\":" << rawTokens
+        << ",\"tokens\":" << tokens
+        << ",\"configurations\":" << configurations
+        << ",\"checkedConfigurations\":" << checkedConfigurations
+        << ",\"phases\":{";
+    bool first = true;
+    for (const std::pair<const std::string, PhaseTimes::Data>& phase : phases.mPhases) {
+        if (!first)
+            out << ',';
+        first = false;
+        out << toJsonString(phase.first)
+            << ":{\"self\":" << phase.second.mSeconds
+            << ",\"total\":" << phase.second.fullSeconds()
+            << ",\"calls\":" << phase.second.mNumberOfResults << '}';
+    }
+    out << "}}";
+    return out.str();
+}
+
+double FilePerformance::threadCpuSeconds()
+{
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        return 0;
+    // 100 ns units
+    const uint64_t k = (static_cast<uint64_t>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    const uint64_t u = (static_cast<uint64_t>(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    return (k + u) / 1e7;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return 0;
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#else
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+#endif
+}
+
+
+void PerformanceReport::write(const FilePerformance& record)
+{
+    const std::string line = record.toJson();
+    std::lock_guard<std::mutex> lock(mMutex);
+    mOut << line << std::endl;
+}
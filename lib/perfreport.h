@@ -0,0 +1,101 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef perfreportH
+#define perfreportH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+#include "timer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+/// @addtogroup Core
+/// @{
+
+/** @brief Measurements of the analysis of one file (--perf-report) */
+struct CPPCHECKLIB FilePerformance {
+    FilePerformance()
+        : size(0)
+        , rawTokens(0)
+        , tokens(0)
+        , configurations(0)
+        , checkedConfigurations(0)
+        , cached(false)
+        , wallSeconds(0)
+        , cpuSeconds(0)
+        , memoryMeasured(false)
+        , memoryGrowth(0) {
+    }
+
+    std::string file;
+    std::size_t size;
+    /** Tokens of the source file, before preprocessing */
+    std::size_t rawTokens;
+    /** Tokens after simplification, summed over the checked configurations */
+    std::size_t tokens;
+    /** Configurations found by the preprocessor */
+    std::size_t configurations;
+    /** Configurations that were tokenized and checked */
+    std::size_t checkedConfigurations;
+    /** Results were loaded from the build dir */
+    bool cached;
+    double wallSeconds;
+    /** CPU time of the checking thread */
+    double cpuSeconds;
+    /** The memory is measured for the whole process, so not when files are checked in parallel (-j) */
+    bool memoryMeasured;
+    /** Peak growth of the resident memory of the process in bytes, sampled between the phases */
+    int64_t memoryGrowth;
+    /** Wall clock time of the phases, by Timer name */
+    PhaseTimes phases;
+
+    /** One line JSON object */
+    std::string toJson() const;
+
+    /** CPU time consumed by the calling thread so far, in seconds */
+    static double threadCpuSeconds();
+};
+
+/**
+ * @brief Writes a FilePerformance record per file, one JSON object per
+ * line. Every record is flushed when it is written, so the report of an
+ * aborted run is usable up to the last checked file.
+ */
+class CPPCHECKLIB PerformanceReport {
+public:
+    explicit PerformanceReport(std::ostream& out) : mOut(out) {}
+    PerformanceReport(const PerformanceReport&) = delete;
+    void operator=(const PerformanceReport&) = delete;
+
+    /** Thread safe */
+    void write(const FilePerformance& record);
+
+private:
+    std::ostream& mOut;
+    std::mutex mMutex;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // perfreportH
@@ -21,6 +21,7 @@
 #include "preprocessor.h"
 
 #include "errorlogger.h"
+#include "importproject.h"
 #include "library.h"
 #include "path.h"
 #include "settings.h"
@@ -64,10 +65,20 @@ std::atomic<bool> Preprocessor::missingSystemIncludeFlag;
 
 char Preprocessor::macroChar = char(1);
 
-Preprocessor::Preprocessor(const Settings& settings, Project& project, ErrorLogger *errorLogger) : mSettings(settings), mProject(project), mErrorLogger(errorLogger)
+Preprocessor::Preprocessor(const Settings& settings, Project& project, ErrorLogger *errorLogger) : mSettings(settings), mProject(project), mFileSettings(nullptr), mErrorLogger(errorLogger)
 {
 }
 
+const std::string& Preprocessor::userDefines() const
+{
+    return mFileSettings ? mFileSettings->defines : mProject.userDefines;
+}
+
+const std::set<std::string>& Preprocessor::userUndefs() const
+{
+    return mFileSettings ? mFileSettings->undefs : mProject.userUndefs;
+}
+
 Preprocessor::~Preprocessor()
 {
     for (std::map<std::string, simplecpp::TokenList *>::iterator it = mTokenLists.begin(); it != mTokenLists.end(); ++it)
@@ -494,11 +505,11 @@ std::set<std::string> Preprocessor::getConfigs(const simplecpp::TokenList &token
 
     std::set<std::string> defined = { "__cplusplus" };
 
-    ::getConfigs(tokens, defined, mProject.userDefines, mProject.userUndefs, ret);
+    ::getConfigs(tokens, defined, userDefines(), userUndefs(), ret);
 
     for (std::map<std::string, simplecpp::TokenList*>::const_iterator it = mTokenLists.begin(); it != mTokenLists.end(); ++it) {
         if (!mProject.configurationExcluded(it->first))
-            ::getConfigs(*(it->second), defined, mProject.userDefines, mProject.userUndefs, ret);
+            ::getConfigs(*(it->second), defined, userDefines(), userUndefs(), ret);
     }
 
     return ret;
@@ -516,7 +527,7 @@ void Preprocessor::preprocess(std::istream &istr, std::map<std::string, std::str
     const std::set<std::string> configs = getConfigs(tokens1);
 
     for (const std::string &cfg : configs) {
-        if (mProject.userUndefs.find(cfg) == mProject.userUndefs.end()) {
+        if (userUndefs().find(cfg) == userUndefs().end()) {
             result[cfg] = getcode(tokens1, cfg, files, false);
         }
     }
@@ -584,11 +595,11 @@ static void splitcfg(const std::string &cfg, std::vector<std::string> &defines,
     }
 }
 
-static simplecpp::DUI createDUI(const Project & mProject, const std::string &cfg, const std::string &filename)
+static simplecpp::DUI createDUI(const Project & mProject, const FileSettings *fileSettings, const std::string &cfg, const std::string &filename)
 {
     simplecpp::DUI dui;
 
-    splitcfg(mProject.userDefines, dui.defines, "1");
+    splitcfg(fileSettings ? fileSettings->defines : mProject.userDefines, dui.defines, "1");
     if (!cfg.empty())
         splitcfg(cfg, dui.defines, emptyString);
 
@@ -607,9 +618,16 @@ static simplecpp::DUI createDUI(const Project & mProject, const std::string &cfg
         dui.defines.push_back(s);
     }
 
-    if (Path::isCPP(filename))
+    if ((fileSettings && fileSettings->language != Project::None) ? (fileSettings->language == Project::CPP) : Path::isCPP(filename))
         dui.defines.emplace_back("__cplusplus");
 
+    if (fileSettings) {
+        dui.undefined = fileSettings->undefs;
+        dui.includePaths = fileSettings->includePaths;
+        dui.includes = fileSettings->userIncludes;
+        return dui;
+    }
+
     dui.undefined = mProject.userUndefs; // -U
     dui.includePaths = mProject.includePaths; // -I
     dui.includes = mProject.userIncludes;  // --include
@@ -637,7 +655,7 @@ static bool hasErrors(const simplecpp::OutputList &outputList)
 
 void Preprocessor::handleErrors(const simplecpp::OutputList& outputList, bool throwError)
 {
-    const bool showerror = (!mProject.userDefines.empty() && !mProject.force);
+    const bool showerror = (!userDefines().empty() && !mProject.force);
     reportOutput(outputList, showerror);
     if (throwError) {
         for (const simplecpp::Output& output : outputList) {
@@ -659,7 +677,7 @@ void Preprocessor::handleErrors(const simplecpp::OutputList& outputList, bool th
 
 bool Preprocessor::loadFiles(const simplecpp::TokenList &rawtokens, std::vector<std::string> &files)
 {
-    const simplecpp::DUI dui = createDUI(mProject, emptyString, files[0]);
+    const simplecpp::DUI dui = createDUI(mProject, mFileSettings, emptyString, files[0]);
 
     simplecpp::OutputList outputList;
     mTokenLists = simplecpp::load(rawtokens, files, dui, &outputList);
@@ -697,7 +715,7 @@ void Preprocessor::setPlatformInfo(simplecpp::TokenList *tokens) const
 
 simplecpp::TokenList Preprocessor::preprocess(const simplecpp::TokenList &tokens1, const std::string &cfg, std::vector<std::string> &files, bool throwError)
 {
-    const simplecpp::DUI dui = createDUI(mProject, cfg, files[0]);
+    const simplecpp::DUI dui = createDUI(mProject, mFileSettings, cfg, files[0]);
 
     simplecpp::OutputList outputList;
     std::list<simplecpp::MacroUsage> macroUsage;
@@ -908,7 +926,7 @@ void Preprocessor::dump(std::ostream &out) const
     // Create a xml directive dump.
     // The idea is not that this will be readable for humans. It's a
     // data dump that 3rd party tools could load and get useful info from.
-    out << "  <directivelist>" << std::endl;
+    out << "  <directivelist>\n";
 
     for (const Directive &dir : mDirectives) {
         out << "    <directive "
@@ -916,9 +934,9 @@ void Preprocessor::dump(std::ostream &out) const
             << "linenr=\"" << dir.linenr << "\" "
             // str might contain characters such as '"', '<' or '>' which
             // could result in invalid XML, so run it through toxml().
-            << "str=\"" << ErrorLogger::toxml(dir.str) << "\"/>" << std::endl;
+            << "str=\"" << ErrorLogger::toxml(dir.str) << "\"/>\n";
     }
-    out << "  </directivelist>" << std::endl;
+    out << "  </directivelist>\n";
 }
 
 static const std::uint32_t crc32Table[] = {
@@ -974,23 +992,51 @@ static void crc32(const std::string &data, uint32_t& crc)
     }
 }
 
+static void crc32(unsigned int value, uint32_t& crc)
+{
+    for (int i = 0; i < 4; ++i) {
+        crc = crc32Table[(crc ^ value) & 0xFF] ^ (crc >> 8);
+        value >>= 8;
+    }
+}
+
+static void crc32(const simplecpp::TokenList &tokens, uint32_t& crc)
+{
+    for (const simplecpp::Token *tok = tokens.cfront(); tok; tok = tok->next) {
+        if (tok->comment)
+            continue;
+        // The results are reported at the positions of the tokens
+        crc32(tok->location.line, crc);
+        crc32(tok->location.col, crc);
+        crc32(tok->str(), crc);
+    }
+}
+
 uint32_t Preprocessor::calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const
 {
     std::uint32_t crc = ~0U;
     crc32(toolinfo, crc);
-    for (const simplecpp::Token *tok = tokens1.cfront(); tok; tok = tok->next) {
-        if (!tok->comment)
-            crc32(tok->str(), crc);
-    }
-    for (std::map<std::string, simplecpp::TokenList *>::const_iterator it = mTokenLists.begin(); it != mTokenLists.end(); ++it) {
-        for (const simplecpp::Token *tok = it->second->cfront(); tok; tok = tok->next) {
-            if (!tok->comment)
-                crc32(tok->str(), crc);
-        }
-    }
+    crc32(tokens1, crc);
+    for (std::map<std::string, simplecpp::TokenList *>::const_iterator it = mTokenLists.begin(); it != mTokenLists.end(); ++it)
+        crc32(*it->second, crc);
     return crc ^ ~0U;
 }
 
+uint32_t Preprocessor::calculateChecksum(const simplecpp::TokenList &tokens)
+{
+    std::uint32_t crc = ~0U;
+    crc32(tokens, crc);
+    return crc ^ ~0U;
+}
+
+std::map<std::string, uint32_t> Preprocessor::calculateIncludeChecksums() const
+{
+    std::map<std::string, uint32_t> checksums;
+    for (std::map<std::string, simplecpp::TokenList *>::const_iterator it = mTokenLists.begin(); it != mTokenLists.end(); ++it)
+        checksums[it->first] = calculateChecksum(*it->second);
+    return checksums;
+}
+
 void Preprocessor::simplifyPragmaAsm(simplecpp::TokenList *tokenList)
 {
     Preprocessor::simplifyPragmaAsmPrivate(tokenList);
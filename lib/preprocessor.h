@@ -34,6 +34,7 @@
 #include <vector>
 
 class ErrorLogger;
+class FileSettings;
 class Settings;
 
 /**
@@ -171,7 +172,8 @@ public:
     void validateCfgError(const std::string &file, const unsigned int line, const std::string &cfg, const std::string &macro);
 
     /**
-     * Calculate CRC32 checksum. Using toolinfo, tokens1, filedata.
+     * Calculate CRC32 checksum. Using toolinfo and the tokens of tokens1 and the included files
+     * with their positions, so that results are only reused where they are reported at the same lines.
      *
      * @param tokens1    Sourcefile tokens
      * @param toolinfo   Arbitrary extra toolinfo
@@ -179,6 +181,12 @@ public:
      */
     uint32_t calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const;
 
+    /** Checksum of the tokens of a single file, as included by calculateChecksum() */
+    static uint32_t calculateChecksum(const simplecpp::TokenList &tokens);
+
+    /** Checksum of the tokens of each loaded include file, by file name */
+    std::map<std::string, uint32_t> calculateIncludeChecksums() const;
+
     void simplifyPragmaAsm(simplecpp::TokenList *tokenList);
 
 private:
@@ -202,6 +210,11 @@ public:
         mFile0 = f;
     }
 
+    /** Use the build configuration of the checked file instead of the Project options */
+    void setFileSettings(const FileSettings *fileSettings) {
+        mFileSettings = fileSettings;
+    }
+
     /**
      * dump all directives present in source file
      */
@@ -213,8 +226,12 @@ private:
     void missingInclude(const std::string &filename, unsigned int linenr, const std::string &header, HeaderTypes headerType);
     void error(const std::string &filename, unsigned int linenr, const std::string &msg);
 
+    const std::string& userDefines() const;
+    const std::set<std::string>& userUndefs() const;
+
     const Settings& mSettings;
     Project& mProject;
+    const FileSettings *mFileSettings;
     ErrorLogger *mErrorLogger;
 
     /** list of all directives met while preprocessing file */
@@ -5,17 +5,19 @@
 #include "symboldatabase.h"
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <memory>
+#include <vector>
 
 void ProgramMemory::setValue(unsigned int varid, const ValueFlow::Value &value)
 {
-    values[varid] = value;
+    values.write()[varid] = value;
 }
 
 const ValueFlow::Value* ProgramMemory::getValue(unsigned int varid) const
 {
-    const ProgramMemory::Map::const_iterator it = values.find(varid);
-    const bool found = it != values.end() && !it->second.isImpossible();
+    const ProgramMemory::Map::const_iterator it = values->find(varid);
+    const bool found = it != values->end() && !it->second.isImpossible();
     if (found)
         return &it->second;
     else
@@ -34,7 +36,7 @@ bool ProgramMemory::getIntValue(unsigned int varid, MathLib::bigint* result) con
 
 void ProgramMemory::setIntValue(unsigned int varid, MathLib::bigint value)
 {
-    values[varid] = ValueFlow::Value(value);
+    values.write()[varid] = ValueFlow::Value(value);
 }
 
 bool ProgramMemory::getTokValue(unsigned int varid, const Token** result) const
@@ -59,12 +61,12 @@ bool ProgramMemory::getContainerSizeValue(unsigned int varid, MathLib::bigint* r
 
 void ProgramMemory::setUnknown(unsigned int varid)
 {
-    values[varid].valueType = ValueFlow::Value::ValueType::UNINIT;
+    values.write()[varid].valueType = ValueFlow::Value::ValueType::UNINIT;
 }
 
 bool ProgramMemory::hasValue(unsigned int varid)
 {
-    return values.find(varid) != values.end();
+    return values->find(varid) != values->end();
 }
 
 void ProgramMemory::swap(ProgramMemory &pm)
@@ -79,19 +81,34 @@ void ProgramMemory::clear()
 
 bool ProgramMemory::empty() const
 {
-    return values.empty();
+    return values->empty();
 }
 
 void ProgramMemory::replace(const ProgramMemory &pm)
 {
-    for (auto&& p:pm.values)
-        values[p.first] = p.second;
+    if (values.shares(pm.values) || pm.empty())
+        return;
+    if (empty()) {
+        values = pm.values;
+        return;
+    }
+    Map &map = values.write();
+    for (auto&& p:*pm.values)
+        map[p.first] = p.second;
 }
 
 void ProgramMemory::insert(const ProgramMemory &pm)
 {
-    for (auto&& p:pm.values)
-        values.insert(p);
+    if (values.shares(pm.values) || pm.empty())
+        return;
+    if (empty()) {
+        values = pm.values;
+        return;
+    }
+    for (auto&& p:*pm.values) {
+        if (values->find(p.first) == values->end())
+            values.write().insert(p);
+    }
 }
 
 bool conditionIsFalse(const Token *condition, const ProgramMemory &programMemory)
@@ -250,13 +267,13 @@ static void fillProgramMemoryFromAssignments(ProgramMemory& pm, const Token* tok
 
 static void removeModifiedVars(ProgramMemory& pm, const Token* tok, const Token* origin)
 {
-    for (auto i = pm.values.begin(), last = pm.values.end(); i != last;) {
-        if (isVariableChanged(origin, tok, i->first, false, nullptr, true)) {
-            i = pm.values.erase(i);
-        } else {
-            ++i;
-        }
+    std::vector<unsigned int> modified;
+    for (auto&& p:*pm.values) {
+        if (isVariableChanged(origin, tok, p.first, false, nullptr, true))
+            modified.push_back(p.first);
     }
+    for (unsigned int varid : modified)
+        pm.values.write().erase(varid);
 }
 
 static ProgramMemory getInitialProgramState(const Token* tok,
@@ -276,7 +293,7 @@ static ProgramMemory getInitialProgramState(const Token* tok,
 void ProgramMemoryState::insert(const ProgramMemory &pm, const Token* origin)
 {
     if (origin)
-        for (auto&& p:pm.values)
+        for (auto&& p:*pm.values)
             origins.insert(std::make_pair(p.first, origin));
     state.insert(pm);
 }
@@ -284,7 +301,7 @@ void ProgramMemoryState::insert(const ProgramMemory &pm, const Token* origin)
 void ProgramMemoryState::replace(const ProgramMemory &pm, const Token* origin)
 {
     if (origin)
-        for (auto&& p:pm.values)
+        for (auto&& p:*pm.values)
             origins[p.first] = origin;
     state.replace(pm);
 }
@@ -315,13 +332,14 @@ void ProgramMemoryState::assume(const Token* tok, bool b)
 
 void ProgramMemoryState::removeModifiedVars(const Token* tok)
 {
-    for (auto i = state.values.begin(), last = state.values.end(); i != last;) {
-        if (isVariableChanged(origins[i->first], tok, i->first, false, nullptr, true)) {
-            origins.erase(i->first);
-            i = state.values.erase(i);
-        } else {
-            ++i;
-        }
+    std::vector<unsigned int> modified;
+    for (auto&& p:*state.values) {
+        if (isVariableChanged(origins[p.first], tok, p.first, false, nullptr, true))
+            modified.push_back(p.first);
+    }
+    for (unsigned int varid : modified) {
+        origins.erase(varid);
+        state.values.write().erase(varid);
     }
 }
 
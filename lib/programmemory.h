@@ -12,7 +12,8 @@ class Token;
 
 struct ProgramMemory {
     using Map = std::unordered_map<unsigned int, ValueFlow::Value>;
-    Map values;
+    /** Shared between copies until modified, so forking a program memory is cheap */
+    CopyOnWrite<Map> values;
 
     void setValue(unsigned int varid, const ValueFlow::Value &value);
     const ValueFlow::Value* getValue(unsigned int varid) const;
@@ -0,0 +1,142 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "progress.h"
+
+
+/** Throughput is measured over this period, so the estimate follows changes in speed */
+static const std::chrono::seconds throughputWindow(30);
+
+static int64_t ticks(std::chrono::steady_clock::time_point time)
+{
+    return time.time_since_epoch().count();
+}
+
+void ProgressMonitor::Worker::startFile(const std::string* file)
+{
+    mFileStart.store(ticks(std::chrono::steady_clock::now()), std::memory_order_relaxed);
+    mStage.store(nullptr, std::memory_order_relaxed);
+    mValue.store(0, std::memory_order_relaxed);
+    mFile.store(file, std::memory_order_release);
+}
+
+void ProgressMonitor::Worker::fileDone(std::size_t size)
+{
+    mFile.store(nullptr, std::memory_order_relaxed);
+    // Only this thread writes the counters, so there is no need for a read-modify-write
+    mBytes.store(mBytes.load(std::memory_order_relaxed) + size, std::memory_order_relaxed);
+    mFiles.store(mFiles.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+
+ProgressMonitor::ProgressMonitor()
+    : mWorkerCount(0)
+    , mTotalFiles(0)
+    , mTotalBytes(0)
+    , mInterval(0)
+    , mStop(false)
+{
+}
+
+ProgressMonitor::~ProgressMonitor()
+{
+    stop();
+}
+
+void ProgressMonitor::start(std::size_t workers, std::chrono::milliseconds interval, const Callback& callback)
+{
+    mWorkers.reset(new Worker[workers]);
+    mWorkerCount = workers;
+    mInterval = interval;
+    mCallback = callback;
+    mStart = std::chrono::steady_clock::now();
+    mHistory.assign(1, Sample{mStart, 0, 0});
+    mStop = false;
+    mThread = std::thread(&ProgressMonitor::run, this);
+}
+
+void ProgressMonitor::stop()
+{
+    if (!mThread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWakeUp.notify_all();
+    mThread.join();
+}
+
+void ProgressMonitor::run()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (;;) {
+        const bool stop = mWakeUp.wait_for(lock, mInterval, [this]() {
+            return mStop;
+        });
+        // The workers never wait for the report
+        lock.unlock();
+        mCallback(status(stop));
+        if (stop)
+            return;
+        lock.lock();
+    }
+}
+
+ProgressStatus ProgressMonitor::status(bool done)
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    ProgressStatus status;
+    status.files = status.bytes = 0;
+    for (std::size_t i = 0; i < mWorkerCount; ++i) {
+        const Worker& worker = mWorkers[i];
+        status.files += worker.mFiles.load(std::memory_order_acquire);
+        status.bytes += worker.mBytes.load(std::memory_order_relaxed);
+        const std::string* file = worker.mFile.load(std::memory_order_acquire);
+        if (file) {
+            const std::chrono::steady_clock::duration spent(ticks(now) - worker.mFileStart.load(std::memory_order_relaxed));
+            status.active.push_back(ProgressStatus::Active{*file,
+                                                           worker.mStage.load(std::memory_order_relaxed),
+                                                           worker.mValue.load(std::memory_order_relaxed),
+                                                           std::chrono::duration<double>(spent).count()});
+        }
+    }
+    status.totalFiles = mTotalFiles;
+    status.totalBytes = mTotalBytes;
+    status.elapsed = std::chrono::duration<double>(now - mStart).count();
+    status.done = done;
+
+    // Throughput since the oldest sample in the window
+    while (mHistory.size() > 1 && now - mHistory[1].time >= throughputWindow)
+        mHistory.pop_front();
+    const Sample& oldest = mHistory.front();
+    const double seconds = std::chrono::duration<double>(now - oldest.time).count();
+    status.bytesPerSecond = seconds > 0 ? (status.bytes - oldest.bytes) / seconds : 0;
+    status.filesPerSecond = seconds > 0 ? (status.files - oldest.files) / seconds : 0;
+    mHistory.push_back(Sample{now, status.files, status.bytes});
+
+    // The remaining time is estimated by size, a large file takes longer than a small one
+    if (status.bytes >= status.totalBytes)
+        status.eta = 0;
+    else if (status.bytesPerSecond > 0)
+        status.eta = (status.totalBytes - status.bytes) / status.bytesPerSecond;
+    else
+        status.eta = -1;
+    return status;
+}
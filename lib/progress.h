@@ -0,0 +1,166 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef progressH
+#define progressH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// @addtogroup Core
+/// @{
+
+/** @brief Progress of a run, see ErrorLogger::reportProgressStatus() */
+struct CPPCHECKLIB ProgressStatus {
+    /** A file that is being checked */
+    struct Active {
+        std::string file;
+        /** Current stage of the analysis, nullptr if none was reported yet */
+        const char* stage;
+        /** Progress of the stage, 0-100 */
+        unsigned int value;
+        /** Time spent on the file so far */
+        double seconds;
+    };
+
+    std::size_t files;
+    std::size_t totalFiles;
+    std::size_t bytes;
+    std::size_t totalBytes;
+    /** Seconds since the start */
+    double elapsed;
+    /** Recent throughput */
+    double bytesPerSecond;
+    double filesPerSecond;
+    /** Estimated seconds until all files are checked, negative if unknown */
+    double eta;
+    /** Last report of the run */
+    bool done;
+    std::vector<Active> active;
+};
+
+/**
+ * @brief Progress of the checking threads. Every thread publishes its
+ * counters in its own Worker through relaxed atomics, so it never blocks
+ * or shares a cache line with another thread. A dedicated thread reads
+ * them at a fixed interval and reports the totals, the throughput and an
+ * estimated remaining time.
+ */
+class CPPCHECKLIB ProgressMonitor {
+public:
+    /** Counters of one checking thread, only written by that thread */
+    class alignas(64) Worker {
+    public:
+        Worker() : mFiles(0), mBytes(0), mFile(nullptr), mFileStart(0), mStage(nullptr), mValue(0) {}
+
+        /** The file must stay valid until fileDone() */
+        void startFile(const std::string* file);
+
+        /** @param stage string literal, it is read later by the reporting thread */
+        void progress(const char stage[], std::size_t value) {
+            mStage.store(stage, std::memory_order_relaxed);
+            mValue.store(static_cast<unsigned int>(value), std::memory_order_relaxed);
+        }
+
+        void fileDone(std::size_t size);
+
+    private:
+        friend class ProgressMonitor;
+
+        std::atomic<std::size_t> mFiles;
+        std::atomic<std::size_t> mBytes;
+        std::atomic<const std::string*> mFile;
+        std::atomic<int64_t> mFileStart;
+        std::atomic<const char*> mStage;
+        std::atomic<unsigned int> mValue;
+    };
+
+    typedef std::function<void(const ProgressStatus&)> Callback;
+
+    ProgressMonitor();
+    ~ProgressMonitor();
+    ProgressMonitor(const ProgressMonitor&) = delete;
+    void operator=(const ProgressMonitor&) = delete;
+
+    /** Thread safe, files can be added while checking */
+    void addTotal(std::size_t files, std::size_t bytes) {
+        mTotalFiles += files;
+        mTotalBytes += bytes;
+    }
+
+    void setTotal(std::size_t files, std::size_t bytes) {
+        mTotalFiles = files;
+        mTotalBytes = bytes;
+    }
+
+    /** Start the reporting thread, callback is called from it every interval */
+    void start(std::size_t workers, std::chrono::milliseconds interval, const Callback& callback);
+
+    Worker& worker(std::size_t index) {
+        return mWorkers[index];
+    }
+
+    /** Stop the reporting thread after a last report */
+    void stop();
+
+    /** Current status. Only called by the reporting thread, it records the throughput history. */
+    ProgressStatus status(bool done);
+
+private:
+    void run();
+
+    std::unique_ptr<Worker[]> mWorkers;
+    std::size_t mWorkerCount;
+    std::atomic<std::size_t> mTotalFiles;
+    std::atomic<std::size_t> mTotalBytes;
+
+    std::chrono::steady_clock::time_point mStart;
+    std::chrono::milliseconds mInterval;
+    Callback mCallback;
+
+    struct Sample {
+        std::chrono::steady_clock::time_point time;
+        std::size_t files;
+        std::size_t bytes;
+    };
+    /** Samples of the last seconds, the throughput is measured over them */
+    std::deque<Sample> mHistory;
+
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mWakeUp;
+    bool mStop;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // progressH
@@ -0,0 +1,371 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "reportwriter.h"
+
+#include "path.h"
+#include "settings.h"
+#include "utils.h"
+#include "version.h"
+
+#include <iterator>
+#include <list>
+#include <utility>
+
+
+void TextReportSink::write(std::ostream& out, const ErrorMessage& msg)
+{
+    out << format(msg) << '\n';
+}
+
+std::string TextReportSink::format(const ErrorMessage& msg) const
+{
+    return msg.toString(mSettings.verbose, mSettings.templateFormat, mSettings.templateLocation);
+}
+
+
+void XmlReportSink::begin(std::ostream& out)
+{
+    out << ErrorMessage::getXMLHeader() << '\n';
+}
+
+void XmlReportSink::write(std::ostream& out, const ErrorMessage& msg)
+{
+    out << msg.toXML() << '\n';
+}
+
+void XmlReportSink::end(std::ostream& out)
+{
+    out << ErrorMessage::getXMLFooter() << '\n';
+}
+
+
+static const char* sarifLevel(Severity::SeverityType severity)
+{
+    switch (severity) {
+    case Severity::error:
+        return "error";
+    case Severity::warning:
+    case Severity::style:
+    case Severity::performance:
+    case Severity::portability:
+        return "warning";
+    default:
+        return "note";
+    }
+}
+
+std::string SarifReportSink::toUri(const std::string& file)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    std::string uri;
+    for (const char c : Path::fromNativeSeparators(file)) {
+        const unsigned char u = static_cast<unsigned char>(c);
+        if (u < 0x21 || u > 0x7e || c == '%' || c == '#' || c == '?' || c == '[' || c == ']') {
+            uri += '%';
+            uri += hex[u >> 4];
+            uri += hex[u & 0xF];
+        } else
+            uri += c;
+    }
+    return uri;
+}
+
+static void writeSarifLocation(std::ostream& out, const ErrorMessage::FileLocation& loc, const std::string& message, int id)
+{
+    out << '{';
+    if (id >= 0)
+        out << "\"id\":" << id << ',';
+    out << "\"physicalLocation\":{\"artifactLocation\":{\"uri\":" << toJsonString(SarifReportSink::toUri(loc.getFile())) << '}';
+    // SARIF lines and columns are 1-based, 0 means unknown
+    if (loc.line > 0) {
+        out << ",\"region\":{\"startLine\":" << loc.line;
+        if (loc.column > 0)
+            out << ",\"startColumn\":" << loc.column;
+        out << '}';
+    }
+    out << '}';
+    if (!message.empty())
+        out << ",\"message\":{\"text\":" << toJsonString(message) << '}';
+    out << '}';
+}
+
+void SarifReportSink::begin(std::ostream& out)
+{
+    out << "{\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\",\"version\":\"2.1.0\",\"runs\":[{\"results\":[";
+}
+
+void SarifReportSink::write(std::ostream& out, const ErrorMessage& msg)
+{
+    if (mRules.find(msg.id) == mRules.end())
+        mRules[msg.id] = msg.shortMessage();
+
+    out << (mFirst ? "\n" : ",\n");
+    mFirst = false;
+
+    out << "{\"ruleId\":" << toJsonString(msg.id)
+        << ",\"level\":\"" << sarifLevel(msg.severity) << '\"'
+        << ",\"message\":{\"text\":" << toJsonString(mSettings.verbose ? msg.verboseMessage() : msg.shortMessage()) << '}';
+    if (!msg.callStack.empty()) {
+        out << ",\"locations\":[";
+        writeSarifLocation(out, msg.callStack.back(), emptyString, -1);
+        out << ']';
+        if (msg.callStack.size() > 1) {
+            out << ",\"relatedLocations\":[";
+            int id = 0;
+            for (std::list<ErrorMessage::FileLocation>::const_iterator it = msg.callStack.cbegin(); std::next(it) != msg.callStack.cend(); ++it) {
+                if (id > 0)
+                    out << ',';
+                writeSarifLocation(out, *it, it->getinfo(), id++);
+            }
+            out << ']';
+        }
+    }
+    out << ",\"properties\":{\"severity\":\"" << Severity::toString(msg.severity) << '\"';
+    if (msg.certainty == Certainty::inconclusive)
+        out << ",\"inconclusive\":true";
+    if (msg.cwe.id)
+        out << ",\"cwe\":" << msg.cwe.id;
+    out << "}}";
+}
+
+void SarifReportSink::end(std::ostream& out)
+{
+    out << "\n],\"tool\":{\"driver\":{\"name\":\"" PROGRAMNAME "\",\"version\":\"" CPPCHECK_VERSION_STRING "\",\"rules\":[";
+    bool first = true;
+    for (std::map<std::string, std::string>::const_iterator it = mRules.cbegin(); it != mRules.cend(); ++it) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"id\":" << toJsonString(it->first) << ",\"shortDescription\":{\"text\":" << toJsonString(it->second) << "}}";
+    }
+    out << "]}}}]}\n";
+}
+
+
+void JsonLinesReportSink::write(std::ostream& out, const ErrorMessage& msg)
+{
+    out << "{\"id\":" << toJsonString(msg.id)
+        << ",\"severity\":\"" << Severity::toString(msg.severity) << '\"'
+        << ",\"inconclusive\":" << (msg.certainty == Certainty::inconclusive ? "true" : "false")
+        << ",\"message\":" << toJsonString(mSettings.verbose ? msg.verboseMessage() : msg.shortMessage());
+    if (msg.cwe.id)
+        out << ",\"cwe\":" << msg.cwe.id;
+    out << ",\"locations\":[";
+    for (std::list<ErrorMessage::FileLocation>::const_reverse_iterator it = msg.callStack.crbegin(); it != msg.callStack.crend(); ++it) {
+        if (it != msg.callStack.crbegin())
+            out << ',';
+        out << "{\"file\":" << toJsonString(it->getFile())
+            << ",\"line\":" << it->line
+            << ",\"column\":" << it->column;
+        if (!it->getinfo().empty())
+            out << ",\"info\":" << toJsonString(it->getinfo());
+        out << '}';
+    }
+    out << "]}\n";
+}
+
+
+ReportWriter::ReportWriter(ReportSink& sink, std::ostream& out, bool verbose)
+    : mSink(sink), mOut(out), mVerbose(verbose), mQueue(nullptr), mReserved(0), mStop(false), mNext(0), mBegun(false)
+{
+    mThread = std::thread(&ReportWriter::run, this);
+}
+
+ReportWriter::~ReportWriter()
+{
+    finish();
+}
+
+std::size_t ReportWriter::reserve(std::size_t count)
+{
+    return mReserved.fetch_add(count);
+}
+
+void ReportWriter::report(const ErrorMessage& msg, std::size_t sequence)
+{
+    push(new Entry{Entry::MESSAGE, sequence, msg, nullptr});
+}
+
+void ReportWriter::done(std::size_t sequence)
+{
+    push(new Entry{Entry::DONE, sequence, ErrorMessage(), nullptr});
+}
+
+void ReportWriter::skipTo(std::size_t sequence)
+{
+    push(new Entry{Entry::SKIP, sequence, ErrorMessage(), nullptr});
+}
+
+void ReportWriter::push(Entry* entry)
+{
+    entry->next = mQueue.load(std::memory_order_relaxed);
+    while (!mQueue.compare_exchange_weak(entry->next, entry, std::memory_order_release, std::memory_order_relaxed))
+        ;
+    // The writer thread only sleeps on an empty queue
+    if (!entry->next)
+        wake();
+}
+
+void ReportWriter::wake()
+{
+    // Taking the lock orders the notification after the writer thread checked the queue
+    {
+        std::lock_guard<std::mutex> lock(mWakeSync);
+    }
+    mWake.notify_one();
+}
+
+bool ReportWriter::stop()
+{
+    if (!mThread.joinable())
+        return false;
+    mStop.store(true, std::memory_order_release);
+    wake();
+    mThread.join();
+    return true;
+}
+
+void ReportWriter::finish()
+{
+    if (!stop())
+        return;
+
+    // Messages of files that were never completed (terminated run)
+    for (std::map<std::size_t, std::vector<ErrorMessage>>::const_iterator it = mPending.cbegin(); it != mPending.cend(); ++it) {
+        for (const ErrorMessage& msg : it->second)
+            emit(msg);
+    }
+    mPending.clear();
+
+    begin();
+    mSink.end(mOut);
+    mOut.flush();
+}
+
+void ReportWriter::discard()
+{
+    if (!stop())
+        return;
+    mPending.clear();
+    // Messages were written already, the report must stay well-formed
+    if (mBegun)
+        mSink.end(mOut);
+    mOut.flush();
+}
+
+void ReportWriter::run()
+{
+    bool written = false;
+    for (;;) {
+        Entry* entries = mQueue.exchange(nullptr, std::memory_order_acquire);
+        if (!entries) {
+            // Check the queue once more after stop was requested, producers are done by then
+            if (mStop.load(std::memory_order_acquire)) {
+                entries = mQueue.exchange(nullptr, std::memory_order_acquire);
+                if (!entries)
+                    break;
+            } else {
+                if (written) {
+                    mOut.flush();
+                    written = false;
+                }
+                std::unique_lock<std::mutex> lock(mWakeSync);
+                mWake.wait(lock, [this]() {
+                    return mQueue.load(std::memory_order_acquire) || mStop.load(std::memory_order_acquire);
+                });
+                continue;
+            }
+        }
+
+        // The queue is a stack: restore the order of arrival
+        Entry* ordered = nullptr;
+        while (entries) {
+            Entry* next = entries->next;
+            entries->next = ordered;
+            ordered = entries;
+            entries = next;
+        }
+        while (ordered) {
+            Entry* next = ordered->next;
+            process(ordered);
+            delete ordered;
+            ordered = next;
+        }
+        written = true;
+    }
+}
+
+void ReportWriter::process(Entry* entry)
+{
+    switch (entry->kind) {
+    case Entry::MESSAGE:
+        if (entry->sequence == unordered || entry->sequence == mNext)
+            emit(entry->msg);
+        else if (entry->sequence > mNext)
+            mPending[entry->sequence].push_back(std::move(entry->msg));
+        break;
+    case Entry::DONE:
+        if (entry->sequence == mNext) {
+            ++mNext;
+            advance();
+        } else if (entry->sequence > mNext)
+            mDoneAhead.insert(entry->sequence);
+        break;
+    case Entry::SKIP:
+        while (mNext < entry->sequence) {
+            ++mNext;
+            advance();
+        }
+        mDoneAhead.erase(mDoneAhead.begin(), mDoneAhead.lower_bound(mNext));
+        break;
+    }
+}
+
+void ReportWriter::advance()
+{
+    for (;;) {
+        const std::map<std::size_t, std::vector<ErrorMessage>>::iterator pending = mPending.find(mNext);
+        if (pending != mPending.end()) {
+            for (const ErrorMessage& msg : pending->second)
+                emit(msg);
+            mPending.erase(pending);
+        }
+        const std::set<std::size_t>::iterator doneAhead = mDoneAhead.find(mNext);
+        if (doneAhead == mDoneAhead.end())
+            return;
+        mDoneAhead.erase(doneAhead);
+        ++mNext;
+    }
+}
+
+void ReportWriter::emit(const ErrorMessage& msg)
+{
+    // Alert only about unique errors
+    if (!mShown.insert(msg.toString(mVerbose)).second)
+        return;
+    begin();
+    mSink.write(mOut, msg);
+}
+
+void ReportWriter::begin()
+{
+    if (mBegun)
+        return;
+    mSink.begin(mOut);
+    mBegun = true;
+}
@@ -0,0 +1,198 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef reportwriterH
+#define reportwriterH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+#include "errorlogger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+class Settings;
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Output format of reported errors. A sink only formats, it is
+ * always called from a single thread.
+ */
+class CPPCHECKLIB ReportSink {
+public:
+    virtual ~ReportSink() {}
+
+    /** Called once before the first message */
+    virtual void begin(std::ostream& out) {
+        (void)out;
+    }
+
+    virtual void write(std::ostream& out, const ErrorMessage& msg) = 0;
+
+    /** Called once after the last message */
+    virtual void end(std::ostream& out) {
+        (void)out;
+    }
+};
+
+/** @brief Plain text, formatted with --template and --template-location */
+class CPPCHECKLIB TextReportSink : public ReportSink {
+public:
+    explicit TextReportSink(const Settings& settings) : mSettings(settings) {}
+
+    void write(std::ostream& out, const ErrorMessage& msg) override;
+
+protected:
+    virtual std::string format(const ErrorMessage& msg) const;
+
+    const Settings& mSettings;
+};
+
+/** @brief XML version 2, as written by --xml */
+class CPPCHECKLIB XmlReportSink : public ReportSink {
+public:
+    void begin(std::ostream& out) override;
+    void write(std::ostream& out, const ErrorMessage& msg) override;
+    void end(std::ostream& out) override;
+};
+
+/**
+ * @brief SARIF 2.1.0 log. Results are streamed as they arrive, the rule
+ * descriptions are collected on the way and written after the results.
+ */
+class CPPCHECKLIB SarifReportSink : public ReportSink {
+public:
+    explicit SarifReportSink(const Settings& settings) : mSettings(settings), mFirst(true) {}
+
+    void begin(std::ostream& out) override;
+    void write(std::ostream& out, const ErrorMessage& msg) override;
+    void end(std::ostream& out) override;
+
+    /** Encode a file name as relative or absolute URI reference */
+    static std::string toUri(const std::string& file);
+
+private:
+    const Settings& mSettings;
+    bool mFirst;
+    std::map<std::string, std::string> mRules;
+};
+
+/** @brief One JSON object per line and message */
+class CPPCHECKLIB JsonLinesReportSink : public ReportSink {
+public:
+    explicit JsonLinesReportSink(const Settings& settings) : mSettings(settings) {}
+
+    void write(std::ostream& out, const ErrorMessage& msg) override;
+
+private:
+    const Settings& mSettings;
+};
+
+/**
+ * @brief Writes messages through a ReportSink on a dedicated thread.
+ *
+ * Messages are pushed onto a lock-free queue that the writer thread drains.
+ * The writer thread sleeps while the queue is empty, a producer only takes
+ * a lock to wake it when it pushes onto an empty queue. Duplicates are
+ * dropped by the writer thread.
+ *
+ * For deterministic output, producers reserve a range of sequence numbers
+ * (one per file) and tag messages with them. Messages of a sequence number
+ * are held back until all lower sequence numbers are done, so the output
+ * order does not depend on thread scheduling. Untagged messages are written
+ * as they arrive.
+ */
+class CPPCHECKLIB ReportWriter {
+public:
+    static const std::size_t unordered = static_cast<std::size_t>(-1);
+
+    ReportWriter(ReportSink& sink, std::ostream& out, bool verbose);
+    ~ReportWriter();
+    ReportWriter(const ReportWriter&) = delete;
+    void operator=(const ReportWriter&) = delete;
+
+    /** Reserve count consecutive sequence numbers, returns the first one */
+    std::size_t reserve(std::size_t count);
+
+    void report(const ErrorMessage& msg, std::size_t sequence = unordered);
+
+    /** All messages of given sequence number are reported */
+    void done(std::size_t sequence);
+
+    /** Mark all sequence numbers below given one as done, e.g. after a cancelled run */
+    void skipTo(std::size_t sequence);
+
+    /** Write all pending messages and the trailer, stop the writer thread */
+    void finish();
+
+    /** Stop the writer thread without writing a report that was not started yet, e.g. when there is nothing to check */
+    void discard();
+
+private:
+    struct Entry {
+        enum Kind { MESSAGE, DONE, SKIP } kind;
+        std::size_t sequence;
+        ErrorMessage msg;
+        Entry* next;
+    };
+
+    void push(Entry* entry);
+    void wake();
+    bool stop();
+    void run();
+    void process(Entry* entry);
+    void emit(const ErrorMessage& msg);
+    void begin();
+    void advance();
+
+    ReportSink& mSink;
+    std::ostream& mOut;
+    const bool mVerbose;
+
+    std::atomic<Entry*> mQueue;
+    std::atomic<std::size_t> mReserved;
+    std::atomic<bool> mStop;
+    /** The writer thread waits on it while the queue is empty */
+    std::mutex mWakeSync;
+    std::condition_variable mWake;
+    std::thread mThread;
+
+    /** Only accessed by the writer thread */
+    std::size_t mNext;
+    std::map<std::size_t, std::vector<ErrorMessage>> mPending;
+    std::set<std::size_t> mDoneAhead;
+    std::unordered_set<std::string> mShown;
+    /** The header is written with the first message */
+    bool mBegun;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // reportwriterH
@@ -0,0 +1,255 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef segmentedlistH
+#define segmentedlistH
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Sequence with stable element addresses, stored in contiguous segments.
+ *
+ * Appending never moves an element, like in a std::list, but elements share
+ * a few allocations and are iterated in memory order. The segments double
+ * in size up to about 4 KB, so short sequences stay small. Only the last
+ * element can be removed.
+ */
+template<class T>
+class SegmentedList {
+    static constexpr std::size_t firstSegmentSize = 2;
+    static constexpr std::size_t maxSegmentSize = sizeof(T) >= 2048 / firstSegmentSize ? firstSegmentSize : 4096 / sizeof(T);
+
+    struct Segment {
+        T* data;
+        std::size_t capacity;
+    };
+
+    template<bool IsConst>
+    class Iterator {
+        friend class SegmentedList;
+        typedef typename std::conditional<IsConst, const SegmentedList*, SegmentedList*>::type Container;
+
+        Container mList;
+        std::size_t mSegment;
+        std::size_t mOffset;
+
+        Iterator(Container list, std::size_t segment, std::size_t offset) : mList(list), mSegment(segment), mOffset(offset) {}
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<IsConst, const T*, T*>::type pointer;
+        typedef typename std::conditional<IsConst, const T&, T&>::type reference;
+
+        Iterator() : mList(nullptr), mSegment(0), mOffset(0) {}
+
+        // iterator => const_iterator
+        template<bool OtherConst, class = typename std::enable_if<IsConst && !OtherConst>::type>
+        Iterator(const Iterator<OtherConst>& other) : mList(other.mList), mSegment(other.mSegment), mOffset(other.mOffset) {}
+
+        reference operator*() const {
+            return mList->mSegments[mSegment].data[mOffset];
+        }
+        pointer operator->() const {
+            return &mList->mSegments[mSegment].data[mOffset];
+        }
+
+        Iterator& operator++() {
+            if (++mOffset == mList->mSegments[mSegment].capacity) {
+                ++mSegment;
+                mOffset = 0;
+            }
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator it(*this);
+            ++*this;
+            return it;
+        }
+        Iterator& operator--() {
+            if (mOffset == 0) {
+                --mSegment;
+                mOffset = mList->mSegments[mSegment].capacity;
+            }
+            --mOffset;
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator it(*this);
+            --*this;
+            return it;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return mSegment == other.mSegment && mOffset == other.mOffset;
+        }
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+
+        template<bool> friend class Iterator;
+    };
+
+public:
+    typedef T value_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    SegmentedList() : mSize(0), mLastUsed(0) {}
+
+    SegmentedList(const SegmentedList& other) : mSize(0), mLastUsed(0) {
+        for (const T& element : other)
+            emplace_back(element);
+    }
+
+    SegmentedList(SegmentedList&& other) noexcept
+        : mSegments(std::move(other.mSegments)), mSize(other.mSize), mLastUsed(other.mLastUsed) {
+        other.mSegments.clear();
+        other.mSize = other.mLastUsed = 0;
+    }
+
+    SegmentedList& operator=(const SegmentedList& other) {
+        if (this != &other) {
+            clear();
+            for (const T& element : other)
+                emplace_back(element);
+        }
+        return *this;
+    }
+
+    ~SegmentedList() {
+        clear();
+    }
+
+    template<class ... Args>
+    T& emplace_back(Args&& ... args) {
+        const bool newSegment = mSegments.empty() || mLastUsed == mSegments.back().capacity;
+        if (newSegment) {
+            const std::size_t capacity = mSegments.empty() ? firstSegmentSize : std::min(mSegments.back().capacity * 2, maxSegmentSize);
+            mSegments.push_back(Segment{static_cast<T*>(::operator new(capacity * sizeof(T))), capacity});
+        }
+        Segment& segment = mSegments.back();
+        try {
+            new (segment.data + (newSegment ? 0 : mLastUsed)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            if (newSegment) {
+                ::operator delete(segment.data);
+                mSegments.pop_back();
+            }
+            throw;
+        }
+        mLastUsed = newSegment ? 1 : mLastUsed + 1;
+        ++mSize;
+        return segment.data[mLastUsed - 1];
+    }
+
+    void push_back(const T& element) {
+        emplace_back(element);
+    }
+    void push_back(T&& element) {
+        emplace_back(std::move(element));
+    }
+
+    void pop_back() {
+        Segment& segment = mSegments.back();
+        segment.data[--mLastUsed].~T();
+        --mSize;
+        if (mLastUsed == 0) {
+            ::operator delete(segment.data);
+            mSegments.pop_back();
+            mLastUsed = mSegments.empty() ? 0 : mSegments.back().capacity;
+        }
+    }
+
+    void clear() {
+        while (!mSegments.empty())
+            pop_back();
+    }
+
+    bool empty() const {
+        return mSize == 0;
+    }
+    std::size_t size() const {
+        return mSize;
+    }
+
+    T& front() {
+        return mSegments.front().data[0];
+    }
+    const T& front() const {
+        return mSegments.front().data[0];
+    }
+    T& back() {
+        return mSegments.back().data[mLastUsed - 1];
+    }
+    const T& back() const {
+        return mSegments.back().data[mLastUsed - 1];
+    }
+
+    iterator begin() {
+        return iterator(this, 0, 0);
+    }
+    iterator end() {
+        return iterator(this, endSegment(), endOffset());
+    }
+    const_iterator begin() const {
+        return const_iterator(this, 0, 0);
+    }
+    const_iterator end() const {
+        return const_iterator(this, endSegment(), endOffset());
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+private:
+    // The end is the start of the next segment when the last segment is full
+    std::size_t endSegment() const {
+        return (mSegments.empty() || mLastUsed == mSegments.back().capacity) ? mSegments.size() : mSegments.size() - 1;
+    }
+    std::size_t endOffset() const {
+        return (mSegments.empty() || mLastUsed == mSegments.back().capacity) ? 0 : mLastUsed;
+    }
+
+    std::vector<Segment> mSegments;
+    std::size_t mSize;
+    /** Number of elements in the last segment */
+    std::size_t mLastUsed;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // segmentedlistH
@@ -23,6 +23,25 @@
 
 std::atomic<bool> Settings::mTerminated;
 
+static thread_local const CancellationToken* currentCancellationToken = nullptr;
+
+CancellationToken::Scope::Scope(const CancellationToken* token)
+    : mPrevious(currentCancellationToken)
+{
+    if (token)
+        currentCancellationToken = token;
+}
+
+CancellationToken::Scope::~Scope()
+{
+    currentCancellationToken = mPrevious;
+}
+
+const CancellationToken* CancellationToken::current()
+{
+    return currentCancellationToken;
+}
+
 const char Project::SafeChecks::XmlRootName[] = "safe-checks";
 const char Project::SafeChecks::XmlClasses[] = "class-public";
 const char Project::SafeChecks::XmlExternalFunctions[] = "external-functions";
@@ -31,16 +50,22 @@ const char Project::SafeChecks::XmlExternalVariables[] = "external-variables";
 
 
 Settings::Settings() :
+    addonJobs(0),
+    addonTimeout(0),
     checkConfiguration(false),
     checkLibrary(false),
     debugnormal(false),
     debugtemplate(false),
     debugwarnings(false),
     dump(false),
+    dumpFormat(DUMP_XML),
     exceptionHandling(false),
     exitCode(0),
     jobs(1),
+    maxFileTime(0),
+    maxFileMemory(0),
     relativePaths(false),
+    outputFormat(OUTPUT_TEXT),
     showtime(SHOWTIME_MODES::SHOWTIME_NONE),
     verbose(false),
     xml(false),
@@ -49,6 +74,14 @@ Settings::Settings() :
     output.setEnabled(Output::findings, true);
 }
 
+bool Settings::terminated()
+{
+    if (mTerminated)
+        return true;
+    const CancellationToken* const token = currentCancellationToken;
+    return token && token->cancelled();
+}
+
 Project::Project() :
     checkAllConfigurations(true),
     checkHeaders(true),
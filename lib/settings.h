@@ -23,6 +23,7 @@
 //---------------------------------------------------------------------------
 
 #include "config.h"
+#include "errortypes.h"
 #include "library.h"
 #include "platform.h"
 #include "standards.h"
@@ -42,42 +43,6 @@ namespace ValueFlow {
 /// @addtogroup Core
 /// @{
 
-template<typename T>
-class SimpleEnableGroup {
-    uint32_t flags = 0;
-public:
-    uint32_t intValue() const {
-        return flags;
-    }
-    void clear() {
-        flags = 0;
-    }
-    void fill() {
-        flags = 0xFFFFFFFF;
-    }
-    void setEnabledAll(bool enabled) {
-        if (enabled)
-            fill();
-        else
-            clear();
-    }
-    bool isEnabled(T flag) const {
-        return (flags & (1U << (uint32_t)flag)) != 0;
-    }
-    void enable(T flag) {
-        flags |= (1U << (uint32_t)flag);
-    }
-    void disable(T flag) {
-        flags &= ~(1U << (uint32_t)flag);
-    }
-    void setEnabled(T flag, bool enabled) {
-        if (enabled)
-            enable(flag);
-        else
-            disable(flag);
-    }
-};
-
 class ComplexEnableGroup {
     std::unordered_map<std::string, bool> flags;
     bool unknownDefault = true;
@@ -117,6 +82,49 @@ public:
 };
 
 
+/**
+ * @brief Cancellation of one job, e.g. a file of the analysis server or a
+ * GUI check. A thread installs the token of its job with a Scope, then
+ * Settings::terminated() is true in this thread once the job is cancelled,
+ * while other jobs go on.
+ */
+class CPPCHECKLIB CancellationToken {
+public:
+    CancellationToken() : mCancelled(false) {}
+    CancellationToken(const CancellationToken &) = delete;
+    void operator=(const CancellationToken &) = delete;
+
+    /** Thread safe, the checking threads stop at their next poll */
+    void cancel() {
+        mCancelled.store(true, std::memory_order_relaxed);
+    }
+    /** Reuse the token for the next job */
+    void reset() {
+        mCancelled.store(false, std::memory_order_relaxed);
+    }
+    bool cancelled() const {
+        return mCancelled.load(std::memory_order_relaxed);
+    }
+
+    /** Installs a token for the current thread while it exists, nullptr keeps the installed one */
+    class CPPCHECKLIB Scope {
+    public:
+        explicit Scope(const CancellationToken* token);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        void operator=(const Scope &) = delete;
+    private:
+        const CancellationToken* mPrevious;
+    };
+
+    /** Token of the current thread, nullptr if there is none */
+    static const CancellationToken* current();
+
+private:
+    std::atomic<bool> mCancelled;
+};
+
+
 /**
 
  * @brief This is just a container for general settings so that we don't need
@@ -131,9 +139,15 @@ class CPPCHECKLIB Settings {
 public:
     Settings();
 
+    /** @brief Maximum number of addon processes running at the same time, 0 means one per hardware thread (--addon-jobs=<n>) */
+    unsigned int addonJobs;
+
     /** @brief Path to the python interpreter to be used to run addons. */
     std::string addonPython;
 
+    /** @brief Maximum time in seconds an addon may run for a single file, 0 means unlimited (--addon-timeout=<sec>) */
+    unsigned int addonTimeout;
+
     /** Is the 'configuration checking' wanted? */
     bool checkConfiguration;
 
@@ -153,6 +167,13 @@ public:
     bool dump;
     std::string dumpFile;
 
+    enum DUMP_FORMAT : uint8_t {
+        DUMP_XML = 0,
+        DUMP_BINARY
+    };
+    /** @brief format of the dump files, also of the ones written for the addons (--dump-format=xml|binary) */
+    DUMP_FORMAT dumpFormat;
+
     /** @brief Is --exception-handling given */
     bool exceptionHandling;
 
@@ -167,11 +188,29 @@ public:
         time. Default is 1. (-j N) */
     unsigned int jobs;
 
+    /** @brief Maximum time in seconds spent on a single file, 0 means unlimited (--max-file-time=<sec>) */
+    unsigned int maxFileTime;
+
+    /**
+     * @brief Maximum memory growth in MB during analysis of a single file, 0 means unlimited (--max-file-memory=<MB>).
+     * The resident memory of the whole process is measured, so it is only meaningful with a single checking thread.
+     */
+    std::size_t maxFileMemory;
+
     /** @brief Use relative paths in output. */
     bool relativePaths;
 
     SimpleEnableGroup<Output::OutputType> output;
 
+    enum OUTPUT_FORMAT : uint8_t {
+        OUTPUT_TEXT = 0,
+        OUTPUT_XML,
+        OUTPUT_SARIF,
+        OUTPUT_JSON
+    };
+    /** @brief format of the reported errors (--output-format=text|xml|sarif|json) */
+    OUTPUT_FORMAT outputFormat;
+
 
     enum SHOWTIME_MODES : uint8_t {
         SHOWTIME_NONE = 0,
@@ -182,6 +221,9 @@ public:
     /** @brief show timing information (--showtime=file|summary|top5) */
     SHOWTIME_MODES showtime;
 
+    /** @brief Write the measurements of each checked file to this file (--perf-report=<file>) */
+    std::string perfReport;
+
 
     /** @brief The output format in which the errors are printed in text mode,
         e.g. "{severity} {file}:{line} {message} {id}" */
@@ -205,10 +247,8 @@ public:
         Settings::mTerminated = t;
     }
 
-    /** @brief termination requested? */
-    static bool terminated() {
-        return Settings::mTerminated;
-    }
+    /** @brief termination of all checks or of the job of this thread (CancellationToken) requested? */
+    static bool terminated();
 };
 
 /**
@@ -382,9 +382,18 @@ bool Suppressions::isSuppressedLocal(const Suppressions::ErrorMessage &errmsg)
     return false;
 }
 
+bool Suppressions::isEverythingSuppressed() const
+{
+    for (const Suppression &s : mSuppressions) {
+        if (s.errorId == "*" && (s.fileName.empty() || s.fileName == "*") && s.lineNumber == Suppression::NO_LINE && s.symbolName.empty())
+            return true;
+    }
+    return false;
+}
+
 void Suppressions::dump(std::ostream & out) const
 {
-    out << "  <suppressions>" << std::endl;
+    out << "  <suppressions>\n";
     for (const Suppression &suppression : mSuppressions) {
         out << "    <suppression";
         out << " errorId=\"" << ErrorLogger::toxml(suppression.errorId) << '"';
@@ -394,9 +403,9 @@ void Suppressions::dump(std::ostream & out) const
             out << " lineNumber=\"" << suppression.lineNumber << '"';
         if (!suppression.symbolName.empty())
             out << " symbolName=\"" << ErrorLogger::toxml(suppression.symbolName) << '\"';
-        out << " />" << std::endl;
+        out << " />\n";
     }
-    out << "  </suppressions>" << std::endl;
+    out << "  </suppressions>\n";
 }
 
 std::list<Suppressions::Suppression> Suppressions::getUnmatchedLocalSuppressions(const std::string &file) const
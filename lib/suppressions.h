@@ -174,6 +174,12 @@ public:
      */
     bool isSuppressedLocal(const ErrorMessage &errmsg);
 
+    /**
+     * @brief Returns true if all messages in all files are suppressed by a
+     * global suppression, e.g. --suppress=*
+     */
+    bool isEverythingSuppressed() const;
+
     /**
      * @brief Create an xml dump of suppressions
      * @param out stream to write XML to
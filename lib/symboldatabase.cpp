@@ -704,7 +704,7 @@ void SymbolDatabase::createSymbolDatabaseClassInfo()
         return;
 
     // fill in using info
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         for (std::vector<Scope::UsingInfo>::iterator i = it->usingList.begin(); i != it->usingList.end(); ++i) {
             // only find if not already found
             if (i->scope == nullptr) {
@@ -720,7 +720,7 @@ void SymbolDatabase::createSymbolDatabaseClassInfo()
     }
 
     // fill in base class info
-    for (std::list<Type>::iterator it = typeList.begin(); it != typeList.end(); ++it) {
+    for (SegmentedList<Type>::iterator it = typeList.begin(); it != typeList.end(); ++it) {
         // finish filling in base class info
         for (Type::BaseInfo & i : it->derivedFrom) {
             const Type* found = findType(i.nameTok, it->enclosingScope);
@@ -734,7 +734,7 @@ void SymbolDatabase::createSymbolDatabaseClassInfo()
     }
 
     // fill in friend info
-    for (std::list<Type>::iterator it = typeList.begin(); it != typeList.end(); ++it) {
+    for (SegmentedList<Type>::iterator it = typeList.begin(); it != typeList.end(); ++it) {
         for (Type::FriendInfo &friendInfo : it->friendList) {
             friendInfo.type = findType(friendInfo.nameStart, it->enclosingScope);
         }
@@ -745,14 +745,14 @@ void SymbolDatabase::createSymbolDatabaseClassInfo()
 void SymbolDatabase::createSymbolDatabaseVariableInfo()
 {
     // fill in variable info
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         // find variables
         it->getVariableList(mCtx.project);
     }
 
     // fill in function arguments
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
-        std::list<Function>::iterator func;
+    for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+        SegmentedList<Function>::iterator func;
 
         for (func = it->functionList.begin(); func != it->functionList.end(); ++func) {
             // add arguments
@@ -767,11 +767,11 @@ void SymbolDatabase::createSymbolDatabaseCopyAndMoveConstructors()
         return;
 
     // fill in class and struct copy/move constructors
-    for (std::list<Scope>::iterator scope = scopeList.begin(); scope != scopeList.end(); ++scope) {
+    for (SegmentedList<Scope>::iterator scope = scopeList.begin(); scope != scopeList.end(); ++scope) {
         if (!scope->isClassOrStruct())
             continue;
 
-        std::list<Function>::iterator func;
+        SegmentedList<Function>::iterator func;
         for (func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
             if (!func->isConstructor() || func->minArgCount() != 1)
                 continue;
@@ -794,7 +794,7 @@ void SymbolDatabase::createSymbolDatabaseCopyAndMoveConstructors()
 void SymbolDatabase::createSymbolDatabaseFunctionScopes()
 {
     // fill in function scopes
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         if (it->type == Scope::eFunction)
             functionScopes.push_back(&*it);
     }
@@ -803,7 +803,7 @@ void SymbolDatabase::createSymbolDatabaseFunctionScopes()
 void SymbolDatabase::createSymbolDatabaseClassAndStructScopes()
 {
     // fill in class and struct scopes
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         if (it->isClassOrStruct())
             classAndStructScopes.push_back(&*it);
     }
@@ -812,8 +812,8 @@ void SymbolDatabase::createSymbolDatabaseClassAndStructScopes()
 void SymbolDatabase::createSymbolDatabaseFunctionReturnTypes()
 {
     // fill in function return types
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
-        std::list<Function>::iterator func;
+    for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+        SegmentedList<Function>::iterator func;
 
         for (func = it->functionList.begin(); func != it->functionList.end(); ++func) {
             // add return types
@@ -835,7 +835,7 @@ void SymbolDatabase::createSymbolDatabaseNeedInitialization()
 {
     if (mCtx.tokenizer->isC()) {
         // For C code it is easy, as there are no constructors and no default values
-        for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+        for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
             Scope *scope = &(*it);
             if (scope->definedType)
                 scope->definedType->needInitialization = Type::NeedInitialization::True;
@@ -848,7 +848,7 @@ void SymbolDatabase::createSymbolDatabaseNeedInitialization()
         do {
             unknowns = 0;
 
-            for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+            for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
                 Scope *scope = &(*it);
 
                 if (!scope->definedType) {
@@ -860,7 +860,7 @@ void SymbolDatabase::createSymbolDatabaseNeedInitialization()
                     // check for default constructor
                     bool hasDefaultConstructor = false;
 
-                    std::list<Function>::const_iterator func;
+                    SegmentedList<Function>::const_iterator func;
 
                     for (func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
                         if (func->type == Function::eConstructor) {
@@ -889,7 +889,7 @@ void SymbolDatabase::createSymbolDatabaseNeedInitialization()
                         bool needInitialization = false;
                         bool unknown = false;
 
-                        std::list<Variable>::const_iterator var;
+                        SegmentedList<Variable>::const_iterator var;
                         for (var = scope->varlist.begin(); var != scope->varlist.end() && !needInitialization; ++var) {
                             if (var->isClass()) {
                                 if (var->type()) {
@@ -923,7 +923,7 @@ void SymbolDatabase::createSymbolDatabaseNeedInitialization()
 
         // this shouldn't happen so output a debug warning
         if (retry == 100 && mCtx.settings->debugwarnings) {
-            for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+            for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
                 const Scope *scope = &(*it);
 
                 if (scope->isClassOrStruct() && scope->definedType->needInitialization == Type::NeedInitialization::Unknown)
@@ -940,11 +940,11 @@ void SymbolDatabase::createSymbolDatabaseVariableSymbolTable()
     std::fill_n(mVariableList.begin(), mVariableList.size(), (const Variable*)nullptr);
 
     // check all scopes for variables
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         Scope *scope = &(*it);
 
         // add all variables
-        for (std::list<Variable>::iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
+        for (SegmentedList<Variable>::iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
             const unsigned int varId = var->declarationId();
             if (varId)
                 mVariableList[varId] = &(*var);
@@ -957,7 +957,7 @@ void SymbolDatabase::createSymbolDatabaseVariableSymbolTable()
         }
 
         // add all function parameters
-        for (std::list<Function>::iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
+        for (SegmentedList<Function>::iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
             for (std::vector<Variable>::iterator arg = func->argumentList.begin(); arg != func->argumentList.end(); ++arg) {
                 // check for named parameters
                 if (arg->nameToken() && arg->declarationId()) {
@@ -1004,7 +1004,7 @@ void SymbolDatabase::createSymbolDatabaseVariableSymbolTable()
 void SymbolDatabase::createSymbolDatabaseSetScopePointers()
 {
     // Set scope pointers
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         Token* start = const_cast<Token*>(it->bodyStart);
         Token* end = const_cast<Token*>(it->bodyEnd);
         if (it->type == Scope::eGlobal) {
@@ -1042,10 +1042,12 @@ void SymbolDatabase::createSymbolDatabaseSetFunctionPointers(bool firstPass)
 {
     if (firstPass) {
         // Set function definition and declaration pointers
-        for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
-            for (std::list<Function>::const_iterator func = it->functionList.begin(); func != it->functionList.end(); ++func) {
-                if (func->tokenDef)
+        for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+            for (SegmentedList<Function>::const_iterator func = it->functionList.begin(); func != it->functionList.end(); ++func) {
+                if (func->tokenDef) {
+                    mFunctionNames.insert(func->tokenDef->str());
                     const_cast<Token *>(func->tokenDef)->function(&*func);
+                }
 
                 if (func->token)
                     const_cast<Token *>(func->token)->function(&*func);
@@ -1079,8 +1081,8 @@ void SymbolDatabase::createSymbolDatabaseSetFunctionPointers(bool firstPass)
     }
 
     // Set C++ 11 delegate constructor function call pointers
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
-        for (std::list<Function>::const_iterator func = it->functionList.begin(); func != it->functionList.end(); ++func) {
+    for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+        for (SegmentedList<Function>::const_iterator func = it->functionList.begin(); func != it->functionList.end(); ++func) {
             // look for initializer list
             if (func->isConstructor() && func->functionScope && func->functionScope->functionOf && func->arg) {
                 const Token * tok = func->arg->link()->next();
@@ -1268,7 +1270,7 @@ void SymbolDatabase::createSymbolDatabaseSetVariablePointers()
 void SymbolDatabase::createSymbolDatabaseEnums()
 {
     // fill in enumerators in enum
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         if (it->type != Scope::eEnum)
             continue;
 
@@ -1279,7 +1281,7 @@ void SymbolDatabase::createSymbolDatabaseEnums()
 
     std::set<std::string> tokensThatAreNotEnumeratorValues;
 
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (SegmentedList<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         if (it->type != Scope::eEnum)
             continue;
 
@@ -2642,7 +2644,7 @@ void SymbolDatabase::addClassFunction(Scope **scope, const Token **tok, const To
     if (!tok1)
         return;
 
-    std::list<Scope>::iterator it1;
+    SegmentedList<Scope>::iterator it1;
 
     // search for match
     for (it1 = scopeList.begin(); it1 != scopeList.end(); ++it1) {
@@ -3223,7 +3225,7 @@ void SymbolDatabase::printOut(const char *title) const
     if (title)
         std::cout << "\n### " << title << " ###\n";
 
-    for (std::list<Scope>::const_iterator scope = scopeList.cbegin(); scope != scopeList.cend(); ++scope) {
+    for (SegmentedList<Scope>::const_iterator scope = scopeList.cbegin(); scope != scopeList.cend(); ++scope) {
         std::cout << "Scope: " << &*scope << " " << scope->type << std::endl;
         std::cout << "    className: " << scope->className << std::endl;
         std::cout << "    classDef: " << tokenToString(scope->classDef, mCtx.tokenizer) << std::endl;
@@ -3388,7 +3390,7 @@ void SymbolDatabase::printOut(const char *title) const
         std::cout << std::endl;
     }
 
-    for (std::list<Type>::const_iterator type = typeList.begin(); type != typeList.end(); ++type) {
+    for (SegmentedList<Type>::const_iterator type = typeList.begin(); type != typeList.end(); ++type) {
         std::cout << "Type: " << &(*type) << std::endl;
         std::cout << "    name: " << type->name() << std::endl;
         std::cout << "    classDef: " << tokenToString(type->classDef, mCtx.tokenizer) << std::endl;
@@ -3459,11 +3461,19 @@ void SymbolDatabase::printXml(std::ostream &out) const
 {
     out << std::setiosflags(std::ios::boolalpha);
 
-    std::set<const Variable *> variables;
+    // Variables in the order of the binary dump, so that both list them alike
+    std::vector<const Variable *> variables;
+    std::set<const Variable *> listed;
+    const auto addVariable = [&](const Variable *var) {
+        if (var && listed.insert(var).second)
+            variables.push_back(var);
+    };
+    for (const Variable *var : mVariableList)
+        addVariable(var);
 
     // Scopes..
-    out << "  <scopes>" << std::endl;
-    for (std::list<Scope>::const_iterator scope = scopeList.begin(); scope != scopeList.end(); ++scope) {
+    out << "  <scopes>\n";
+    for (SegmentedList<Scope>::const_iterator scope = scopeList.begin(); scope != scopeList.end(); ++scope) {
         out << "    <scope";
         out << " id=\"" << &*scope << "\"";
         out << " type=\"" << scope->type << "\"";
@@ -3478,12 +3488,12 @@ void SymbolDatabase::printXml(std::ostream &out) const
         if (scope->function)
             out << " function=\"" << scope->function << "\"";
         if (scope->functionList.empty() && scope->varlist.empty())
-            out << "/>" << std::endl;
+            out << "/>\n";
         else {
-            out << '>' << std::endl;
+            out << ">\n";
             if (!scope->functionList.empty()) {
-                out << "      <functionList>" << std::endl;
-                for (std::list<Function>::const_iterator function = scope->functionList.begin(); function != scope->functionList.end(); ++function) {
+                out << "      <functionList>\n";
+                for (SegmentedList<Function>::const_iterator function = scope->functionList.begin(); function != scope->functionList.end(); ++function) {
                     out << "        <function id=\"" << &*function << "\" tokenDef=\"" << function->tokenDef << "\" name=\"" << ErrorLogger::toxml(function->name()) << '\"';
                     out << " type=\"" << (function->type == Function::eConstructor? "Constructor" :
                                           function->type == Function::eCopyConstructor ? "CopyConstructor" :
@@ -3502,44 +3512,42 @@ void SymbolDatabase::printXml(std::ostream &out) const
                     if (function->isStatic())
                         out << " isStatic=\"true\"";
                     if (function->argCount() == 0U)
-                        out << "/>" << std::endl;
+                        out << "/>\n";
                     else {
-                        out << ">" << std::endl;
+                        out << ">\n";
                         for (unsigned int argnr = 0; argnr < function->argCount(); ++argnr) {
                             const Variable *arg = function->getArgumentVar(argnr);
-                            out << "          <arg nr=\"" << argnr+1 << "\" variable=\"" << arg << "\"/>" << std::endl;
-                            variables.insert(arg);
+                            out << "          <arg nr=\"" << argnr+1 << "\" variable=\"" << arg << "\"/>\n";
+                            addVariable(arg);
                         }
-                        out << "        </function>" << std::endl;
+                        out << "        </function>\n";
                     }
                 }
-                out << "      </functionList>" << std::endl;
+                out << "      </functionList>\n";
             }
             if (!scope->varlist.empty()) {
-                out << "      <varlist>" << std::endl;
-                for (std::list<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var)
-                    out << "        <var id=\""   << &*var << "\"/>" << std::endl;
-                out << "      </varlist>" << std::endl;
+                out << "      <varlist>\n";
+                for (SegmentedList<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
+                    out << "        <var id=\""   << &*var << "\"/>\n";
+                    addVariable(&*var);
+                }
+                out << "      </varlist>\n";
             }
-            out << "    </scope>" << std::endl;
+            out << "    </scope>\n";
         }
     }
-    out << "  </scopes>" << std::endl;
+    out << "  </scopes>\n";
 
     // Variables..
-    for (const Variable *var : mVariableList)
-        variables.insert(var);
-    out << "  <variables>" << std::endl;
+    out << "  <variables>\n";
     for (const Variable *var : variables) {
-        if (!var)
-            continue;
         out << "    <var id=\""   << var << '\"';
         out << " nameToken=\""      << var->nameToken() << '\"';
         out << " typeStartToken=\"" << var->typeStartToken() << '\"';
         out << " typeEndToken=\""   << var->typeEndToken() << '\"';
         out << " access=\""         << accessControlToString(var->mAccess) << '\"';
         out << " scope=\""          << var->scope() << '\"';
-        out << " constness=\""      << var->valueType()->constness << '\"';
+        out << " constness=\""      << (var->valueType() ? var->valueType()->constness : 0) << '\"';
         out << " isArgument=\""     << var->isArgument() << '\"';
         out << " isArray=\""        << var->isArray() << '\"';
         out << " isClass=\""        << var->isClass() << '\"';
@@ -3549,9 +3557,9 @@ void SymbolDatabase::printXml(std::ostream &out) const
         out << " isPointer=\""      << var->isPointer() << '\"';
         out << " isReference=\""    << var->isReference() << '\"';
         out << " isStatic=\""       << var->isStatic() << '\"';
-        out << "/>" << std::endl;
+        out << "/>\n";
     }
-    out << "  </variables>" << std::endl;
+    out << "  </variables>\n";
     out << std::resetiosflags(std::ios::boolalpha);
 }
 
@@ -3875,7 +3883,7 @@ Scope::Scope(const SymbolDatabase *check_, const Token *classDef_, const Scope *
 bool Scope::hasDefaultConstructor() const
 {
     if (numConstructors) {
-        std::list<Function>::const_iterator func;
+        SegmentedList<Function>::const_iterator func;
 
         for (func = functionList.begin(); func != functionList.end(); ++func) {
             if (func->type == Function::eConstructor && func->argCount() == 0)
@@ -4101,7 +4109,7 @@ const Token *Scope::checkVariable(const Token *tok, AccessControl varaccess, con
 
 const Variable *Scope::getVariable(const std::string &varname) const
 {
-    std::list<Variable>::const_iterator iter;
+    SegmentedList<Variable>::const_iterator iter;
 
     for (iter = varlist.begin(); iter != varlist.end(); ++iter) {
         if (iter->name() == varname)
@@ -4541,28 +4549,42 @@ bool Scope::hasInlineOrLambdaFunction() const
     return false;
 }
 
-void Scope::findFunctionInBase(const std::string & name, std::size_t args, std::vector<const Function *> & matches) const
+const Scope::FunctionCandidates &Scope::getFunctionCandidates(const std::string & name) const
 {
-    if (isClassOrStruct() && definedType && !definedType->derivedFrom.empty()) {
-        const std::vector<Type::BaseInfo> &derivedFrom = definedType->derivedFrom;
-        for (const Type::BaseInfo & i : derivedFrom) {
+    const std::pair<std::unordered_map<std::string, FunctionCandidates>::iterator, bool> inserted = mFunctionCandidates.emplace(name, FunctionCandidates());
+    FunctionCandidates &candidates = inserted.first->second;
+    if (!inserted.second) // known, or recursive inheritance
+        return candidates;
+
+    auto addFunctions = [&](const Scope *scope) {
+        auto range = scope->functionMap.equal_range(name);
+        for (std::multimap<std::string, const Function *>::const_iterator it = range.first; it != range.second; ++it)
+            candidates.functions.push_back(it->second);
+    };
+
+    addFunctions(this);
+
+    // check in anonumous namespaces
+    for (const Scope *nestedScope : nestedList) {
+        if (nestedScope->type == eNamespace && nestedScope->className.empty())
+            addFunctions(nestedScope);
+    }
+    candidates.numOwn = candidates.functions.size();
+
+    // check in base classes
+    if (isClassOrStruct() && definedType) {
+        for (const Type::BaseInfo & i : definedType->derivedFrom) {
             const Type *base = i.type;
             if (base && base->classScope) {
                 if (base->classScope == this) // Ticket #5120, #5125: Recursive class; tok should have been found already
                     continue;
 
-                auto range = base->classScope->functionMap.equal_range(name);
-                for (std::multimap<std::string, const Function*>::const_iterator it = range.first; it != range.second; ++it) {
-                    const Function *func = it->second;
-                    if (args == func->argCount() || (args < func->argCount() && args >= func->minArgCount())) {
-                        matches.push_back(func);
-                    }
-                }
-
-                base->classScope->findFunctionInBase(name, args, matches);
+                const std::vector<const Function *> &baseFunctions = base->classScope->getFunctionCandidates(name).functions;
+                candidates.functions.insert(candidates.functions.end(), baseFunctions.cbegin(), baseFunctions.cend());
             }
         }
     }
+    return candidates;
 }
 
 //---------------------------------------------------------------------------
@@ -4639,6 +4661,10 @@ static std::string getTypeString(const Token *typeToken)
 
 const Function* Scope::findFunction(const Token *tok, bool requireConst) const
 {
+    const FunctionCandidates &candidates = getFunctionCandidates(tok->str());
+    if (candidates.functions.empty())
+        return nullptr;
+
     const bool isCall = Token::Match(tok->next(), "(|{");
 
     const std::vector<const Token *> arguments = getArguments(tok);
@@ -4648,29 +4674,19 @@ const Function* Scope::findFunction(const Token *tok, bool requireConst) const
     // find all the possible functions that could match
     const std::size_t args = arguments.size();
 
-    auto addMatchingFunctions = [&](const Scope *scope) {
-        auto range = scope->functionMap.equal_range(tok->str());
-        for (std::multimap<std::string, const Function *>::const_iterator it = range.first; it != range.second; ++it) {
-            const Function *func = it->second;
+    for (std::size_t i = 0; i < candidates.functions.size(); ++i) {
+        const Function *func = candidates.functions[i];
+        if (i < candidates.numOwn) {
             if (!isCall || args == func->argCount() ||
                 (func->isVariadic() && args >= (func->argCount() - 1)) ||
                 (args < func->argCount() && args >= func->minArgCount())) {
                 matches.push_back(func);
             }
+        } else if (args == func->argCount() || (args < func->argCount() && args >= func->minArgCount())) {
+            matches.push_back(func);
         }
-    };
-
-    addMatchingFunctions(this);
-
-    // check in anonumous namespaces
-    for (const Scope *nestedScope : nestedList) {
-        if (nestedScope->type == eNamespace && nestedScope->className.empty())
-            addMatchingFunctions(nestedScope);
     }
 
-    // check in base classes
-    findFunctionInBase(tok->str(), args, matches);
-
     // Non-call => Do not match parameters
     if (!isCall) {
         return matches.empty() ? nullptr : matches[0];
@@ -4942,7 +4958,7 @@ const Function* SymbolDatabase::findFunction(const Token *tok) const
     }
 
     // check in enclosing scopes
-    else {
+    else if (mFunctionNames.find(tok->str()) != mFunctionNames.end()) {
         while (currScope) {
             const Function *func = currScope->findFunction(tok);
             if (func)
@@ -4958,7 +4974,7 @@ const Function* SymbolDatabase::findFunction(const Token *tok) const
 const Scope *SymbolDatabase::findScopeByName(const char* name) const
 {
     std::string sname = name;
-    for (std::list<Scope>::const_iterator it = scopeList.cbegin(); it != scopeList.cend(); ++it) {
+    for (SegmentedList<Scope>::const_iterator it = scopeList.cbegin(); it != scopeList.cend(); ++it) {
         if (it->className == sname)
             return &*it;
     }
@@ -5034,13 +5050,25 @@ Scope *Scope::findInNestedListRecursive(const std::string & name)
 
 const Function *Scope::getDestructor() const
 {
-    for (std::list<Function>::const_iterator it = functionList.cbegin(); it != functionList.cend(); ++it) {
+    for (SegmentedList<Function>::const_iterator it = functionList.cbegin(); it != functionList.cend(); ++it) {
         if (it->type == Function::eDestructor)
             return &(*it);
     }
     return nullptr;
 }
 
+void Scope::addFunction(const Function & func)
+{
+    // The memoized candidates of this scope and of its derived classes would be outdated
+    assert(mFunctionCandidates.empty());
+
+    functionList.push_back(func);
+
+    const Function * back = &functionList.back();
+
+    functionMap.insert(std::make_pair(back->tokenDef->str(), back));
+}
+
 //---------------------------------------------------------------------------
 
 bool SymbolDatabase::isCPP() const
@@ -5544,7 +5572,7 @@ void SymbolDatabase::setValueType(Token *tok, const ValueType &valuetype)
             const Scope *typeScope = vt1->typeScope;
             if (!typeScope)
                 return;
-            for (std::list<Variable>::const_iterator it = typeScope->varlist.begin(); it != typeScope->varlist.end(); ++it) {
+            for (SegmentedList<Variable>::const_iterator it = typeScope->varlist.begin(); it != typeScope->varlist.end(); ++it) {
                 if (it->nameToken()->str() == name) {
                     var = &*it;
                     break;
@@ -6390,61 +6418,54 @@ bool ValueType::fromLibraryType(const std::string &typestr, const Project* proje
     return false;
 }
 
-std::string ValueType::dump() const
+const char* ValueType::typeToString(Type type)
 {
-    std::ostringstream ret;
     switch (type) {
     case UNKNOWN_TYPE:
         return "";
     case NONSTD:
-        ret << "valueType-type=\"nonstd\"";
-        break;
+        return "nonstd";
     case RECORD:
-        ret << "valueType-type=\"record\"";
-        break;
+        return "record";
     case CONTAINER:
-        ret << "valueType-type=\"container\"";
-        break;
+        return "container";
     case ITERATOR:
-        ret << "valueType-type=\"iterator\"";
-        break;
+        return "iterator";
     case VOID:
-        ret << "valueType-type=\"void\"";
-        break;
+        return "void";
     case BOOL:
-        ret << "valueType-type=\"bool\"";
-        break;
+        return "bool";
     case CHAR:
-        ret << "valueType-type=\"char\"";
-        break;
+        return "char";
     case SHORT:
-        ret << "valueType-type=\"short\"";
-        break;
+        return "short";
     case WCHAR_T:
-        ret << "valueType-type=\"wchar_t\"";
-        break;
+        return "wchar_t";
     case INT:
-        ret << "valueType-type=\"int\"";
-        break;
+        return "int";
     case LONG:
-        ret << "valueType-type=\"long\"";
-        break;
+        return "long";
     case LONGLONG:
-        ret << "valueType-type=\"long long\"";
-        break;
+        return "long long";
     case UNKNOWN_INT:
-        ret << "valueType-type=\"unknown int\"";
-        break;
+        return "unknown int";
     case FLOAT:
-        ret << "valueType-type=\"float\"";
-        break;
+        return "float";
     case DOUBLE:
-        ret << "valueType-type=\"double\"";
-        break;
+        return "double";
     case LONGDOUBLE:
-        ret << "valueType-type=\"long double\"";
-        break;
+        return "long double";
     }
+    return "";
+}
+
+std::string ValueType::dump() const
+{
+    if (type == UNKNOWN_TYPE)
+        return "";
+
+    std::ostringstream ret;
+    ret << "valueType-type=\"" << typeToString(type) << '\"';
 
     switch (sign) {
     case Sign::UNKNOWN_SIGN:
@@ -25,14 +25,16 @@
 #include "config.h"
 #include "library.h"
 #include "mathlib.h"
+#include "segmentedlist.h"
 #include "token.h"
 #include "utils.h"
 
 #include <cstddef>
-#include <list>
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -1004,9 +1006,9 @@ public:
     const Token *classDef;   ///< class/struct/union/namespace token
     const Token *bodyStart;  ///< '{' token
     const Token *bodyEnd;    ///< '}' token
-    std::list<Function> functionList;
+    SegmentedList<Function> functionList;
     std::multimap<std::string, const Function *> functionMap;
-    std::list<Variable> varlist;
+    SegmentedList<Variable> varlist;
     const Scope *nestedIn;
     std::vector<Scope *> nestedList;
     unsigned int numConstructors;
@@ -1113,13 +1115,8 @@ public:
 
     const Function *getDestructor() const;
 
-    void addFunction(const Function & func) {
-        functionList.push_back(func);
-
-        const Function * back = &functionList.back();
-
-        functionMap.insert(make_pair(back->tokenDef->str(), back));
-    }
+    /** Only called while the scopes are created, before any function lookup */
+    void addFunction(const Function & func);
 
     bool hasDefaultConstructor() const;
 
@@ -1153,7 +1150,22 @@ private:
      */
     bool isVariableDeclaration(const Token* const tok, const Token*& vartok, const Token*& typetok) const;
 
-    void findFunctionInBase(const std::string & name, std::size_t args, std::vector<const Function *> & matches) const;
+    /** Functions of a name, visible in this scope */
+    struct FunctionCandidates {
+        /** Functions of this scope and of anonymous namespaces in it, then functions of base classes */
+        std::vector<const Function *> functions;
+        std::size_t numOwn;
+    };
+
+    /**
+     * @brief get the functions with given name, memoized per scope. The
+     * lookup is only done once all functions and base classes are known:
+     * the memo of a derived class contains the functions of its base
+     * classes, adding a function to a base class would not update it.
+     */
+    const FunctionCandidates &getFunctionCandidates(const std::string & name) const;
+
+    mutable std::unordered_map<std::string, FunctionCandidates> mFunctionCandidates;
 };
 
 enum class Reference : uint8_t {
@@ -1230,6 +1242,8 @@ public:
     static ValueType parseDecl(const Token *type, const Project* project);
 
     static Type typeFromString(const std::string &typestr, bool longType);
+    /** Name of the type in the dump, empty for UNKNOWN_TYPE */
+    static const char* typeToString(Type type);
 
     enum class MatchResult : uint8_t { UNKNOWN, SAME, FALLBACK1, FALLBACK2, NOMATCH };
     static MatchResult matchParameter(const ValueType *call, const ValueType *func);
@@ -1263,7 +1277,7 @@ public:
     ~SymbolDatabase();
 
     /** @brief Information about all namespaces/classes/structrues */
-    std::list<Scope> scopeList;
+    SegmentedList<Scope> scopeList;
 
     /** @brief Fast access to function scopes */
     std::vector<const Scope *> functionScopes;
@@ -1272,7 +1286,7 @@ public:
     std::vector<const Scope *> classAndStructScopes;
 
     /** @brief Fast access to types */
-    std::list<Type> typeList;
+    SegmentedList<Type> typeList;
 
     /**
      * @brief find a variable type if it's a user defined type
@@ -1398,7 +1412,10 @@ private:
     std::vector<const Variable *> mVariableList;
 
     /** list for missing types */
-    std::list<Type> mBlankTypes;
+    SegmentedList<Type> mBlankTypes;
+
+    /** names of all functions, calls of other names are not looked up */
+    std::unordered_set<std::string> mFunctionNames;
 
     bool mIsCpp;
     ValueType::Sign mDefaultSignedness;
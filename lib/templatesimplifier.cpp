@@ -22,6 +22,7 @@
 #include "errorlogger.h"
 #include "mathlib.h"
 #include "settings.h"
+#include "timer.h"
 #include "token.h"
 #include "tokenize.h"
 #include "tokenlist.h"
@@ -31,6 +32,7 @@
 #include <iostream>
 #include <map>
 #include <stack>
+#include <unordered_map>
 #include <utility>
 
 namespace {
@@ -43,26 +45,6 @@ namespace {
     private:
         const Token * const mToken;
     };
-
-    class FindName {
-    public:
-        explicit FindName(const std::string &name) : mName(name) {}
-        bool operator()(const TokenAndName &tokenAndName) const {
-            return tokenAndName.name() == mName;
-        }
-    private:
-        const std::string mName;
-    };
-
-    class FindFullName {
-    public:
-        explicit FindFullName(const std::string &fullName) : mFullName(fullName) {}
-        bool operator()(const TokenAndName &tokenAndName) const {
-            return tokenAndName.fullName() == mFullName;
-        }
-    private:
-        const std::string mFullName;
-    };
 }
 
 TokenAndName::TokenAndName(Token *token, const std::string &scope) :
@@ -237,6 +219,7 @@ TemplateSimplifier::~TemplateSimplifier()
 
 void TemplateSimplifier::fixAngleBrackets()
 {
+    Timer t("TemplateSimplifier::fixAngleBrackets", mSettings->showtime);
     for (Token *tok = mTokenList.front(); tok; tok = tok->next()) {
         // Ticket #6181: normalize C++11 template parameter list closing syntax
         if (tok->str() == "<" && templateParameters(tok)) {
@@ -261,6 +244,7 @@ void TemplateSimplifier::fixAngleBrackets()
 
 void TemplateSimplifier::cleanupAfterSimplify()
 {
+    Timer t("TemplateSimplifier::cleanupAfterSimplify", mSettings->showtime);
     bool goback = false;
     for (Token *tok = mTokenList.front(); tok; tok = tok->next()) {
         tok->clearTemplatesimplifier();
@@ -775,12 +759,31 @@ void TemplateSimplifier::addInstantiation(Token *token, const std::string &scope
     TokenAndName instantiation(token, scope);
 
     // check if instantiation already exists before adding it
-    std::list<TokenAndName>::iterator it = std::find(mTemplateInstantiations.begin(),
-                                           mTemplateInstantiations.end(),
-                                           instantiation);
+    const std::unordered_map<std::string, std::vector<TokenAndName *>>::const_iterator sameName = mInstantiationsByName.find(instantiation.name());
+    if (sameName != mInstantiationsByName.cend()) {
+        for (const TokenAndName *existing : sameName->second) {
+            if (existing && *existing == instantiation)
+                return;
+        }
+    }
+
+    appendInstantiation(token, scope);
+}
+
+void TemplateSimplifier::appendInstantiation(Token *token, const std::string &scope)
+{
+    mTemplateInstantiations.emplace_back(token, scope);
+    mInstantiationsByName[mTemplateInstantiations.back().name()].push_back(&mTemplateInstantiations.back());
+}
 
-    if (it == mTemplateInstantiations.end())
-        mTemplateInstantiations.emplace_back(instantiation);
+std::list<TokenAndName>::iterator TemplateSimplifier::eraseInstantiation(std::list<TokenAndName>::iterator it)
+{
+    // Keep the positions in the index stable for loops over it, erased entries are skipped
+    std::vector<TokenAndName *> &sameName = mInstantiationsByName[it->name()];
+    const std::vector<TokenAndName *>::iterator entry = std::find(sameName.begin(), sameName.end(), &*it);
+    if (entry != sameName.end())
+        *entry = nullptr;
+    return mTemplateInstantiations.erase(it);
 }
 
 static void getFunctionArguments(const Token *nameToken, std::vector<const Token *> &args)
@@ -823,6 +826,11 @@ void TemplateSimplifier::getTemplateInstantiations()
             functionNameMap.insert(std::make_pair(decl.name(), &decl));
     }
 
+    // first declaration of each full name
+    std::unordered_map<std::string, const TokenAndName *> declarationMap;
+    for (const auto & decl : mTemplateDeclarations)
+        declarationMap.emplace(decl.fullName(), &decl);
+
     const Token *skip = nullptr;
 
     for (Token *tok = mTokenList.front(); tok; tok = tok->next()) {
@@ -1017,10 +1025,10 @@ void TemplateSimplifier::getTemplateInstantiations()
                 while (true) {
                     const std::string fullName = scopeName + (scopeName.empty()?"":" :: ") +
                                                  qualification + (qualification.empty()?"":" :: ") + tok->str();
-                    const std::list<TokenAndName>::const_iterator it = std::find_if(mTemplateDeclarations.begin(), mTemplateDeclarations.end(), FindFullName(fullName));
-                    if (it != mTemplateDeclarations.end()) {
+                    const std::unordered_map<std::string, const TokenAndName *>::const_iterator it = declarationMap.find(fullName);
+                    if (it != declarationMap.cend()) {
                         // full name matches
-                        addInstantiation(tok, it->scope());
+                        addInstantiation(tok, it->second->scope());
                         break;
                     } else {
                         // full name doesn't match so try with using namespaces if available
@@ -1029,8 +1037,8 @@ void TemplateSimplifier::getTemplateInstantiations()
                             std::string fullNameSpace = scopeName + (scopeName.empty()?"":" :: ") +
                                                         nameSpace + (qualification.empty()?"":" :: ") + qualification;
                             std::string newFullName = fullNameSpace + " :: " + tok->str();
-                            const std::list<TokenAndName>::const_iterator it1 = std::find_if(mTemplateDeclarations.begin(), mTemplateDeclarations.end(), FindFullName(newFullName));
-                            if (it1 != mTemplateDeclarations.end()) {
+                            const std::unordered_map<std::string, const TokenAndName *>::const_iterator it1 = declarationMap.find(newFullName);
+                            if (it1 != declarationMap.cend()) {
                                 // insert using namespace into token stream
                                 std::string::size_type offset = 0;
                                 std::string::size_type pos = 0;
@@ -1040,7 +1048,7 @@ void TemplateSimplifier::getTemplateInstantiations()
                                 }
                                 qualificationTok->insertToken(nameSpace.substr(offset), emptyString, true);
                                 qualificationTok->insertToken("::", emptyString, true);
-                                addInstantiation(tok, it1->scope());
+                                addInstantiation(tok, it1->second->scope());
                                 found = true;
                                 break;
                             }
@@ -1252,7 +1260,7 @@ void TemplateSimplifier::useDefaultArgumentValues(TokenAndName &declaration)
                                                        mTemplateInstantiations.end(),
                                                        FindToken(tok2));
                 if (ti != mTemplateInstantiations.end())
-                    mTemplateInstantiations.erase(ti);
+                    eraseInstantiation(ti);
                 ++indentlevel;
             } else if (indentlevel > 0 && tok2->str() == ">")
                 --indentlevel;
@@ -1267,11 +1275,11 @@ void TemplateSimplifier::useDefaultArgumentValues(TokenAndName &declaration)
             continue;
 
         // don't strip args from uninstantiated templates
-        std::list<TokenAndName>::iterator ti2 = std::find_if(mTemplateInstantiations.begin(),
-                                                mTemplateInstantiations.end(),
-                                                FindName(declaration.name()));
-
-        if (ti2 == mTemplateInstantiations.end())
+        const std::unordered_map<std::string, std::vector<TokenAndName *>>::const_iterator sameName = mInstantiationsByName.find(declaration.name());
+        if (sameName == mInstantiationsByName.cend() ||
+            std::all_of(sameName->second.cbegin(), sameName->second.cend(), [](const TokenAndName *inst) {
+            return inst == nullptr;
+        }))
             continue;
 
         eraseTokens(eqtok, tok2);
@@ -1387,7 +1395,7 @@ void TemplateSimplifier::simplifyTemplateAliases()
             found = true;
 
             // erase this instantiation
-            it2 = mTemplateInstantiations.erase(it2);
+            it2 = eraseInstantiation(it2);
         }
 
         if (found) {
@@ -1853,7 +1861,15 @@ void TemplateSimplifier::expandTemplate(
         }
     }
 
-    for (Token *tok3 = mTokenList.front(); tok3; tok3 = tok3 ? tok3->next() : nullptr) {
+    // The template and its out of line members can't be used before the
+    // declaration, so start scanning there instead of at the front.
+    const bool hasOutOfLineMembers = mOutOfLineMemberNames.find(templateInstantiation.name()) != mOutOfLineMemberNames.end();
+    bool declarationExpanded = false;
+    for (Token *tok3 = templateDeclaration.token(); tok3; tok3 = tok3 ? tok3->next() : nullptr) {
+        // nothing left to expand after the declaration
+        if (declarationExpanded && !hasOutOfLineMembers)
+            break;
+
         if (inTemplateDefinition) {
             if (!endOfTemplateDefinition) {
                 if (isVariable) {
@@ -1893,6 +1909,7 @@ void TemplateSimplifier::expandTemplate(
 
         // Start of template..
         if (tok3 == templateDeclarationToken) {
+            declarationExpanded = true;
             tok3 = tok3->next();
             if (tok3->str() == "static")
                 tok3 = tok3->next();
@@ -2262,7 +2279,7 @@ void TemplateSimplifier::expandTemplate(
         // only add recursive instantiation if its arguments are a constant expression
         if (templateDeclaration.fullName() != fullName ||
             (inst.token->tokAt(2)->isNumber() || inst.token->tokAt(2)->isStandardType()))
-            mTemplateInstantiations.emplace_back(inst.token, inst.scope);
+            appendInstantiation(inst.token, inst.scope);
     }
 }
 
@@ -2988,7 +3005,6 @@ std::string TemplateSimplifier::getNewName(
 bool TemplateSimplifier::simplifyTemplateInstantiations(
     const TokenAndName &templateDeclaration,
     const std::list<const Token *> &specializations,
-    const std::time_t maxtime,
     std::set<std::string> &expandedtemplates)
 {
     // this variable is not used at the moment. The intention was to
@@ -3009,7 +3025,15 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
 
     bool instantiated = false;
 
-    for (const TokenAndName &instantiation : mTemplateInstantiations) {
+    // Only instantiations with the same name can match. The index grows while
+    // templates are expanded, so it is looked up by position.
+    const std::vector<TokenAndName *> &sameName = mInstantiationsByName[templateDeclaration.name()];
+    for (std::size_t i = 0; i < sameName.size(); ++i) {
+        // skip erased instantiations
+        if (!sameName[i])
+            continue;
+        const TokenAndName &instantiation = *sameName[i];
+
         // skip deleted instantiations
         if (!instantiation.token())
             continue;
@@ -3064,12 +3088,8 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
         Token * const tok2 = instantiation.token();
         if (mErrorLogger && !mTokenList.getFiles().empty())
             mErrorLogger->reportProgress(mTokenList.getFiles()[0], "TemplateSimplifier::simplifyTemplateInstantiations()", tok2->progressValue());
-#ifdef MAXTIME
-        if (std::time(0) > maxtime)
+        if (Settings::terminated() || mTokenizer->isBudgetExhausted("TemplateSimplifier::simplifyTemplateInstantiations"))
             return false;
-#else
-        (void)maxtime;
-#endif
         assert(mTokenList.validateToken(tok2)); // that assertion fails on examples from #6021
 
         const Token *startToken = tok2;
@@ -3125,12 +3145,8 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
         Token * tok2 = const_cast<Token *>(templateDeclaration.nameToken());
         if (mErrorLogger && !mTokenList.getFiles().empty())
             mErrorLogger->reportProgress(mTokenList.getFiles()[0], "TemplateSimplifier::simplifyTemplateInstantiations()", tok2->progressValue());
-#ifdef MAXTIME
-        if (std::time(0) > maxtime)
+        if (Settings::terminated() || mTokenizer->isBudgetExhausted("TemplateSimplifier::simplifyTemplateInstantiations"))
             return false;
-#else
-        (void)maxtime;
-#endif
         assert(mTokenList.validateToken(tok2)); // that assertion fails on examples from #6021
 
         Token *startToken = tok2;
@@ -3207,6 +3223,10 @@ void TemplateSimplifier::replaceTemplateUsage(
 {
     std::vector< std::pair<Token *, Token *> > removeTokens;
     for (Token *nameTok = mTokenList.front(); nameTok; nameTok = nameTok->next()) {
+        // cheap test first: without a pointer, only the name can match
+        if (nameTok->str() != instantiation.name() && (!nameTok->templateSimplifierPointers() || nameTok->templateSimplifierPointers()->empty()))
+            continue;
+
         if (!Token::Match(nameTok, "%name% <") ||
             Token::Match(nameTok, "template|const_cast|dynamic_cast|reinterpret_cast|static_cast"))
             continue;
@@ -3281,7 +3301,7 @@ void TemplateSimplifier::replaceTemplateUsage(
                     std::list<TokenAndName>::iterator ti;
                     for (ti = mTemplateInstantiations.begin(); ti != mTemplateInstantiations.end();) {
                         if (ti->token() == tok) {
-                            ti = mTemplateInstantiations.erase(ti);
+                            ti = eraseInstantiation(ti);
                             break;
                         } else {
                             ++ti;
@@ -3380,6 +3400,24 @@ void TemplateSimplifier::getPartialSpecializations()
     }
 }
 
+void TemplateSimplifier::getOutOfLineMembers()
+{
+    mOutOfLineMemberNames.clear();
+    for (const Token *tok = mTokenList.front(); tok; tok = tok->next()) {
+        if (!Token::Match(tok, "%name% <"))
+            continue;
+        const Token *closing = tok->next()->findClosingBracket();
+        if (!closing || !Token::Match(closing->next(), ":: ~| %name% ("))
+            continue;
+        for (const Token *prev = tok; prev && !Token::Match(prev, "[;{}]"); prev = prev->previous()) {
+            if (prev->str() == "template") {
+                mOutOfLineMemberNames.insert(tok->str());
+                break;
+            }
+        }
+    }
+}
+
 void TemplateSimplifier::fixForwardDeclaredDefaultArgumentValues()
 {
     // try to locate a matching declaration for each forward declaration
@@ -3616,9 +3654,7 @@ void TemplateSimplifier::printOut(const std::string & text) const
     }
 }
 
-void TemplateSimplifier::simplifyTemplates(
-    const std::time_t maxtime,
-    bool &codeWithTemplates)
+void TemplateSimplifier::simplifyTemplates(bool &codeWithTemplates)
 {
     // convert "sizeof ..." to "sizeof..."
     for (Token *tok = mTokenList.front(); tok; tok = tok->next()) {
@@ -3646,6 +3682,9 @@ void TemplateSimplifier::simplifyTemplates(
     const unsigned int passCountMax = 10;
     for (; passCount < passCountMax; ++passCount) {
         if (passCount) {
+            if (Settings::terminated() || mTokenizer->isBudgetExhausted("TemplateSimplifier::simplifyTemplates"))
+                return;
+
             // it may take more than one pass to simplify type aliases
             bool usingChanged = false;
             while (mTokenizer->simplifyUsing())
@@ -3661,6 +3700,7 @@ void TemplateSimplifier::simplifyTemplates(
             mTemplateSpecializationMap.clear();
             mTemplatePartialSpecializationMap.clear();
             mTemplateInstantiations.clear();
+            mInstantiationsByName.clear();
             mInstantiatedTemplates.clear();
             mExplicitInstantiationsToDelete.clear();
             mTemplateNamePos.clear();
@@ -3692,6 +3732,9 @@ void TemplateSimplifier::simplifyTemplates(
         // Locate possible instantiations of templates..
         getTemplateInstantiations();
 
+        // Locate member functions implemented outside of their class template
+        getOutOfLineMembers();
+
         // Template arguments with default values
         useDefaultArgumentValues();
 
@@ -3702,24 +3745,21 @@ void TemplateSimplifier::simplifyTemplates(
 
         std::set<std::string> expandedtemplates;
 
+        // get specializations..
+        std::unordered_map<std::string, std::list<const Token *>> specializations;
+        for (std::list<TokenAndName>::const_iterator iter2 = mTemplateDeclarations.begin(); iter2 != mTemplateDeclarations.end(); ++iter2) {
+            if (iter2->isAlias() || iter2->isFriend())
+                continue;
+            specializations[iter2->fullName()].push_back(iter2->nameToken());
+        }
+
         for (std::list<TokenAndName>::reverse_iterator iter1 = mTemplateDeclarations.rbegin(); iter1 != mTemplateDeclarations.rend(); ++iter1) {
             if (iter1->isAlias() || iter1->isFriend())
                 continue;
 
-            // get specializations..
-            std::list<const Token *> specializations;
-            for (std::list<TokenAndName>::const_iterator iter2 = mTemplateDeclarations.begin(); iter2 != mTemplateDeclarations.end(); ++iter2) {
-                if (iter2->isAlias() || iter2->isFriend())
-                    continue;
-
-                if (iter1->fullName() == iter2->fullName())
-                    specializations.push_back(iter2->nameToken());
-            }
-
             const bool instantiated = simplifyTemplateInstantiations(
                                           *iter1,
-                                          specializations,
-                                          maxtime,
+                                          specializations[iter1->fullName()],
                                           expandedtemplates);
             if (instantiated)
                 mInstantiatedTemplates.push_back(*iter1);
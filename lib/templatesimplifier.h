@@ -25,12 +25,12 @@
 
 #include "config.h"
 
-#include <ctime>
 #include <list>
 #include <map>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class ErrorLogger;
@@ -304,13 +304,10 @@ public:
     static bool getTemplateNamePositionTemplateVariable(const Token *tok, int &namepos);
 
     /**
-     * Simplify templates
-     * @param maxtime time when the simplification should be stopped
+     * Simplify templates. The simplification is stopped when the budget of the file is used up.
      * @param codeWithTemplates output parameter that is set if code contains templates
      */
-    void simplifyTemplates(
-        const std::time_t maxtime,
-        bool &codeWithTemplates);
+    void simplifyTemplates(bool &codeWithTemplates);
 
     /**
      * Simplify constant calculations such as "1+2" => "3"
@@ -386,24 +383,41 @@ private:
      */
     void getPartialSpecializations();
 
+    /**
+     * Collect the names of class templates with member functions
+     * implemented outside of the class definition.
+     */
+    void getOutOfLineMembers();
+
     /**
      * simplify template aliases
      */
     void simplifyTemplateAliases();
 
+    /**
+     * Append to mTemplateInstantiations and its index
+     * @param token template instantiation name token "name<...>"
+     * @param scope full qualification of instantiation
+     */
+    void appendInstantiation(Token *token, const std::string &scope);
+
+    /**
+     * Erase from mTemplateInstantiations and its index
+     * @return iterator following the erased instantiation
+     */
+    std::list<TokenAndName>::iterator eraseInstantiation(std::list<TokenAndName>::iterator it);
+
     /**
      * Simplify templates : expand all instantiations for a template
      * @todo It seems that inner templates should be instantiated recursively
      * @param templateDeclaration template declaration
      * @param specializations template specializations (list each template name token)
-     * @param maxtime time when the simplification will stop
      * @param expandedtemplates all templates that has been expanded so far. The full names are stored.
      * @return true if the template was instantiated
      */
     bool simplifyTemplateInstantiations(
         const TokenAndName &templateDeclaration,
         const std::list<const Token *> &specializations,
-        const std::time_t maxtime,
         std::set<std::string> &expandedtemplates);
 
     /**
@@ -514,7 +528,10 @@ private:
     std::map<Token *, Token *> mTemplateSpecializationMap;
     std::map<Token *, Token *> mTemplatePartialSpecializationMap;
     std::list<TokenAndName> mTemplateInstantiations;
+    /** mTemplateInstantiations by name in list order, erased instantiations are nullptr */
+    std::unordered_map<std::string, std::vector<TokenAndName *>> mInstantiationsByName;
     std::list<TokenAndName> mInstantiatedTemplates;
+    std::unordered_set<std::string> mOutOfLineMemberNames;
     std::list<TokenAndName> mMemberFunctionsToDelete;
     std::vector<TokenAndName> mExplicitInstantiationsToDelete;
     std::vector<TokenAndName> mTypesUsedInTemplateInstantiation;
@@ -19,8 +19,10 @@
 
 #include "threadexecutor.h"
 
+#include "addonexecutor.h"
 #include "config.h"
 #include "cppcheck.h"
+#include "reportwriter.h"
 #include "settings.h"
 #include "suppressions.h"
 
@@ -28,16 +30,17 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 
 ThreadExecutor::ThreadExecutor(std::list<CTU::CTUInfo>& files, Settings& settings, Project& project, ErrorLogger& errorLogger)
-    : mCTUs(files), mSettings(settings), mProject(project), mErrorLogger(errorLogger)
+    : mCTUs(files), mSettings(settings), mProject(project), mErrorLogger(errorLogger), mNextIndex(0), mStreaming(false), mDiscovering(false), mReportWriter(nullptr), mPerformanceReport(nullptr), mCancellationToken(nullptr), mMarkupSequence(0), mEndSequence(0), mProgressInterval(1000)
+{
+}
+
+ThreadExecutor::~ThreadExecutor()
 {
-    mProcessedFiles = 0;
-    mTotalFiles = 0;
-    mProcessedSize = 0;
-    mTotalFileSize = 0;
 }
 
 void ThreadExecutor::addFileContent(const std::string &path, const std::string &content)
@@ -45,9 +48,125 @@ void ThreadExecutor::addFileContent(const std::string &path, const std::string &
     mFileContents[path] = content;
 }
 
-unsigned int ThreadExecutor::checkSync()
+/** Reports the errors of the file a thread is currently checking */
+class ThreadExecutor::FileReporter : public ErrorLogger {
+public:
+    explicit FileReporter(ThreadExecutor& executor) : index(0), markupStage(false), progress(nullptr), mExecutor(executor) {}
+
+    void reportOut(const std::string &outmsg) override {
+        mExecutor.reportOut(outmsg);
+    }
+    void reportErr(const ErrorMessage &msg) override {
+        mExecutor.reportErr(msg, index, markupStage);
+    }
+    void reportProgress(const std::string &filename, const char stage[], const std::size_t value) override {
+        (void)filename;
+        if (progress)
+            progress->progress(stage, value);
+    }
+
+    /** Position of the file in the list */
+    std::size_t index;
+    bool markupStage;
+    /** Counters of this thread, nullptr if progress is not reported */
+    ProgressMonitor::Worker* progress;
+
+private:
+    ThreadExecutor& mExecutor;
+};
+
+void ThreadExecutor::startDiscovery()
 {
+    std::lock_guard<std::mutex> lock(mFileSync);
+    mStreaming = true;
+    mDiscovering = true;
     mItNextCTU = mCTUs.begin();
+    mNextIndex = 0;
+    mHeld.assign(mCTUs.size(), HeldReport{{}, false});
+    std::size_t totalSize = 0;
+    for (const CTU::CTUInfo& ctu : mCTUs)
+        totalSize += ctu.filesize;
+    mProgress.setTotal(mCTUs.size(), totalSize);
+}
+
+void ThreadExecutor::addCTUs(std::list<CTU::CTUInfo>& ctus)
+{
+    if (ctus.empty())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mFileSync);
+        std::size_t totalSize = 0;
+        for (const CTU::CTUInfo& ctu : ctus)
+            totalSize += ctu.filesize;
+        mProgress.addTotal(ctus.size(), totalSize);
+        {
+            std::lock_guard<std::mutex> sequenceLock(mSequenceSync);
+            mHeld.resize(mHeld.size() + ctus.size(), HeldReport{{}, false});
+        }
+        const std::list<CTU::CTUInfo>::iterator first = ctus.begin();
+        mCTUs.splice(mCTUs.end(), ctus);
+        // The threads waiting at the end continue with the new files
+        if (mItNextCTU == mCTUs.end())
+            mItNextCTU = first;
+    }
+    mFileAdded.notify_all();
+}
+
+void ThreadExecutor::finishDiscovery()
+{
+    {
+        std::lock_guard<std::mutex> lock(mFileSync);
+        mDiscovering = false;
+
+        // Report in the order of the file names, as if all files were known from the start
+        std::vector<std::pair<const std::string*, std::size_t>> order;
+        order.reserve(mCTUs.size());
+        for (const CTU::CTUInfo& ctu : mCTUs)
+            order.emplace_back(&ctu.sourcefile, order.size());
+        std::sort(order.begin(), order.end(), [](const std::pair<const std::string*, std::size_t>& lhs, const std::pair<const std::string*, std::size_t>& rhs) {
+            return *lhs.first < *rhs.first;
+        });
+
+        std::lock_guard<std::mutex> sequenceLock(mSequenceSync);
+        const std::size_t first = mReportWriter ? mReportWriter->reserve(mCTUs.size()) : 0;
+        mEndSequence = first + mCTUs.size();
+        mSequences.resize(mCTUs.size());
+        for (std::size_t rank = 0; rank < order.size(); ++rank)
+            mSequences[order[rank].second] = first + rank;
+
+        // Messages of the files checked so far
+        if (mReportWriter) {
+            for (std::size_t index = 0; index < mHeld.size(); ++index) {
+                for (const ErrorMessage& msg : mHeld[index].messages)
+                    mReportWriter->report(msg, mSequences[index]);
+                if (mHeld[index].done)
+                    mReportWriter->done(mSequences[index]);
+            }
+        }
+        mHeld.clear();
+    }
+    mFileAdded.notify_all();
+}
+
+unsigned int ThreadExecutor::checkSync()
+{
+    if (!mStreaming) {
+        mItNextCTU = mCTUs.begin();
+        mNextIndex = 0;
+
+        // One sequence number per file
+        const std::size_t first = mReportWriter ? mReportWriter->reserve(mCTUs.size()) : 0;
+        mEndSequence = first + mCTUs.size();
+        mSequences.resize(mCTUs.size());
+        for (std::size_t index = 0; index < mCTUs.size(); ++index)
+            mSequences[index] = first + index;
+
+        std::size_t totalSize = 0;
+        for (auto i = mCTUs.begin(); i != mCTUs.end(); ++i) {
+            totalSize += i->filesize;
+        }
+        mProgress.setTotal(mCTUs.size(), totalSize);
+    }
 
     unsigned int jobs = mSettings.jobs;
     if (jobs == 0)
@@ -55,74 +174,133 @@ unsigned int ThreadExecutor::checkSync()
 
     mResult = 0;
 
-    mProcessedFiles = 0;
-    mProcessedSize = 0;
-    mTotalFiles = mCTUs.size();
-    mTotalFileSize = 0;
-    for (auto i = mCTUs.begin(); i != mCTUs.end(); ++i) {
-        mTotalFileSize += i->filesize;
+    if (mSettings.output.isEnabled(Output::progress)) {
+        mProgress.start(jobs, mProgressInterval, [this](const ProgressStatus& status) {
+            // Keeps the lines intact, only threads that print a message wait
+            std::lock_guard<std::mutex> lock(mReportSync);
+            mErrorLogger.reportProgressStatus(status);
+        });
     }
 
+    const bool markupStage = !mProject.library.markupExtensions().empty();
+
+    // The threads go on with the next file while the addons of a file are running
+    if (!mProject.addons.empty())
+        mAddonExecutor.reset(new AddonExecutor(mSettings.addonJobs, std::chrono::seconds(mSettings.addonTimeout)));
+
     if (jobs != 1) {
         std::vector<std::thread> threadHandles;
         threadHandles.reserve(jobs);
         for (unsigned int i = 0; i < jobs; ++i) {
-            threadHandles.emplace_back(std::bind(&ThreadExecutor::threadProc, this, false));
+            threadHandles.emplace_back(std::bind(&ThreadExecutor::threadProc, this, false, i));
         }
         for (unsigned int i = 0; i < jobs; ++i) {
             threadHandles[i].join();
         }
+    } else {
+        threadProc(false, 0);
+    }
+    if (mAddonExecutor)
+        mAddonExecutor->wait();
+
+    if (mStreaming) {
+        // Checking stops early when terminated
+        {
+            std::unique_lock<std::mutex> lock(mFileSync);
+            mFileAdded.wait(lock, [this]() {
+                return !mDiscovering;
+            });
+        }
+        // The files were added in the order they were found
+        mCTUs.sort([](const CTU::CTUInfo& lhs, const CTU::CTUInfo& rhs) {
+            return lhs.sourcefile < rhs.sourcefile;
+        });
+    }
 
-        // Second stage: Some markup files need to be processed after all c/cpp files were checked
-        if (!mProject.library.markupExtensions().empty()) {
-            mItNextCTU = mCTUs.begin();
-            threadHandles.clear();
+    // Second stage: Some markup files need to be processed after all c/cpp files were checked
+    if (markupStage) {
+        mItNextCTU = mCTUs.begin();
+        mNextIndex = 0;
+        if (mReportWriter)
+            mMarkupSequence = mReportWriter->reserve(mCTUs.size());
+        mEndSequence = mMarkupSequence + mCTUs.size();
+
+        if (jobs != 1) {
+            std::vector<std::thread> threadHandles;
+            threadHandles.reserve(jobs);
             for (unsigned int i = 0; i < jobs; ++i) {
-                threadHandles.emplace_back(std::bind(&ThreadExecutor::threadProc, this, true));
+                threadHandles.emplace_back(std::bind(&ThreadExecutor::threadProc, this, true, i));
             }
             for (unsigned int i = 0; i < jobs; ++i) {
                 threadHandles[i].join();
             }
-        }
-    } else {
-        threadProc(false);
-
-        // Second stage: Some markup files need to be processed after all c/cpp files were checked
-        if (!mProject.library.markupExtensions().empty()) {
-            mItNextCTU = mCTUs.begin();
-            threadProc(true);
+        } else {
+            threadProc(true, 0);
         }
     }
 
+    mAddonExecutor.reset();
+    mProgress.stop();
+
+    // Files that were not checked due to termination do not block later output
+    if (mReportWriter)
+        mReportWriter->skipTo(mEndSequence);
+
     return mResult;
 }
 
 std::thread ThreadExecutor::checkAsync(std::function<void(unsigned int)> callback)
 {
-    return std::thread([&]() {
-        unsigned int retval = checkSync();
+    return std::thread([this, callback]() {
+        const unsigned int retval = checkSync();
         callback(retval);
     });
 }
 
-void ThreadExecutor::threadProc(bool markupStage)
+void ThreadExecutor::threadProc(bool markupStage, std::size_t worker)
 {
-    CppCheck fileChecker(*this, mSettings, mProject, false);
-
+    const CancellationToken::Scope cancellation(mCancellationToken);
+    FileReporter reporter(*this);
+    reporter.markupStage = markupStage;
+    if (mSettings.output.isEnabled(Output::progress))
+        reporter.progress = &mProgress.worker(worker);
+    CppCheck fileChecker(reporter, mSettings, mProject, false);
+    fileChecker.setPerformanceReport(mPerformanceReport);
+
+    std::unique_lock<std::mutex> lock(mFileSync);
     while (!mSettings.terminated()) {
-        mFileSync.lock();
         if (mItNextCTU == mCTUs.end()) {
-            mFileSync.unlock();
-            break;
+            if (markupStage || !mDiscovering)
+                break;
+            mFileAdded.wait(lock);
+            continue;
         }
 
         CTU::CTUInfo* ctu = &*mItNextCTU;
         ++mItNextCTU;
+        reporter.index = mNextIndex++;
 
-        mFileSync.unlock();
+        lock.unlock();
 
-        if (markupStage != mProject.library.processMarkupAfterCode(ctu->sourcefile))
+        if (markupStage != mProject.library.processMarkupAfterCode(ctu->sourcefile)) {
+            fileDone(reporter.index, markupStage);
+            lock.lock();
             continue;
+        }
+
+        if (reporter.progress)
+            reporter.progress->startFile(&ctu->sourcefile);
+
+        if (mAddonExecutor) {
+            // The file is done when its addons are
+            const std::shared_ptr<FileReporter> addonReporter = std::make_shared<FileReporter>(*this);
+            addonReporter->index = reporter.index;
+            addonReporter->markupStage = markupStage;
+            fileChecker.deferAddons(mAddonExecutor.get(), addonReporter.get(), [this, addonReporter](unsigned int result) {
+                mResult += result;
+                fileDone(addonReporter->index, addonReporter->markupStage);
+            });
+        }
 
         const std::map<std::string, std::string>::const_iterator fileContent = mFileContents.find(ctu->sourcefile);
         if (fileContent != mFileContents.cend()) {
@@ -133,15 +311,29 @@ void ThreadExecutor::threadProc(bool markupStage)
             mResult += fileChecker.check(ctu);
         }
 
-        if (mSettings.output.isEnabled(Output::progress)) {
-            mReportSync.lock();
-            mProcessedSize += ctu->filesize;
-            mProcessedFiles++;
-            mErrorLogger.reportStatus(mProcessedFiles, mTotalFiles, mProcessedSize, mTotalFileSize);
-            mReportSync.unlock();
-        }
+        if (!mAddonExecutor)
+            fileDone(reporter.index, markupStage);
+
+        if (reporter.progress)
+            reporter.progress->fileDone(ctu->filesize);
+
+        lock.lock();
+    }
+}
 
+void ThreadExecutor::fileDone(std::size_t index, bool markupStage)
+{
+    if (!mReportWriter)
+        return;
+    if (markupStage) {
+        mReportWriter->done(mMarkupSequence + index);
+        return;
     }
+    std::lock_guard<std::mutex> lock(mSequenceSync);
+    if (index < mSequences.size())
+        mReportWriter->done(mSequences[index]);
+    else
+        mHeld[index].done = true;
 }
 
 void ThreadExecutor::reportOut(const std::string &outmsg)
@@ -158,6 +350,35 @@ void ThreadExecutor::reportErr(const ErrorMessage &msg)
     if (mProject.nomsg.isSuppressed(msg.toSuppressionsErrorMessage()))
         return;
 
+    if (mReportWriter)
+        mReportWriter->report(msg);
+    else
+        reportUnique(msg);
+}
+
+void ThreadExecutor::reportErr(const ErrorMessage &msg, std::size_t index, bool markupStage)
+{
+    if (mProject.nomsg.isSuppressed(msg.toSuppressionsErrorMessage()))
+        return;
+
+    if (!mReportWriter) {
+        reportUnique(msg);
+        return;
+    }
+
+    if (markupStage) {
+        mReportWriter->report(msg, mMarkupSequence + index);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mSequenceSync);
+    if (index < mSequences.size())
+        mReportWriter->report(msg, mSequences[index]);
+    else
+        mHeld[index].messages.push_back(msg);
+}
+
+void ThreadExecutor::reportUnique(const ErrorMessage &msg)
+{
     // Alert only about unique errors
     bool reportError = false;
     const std::string errmsg = msg.toString(mSettings.verbose);
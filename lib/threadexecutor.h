@@ -23,17 +23,26 @@
 #include "config.h"
 #include "errorlogger.h"
 #include "ctu.h"
+#include "progress.h"
 
 #include <cstddef>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <mutex>
 #include <atomic>
+#include <chrono>
 #include <thread>
 #include <functional>
+#include <condition_variable>
+#include <vector>
 
 
+class AddonExecutor;
+class CancellationToken;
+class PerformanceReport;
+class ReportWriter;
 class Settings;
 
 /// @addtogroup CLI
@@ -46,12 +55,56 @@ class Settings;
 class CPPCHECKLIB ThreadExecutor : public ErrorLogger {
 public:
     ThreadExecutor(std::list<CTU::CTUInfo>& files, Settings& settings, Project& project, ErrorLogger& errorLogger);
+    ~ThreadExecutor() override;
     ThreadExecutor(const ThreadExecutor &) = delete;
     void operator=(const ThreadExecutor &) = delete;
 
     unsigned int checkSync();
+    /** Run checkSync() in a new thread, callback gets its result in that thread */
     std::thread checkAsync(std::function<void(unsigned int)> callback);
 
+    /**
+     * @brief Check files while they are being discovered. Call before
+     * checkSync(), then add the files with addCTUs() from another thread
+     * and call finishDiscovery() when all are added. The messages are
+     * still reported in the order of the file names, and the CTUs are
+     * sorted by file name when checkSync() returns.
+     */
+    void startDiscovery();
+
+    /** Move given CTUs to the end of the file list, thread safe */
+    void addCTUs(std::list<CTU::CTUInfo>& ctus);
+
+    /** All files are added, checkSync() returns once they are checked */
+    void finishDiscovery();
+
+    /**
+     * @brief Report errors through given writer instead of the ErrorLogger.
+     * The messages of each file are tagged with a sequence number, so the
+     * writer outputs them in file order regardless of the number of jobs.
+     */
+    void setReportWriter(ReportWriter* reportWriter) {
+        mReportWriter = reportWriter;
+    }
+
+    /**
+     * @brief Interval of the progress reports (--output=progress). They are
+     * made by a separate thread, the checking threads only update counters.
+     */
+    void setProgressInterval(std::chrono::milliseconds interval) {
+        mProgressInterval = interval;
+    }
+
+    /** Write the measurements of every checked file to given report (--perf-report) */
+    void setPerformanceReport(PerformanceReport* performanceReport) {
+        mPerformanceReport = performanceReport;
+    }
+
+    /** Stop checking when given token is cancelled, in addition to Settings::terminate() */
+    void setCancellationToken(const CancellationToken* cancellationToken) {
+        mCancellationToken = cancellationToken;
+    }
+
     void reportOut(const std::string &outmsg) override;
     void reportErr(const ErrorMessage &msg) override;
 
@@ -73,20 +126,50 @@ private:
 private:
     std::map<std::string, std::string> mFileContents;
     std::list<CTU::CTUInfo>::iterator mItNextCTU;
+    std::size_t mNextIndex;
     std::mutex mFileSync;
 
+    /** Files are added while checking */
+    bool mStreaming;
+    /** More files can be added */
+    bool mDiscovering;
+    std::condition_variable mFileAdded;
+
+    /** Messages of a file checked before its sequence number is known */
+    struct HeldReport {
+        std::vector<ErrorMessage> messages;
+        bool done;
+    };
+    /** By index in the file list, while discovering */
+    std::vector<HeldReport> mHeld;
+    /** Sequence numbers of the first stage, by index in the file list */
+    std::vector<std::size_t> mSequences;
+    std::mutex mSequenceSync;
+
     std::list<std::string> mErrorList;
     std::mutex mErrorSync;
 
     std::mutex mReportSync;
 
-    std::atomic<std::size_t> mProcessedFiles;
-    std::atomic<std::size_t> mTotalFiles;
-    std::atomic<std::size_t> mProcessedSize;
-    std::atomic<std::size_t> mTotalFileSize;
+    ReportWriter* mReportWriter;
+    PerformanceReport* mPerformanceReport;
+    const CancellationToken* mCancellationToken;
+    std::size_t mMarkupSequence;
+    std::size_t mEndSequence;
+
+    /** Runs the addons of all files while checking, nullptr if there are none */
+    std::unique_ptr<AddonExecutor> mAddonExecutor;
+
+    ProgressMonitor mProgress;
+    std::chrono::milliseconds mProgressInterval;
     std::atomic<unsigned int> mResult;
 
-    void threadProc(bool markupStage);
+    class FileReporter;
+
+    void threadProc(bool markupStage, std::size_t worker);
+    void reportErr(const ErrorMessage &msg, std::size_t index, bool markupStage);
+    void fileDone(std::size_t index, bool markupStage);
+    void reportUnique(const ErrorMessage &msg);
 };
 
 /// @}
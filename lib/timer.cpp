@@ -19,18 +19,33 @@
 
 #include "timer.h"
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
+#if defined(_WIN32)
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__linux__)
+#include <cstdio>
+#include <unistd.h>
+#endif
+
 
 TimerResults Timer::results;
 
 namespace {
     struct TimerResultsCollector {
+        TimerResultsCollector() : mPhaseTimes(nullptr) {}
+
         void start(Timer* timer, bool intermediate);
-        void stop(Timer* timer, std::clock_t clocks, bool intermediate);
+        void stop(Timer* timer, Settings::SHOWTIME_MODES showtimeMode, std::clock_t clocks, double seconds, bool intermediate);
 
         std::vector<Timer*> mHierachy;
+        PhaseTimes* mPhaseTimes;
     };
 
     thread_local TimerResultsCollector trc;
@@ -45,7 +60,7 @@ void TimerResultsCollector::start(Timer* timer, bool intermediate)
     }
 }
 
-void TimerResultsCollector::stop(Timer* timer, std::clock_t clocks, bool intermediate)
+void TimerResultsCollector::stop(Timer* timer, Settings::SHOWTIME_MODES showtimeMode, std::clock_t clocks, double seconds, bool intermediate)
 {
     if (!intermediate) {
         mHierachy.pop_back();
@@ -53,12 +68,23 @@ void TimerResultsCollector::stop(Timer* timer, std::clock_t clocks, bool interme
             mHierachy.back()->start(true);
         }
     }
-    for (size_t i = 0; i < mHierachy.size(); i++)
-        if (mHierachy[i] != timer)
-            Timer::results.mResults[mHierachy[i]->getName()].mAdditionalClocks += clocks;
-    Timer::results.mResults[timer->getName()].mClocks += clocks;
-    if (!intermediate)
-        Timer::results.mResults[timer->getName()].mNumberOfResults++;
+    if (showtimeMode == Settings::SHOWTIME_SUMMARY || showtimeMode == Settings::SHOWTIME_TOP5) {
+        for (size_t i = 0; i < mHierachy.size(); i++)
+            if (mHierachy[i] != timer)
+                Timer::results.mResults[mHierachy[i]->getName()].mAdditionalClocks += clocks;
+        Timer::results.mResults[timer->getName()].mClocks += clocks;
+        if (!intermediate)
+            Timer::results.mResults[timer->getName()].mNumberOfResults++;
+    }
+    if (mPhaseTimes) {
+        for (size_t i = 0; i < mHierachy.size(); i++)
+            if (mHierachy[i] != timer)
+                mPhaseTimes->mPhases[mHierachy[i]->getName()].mAdditionalSeconds += seconds;
+        PhaseTimes::Data& data = mPhaseTimes->mPhases[timer->getName()];
+        data.mSeconds += seconds;
+        if (!intermediate)
+            data.mNumberOfResults++;
+    }
 }
 
 Timer::Timer(const std::string& str, Settings::SHOWTIME_MODES showtimeMode)
@@ -83,29 +109,133 @@ Timer::~Timer()
 
 void Timer::start(bool intermediate)
 {
-    if (mShowTimeMode == Settings::SHOWTIME_NONE)
+    if (mShowTimeMode == Settings::SHOWTIME_NONE && !trc.mPhaseTimes)
         return;
     if (mStopped) {
         mStopped = false;
         if (!intermediate)
             trc.start(this, intermediate);
         mStart = std::clock();
+        mWallStart = std::chrono::steady_clock::now();
     }
 }
 
 void Timer::stop(bool intermediate)
 {
-    if (mShowTimeMode == Settings::SHOWTIME_NONE)
-        return;
     if (!mStopped) {
-        const std::clock_t end = std::clock();
-        const std::clock_t diff = end - mStart;
+        const std::clock_t diff = std::clock() - mStart;
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - mWallStart).count();
 
         mAccumulated += diff;
-        if (mShowTimeMode == Settings::SHOWTIME_FILE) {
-        } else
-            trc.stop(this, diff, intermediate);
+        trc.stop(this, mShowTimeMode, diff, seconds, intermediate);
     }
 
     mStopped = true;
 }
+
+void Timer::record(PhaseTimes* phaseTimes)
+{
+    trc.mPhaseTimes = phaseTimes;
+}
+
+
+FileBudget::FileBudget(unsigned int maxSeconds, std::size_t maxMegabytes)
+    : mStart(std::chrono::steady_clock::now())
+    , mLastMemorySample(mStart)
+    , mStartMemory(maxMegabytes ? currentMemoryUsage() : 0)
+    , mMaxMemory(maxMegabytes * 1024 * 1024)
+    , mUsedMemory(0)
+    , mMaxMillis(static_cast<std::size_t>(maxSeconds) * 1000)
+    , mTier(FULL)
+{
+}
+
+FileBudget::Tier FileBudget::check(const char phase[])
+{
+    if (!isLimited() || mTier == EXHAUSTED)
+        return mTier;
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    // Usage in per mille of the budget; the larger of time and memory counts
+    std::size_t usage = 0;
+    if (mMaxMillis) {
+        const std::size_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - mStart).count();
+        usage = elapsed * 1000 / mMaxMillis;
+    }
+    if (mMaxMemory) {
+        // Reading the memory usage is comparatively expensive, so it is sampled
+        if (now - mLastMemorySample >= std::chrono::milliseconds(20)) {
+            mLastMemorySample = now;
+            const std::size_t memory = currentMemoryUsage();
+            mUsedMemory = memory > mStartMemory ? memory - mStartMemory : 0;
+        }
+        usage = std::max(usage, mUsedMemory / (mMaxMemory / 1000 + 1));
+    }
+
+    return update(usage, phase);
+}
+
+FileBudget::Tier FileBudget::update(std::size_t usage, const char phase[])
+{
+    if (mTier == EXHAUSTED)
+        return mTier;
+
+    Tier tier = FULL;
+    if (usage >= 1000)
+        tier = EXHAUSTED;
+    else if (usage >= 750)
+        tier = MINIMAL;
+    else if (usage >= 500)
+        tier = REDUCED;
+
+    if (tier > mTier) {
+        mTier = tier;
+        mCuts.emplace_back(tier, phase);
+    }
+    return mTier;
+}
+
+const char* FileBudget::tierName(Tier tier)
+{
+    switch (tier) {
+    case FULL:
+        return "full";
+    case REDUCED:
+        return "reduced ValueFlow iterations";
+    case MINIMAL:
+        return "no ValueFlow forward analysis";
+    case EXHAUSTED:
+        return "aborted";
+    }
+    return "";
+}
+
+std::size_t FileBudget::currentMemoryUsage()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return pmc.WorkingSetSize;
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) == KERN_SUCCESS)
+        return info.resident_size;
+    return 0;
+#elif defined(__linux__)
+    std::FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f)
+        return 0;
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    const int n = std::fscanf(f, "%lu %lu", &size, &resident);
+    std::fclose(f);
+    if (n != 2)
+        return 0;
+    return (std::size_t)resident * (std::size_t)sysconf(_SC_PAGESIZE);
+#else
+    return 0;
+#endif
+}
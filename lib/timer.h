@@ -24,9 +24,13 @@
 #include "config.h"
 #include "settings.h"
 
+#include <chrono>
+#include <cstdint>
 #include <ctime>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 
 class CPPCHECKLIB TimerResults {
@@ -56,6 +60,29 @@ public:
     std::map<std::string, Data> mResults;
 };
 
+/** @brief Wall clock time per Timer name, recorded on one thread by Timer::record() */
+class CPPCHECKLIB PhaseTimes {
+public:
+    struct Data {
+        double mSeconds;
+        double mAdditionalSeconds;
+        std::size_t mNumberOfResults;
+
+        Data()
+            : mSeconds(0)
+            , mAdditionalSeconds(0)
+            , mNumberOfResults(0) {
+        }
+
+        /** Time including the nested Timers */
+        double fullSeconds() const {
+            return mSeconds + mAdditionalSeconds;
+        }
+    };
+
+    std::map<std::string, Data> mPhases;
+};
+
 class CPPCHECKLIB Timer {
 public:
     Timer(const std::string& str, Settings::SHOWTIME_MODES showtimeMode);
@@ -69,16 +96,89 @@ public:
 
     static TimerResults results;
 
+    /**
+     * @brief Record the Timers of the calling thread in given PhaseTimes,
+     * regardless of the showtime mode. nullptr stops recording.
+     */
+    static void record(PhaseTimes* phaseTimes);
+
 private:
     Timer(const Timer& other) = delete;
     Timer& operator=(const Timer&) = delete;
 
     const std::string mStr;
     std::clock_t mStart;
+    std::chrono::steady_clock::time_point mWallStart;
     std::clock_t mAccumulated;
     const Settings::SHOWTIME_MODES mShowTimeMode;
     bool mStopped;
 };
 
+/**
+ * @brief Time and memory budget for the analysis of a single file (--max-file-time, --max-file-memory).
+ * When the budget runs low, the analysis is degraded step by step before it is given up.
+ */
+class CPPCHECKLIB FileBudget {
+public:
+    enum Tier : uint8_t {
+        FULL,       ///< Enough budget left: run everything
+        REDUCED,    ///< Half of the budget is used: reduce number of ValueFlow iterations
+        MINIMAL,    ///< Three quarters of the budget are used: skip ValueFlow forward analysis
+        EXHAUSTED   ///< Budget is used up: skip remaining phases
+    };
+
+    /**
+     * @param maxSeconds maximum wall clock time for the file, 0 means unlimited
+     * @param maxMegabytes maximum memory growth during analysis of the file, 0 means unlimited.
+     * The growth of the whole process is measured, other threads that allocate memory count too.
+     */
+    FileBudget(unsigned int maxSeconds, std::size_t maxMegabytes);
+
+    /**
+     * @brief Compare used time and memory against the budget.
+     * @param phase name of the phase being executed. It is only copied if the tier is lowered.
+     * @return the current tier
+     */
+    Tier check(const char phase[]);
+
+    /**
+     * @brief Lower the tier according to given usage, in per mille of the
+     * budget. check() measures it, unit tests pass it directly.
+     */
+    Tier update(std::size_t usage, const char phase[]);
+
+    bool exhausted(const char phase[]) {
+        return check(phase) == EXHAUSTED;
+    }
+
+    Tier tier() const {
+        return mTier;
+    }
+
+    bool isLimited() const {
+        return mMaxMillis != 0 || mMaxMemory != 0;
+    }
+
+    /** Phases in which the tier was lowered */
+    const std::vector<std::pair<Tier, std::string>>& cuts() const {
+        return mCuts;
+    }
+
+    static const char* tierName(Tier tier);
+
+    /** Current memory usage (resident set size) of the process in bytes, 0 if unknown */
+    static std::size_t currentMemoryUsage();
+
+private:
+    std::chrono::steady_clock::time_point mStart;
+    std::chrono::steady_clock::time_point mLastMemorySample;
+    std::size_t mStartMemory;
+    std::size_t mMaxMemory;
+    std::size_t mUsedMemory;
+    std::size_t mMaxMillis;
+    Tier mTier;
+    std::vector<std::pair<Tier, std::string>> mCuts;
+};
+
 //---------------------------------------------------------------------------
 #endif // timerH
@@ -30,14 +30,15 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <map>
 #include <set>
 #include <stack>
+#include <unordered_map>
 #include <utility>
 
-const std::vector<ValueFlow::Value> TokenImpl::mEmptyValueList;
 static thread_local const Token* lastMatchResult = nullptr;
 
 Token::Token(TokensFrontBack *tokensFrontBack) :
@@ -591,134 +592,247 @@ bool Token::simpleMatch(const Token *tok, const char pattern[], size_t pattern_l
     return true;
 }
 
-bool Token::firstWordEquals(const char *str, const char *word)
-{
+namespace {
+    /**
+     * A Token::Match pattern, parsed into one instruction per pattern word.
+     * Programs are cached per thread by the address of the pattern, so
+     * string literals are parsed once. The pattern text is kept to detect
+     * reused addresses (patterns built at runtime, arrays on the stack).
+     */
+    struct MatchProgram {
+        enum Command : std::uint8_t {
+            CMD_ANY, CMD_ASSIGN, CMD_BOOL, CMD_CHAR, CMD_COMP, CMD_COP, CMD_NAME, CMD_NUM,
+            CMD_OP, CMD_OR, CMD_OROR, CMD_STR, CMD_TYPE, CMD_VAR, CMD_VARID, CMD_UNKNOWN
+        };
+
+        struct Alternative {
+            std::string literal;
+            Command command;
+            bool isCommand;
+        };
+
+        enum Kind : std::uint8_t {
+            SET_RESULT, // $
+            CHARS,      // [abc]
+            NOT,        // !!else
+            MULTI       // int|%name%|
+        };
+
+        struct Op {
+            Kind kind;
+            bool useLink;
+            bool emptyAlternative;
+            /** CHARS: accepted characters, NOT: rejected string */
+            std::string str;
+            std::vector<Alternative> alternatives;
+        };
+
+        std::string pattern;
+        std::vector<Op> ops;
+
+        void compile(const char pattern_[]);
+    };
+
+}
+
+static MatchProgram::Command matchCommand(const std::string& name)
+{
+    // Token::Match is used during static initialization, don't depend on initialization order
+    static const std::map<std::string, MatchProgram::Command> commands = {
+        { "%any%", MatchProgram::CMD_ANY },
+        { "%assign%", MatchProgram::CMD_ASSIGN },
+        { "%bool%", MatchProgram::CMD_BOOL },
+        { "%char%", MatchProgram::CMD_CHAR },
+        { "%comp%", MatchProgram::CMD_COMP },
+        { "%cop%", MatchProgram::CMD_COP },
+        { "%name%", MatchProgram::CMD_NAME },
+        { "%num%", MatchProgram::CMD_NUM },
+        { "%op%", MatchProgram::CMD_OP },
+        { "%or%", MatchProgram::CMD_OR },
+        { "%oror%", MatchProgram::CMD_OROR },
+        { "%str%", MatchProgram::CMD_STR },
+        { "%type%", MatchProgram::CMD_TYPE },
+        { "%var%", MatchProgram::CMD_VAR },
+        { "%varid%", MatchProgram::CMD_VARID }
+    };
+    const std::map<std::string, MatchProgram::Command>::const_iterator it = commands.find(name);
+    return (it == commands.end()) ? MatchProgram::CMD_UNKNOWN : it->second;
+}
+
+void MatchProgram::compile(const char pattern_[])
+{
+    pattern = pattern_;
+    ops.clear();
+
+    const char *p = pattern_;
     for (;;) {
-        if (*str != *word) {
-            return (*str == ' ' && *word == 0);
-        } else if (*str == 0)
+        while (*p == ' ')
+            ++p;
+        if (*p == '\0')
             break;
 
-        ++str;
-        ++word;
-    }
+        ops.emplace_back();
+        Op& op = ops.back();
+        op.useLink = false;
+        op.emptyAlternative = false;
 
-    return true;
+        if (p[0] == '$' && (p[1] == 0 || p[1] == ' ' || p[1] == '|')) {
+            op.kind = SET_RESULT;
+            ++p;
+            continue;
+        }
+
+        if (p[0] == '@' && (p[1] != 0 && p[1] != ' ' && p[1] != '|')) {
+            op.useLink = true;
+            ++p;
+        }
+
+        const char *end = p;
+        while (*end && *end != ' ')
+            ++end;
+
+        if (p[0] == '[' && std::memchr(p, ']', end - p)) {
+            // ']' is only accepted if it is given twice, e.g. "[])]"
+            op.kind = CHARS;
+            if (std::count(p + 1, end, ']') > 1)
+                op.str += ']';
+            for (const char *c = p + 1; c != end; ++c) {
+                if (*c != ']')
+                    op.str += *c;
+            }
+        } else if (p[0] == '!' && p[1] == '!' && p[2] != '\0') {
+            op.kind = NOT;
+            op.str.assign(p + 2, end);
+        } else {
+            op.kind = MULTI;
+            for (const char *alt = p; alt < end;) {
+                const char *altEnd = alt;
+                while (altEnd != end && *altEnd != '|')
+                    ++altEnd;
+                if (altEnd == end && alt == end)
+                    break;
+                if (altEnd != alt) {
+                    op.alternatives.emplace_back();
+                    Alternative& alternative = op.alternatives.back();
+                    alternative.literal.assign(alt, altEnd);
+                    alternative.isCommand = (alternative.literal.size() > 1 && alternative.literal[0] == '%');
+                    if (alternative.isCommand)
+                        alternative.command = matchCommand(alternative.literal);
+                }
+                alt = altEnd + (altEnd != end);
+            }
+            // A trailing '|' allows an empty match
+            op.emptyAlternative = (end[-1] == '|');
+        }
+        p = end;
+    }
 }
 
-const char *Token::chrInFirstWord(const char *str, char c)
+static const MatchProgram& getMatchProgram(const char pattern[])
 {
-    for (;;) {
-        if (*str == ' ' || *str == 0)
-            return nullptr;
+    static thread_local std::unordered_map<const char*, MatchProgram> programs;
 
-        if (*str == c)
-            return str;
+    std::unordered_map<const char*, MatchProgram>::iterator it = programs.find(pattern);
+    if (it != programs.end() && std::strcmp(it->second.pattern.c_str(), pattern) == 0)
+        return it->second;
+    if (it == programs.end()) {
+        // Keep the cache bounded if many patterns are generated at runtime
+        if (programs.size() >= 8192)
+            programs.clear();
+        it = programs.emplace(pattern, MatchProgram()).first;
+    }
+    it->second.compile(pattern);
+    return it->second;
+}
 
-        ++str;
+static bool matchCommand(const Token *tok, MatchProgram::Command command, unsigned int varid)
+{
+    switch (command) {
+    case MatchProgram::CMD_ANY:
+        return true;
+    case MatchProgram::CMD_ASSIGN:
+        return tok->isAssignmentOp();
+    case MatchProgram::CMD_BOOL:
+        return tok->isBoolean();
+    case MatchProgram::CMD_CHAR:
+        return tok->tokType() == Token::eChar;
+    case MatchProgram::CMD_COMP:
+        return tok->isComparisonOp();
+    case MatchProgram::CMD_COP:
+        return tok->isConstOp();
+    case MatchProgram::CMD_NAME:
+        return tok->isName();
+    case MatchProgram::CMD_NUM:
+        return tok->isNumber();
+    case MatchProgram::CMD_OP:
+        return tok->isOp();
+    case MatchProgram::CMD_OR:
+        return tok->tokType() == Token::eBitOp && tok->str() == "|";
+    case MatchProgram::CMD_OROR:
+        return tok->tokType() == Token::eLogicalOp && tok->str() == "||";
+    case MatchProgram::CMD_STR:
+        return tok->tokType() == Token::eString;
+    case MatchProgram::CMD_TYPE:
+        return tok->isName() && tok->varId() == 0 && (tok->str() != "delete" || !tok->isKeyword()); // HACK: this is legacy behaviour, it should return false for all keywords, except types
+    case MatchProgram::CMD_VAR:
+        return tok->varId() != 0;
+    case MatchProgram::CMD_VARID:
+        if (varid == 0)
+            throw InternalError(tok, "Internal error. Token::Match called with varid 0. Please report this to Cppcheck developers");
+        return tok->varId() == varid;
+    case MatchProgram::CMD_UNKNOWN:
+        break;
     }
+    //unknown %cmd%, abort
+    throw InternalError(tok, "Unexpected command");
 }
 
 bool Token::Match(const Token *tok, const char pattern[], unsigned int varid)
 {
-    const char *p = pattern;
-    while (*p) {
-        // Skip spaces in pattern..
-        while (*p == ' ')
-            ++p;
-
-        // No token => Success!
-        if (*p == '\0')
-            break;
-
-        if (p[0] == '$' && (p[1] == 0 || p[1] == ' ' || p[1] == '|')) {
+    const MatchProgram& program = getMatchProgram(pattern);
+    for (const MatchProgram::Op& op : program.ops) {
+        if (op.kind == MatchProgram::SET_RESULT) {
             lastMatchResult = tok;
-            ++p;
-
-            // Skip spaces in pattern..
-            while (*p == ' ')
-                ++p;
-
-            // No token => Success!
-            if (*p == '\0')
-                break;
-        }
-
-        bool useLink = false;
-        if (p[0] == '@' && (p[1] != 0 && p[1] != ' ' && p[1] != '|')) {
-            useLink = true;
-            p++;
+            continue;
         }
 
         if (!tok) {
             // If we have no tokens, pattern "!!else" should return true
-            if (p[0] == '!' && p[1] == '!' && p[2] != '\0') {
-                while (*p && *p != ' ')
-                    ++p;
+            if (op.kind == MatchProgram::NOT)
                 continue;
-            } else
-                return false;
+            return false;
         }
 
-        // [.. => search for a one-character token..
-        if (p[0] == '[' && chrInFirstWord(p, ']')) {
-            if (tok->str().length() != 1)
+        switch (op.kind) {
+        case MatchProgram::CHARS:
+            // [.. => search for a one-character token..
+            if (tok->str().length() != 1 || op.str.find(tok->str()[0]) == std::string::npos)
                 return false;
-
-            const char *temp = p+1;
-            bool chrFound = false;
-            int count = 0;
-            while (*temp && *temp != ' ') {
-                if (*temp == ']') {
-                    ++count;
-                }
-
-                else if (*temp == tok->str()[0]) {
-                    chrFound = true;
+            break;
+        case MatchProgram::NOT:
+            // Token can be anything except the given one
+            if (tok->str() == op.str)
+                return false;
+            break;
+        default: {
+            // Multi options, such as void|int|char (accept token which is one of these 3)
+            bool found = false;
+            for (const MatchProgram::Alternative& alternative : op.alternatives) {
+                if (alternative.isCommand ? matchCommand(tok, alternative.command, varid) : tok->str() == alternative.literal) {
+                    found = true;
                     break;
                 }
-
-                ++temp;
             }
-
-            if (count > 1 && tok->str()[0] == ']')
-                chrFound = true;
-
-            if (!chrFound)
-                return false;
-
-            p = temp;
-            while (*p && *p != ' ')
-                ++p;
-        }
-
-        // Parse "not" options. Token can be anything except the given one
-        else if (p[0] == '!' && p[1] == '!' && p[2] != '\0') {
-            p += 2;
-            if (firstWordEquals(p, tok->str().c_str()))
-                return false;
-            while (*p && *p != ' ')
-                ++p;
-        }
-
-        // Parse multi options, such as void|int|char (accept token which is one of these 3)
-        else {
-            const int res = multiCompare(tok, p, varid);
-            if (res == 0) {
+            if (!found) {
+                if (!op.emptyAlternative)
+                    return false;
                 // Empty alternative matches, use the same token on next round
-                while (*p && *p != ' ')
-                    ++p;
                 continue;
-            } else if (res == -1) {
-                // No match
-                return false;
             }
         }
+        }
 
-        while (*p && *p != ' ')
-            ++p;
-
-        if (useLink) {
+        if (op.useLink) {
             if (!tok->link())
                 return false;
             tok = tok->link();
@@ -1645,23 +1759,21 @@ void Token::printValueFlow(bool xml, std::ostream &out) const
 {
     unsigned int line = 0;
     if (xml)
-        out << "  <valueflow>" << std::endl;
+        out << "  <valueflow>\n";
     else
-        out << "\n\n##Value flow" << std::endl;
+        out << "\n\n##Value flow\n";
     for (const Token *tok = this; tok; tok = tok->next()) {
-        if (!tok->mImpl->mValues)
-            continue;
-        if (tok->mImpl->mValues->empty()) // Values might be removed by removeContradictions
+        if (tok->mImpl->mValues.empty()) // Values might be removed by removeContradictions
             continue;
         if (xml)
-            out << "    <values id=\"" << tok->mImpl->mValues << "\">" << std::endl;
+            out << "    <values id=\"" << &tok->mImpl->mValues << "\">\n";
         else if (line != tok->linenr())
-            out << "Line " << tok->linenr() << std::endl;
+            out << "Line " << tok->linenr() << '\n';
         line = tok->linenr();
         if (!xml) {
-            ValueFlow::Value::ValueKind valueKind = tok->mImpl->mValues->front().valueKind;
+            ValueFlow::Value::ValueKind valueKind = tok->mImpl->mValues.front().valueKind;
             bool same = true;
-            for (const ValueFlow::Value &value : *tok->mImpl->mValues) {
+            for (const ValueFlow::Value &value : tok->mImpl->mValues) {
                 if (value.valueKind != valueKind) {
                     same = false;
                     break;
@@ -1680,10 +1792,10 @@ void Token::printValueFlow(bool xml, std::ostream &out) const
                     break;
                 }
             }
-            if (tok->mImpl->mValues->size() > 1U)
+            if (tok->mImpl->mValues.size() > 1U)
                 out << '{';
         }
-        for (const ValueFlow::Value &value : *tok->mImpl->mValues) {
+        for (const ValueFlow::Value &value : tok->mImpl->mValues) {
             if (xml) {
                 out << "      <value ";
                 switch (value.valueType) {
@@ -1731,11 +1843,11 @@ void Token::printValueFlow(bool xml, std::ostream &out) const
                     out << " impossible=\"true\"";
                 else if (value.isInconclusive())
                     out << " inconclusive=\"true\"";
-                out << "/>" << std::endl;
+                out << "/>\n";
             }
 
             else {
-                if (&value != &tok->mImpl->mValues->front())
+                if (&value != &tok->mImpl->mValues.front())
                     out << ",";
                 if (value.isImpossible())
                     out << "!";
@@ -1784,23 +1896,21 @@ void Token::printValueFlow(bool xml, std::ostream &out) const
             }
         }
         if (xml)
-            out << "    </values>" << std::endl;
-        else if (tok->mImpl->mValues->size() > 1U)
-            out << '}' << std::endl;
+            out << "    </values>\n";
+        else if (tok->mImpl->mValues.size() > 1U)
+            out << "}\n";
         else
-            out << std::endl;
+            out << '\n';
     }
     if (xml)
-        out << "  </valueflow>" << std::endl;
+        out << "  </valueflow>\n";
 }
 
 const ValueFlow::Value * Token::getValueLE(const MathLib::bigint val, const Project* project) const
 {
-    if (!mImpl->mValues)
-        return nullptr;
     const ValueFlow::Value *ret = nullptr;
     std::vector<ValueFlow::Value>::const_iterator it;
-    for (it = mImpl->mValues->begin(); it != mImpl->mValues->end(); ++it) {
+    for (it = mImpl->mValues.begin(); it != mImpl->mValues.end(); ++it) {
         if (it->isImpossible())
             continue;
         if (it->isIntValue() && it->intvalue <= val) {
@@ -1821,11 +1931,9 @@ const ValueFlow::Value * Token::getValueLE(const MathLib::bigint val, const Proj
 
 const ValueFlow::Value * Token::getValueGE(const MathLib::bigint val, const Project* project) const
 {
-    if (!mImpl->mValues)
-        return nullptr;
     const ValueFlow::Value *ret = nullptr;
     std::vector<ValueFlow::Value>::const_iterator it;
-    for (it = mImpl->mValues->begin(); it != mImpl->mValues->end(); ++it) {
+    for (it = mImpl->mValues.begin(); it != mImpl->mValues.end(); ++it) {
         if (it->isImpossible())
             continue;
         if (it->isIntValue() && it->intvalue >= val) {
@@ -1846,11 +1954,11 @@ const ValueFlow::Value * Token::getValueGE(const MathLib::bigint val, const Proj
 
 const ValueFlow::Value * Token::getInvalidValue(const Token *ftok, unsigned int argnr, const Project* project) const
 {
-    if (!mImpl->mValues || !project)
+    if (!project)
         return nullptr;
     const ValueFlow::Value *ret = nullptr;
     std::vector<ValueFlow::Value>::const_iterator it;
-    for (it = mImpl->mValues->begin(); it != mImpl->mValues->end(); ++it) {
+    for (it = mImpl->mValues.begin(); it != mImpl->mValues.end(); ++it) {
         if (it->isImpossible())
             continue;
         if ((it->isIntValue() && !project->library.isIntArgValid(ftok, argnr, it->intvalue)) ||
@@ -1872,12 +1980,10 @@ const ValueFlow::Value * Token::getInvalidValue(const Token *ftok, unsigned int
 
 const Token *Token::getValueTokenMinStrSize(const Project* project) const
 {
-    if (!mImpl->mValues)
-        return nullptr;
     const Token *ret = nullptr;
     int minsize = INT_MAX;
     std::vector<ValueFlow::Value>::const_iterator it;
-    for (it = mImpl->mValues->begin(); it != mImpl->mValues->end(); ++it) {
+    for (it = mImpl->mValues.begin(); it != mImpl->mValues.end(); ++it) {
         if (it->isTokValue() && it->tokvalue && it->tokvalue->tokType() == Token::eString) {
             const int size = getStrSize(it->tokvalue, project);
             if (!ret || size < minsize) {
@@ -1891,12 +1997,10 @@ const Token *Token::getValueTokenMinStrSize(const Project* project) const
 
 const Token *Token::getValueTokenMaxStrLength() const
 {
-    if (!mImpl->mValues)
-        return nullptr;
     const Token *ret = nullptr;
     int maxlength = 0;
     std::vector<ValueFlow::Value>::const_iterator it;
-    for (it = mImpl->mValues->begin(); it != mImpl->mValues->end(); ++it) {
+    for (it = mImpl->mValues.begin(); it != mImpl->mValues.end(); ++it) {
         if (it->isTokValue() && it->tokvalue && it->tokvalue->tokType() == Token::eString) {
             const int length = getStrLength(it->tokvalue);
             if (!ret || length > maxlength) {
@@ -2029,15 +2133,15 @@ bool Token::addValue(const ValueFlow::Value &value)
         });
     }
 
-    if (mImpl->mValues) {
+    if (!mImpl->mValues.empty()) {
         // Don't handle more than 10 values for performance reasons
         // TODO: add setting?
-        if (mImpl->mValues->size() >= 10U)
+        if (mImpl->mValues.size() >= 10U)
             return false;
 
         // if value already exists, don't add it again
         std::vector<ValueFlow::Value>::iterator it;
-        for (it = mImpl->mValues->begin(); it != mImpl->mValues->end(); ++it) {
+        for (it = mImpl->mValues.begin(); it != mImpl->mValues.end(); ++it) {
             // different types => continue
             if (it->valueType != value.valueType)
                 continue;
@@ -2089,31 +2193,33 @@ bool Token::addValue(const ValueFlow::Value &value)
         }
 
         // Add value
-        if (it == mImpl->mValues->end()) {
+        if (it == mImpl->mValues.end()) {
             ValueFlow::Value v(value);
             if (v.varId == 0)
                 v.varId = mImpl->mVarId;
             if (v.isKnown() && v.isIntValue())
-                mImpl->mValues->insert(mImpl->mValues->begin(), v);
+                mImpl->mValues.insert(mImpl->mValues.begin(), v);
             else
-                mImpl->mValues->push_back(v);
+                mImpl->mValues.push_back(v);
         }
     } else {
-        ValueFlow::Value v(value);
-        if (v.varId == 0)
-            v.varId = mImpl->mVarId;
-        mImpl->mValues = new std::vector<ValueFlow::Value>(1, v);
+        mImpl->mValues.push_back(value);
+        if (mImpl->mValues.back().varId == 0)
+            mImpl->mValues.back().varId = mImpl->mVarId;
     }
 
-    removeContradictions(*mImpl->mValues);
+    removeContradictions(mImpl->mValues);
+    updateValueFlags();
 
     return true;
 }
 
 void Token::removeValues(std::function<bool(const ValueFlow::Value&)> pred)
 {
-    if (mImpl->mValues)
-        mImpl->mValues->erase(std::remove_if(mImpl->mValues->begin(), mImpl->mValues->end(), pred), mImpl->mValues->end());
+    if (mImpl->mValues.empty())
+        return;
+    mImpl->mValues.erase(std::remove_if(mImpl->mValues.begin(), mImpl->mValues.end(), pred), mImpl->mValues.end());
+    updateValueFlags();
 }
 
 void Token::assignProgressValues(Token *tok)
@@ -2247,25 +2353,26 @@ std::shared_ptr<ScopeInfo2> Token::scopeInfo() const
     return mImpl->mScopeInfo;
 }
 
-bool Token::hasKnownIntValue() const
+void Token::updateValueFlags()
 {
-    if (!mImpl->mValues)
-        return false;
-    return std::any_of(mImpl->mValues->begin(), mImpl->mValues->end(), [](const ValueFlow::Value& value) {
-        return value.isKnown() && value.isIntValue();
-    });
-}
-
-bool Token::hasKnownValue() const
-{
-    return mImpl->mValues && std::any_of(mImpl->mValues->begin(), mImpl->mValues->end(), std::mem_fn(&ValueFlow::Value::isKnown));
+    uint8_t flags = 0;
+    for (const ValueFlow::Value& value : mImpl->mValues) {
+        if (value.isKnown()) {
+            flags |= TokenImpl::fHasKnownValue;
+            if (value.isIntValue())
+                flags |= TokenImpl::fHasKnownIntValue;
+        }
+        if (value.isIntValue() && (value.isImpossible() || value.bound != ValueFlow::Value::Bound::Point))
+            flags |= TokenImpl::fHasImpossibleOrBoundIntValue;
+    }
+    mImpl->mValueFlags = flags;
 }
 
 bool Token::isImpossibleIntValue(const MathLib::bigint val) const
 {
-    if (!mImpl->mValues)
+    if (!(mImpl->mValueFlags & TokenImpl::fHasImpossibleOrBoundIntValue))
         return false;
-    for (const auto& v : *mImpl->mValues) {
+    for (const auto& v : mImpl->mValues) {
         if (v.isIntValue() && v.isImpossible() && v.intvalue == val)
             return true;
         if (v.isIntValue() && v.bound == ValueFlow::Value::Bound::Lower && val > v.intvalue)
@@ -2278,20 +2385,16 @@ bool Token::isImpossibleIntValue(const MathLib::bigint val) const
 
 const ValueFlow::Value* Token::getValue(const MathLib::bigint val) const
 {
-    if (!mImpl->mValues)
-        return nullptr;
-    const auto it = std::find_if(mImpl->mValues->begin(), mImpl->mValues->end(), [=](const ValueFlow::Value& value) {
+    const auto it = std::find_if(mImpl->mValues.begin(), mImpl->mValues.end(), [=](const ValueFlow::Value& value) {
         return value.isIntValue() && !value.isImpossible() && value.intvalue == val;
     });
-    return it == mImpl->mValues->end() ? nullptr : &*it;
+    return it == mImpl->mValues.end() ? nullptr : &*it;
 }
 
 const ValueFlow::Value* Token::getMaxValue(bool condition) const
 {
-    if (!mImpl->mValues)
-        return nullptr;
     const ValueFlow::Value* ret = nullptr;
-    for (const ValueFlow::Value& value : *mImpl->mValues) {
+    for (const ValueFlow::Value& value : mImpl->mValues) {
         if (!value.isIntValue())
             continue;
         if (value.isImpossible())
@@ -2305,30 +2408,25 @@ const ValueFlow::Value* Token::getMaxValue(bool condition) const
 
 const ValueFlow::Value* Token::getMovedValue() const
 {
-    if (!mImpl->mValues)
-        return nullptr;
-    const auto it = std::find_if(mImpl->mValues->begin(), mImpl->mValues->end(), [](const ValueFlow::Value& value) {
+    const auto it = std::find_if(mImpl->mValues.begin(), mImpl->mValues.end(), [](const ValueFlow::Value& value) {
         return value.isMovedValue() && !value.isImpossible() &&
                value.moveKind != ValueFlow::Value::MoveKind::NonMovedVariable;
     });
-    return it == mImpl->mValues->end() ? nullptr : &*it;
+    return it == mImpl->mValues.end() ? nullptr : &*it;
 }
 
 const ValueFlow::Value* Token::getContainerSizeValue(const MathLib::bigint val) const
 {
-    if (!mImpl->mValues)
-        return nullptr;
-    const auto it = std::find_if(mImpl->mValues->begin(), mImpl->mValues->end(), [=](const ValueFlow::Value& value) {
+    const auto it = std::find_if(mImpl->mValues.begin(), mImpl->mValues.end(), [=](const ValueFlow::Value& value) {
         return value.isContainerSizeValue() && !value.isImpossible() && value.intvalue == val;
     });
-    return it == mImpl->mValues->end() ? nullptr : &*it;
+    return it == mImpl->mValues.end() ? nullptr : &*it;
 }
 
 TokenImpl::~TokenImpl()
 {
     delete mOriginalName;
     delete mValueType;
-    delete mValues;
 
     if (mTemplateSimplifierPointers)
         for (auto *templateSimplifierPointer : *mTemplateSimplifierPointers) {
@@ -101,8 +101,15 @@ struct TokenImpl {
     ValueType *mValueType;
 
     // ValueFlow
-    std::vector<ValueFlow::Value>* mValues;
-    static const std::vector<ValueFlow::Value> mEmptyValueList;
+    std::vector<ValueFlow::Value> mValues;
+
+    // Summary of mValues, updated whenever mValues changes
+    enum ValueFlags : uint8_t {
+        fHasKnownValue      = (1 << 0),
+        fHasKnownIntValue   = (1 << 1),
+        fHasImpossibleOrBoundIntValue = (1 << 2)
+    };
+    uint8_t mValueFlags;
 
     // Pointer to a template in the template simplifier
     std::set<TokenAndName*>* mTemplateSimplifierPointers;
@@ -142,7 +149,7 @@ struct TokenImpl {
         , mIndex(0)
         , mOriginalName(nullptr)
         , mValueType(nullptr)
-        , mValues(nullptr)
+        , mValueFlags(0)
         , mTemplateSimplifierPointers(nullptr)
         , mScopeInfo(nullptr)
         , mCppcheckAttributes(nullptr)
@@ -1107,7 +1114,7 @@ public:
     }
 
     const std::vector<ValueFlow::Value>& values() const {
-        return mImpl->mValues ? *mImpl->mValues : TokenImpl::mEmptyValueList;
+        return mImpl->mValues;
     }
 
     /**
@@ -1121,11 +1128,15 @@ public:
             *mImpl->mOriginalName = name;
     }
 
-    bool hasKnownIntValue() const;
-    bool hasKnownValue() const;
+    bool hasKnownIntValue() const {
+        return (mImpl->mValueFlags & TokenImpl::fHasKnownIntValue) != 0;
+    }
+    bool hasKnownValue() const {
+        return (mImpl->mValueFlags & TokenImpl::fHasKnownValue) != 0;
+    }
 
     MathLib::bigint getKnownIntValue() const {
-        return mImpl->mValues->front().intvalue;
+        return mImpl->mValues.front().intvalue;
     }
 
     bool isImpossibleIntValue(const MathLib::bigint val) const;
@@ -1168,23 +1179,12 @@ private:
         mPrevious = previousToken;
     }
 
+    /** Recalculate TokenImpl::mValueFlags after the values changed */
+    void updateValueFlags();
+
     /** used by deleteThis() to take data from token to delete */
     void takeData(Token *fromToken);
 
-    /**
-     * Works almost like strcmp() except returns only true or false and
-     * if str has empty space &apos; &apos; character, that character is handled
-     * as if it were &apos;\\0&apos;
-     */
-    static bool firstWordEquals(const char *str, const char *word);
-
-    /**
-     * Works almost like strchr() except
-     * if str has empty space &apos; &apos; character, that character is handled
-     * as if it were &apos;\\0&apos;
-     */
-    static const char *chrInFirstWord(const char *str, char c);
-
     std::string mStr;
 
     Token *mNext;
@@ -1334,8 +1334,8 @@ public:
     }
 
     void clearValueFlow() {
-        delete mImpl->mValues;
-        mImpl->mValues = nullptr;
+        std::vector<ValueFlow::Value>().swap(mImpl->mValues);
+        mImpl->mValueFlags = 0;
     }
 
     void clearTemplatesimplifier() {
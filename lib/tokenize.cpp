@@ -39,10 +39,10 @@
 #include <cassert>
 #include <cctype>
 #include <cstring>
-#include <ctime>
 #include <iostream>
 #include <set>
 #include <stack>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 //---------------------------------------------------------------------------
@@ -155,10 +155,10 @@ Tokenizer::Tokenizer() :
     mVarId(0),
     mUnnamedCount(0),
     mCodeWithTemplates(false), //is there any templates?
-#ifdef MAXTIME
-    mMaxTime(std::time(0) + MAXTIME),
-#endif
-    mPreprocessor(nullptr)
+    mPreprocessor(nullptr),
+    mBudget(nullptr),
+    mAnalysisLayer(AnalysisLayer::ValueFlow),
+    mBuiltLayer(AnalysisLayer::None)
 {
 }
 
@@ -170,10 +170,10 @@ Tokenizer::Tokenizer(const Settings* settings, const Project* project, ErrorLogg
     mVarId(0),
     mUnnamedCount(0),
     mCodeWithTemplates(false), //is there any templates?
-#ifdef MAXTIME
-    mMaxTime(std::time(0) + MAXTIME),
-#endif
-    mPreprocessor(nullptr)
+    mPreprocessor(nullptr),
+    mBudget(nullptr),
+    mAnalysisLayer(AnalysisLayer::ValueFlow),
+    mBuiltLayer(AnalysisLayer::None)
 {
     // make sure settings are specified
     assert(list.mSettings);
@@ -611,6 +611,7 @@ void Tokenizer::simplifyTypedef()
         bool ptrMember = false;
         bool typeOf = false;
         bool inMemberFunc = false;
+        bool active = true;
         int memberScope = 0;
         int scopeLevel;
         int silenceUntil = -1;
@@ -622,7 +623,46 @@ void Tokenizer::simplifyTypedef()
         std::string pattern;
     };
     std::list<Typedefparams> params;
+    // Typedefs whose pattern or lifetime depends on the scope. Global typedefs
+    // are not tracked here, nothing has to be updated for them at braces.
     std::list<Typedefparams*> activeParams;
+    // Global typedefs that are silenced until the end of a scope
+    std::vector<Typedefparams*> silencedParams;
+    // All active typedefs by the names their pattern can start with (type name
+    // or class/namespace name), in order of definition
+    std::unordered_map<std::string, std::vector<Typedefparams*>> activeParamsByName;
+
+    const auto activate = [&](Typedefparams* p) {
+        if (p->scopeLevel > 0 || !p->spaceInfo.empty())
+            activeParams.push_back(p);
+        activeParamsByName[p->typeName->str()].push_back(p);
+        for (std::size_t i = 0; i < p->spaceInfo.size(); ++i) {
+            const std::string& name = p->spaceInfo[i].className;
+            if (name == p->typeName->str())
+                continue;
+            bool duplicate = false;
+            for (std::size_t j = 0; j < i; ++j)
+                duplicate = duplicate || p->spaceInfo[j].className == name;
+            if (!duplicate)
+                activeParamsByName[name].push_back(p);
+        }
+    };
+    const std::vector<Typedefparams*> noParams;
+    // Active typedefs whose pattern can start with given name
+    const auto candidates = [&](const std::string& name) -> const std::vector<Typedefparams*>& {
+        const std::unordered_map<std::string, std::vector<Typedefparams*>>::iterator it = activeParamsByName.find(name);
+        if (it == activeParamsByName.end())
+            return noParams;
+        std::vector<Typedefparams*>& c = it->second;
+        c.erase(std::remove_if(c.begin(), c.end(), [](const Typedefparams* p) {
+            return !p->active;
+        }), c.end());
+        if (c.empty()) {
+            activeParamsByName.erase(it);
+            return noParams;
+        }
+        return c;
+    };
 
     Token* lasttypedef = nullptr;
     int typedefScopeLevel = 0;
@@ -632,7 +672,7 @@ void Tokenizer::simplifyTypedef()
         if (mErrorLogger && !list.getFiles().empty())
             mErrorLogger->reportProgress(list.getFiles()[0], "Tokenize (typedef)", tok->progressValue());
 
-        if (Settings::terminated() || isMaxTime())
+        if (Settings::terminated() || isBudgetExhausted("Tokenizer::simplifyTypedef"))
             return;
 
         if (goback) {
@@ -1048,7 +1088,7 @@ void Tokenizer::simplifyTypedef()
             p.classLevel = p.spaceInfo.size();
             p.typeEndNext = p.typeEndNext->next();
 
-            activeParams.push_back(&p);
+            activate(&p);
 
             Typedefparams* p2 = &p;
             while (tok->str() == ",") {
@@ -1069,7 +1109,7 @@ void Tokenizer::simplifyTypedef()
                     p2->pattern = p2->typeName->str();
                     p2->tokOffset = p2->tokOffset->next();
 
-                    activeParams.push_back(p2);
+                    activate(p2);
 
                     if (p2->tokOffset && p2->tokOffset->str() == "[") {
                         p2->arrayStart = p2->tokOffset;
@@ -1136,15 +1176,24 @@ void Tokenizer::simplifyTypedef()
                         p.pattern += p.typeName->str();
                         ++it;
                     } else {
-                        if (p.scopeLevel > scopeLevel + p.spaceInfo.size())
+                        if (p.scopeLevel > scopeLevel + p.spaceInfo.size()) {
+                            p.active = false;
                             it = activeParams.erase(it);
-                        else
+                        } else
                             ++it;
 
                         if (scopeLevel <= p.silenceUntil)
                             p.silenceUntil = -1;
                     }
                 }
+
+                for (auto it = silencedParams.begin(); it != silencedParams.end();) {
+                    if (scopeLevel <= (*it)->silenceUntil) {
+                        (*it)->silenceUntil = -1;
+                        it = silencedParams.erase(it);
+                    } else
+                        ++it;
+                }
             }
 
             // check for member functions
@@ -1232,7 +1281,8 @@ void Tokenizer::simplifyTypedef()
         else if (isCPP() && Token::Match(tok, "operator %any% @( const| {")) {
             // check for qualifier
             if (tok->strAt(-1) == "::") {
-                for (auto it = activeParams.cbegin(); it != activeParams.cend(); ++it) {
+                const std::vector<Typedefparams*>& named = candidates(tok->strAt(1));
+                for (auto it = named.cbegin(); it != named.cend(); ++it) {
                     const Typedefparams& p = **it;
                     if (p.silenceUntil >= 0)
                         continue;
@@ -1251,8 +1301,9 @@ void Tokenizer::simplifyTypedef()
 
         // check for typedef that can be substituted
         else if (tok->isNameOnly()) {
+            const std::vector<Typedefparams*>& named = candidates(tok->str());
 
-            for (auto it = activeParams.begin(); it != activeParams.end(); ++it) {
+            for (auto it = named.cbegin(); it != named.cend(); ++it) {
                 Typedefparams& p = **it;
                 if (p.silenceUntil >= 0)
                     continue;
@@ -1323,6 +1374,8 @@ void Tokenizer::simplifyTypedef()
                         } else if (Token::Match(tok2->previous(), "case|;|{|} %type% :")) {
                             // Don't substitute labels
                         } else if (duplicateTypedef(tok2, p.typeName, p.typeDef, silenceUntil)) {
+                            if (p.silenceUntil < 0 && p.scopeLevel == 0 && p.spaceInfo.empty())
+                                silencedParams.push_back(&p);
                             p.silenceUntil = silenceUntil;
                         } else if (Token::Match(tok2->tokAt(-2), "%type% *|&")) {
                             // Ticket #5868: Don't substitute variable names
@@ -1987,6 +2040,7 @@ bool Tokenizer::isMemberFunction(const Token *openParen) const
 
 bool Tokenizer::simplifyUsing()
 {
+    Timer t("Tokenizer::simplifyUsing", list.mSettings->showtime);
     bool substitute = false;
     std::list<ScopeInfo3> scopeList;
     struct Using {
@@ -2314,6 +2368,7 @@ bool Tokenizer::simplifyUsing()
 }
 void Tokenizer::simplifyMulAndParens()
 {
+    Timer t("Tokenizer::simplifyMulAndParens", list.mSettings->showtime);
     if (!list.front())
         return;
     for (Token *tok = list.front()->tokAt(3); tok; tok = tok->next()) {
@@ -2411,29 +2466,42 @@ bool Tokenizer::simplifyTokens1()
     if (!simplifyTokenList1(list.getFiles().front().c_str()))
         return false;
 
-    {
+    buildAnalysisLayers(mAnalysisLayer);
+
+    printDebugOutput();
+
+    return true;
+}
+
+void Tokenizer::buildAnalysisLayers(AnalysisLayer layer)
+{
+    if (mBuiltLayer < AnalysisLayer::Ast && layer >= AnalysisLayer::Ast) {
         Timer t("Tokenizer::createAst", list.mSettings->showtime);
         list.createAst();
         list.validateAst();
+        mBuiltLayer = AnalysisLayer::Ast;
     }
 
-    createSymbolDatabase();
+    if (mBuiltLayer < AnalysisLayer::Symbols && layer >= AnalysisLayer::Symbols) {
+        createSymbolDatabase();
+        mBuiltLayer = AnalysisLayer::Symbols;
+    }
 
-    {
+    if (mBuiltLayer < AnalysisLayer::ValueTypes && layer >= AnalysisLayer::ValueTypes) {
         Timer t("Tokenizer::setValueTypeInTokenList", list.mSettings->showtime);
         mSymbolDatabase->setValueTypeInTokenList(true);
+        mBuiltLayer = AnalysisLayer::ValueTypes;
     }
 
-    {
-        Timer t("Tokenizer::ValueFlow", list.mSettings->showtime);
-        ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger);
-    }
-
-    mSymbolDatabase->setArrayDimensionsUsingValueFlow();
-
-    printDebugOutput();
+    if (mBuiltLayer < AnalysisLayer::ValueFlow && layer >= AnalysisLayer::ValueFlow) {
+        {
+            Timer t("Tokenizer::ValueFlow", list.mSettings->showtime);
+            ValueFlow::setValues(&list, mSymbolDatabase, mErrorLogger, mBudget);
+        }
 
-    return true;
+        mSymbolDatabase->setArrayDimensionsUsingValueFlow();
+        mBuiltLayer = AnalysisLayer::ValueFlow;
+    }
 }
 
 bool Tokenizer::tokenize(std::istream &code,
@@ -2451,12 +2519,14 @@ bool Tokenizer::tokenize(std::istream &code,
 
 void Tokenizer::findComplicatedSyntaxErrorsInTemplates()
 {
+    Timer t("Tokenizer::findComplicatedSyntaxErrorsInTemplates", list.mSettings->showtime);
     validate();
     mTemplateSimplifier->checkComplicatedSyntaxErrorsInTemplates();
 }
 
 void Tokenizer::checkForEnumsWithTypedef()
 {
+    Timer t("Tokenizer::checkForEnumsWithTypedef", list.mSettings->showtime);
     for (const Token *tok = list.front(); tok; tok = tok->next()) {
         if (Token::Match(tok, "enum %name% {")) {
             tok = tok->tokAt(2);
@@ -2486,6 +2556,7 @@ void Tokenizer::fillTypeSizes()
 
 void Tokenizer::combineOperators()
 {
+    Timer t("Tokenizer::combineOperators", list.mSettings->showtime);
     const bool cpp = isCPP();
 
     // Combine tokens..
@@ -2586,6 +2657,7 @@ void Tokenizer::combineStringAndCharLiterals()
 
 void Tokenizer::concatenateNegativeNumberAndAnyPositive()
 {
+    Timer t("Tokenizer::concatenateNegativeNumberAndAnyPositive", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (!Token::Match(tok, "?|:|,|(|[|{|return|case|sizeof|%op% +|-") || tok->tokType() == Token::eIncDecOp)
             continue;
@@ -2602,6 +2674,7 @@ void Tokenizer::concatenateNegativeNumberAndAnyPositive()
 
 void Tokenizer::simplifyExternC()
 {
+    Timer t("Tokenizer::simplifyExternC", list.mSettings->showtime);
     if (isC())
         return;
 
@@ -2627,6 +2700,7 @@ void Tokenizer::simplifyExternC()
 
 void Tokenizer::simplifyRoundCurlyParentheses()
 {
+    Timer t("Tokenizer::simplifyRoundCurlyParentheses", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         while (Token::Match(tok, "[;{}:] ( @{ ) ;")) {
             if (tok->str() == ":" && !Token::Match(tok->tokAt(-2),"[;{}] %type% :"))
@@ -2694,30 +2768,9 @@ void Tokenizer::simplifyModules()
     }
 }
 
-void Tokenizer::simplifyArrayAccessSyntax()
-{
-    // 0[a] -> a[0]
-    for (Token *tok = list.front(); tok; tok = tok->next()) {
-        if (tok->isNumber() && Token::Match(tok, "%num% [ %name% ]")) {
-            const std::string number(tok->str());
-            Token* indexTok = tok->tokAt(2);
-            tok->str(indexTok->str());
-            tok->varId(indexTok->varId());
-            indexTok->str(number);
-        }
-    }
-}
-
-void Tokenizer::simplifyParameterVoid()
-{
-    for (Token* tok = list.front(); tok; tok = tok->next()) {
-        if (Token::Match(tok, "%name% ( void )"))
-            tok->next()->deleteNext();
-    }
-}
-
 void Tokenizer::simplifyRedundantConsecutiveBraces()
 {
+    Timer t("Tokenizer::simplifyRedundantConsecutiveBraces", list.mSettings->showtime);
     // Remove redundant consecutive braces, i.e. '.. { { .. } } ..' -> '.. { .. } ..'.
     for (Token *tok = list.front(); tok;) {
         if (Token::simpleMatch(tok, "= {")) {
@@ -2731,10 +2784,11 @@ void Tokenizer::simplifyRedundantConsecutiveBraces()
     }
 }
 
-void Tokenizer::simplifyDoublePlusAndDoubleMinus()
+void Tokenizer::simplifyLocalPatterns()
 {
-    // Convert - - into + and + - into -
+    Timer t("Tokenizer::simplifyLocalPatterns", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
+        // Convert - - into + and + - into -
         while (tok->next()) {
             if (tok->str() == "+") {
                 if (tok->next()->str()[0] == '-') {
@@ -2768,6 +2822,21 @@ void Tokenizer::simplifyDoublePlusAndDoubleMinus()
 
             break;
         }
+
+        if (tok->isNumber()) {
+            // 0[a] -> a[0]
+            if (Token::Match(tok, "%num% [ %name% ]")) {
+                const std::string number(tok->str());
+                Token* indexTok = tok->tokAt(2);
+                tok->str(indexTok->str());
+                tok->varId(indexTok->varId());
+                indexTok->str(number);
+            }
+        } else if (tok->isName()) {
+            // f(void) -> f()
+            if (Token::Match(tok, "%name% ( void )"))
+                tok->next()->deleteNext();
+        }
     }
 }
 
@@ -2775,6 +2844,7 @@ void Tokenizer::simplifyDoublePlusAndDoubleMinus()
 
 void Tokenizer::arraySize()
 {
+    Timer t("Tokenizer::arraySize", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (!tok->isName() || !Token::Match(tok, "%var% [ ] ="))
             continue;
@@ -2869,6 +2939,7 @@ const Token * Tokenizer::startOfExecutableScope(const Token * tok)
 
 void Tokenizer::simplifyLabelsCaseDefault()
 {
+    Timer t("Tokenizer::simplifyLabelsCaseDefault", list.mSettings->showtime);
     const bool cpp = isCPP();
     bool executablescope = false;
     int indentLevel = 0;
@@ -2936,6 +3007,7 @@ void Tokenizer::simplifyLabelsCaseDefault()
 
 void Tokenizer::simplifyCaseRange()
 {
+    Timer t("Tokenizer::simplifyCaseRange", list.mSettings->showtime);
     for (Token* tok = list.front(); tok; tok = tok->next()) {
         if (Token::Match(tok, "case %num% ... %num% :")) {
             const MathLib::bigint start = MathLib::toLongNumber(tok->strAt(1));
@@ -3066,13 +3138,12 @@ void Tokenizer::calculateScopes()
 void Tokenizer::simplifyTemplates()
 {
     Timer t("Tokenizer::simplifyTemplates", list.mSettings->showtime);
-    mTemplateSimplifier->simplifyTemplates(
-#ifdef MAXTIME
-        mMaxTime,
-#else
-        0, // ignored
-#endif
-        mCodeWithTemplates);
+    mTemplateSimplifier->simplifyTemplates(mCodeWithTemplates);
+}
+
+bool Tokenizer::isBudgetExhausted(const char phase[]) const
+{
+    return mBudget && mBudget->exhausted(phase);
 }
 //---------------------------------------------------------------------------
 
@@ -4132,6 +4203,7 @@ void Tokenizer::createLinks()
 
 void Tokenizer::createLinks2()
 {
+    Timer t("Tokenizer::createLinks2", list.mSettings->showtime);
     if (isC())
         return;
 
@@ -4254,6 +4326,7 @@ void Tokenizer::createLinks2()
 
 void Tokenizer::sizeofAddParentheses()
 {
+    Timer t("Tokenizer::sizeofAddParentheses", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (!Token::Match(tok, "sizeof !!("))
             continue;
@@ -4391,9 +4464,12 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
     simplifyRoundCurlyParentheses();
 
     // check for simple syntax errors..
-    for (const Token *tok = list.front(); tok; tok = tok->next()) {
-        if (Token::Match(tok, "> struct @{ ;")) {
-            syntaxError(tok);
+    {
+        Timer t("Tokenizer::simplifyTokenList1::checkSyntax", list.mSettings->showtime);
+        for (const Token *tok = list.front(); tok; tok = tok->next()) {
+            if (Token::Match(tok, "> struct @{ ;")) {
+                syntaxError(tok);
+            }
         }
     }
 
@@ -4403,11 +4479,14 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
     sizeofAddParentheses();
 
     // Simplify: 0[foo] -> *(foo)
-    for (Token* tok = list.front(); tok; tok = tok->next()) {
-        if (Token::simpleMatch(tok, "0 [") && tok->linkAt(1)) {
-            tok->str("*");
-            tok->next()->str("(");
-            tok->linkAt(1)->str(")");
+    {
+        Timer t("Tokenizer::simplifyTokenList1::zeroIndex", list.mSettings->showtime);
+        for (Token* tok = list.front(); tok; tok = tok->next()) {
+            if (Token::simpleMatch(tok, "0 [") && tok->linkAt(1)) {
+                tok->str("*");
+                tok->next()->str("(");
+                tok->linkAt(1)->str(")");
+            }
         }
     }
 
@@ -4423,6 +4502,7 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
 
     // simplify simple calculations inside <..>
     if (isCPP()) {
+        Timer t("Tokenizer::simplifyTokenList1::templateArgumentCalculations", list.mSettings->showtime);
         Token *lt = nullptr;
         for (Token *tok = list.front(); tok; tok = tok->next()) {
             if (Token::Match(tok, "[;{}]"))
@@ -4515,18 +4595,17 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
     // If typedef handling is refactored and moved to symboldatabase someday we can remove this
     prepareTernaryOpForAST();
 
-    for (Token* tok = list.front(); tok;) {
-        if (Token::Match(tok, "union|struct|class union|struct|class"))
-            tok->deleteNext();
-        else
-            tok = tok->next();
-    }
-
-    // class x y {
-    if (isCPP() && list.mProject->severity.isEnabled(Severity::information)) {
-        for (const Token *tok = list.front(); tok; tok = tok->next()) {
-            if (Token::Match(tok, "class %type% %type% [:{]")) {
-                unhandled_macro_class_x_y(tok);
+    {
+        Timer t("Tokenizer::simplifyTokenList1::classMacros", list.mSettings->showtime);
+        const bool checkClassMacros = isCPP() && list.mProject->severity.isEnabled(Severity::information);
+        for (Token* tok = list.front(); tok;) {
+            if (Token::Match(tok, "union|struct|class union|struct|class"))
+                tok->deleteNext();
+            else {
+                // class x y {
+                if (checkClassMacros && Token::Match(tok, "class %type% %type% [:{]"))
+                    unhandled_macro_class_x_y(tok);
+                tok = tok->next();
             }
         }
     }
@@ -4549,28 +4628,37 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
     simplifyAt();
 
     // When the assembly code has been cleaned up, no @ is allowed
-    for (const Token *tok = list.front(); tok; tok = tok->next()) {
-        if (tok->str() == "(") {
-            const Token *tok1 = tok;
-            tok = tok->link();
-            if (!tok)
-                syntaxError(tok1);
-        } else if (tok->str() == "@") {
-            syntaxError(tok);
+    {
+        Timer t("Tokenizer::simplifyTokenList1::checkAt", list.mSettings->showtime);
+        for (const Token *tok = list.front(); tok; tok = tok->next()) {
+            if (tok->str() == "(") {
+                const Token *tok1 = tok;
+                tok = tok->link();
+                if (!tok)
+                    syntaxError(tok1);
+            } else if (tok->str() == "@") {
+                syntaxError(tok);
+            }
         }
     }
 
     // Order keywords "static" and "const"
     simplifyStaticConst();
 
-    // convert platform dependent types to standard types
-    // 32 bits: size_t -> unsigned long
-    // 64 bits: size_t -> unsigned long long
-    list.simplifyPlatformTypes();
+    {
+        Timer t("TokenList::simplifyPlatformTypes", list.mSettings->showtime);
+        // convert platform dependent types to standard types
+        // 32 bits: size_t -> unsigned long
+        // 64 bits: size_t -> unsigned long long
+        list.simplifyPlatformTypes();
+    }
 
-    // collapse compound standard types into a single token
-    // unsigned long long int => long (with _isUnsigned=true,_isLong=true)
-    list.simplifyStdType();
+    {
+        Timer t("TokenList::simplifyStdType", list.mSettings->showtime);
+        // collapse compound standard types into a single token
+        // unsigned long long int => long (with _isUnsigned=true,_isLong=true)
+        list.simplifyStdType();
+    }
 
     if (Settings::terminated())
         return false;
@@ -4640,10 +4728,13 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
     createLinks2();
 
     // Mark C++ casts
-    for (Token *tok = list.front(); tok; tok = tok->next()) {
-        if (Token::Match(tok, "const_cast|dynamic_cast|reinterpret_cast|static_cast @< (")) {
-            tok = tok->linkAt(1)->next();
-            tok->isCast(true);
+    {
+        Timer t("Tokenizer::simplifyTokenList1::markCasts", list.mSettings->showtime);
+        for (Token *tok = list.front(); tok; tok = tok->next()) {
+            if (Token::Match(tok, "const_cast|dynamic_cast|reinterpret_cast|static_cast @< (")) {
+                tok = tok->linkAt(1)->next();
+                tok->isCast(true);
+            }
         }
     }
 
@@ -4660,16 +4751,13 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
     // Change initialisation of variable to assignment
     simplifyInitVar();
 
-    simplifyDoublePlusAndDoubleMinus();
-
-    simplifyArrayAccessSyntax();
+    // Convert - - into + and + - into -, 0[a] into a[0] and f(void) into f()
+    simplifyLocalPatterns();
 
     Token::assignProgressValues(list.front());
 
     removeRedundantSemicolons();
 
-    simplifyParameterVoid();
-
     simplifyRedundantConsecutiveBraces();
 
     simplifyEmptyNamespaces();
@@ -4680,7 +4768,10 @@ bool Tokenizer::simplifyTokenList1(const char FileName[])
 
     validate();
 
-    list.front()->assignIndexes();
+    {
+        Timer t("Token::assignIndexes", list.mSettings->showtime);
+        list.front()->assignIndexes();
+    }
 
     return true;
 }
@@ -4741,7 +4832,7 @@ void Tokenizer::dump(std::ostream &out) const
     // data dump that 3rd party tools could load and get useful info from.
 
     // tokens..
-    out << "  <tokenlist>" << std::endl;
+    out << "  <tokenlist>\n";
     for (const Token *tok = list.front(); tok; tok = tok->next()) {
         out << "    <token id=\"" << tok << "\" file=\"" << ErrorLogger::toxml(list.file(tok)) << "\" linenr=\"" << tok->linenr() << "\" column=\"" << tok->column() << "\"";
         out << " str=\"" << ErrorLogger::toxml(tok->str()) << '\"';
@@ -4806,9 +4897,9 @@ void Tokenizer::dump(std::ostream &out) const
             if (!vt.empty())
                 out << ' ' << vt;
         }
-        out << "/>" << std::endl;
+        out << "/>\n";
     }
-    out << "  </tokenlist>" << std::endl;
+    out << "  </tokenlist>\n";
 
     mSymbolDatabase->printXml(out);
     if (list.front())
@@ -4940,6 +5031,7 @@ void Tokenizer::simplifyHeaders()
 
 void Tokenizer::removeMacrosInGlobalScope()
 {
+    Timer t("Tokenizer::removeMacrosInGlobalScope", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (tok->str() == "(") {
             tok = tok->link();
@@ -5031,6 +5123,7 @@ void Tokenizer::removePragma()
 
 void Tokenizer::removeMacroInClassDef()
 {
+    Timer t("Tokenizer::removeMacroInClassDef", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (!Token::Match(tok, "class|struct %name% %name% {|:"))
             continue;
@@ -5077,6 +5170,7 @@ void Tokenizer::removeMacroInVarDecl()
 
 void Tokenizer::addSemicolonAfterUnknownMacro()
 {
+    Timer t("Tokenizer::addSemicolonAfterUnknownMacro", list.mSettings->showtime);
     if (!isCPP())
         return;
     for (Token *tok = list.front(); tok; tok = tok->next()) {
@@ -5095,6 +5189,7 @@ void Tokenizer::addSemicolonAfterUnknownMacro()
 
 void Tokenizer::simplifyEmptyNamespaces()
 {
+    Timer t("Tokenizer::simplifyEmptyNamespaces", list.mSettings->showtime);
     if (isC())
         return;
 
@@ -5136,6 +5231,7 @@ void Tokenizer::simplifyEmptyNamespaces()
 
 void Tokenizer::removeRedundantSemicolons()
 {
+    Timer t("Tokenizer::removeRedundantSemicolons", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (tok->link() && tok->str() == "(") {
             tok = tok->link();
@@ -5156,6 +5252,7 @@ void Tokenizer::removeRedundantSemicolons()
 
 bool Tokenizer::simplifyAddBraces()
 {
+    Timer t("Tokenizer::simplifyAddBraces", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         Token const * tokRet=simplifyAddBracesToCommand(tok);
         if (!tokRet)
@@ -5289,6 +5386,7 @@ Token *Tokenizer::simplifyAddBracesPair(Token *tok, bool commandWithCondition)
 
 void Tokenizer::simplifyFunctionParameters()
 {
+    Timer t("Tokenizer::simplifyFunctionParameters", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (tok->link() && Token::Match(tok, "{|[|(")) {
             tok = tok->link();
@@ -5456,6 +5554,7 @@ void Tokenizer::simplifyFunctionParameters()
 
 void Tokenizer::simplifyPointerToStandardType()
 {
+    Timer t("Tokenizer::simplifyPointerToStandardType", list.mSettings->showtime);
     if (!isC())
         return;
 
@@ -5478,6 +5577,7 @@ void Tokenizer::simplifyPointerToStandardType()
 
 void Tokenizer::simplifyFunctionPointers()
 {
+    Timer t("Tokenizer::simplifyFunctionPointers", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         // #2873 - do not simplify function pointer usage here:
         // (void)(xy(*p)(0));
@@ -5570,6 +5670,7 @@ void Tokenizer::simplifyFunctionPointers()
 
 void Tokenizer::simplifyVarDecl(const bool only_k_r_fpar)
 {
+    Timer t("Tokenizer::simplifyVarDecl", list.mSettings->showtime);
     simplifyVarDecl(list.front(), nullptr, only_k_r_fpar);
 }
 
@@ -5884,6 +5985,7 @@ void Tokenizer::simplifyVarDecl(Token * tokBegin, const Token * const tokEnd, co
 
 void Tokenizer::simplifyStaticConst()
 {
+    Timer t("Tokenizer::simplifyStaticConst", list.mSettings->showtime);
     // This function will simplify the token list so that the qualifiers "extern", "static"
     // and "const" appear in the same order as in the array below.
     const std::string qualifiers[] = {"extern", "static", "const"};
@@ -5946,6 +6048,7 @@ void Tokenizer::simplifyStaticConst()
 
 void Tokenizer::simplifyVariableMultipleAssign()
 {
+    Timer t("Tokenizer::simplifyVariableMultipleAssign", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (Token::Match(tok, "%name% = %name% = %num%|%name% ;")) {
             // skip intermediate assignments
@@ -6001,6 +6104,7 @@ static const std::map<std::string, const char*> cAlternativeTokens = {
 //  xor_eq   =>     ^=
 bool Tokenizer::simplifyCAlternativeTokens()
 {
+    Timer t("Tokenizer::simplifyCAlternativeTokens", list.mSettings->showtime);
     /* executable scope level */
     int executableScopeLevel = 0;
 
@@ -6061,6 +6165,7 @@ bool Tokenizer::simplifyCAlternativeTokens()
 // int i(0), j; => int i; i = 0; int j;
 void Tokenizer::simplifyInitVar()
 {
+    Timer t("Tokenizer::simplifyInitVar", list.mSettings->showtime);
     if (isC())
         return;
 
@@ -6138,6 +6243,7 @@ Token * Tokenizer::initVar(Token * tok)
 
 void Tokenizer::elseif()
 {
+    Timer t("Tokenizer::elseif", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (!Token::simpleMatch(tok, "else if"))
             continue;
@@ -6161,6 +6267,7 @@ void Tokenizer::elseif()
 
 bool Tokenizer::simplifyRedundantParentheses()
 {
+    Timer t("Tokenizer::simplifyRedundantParentheses", list.mSettings->showtime);
     bool ret = false;
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (tok->str() != "(")
@@ -6339,6 +6446,7 @@ bool Tokenizer::simplifyRedundantParentheses()
 
 void Tokenizer::simplifyTypeIntrinsics()
 {
+    Timer t("Tokenizer::simplifyTypeIntrinsics", list.mSettings->showtime);
     static const std::map<std::string, const char*> intrinsics = {
         { "__has_nothrow_assign", "has_nothrow_assign" },
         { "__has_nothrow_constructor", "has_nothrow_constructor" },
@@ -6668,31 +6776,35 @@ void Tokenizer::validateC() const
 
 void Tokenizer::validate() const
 {
-    std::stack<const Token *> linkTokens;
+    Timer t("Tokenizer::validate", list.mSettings->showtime);
+    std::vector<const Token *> linkTokens;
     const Token *lastTok = nullptr;
     for (const Token *tok = tokens(); tok; tok = tok->next()) {
         lastTok = tok;
-        if (Token::Match(tok, "[{([]") || (tok->link() && tok->str() == "<")) {
+        // Only single character brackets and (template) angle brackets can be linked
+        const std::string& str = tok->str();
+        const char c = str.size() == 1 ? str[0] : (str == ">>" ? '>' : '\0');
+        if (c == '{' || c == '(' || c == '[' || (c == '<' && tok->link())) {
             if (tok->link() == nullptr)
                 cppcheckError(tok);
 
-            linkTokens.push(tok);
+            linkTokens.push_back(tok);
         }
 
-        else if (Token::Match(tok, "[})]]") || (Token::Match(tok, ">|>>") && tok->link())) {
+        else if (c == '}' || c == ')' || c == ']' || (c == '>' && tok->link())) {
             if (tok->link() == nullptr)
                 cppcheckError(tok);
 
             if (linkTokens.empty() == true)
                 cppcheckError(tok);
 
-            if (tok->link() != linkTokens.top())
+            if (tok->link() != linkTokens.back())
                 cppcheckError(tok);
 
             if (tok != tok->link()->link())
                 cppcheckError(tok);
 
-            linkTokens.pop();
+            linkTokens.pop_back();
         }
 
         else if (tok->link() != nullptr)
@@ -6700,7 +6812,7 @@ void Tokenizer::validate() const
     }
 
     if (!linkTokens.empty())
-        cppcheckError(linkTokens.top());
+        cppcheckError(linkTokens.back());
 
     // Validate that the Tokenizer::list.back() is updated correctly during simplifications
     if (lastTok != list.back())
@@ -7158,6 +7270,7 @@ std::string Tokenizer::simplifyString(const std::string &source)
 
 void Tokenizer::simplifyStructDecl()
 {
+    Timer t("Tokenizer::simplifyStructDecl", list.mSettings->showtime);
     const bool cpp = isCPP();
 
     // A counter that is used when giving unique names for anonymous structs.
@@ -7346,6 +7459,7 @@ void Tokenizer::simplifyCallingConvention()
 
 void Tokenizer::simplifyDeclspec()
 {
+    Timer t("Tokenizer::simplifyDeclspec", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         while (Token::Match(tok, "__declspec|_declspec (") && tok->next()->link() && tok->next()->link()->next()) {
             if (Token::Match(tok->tokAt(2), "noreturn|nothrow")) {
@@ -7370,6 +7484,7 @@ void Tokenizer::simplifyDeclspec()
 
 void Tokenizer::simplifyAttribute()
 {
+    Timer t("Tokenizer::simplifyAttribute", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (Token::Match(tok, "%type% (") && !list.mProject->library.isNotLibraryFunction(tok)) {
             if (list.mProject->library.isFunctionConst(tok->str(), true))
@@ -7472,6 +7587,7 @@ void Tokenizer::simplifyAttribute()
 
 void Tokenizer::simplifyCppcheckAttribute()
 {
+    Timer t("Tokenizer::simplifyCppcheckAttribute", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (tok->str() != "(")
             continue;
@@ -7511,6 +7627,7 @@ void Tokenizer::simplifyCppcheckAttribute()
 
 void Tokenizer::simplifyCPPAttribute()
 {
+    Timer t("Tokenizer::simplifyCPPAttribute", list.mSettings->showtime);
     if (list.mProject->standards.cpp < Standards::CPP11 || isC())
         return;
 
@@ -7576,6 +7693,7 @@ static const std::set<std::string> keywords = {
 //   - Not in C++ standard yet
 void Tokenizer::simplifyKeyword()
 {
+    Timer t("Tokenizer::simplifyKeyword", list.mSettings->showtime);
     // FIXME: There is a risk that "keywords" are removed by mistake. This
     // code should be fixed so it doesn't remove variables etc. Nonstandard
     // keywords should be defined with a library instead. For instance the
@@ -7657,6 +7775,7 @@ void Tokenizer::simplifyKeyword()
 
 void Tokenizer::simplifyAssignmentBlock()
 {
+    Timer t("Tokenizer::simplifyAssignmentBlock", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (Token::Match(tok, "[;{}] %name% = ( {")) {
             const std::string &varname = tok->next()->str();
@@ -7769,6 +7888,7 @@ void Tokenizer::simplifyAsm()
 
 void Tokenizer::simplifyAsm2()
 {
+    Timer t("Tokenizer::simplifyAsm2", list.mSettings->showtime);
     // Block declarations: ^{}
     // A C extension used to create lambda like closures.
 
@@ -7817,6 +7937,7 @@ void Tokenizer::simplifyAsm2()
 
 void Tokenizer::simplifyAt()
 {
+    Timer t("Tokenizer::simplifyAt", list.mSettings->showtime);
     std::set<std::string> var;
 
     for (Token *tok = list.front(); tok; tok = tok->next()) {
@@ -7863,6 +7984,7 @@ void Tokenizer::simplifyAt()
 // Simplify bitfields
 void Tokenizer::simplifyBitfields()
 {
+    Timer t("Tokenizer::simplifyBitfields", list.mSettings->showtime);
     bool goback = false;
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (goback) {
@@ -7987,6 +8109,7 @@ static const std::set<std::string> stdFunctions = {
 // Add std:: in front of std classes, when using namespace std; was given
 void Tokenizer::simplifyNamespaceStd()
 {
+    Timer t("Tokenizer::simplifyNamespaceStd", list.mSettings->showtime);
     if (!isCPP())
         return;
 
@@ -8041,6 +8164,7 @@ void Tokenizer::simplifyNamespaceStd()
 
 void Tokenizer::simplifyMicrosoftMemoryFunctions()
 {
+    Timer t("Tokenizer::simplifyMicrosoftMemoryFunctions", list.mSettings->showtime);
     // skip if not Windows
     if (!list.mProject->isWindowsPlatform())
         return;
@@ -8136,6 +8260,7 @@ namespace {
 
 void Tokenizer::simplifyMicrosoftStringFunctions()
 {
+    Timer t("Tokenizer::simplifyMicrosoftStringFunctions", list.mSettings->showtime);
     // skip if not Windows
     if (!list.mProject->isWindowsPlatform())
         return;
@@ -8172,6 +8297,7 @@ void Tokenizer::simplifyMicrosoftStringFunctions()
 // Remove Borland code
 void Tokenizer::simplifyBorland()
 {
+    Timer t("Tokenizer::simplifyBorland", list.mSettings->showtime);
     // skip if not Windows
     if (!list.mProject->isWindowsPlatform())
         return;
@@ -8224,6 +8350,7 @@ void Tokenizer::simplifyBorland()
 // Remove Qt signals and slots
 void Tokenizer::simplifyQtSignalsSlots()
 {
+    Timer t("Tokenizer::simplifyQtSignalsSlots", list.mSettings->showtime);
     if (isC())
         return;
     for (Token *tok = list.front(); tok; tok = tok->next()) {
@@ -8333,6 +8460,7 @@ bool Tokenizer::operatorEnd(const Token * tok) const
 
 void Tokenizer::simplifyOperatorName()
 {
+    Timer t("Tokenizer::simplifyOperatorName", list.mSettings->showtime);
     if (isC())
         return;
 
@@ -8444,6 +8572,7 @@ void Tokenizer::simplifyOperatorName()
 
 void Tokenizer::simplifyOverloadedOperators()
 {
+    Timer t("Tokenizer::simplifyOverloadedOperators", list.mSettings->showtime);
     if (isC())
         return;
     std::set<std::string> classNames;
@@ -8520,6 +8649,7 @@ void Tokenizer::simplifyOverloadedOperators()
 // remove unnecessary member qualification..
 void Tokenizer::removeUnnecessaryQualification()
 {
+    Timer t("Tokenizer::removeUnnecessaryQualification", list.mSettings->showtime);
     if (isC())
         return;
 
@@ -8668,6 +8798,7 @@ void Tokenizer::printUnknownTypes() const
 
 void Tokenizer::simplifyMathExpressions()
 {
+    Timer t("Tokenizer::simplifyMathExpressions", list.mSettings->showtime);
     for (Token *tok = list.front(); tok; tok = tok->next()) {
 
         //simplify Pythagorean trigonometric identity: pow(sin(x),2)+pow(cos(x),2) = 1
@@ -8758,6 +8889,7 @@ void Tokenizer::simplifyMathExpressions()
 
 void Tokenizer::prepareTernaryOpForAST()
 {
+    Timer t("Tokenizer::prepareTernaryOpForAST", list.mSettings->showtime);
     // http://en.cppreference.com/w/cpp/language/operator_precedence says about ternary operator:
     //       "The expression in the middle of the conditional operator (between ? and :) is parsed as if parenthesized: its precedence relative to ?: is ignored."
     // The AST parser relies on this function to add such parentheses where necessary.
@@ -8851,6 +8983,7 @@ const Token *Tokenizer::findSQLBlockEnd(const Token *tokSQLStart)
 
 void Tokenizer::simplifyNestedNamespace()
 {
+    Timer t("Tokenizer::simplifyNestedNamespace", list.mSettings->showtime);
     if (!isCPP())
         return;
 
@@ -8917,6 +9050,7 @@ static Token * deleteAlias(Token * tok)
 
 void Tokenizer::simplifyNamespaceAliases()
 {
+    Timer t("Tokenizer::simplifyNamespaceAliases", list.mSettings->showtime);
     if (!isCPP())
         return;
 
@@ -26,7 +26,6 @@
 #include "errortypes.h"
 #include "tokenlist.h"
 
-#include <ctime>
 #include <list>
 #include <map>
 #include <string>
@@ -40,6 +39,7 @@ class TemplateSimplifier;
 class ErrorLogger;
 class VariableMap;
 class Preprocessor;
+class FileBudget;
 
 namespace simplecpp {
     class TokenList;
@@ -60,6 +60,18 @@ class CPPCHECKLIB Tokenizer {
     friend class TemplateSimplifier;
 
 public:
+    /**
+     * Analysis data built on top of the simplified token list by
+     * simplifyTokens1(). Each layer requires the layers before it.
+     */
+    enum class AnalysisLayer {
+        None,
+        Ast,        ///< abstract syntax tree
+        Symbols,    ///< symbol database, basic value types
+        ValueTypes, ///< value types of all expressions
+        ValueFlow   ///< values, array dimensions from values
+    };
+
     Tokenizer();
     Tokenizer(const Settings* settings, const Project* project, ErrorLogger* errorLogger);
     ~Tokenizer();
@@ -87,6 +99,19 @@ public:
 
     bool simplifyTokens0(const std::string& configuration);
     bool simplifyTokens1();
+
+    /** Layers built by simplifyTokens1(), all layers by default */
+    void setAnalysisLayer(AnalysisLayer layer) {
+        mAnalysisLayer = layer;
+    }
+
+    /** Most complete layer that has been built */
+    AnalysisLayer getAnalysisLayer() const {
+        return mBuiltLayer;
+    }
+
+    /** Build the missing layers up to the given one, after simplifyTokens1() */
+    void buildAnalysisLayers(AnalysisLayer layer);
     /**
      * Tokenize code
      * @param code input stream for code, e.g.
@@ -310,14 +335,14 @@ public:
      */
     void simplifyTemplates();
 
-    void simplifyDoublePlusAndDoubleMinus();
+    /**
+     * Single pass over the token list for independent local rewrites:
+     * "- -" into "+", "+ -" into "-", "0[a]" into "a[0]" and "f(void)" into "f()"
+     */
+    void simplifyLocalPatterns();
 
     void simplifyRedundantConsecutiveBraces();
 
-    void simplifyArrayAccessSyntax();
-
-    void simplifyParameterVoid();
-
     void fillTypeSizes();
 
     void combineOperators();
@@ -377,6 +402,13 @@ public:
         return mPreprocessor;
     }
 
+    void setBudget(FileBudget *budget) {
+        mBudget = budget;
+    }
+    FileBudget *getBudget() const {
+        return mBudget;
+    }
+
     bool hasIfdef(const Token *start, const Token *end) const;
 
 private:
@@ -671,14 +703,11 @@ public:
     */
     static const Token * startOfExecutableScope(const Token * tok);
 
-#ifdef MAXTIME
-    bool isMaxTime() const {
-        return (std::time(0) > mMaxTime);
-#else
-    static bool isMaxTime() {
-        return false;
-#endif
-    }
+    /**
+     * Is the time or memory budget of the file used up?
+     * @param phase name of the phase that is cut if the budget is used up
+     */
+    bool isBudgetExhausted(const char phase[]) const;
 
     const Settings *getSettings() const {
         return list.getSettings();
@@ -733,12 +762,14 @@ private:
      */
     bool mCodeWithTemplates;
 
-#ifdef MAXTIME
-    /** Tokenizer maxtime */
-    const std::time_t mMaxTime;
-#endif
-
     const Preprocessor *mPreprocessor;
+
+    /** Time and memory budget of the file, nullptr if unlimited */
+    FileBudget *mBudget;
+
+    /** Layers requested for simplifyTokens1() and layers built so far */
+    AnalysisLayer mAnalysisLayer;
+    AnalysisLayer mBuiltLayer;
 };
 
 /// @}
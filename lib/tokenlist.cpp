@@ -21,6 +21,7 @@
 #include "tokenlist.h"
 
 #include "errorlogger.h"
+#include "importproject.h"
 #include "library.h"
 #include "path.h"
 #include "settings.h"
@@ -44,7 +45,8 @@ TokenList::TokenList(const Settings* settings, const Project* project) :
     mSettings(settings),
     mProject(project),
     mIsC(false),
-    mIsCpp(false)
+    mIsCpp(false),
+    mFileSettings(nullptr)
 {
     mTokensFrontBack.list = this;
     mKeywords.insert("auto");
@@ -111,13 +113,11 @@ void TokenList::deallocateTokens()
 
 void TokenList::determineCppC()
 {
-    if (!mProject) {
-        mIsC = Path::isC(getSourceFilePath());
-        mIsCpp = Path::isCPP(getSourceFilePath());
-    } else {
-        mIsC = mProject->enforcedLang == Project::C || (mProject->enforcedLang == Project::None && Path::isC(getSourceFilePath()));
-        mIsCpp = mProject->enforcedLang == Project::CPP || (mProject->enforcedLang == Project::None && Path::isCPP(getSourceFilePath()));
-    }
+    Project::Language lang = mProject ? mProject->enforcedLang : Project::None;
+    if (mFileSettings && mFileSettings->language != Project::None)
+        lang = mFileSettings->language;
+    mIsC = lang == Project::C || (lang == Project::None && Path::isC(getSourceFilePath()));
+    mIsCpp = lang == Project::CPP || (lang == Project::None && Path::isCPP(getSourceFilePath()));
 
     if (mIsCpp) {
         //mKeywords.insert("bool"); // type
@@ -28,6 +28,7 @@
 #include <string>
 #include <vector>
 
+class FileSettings;
 class Settings;
 class Project;
 
@@ -70,6 +71,11 @@ public:
         return mIsCpp;
     }
 
+    /** Use the language of the build configuration of the file, unless it is None */
+    void setFileSettings(const FileSettings* fileSettings) {
+        mFileSettings = fileSettings;
+    }
+
     /**
      * Delete all tokens in given token list
      * @param tok token list to delete
@@ -223,6 +229,8 @@ private:
     /** File is known to be C/C++ code */
     bool mIsC;
     bool mIsCpp;
+
+    const FileSettings* mFileSettings;
 };
 
 /// @}
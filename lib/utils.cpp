@@ -23,6 +23,7 @@
 #include <stack>
 #include <cctype>
 #include <array>
+#include <cstdio>
 
 
 bool isPrefixStringCharLiteral(const std::string& str, char q, const std::string& p)
@@ -144,3 +145,36 @@ bool matchglob(const std::string& pattern, const std::string& name)
         n++;
     }
 }
+
+std::string toJsonString(const std::string& str)
+{
+    std::string result = "\"";
+    for (const char c : str) {
+        switch (c) {
+        case '\"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\r':
+            result += "\\r";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned int>(c));
+                result += buf;
+            } else
+                result += c;
+        }
+    }
+    result += '\"';
+    return result;
+}
@@ -25,6 +25,7 @@
 #include "config.h"
 
 #include <cstddef>
+#include <memory>
 #include <string>
 
 inline bool endsWith(const std::string &str, char c)
@@ -78,6 +79,57 @@ CPPCHECKLIB bool isValidGlobPattern(const std::string& pattern);
 
 CPPCHECKLIB bool matchglob(const std::string& pattern, const std::string& name);
 
+/** Quote and escape a string for use as a JSON value */
+CPPCHECKLIB std::string toJsonString(const std::string& str);
+
+/**
+ * @brief Value that is shared between copies until one of them is modified.
+ *
+ * Copying is O(1). write() copies the value first if it is shared, so
+ * forked states only pay for the parts they change. Not thread safe, a
+ * value and its copies must stay in one thread.
+ */
+template<class T>
+class CopyOnWrite {
+public:
+    const T& operator*() const {
+        return mData ? *mData : empty();
+    }
+    const T* operator->() const {
+        return &**this;
+    }
+
+    /** Get the value for modification */
+    T& write() {
+        if (!mData)
+            mData = std::make_shared<T>();
+        else if (mData.use_count() > 1)
+            mData = std::make_shared<T>(*mData);
+        return *mData;
+    }
+
+    /** Is the value shared with given one, i.e. it is unmodified since they were copied */
+    bool shares(const CopyOnWrite& other) const {
+        return mData == other.mData;
+    }
+
+    void clear() {
+        mData.reset();
+    }
+
+    void swap(CopyOnWrite& other) {
+        mData.swap(other.mData);
+    }
+
+private:
+    static const T& empty() {
+        static const T e;
+        return e;
+    }
+
+    std::shared_ptr<T> mData;
+};
+
 #define UNUSED(x) (void)(x)
 
 #endif
@@ -91,6 +91,7 @@
 #include "settings.h"
 #include "standards.h"
 #include "symboldatabase.h"
+#include "timer.h"
 #include "token.h"
 #include "tokenlist.h"
 #include "utils.h"
@@ -573,7 +574,7 @@ static void setTokenValue(Token* tok, const ValueFlow::Value &value, const Proje
                         setTokenValue(parent, result, project);
                         break;
                     case '/':
-                        if (value1.isTokValue() || value2.isTokValue() || value2.intvalue == 0)
+                        if (value1.isTokValue() || value2.isTokValue() || floatValue2 == 0.0)
                             break;
                         if (value1.isFloatValue() || value2.isFloatValue()) {
                             result.valueType = ValueFlow::Value::FLOAT;
@@ -1246,7 +1247,9 @@ static void valueFlowPointerAliasDeref(TokenList *tokenlist)
             if (!(v.isContainerSizeValue() || v.isUninitValue()))
                 continue;
             ValueFlow::Value value = v;
-            value.errorPath.insert(value.errorPath.begin(), errorPath.begin(), errorPath.end());
+            ErrorPath valueErrorPath = errorPath;
+            valueErrorPath.splice(valueErrorPath.end(), ErrorPath(v.errorPath));
+            value.errorPath = valueErrorPath;
             setTokenValue(tok, value, tokenlist->getProject());
         }
     }
@@ -1313,7 +1316,9 @@ static void valueFlowSameExpressions(TokenList *tokenlist)
         if (!val.isKnown())
             continue;
 
-        if (isSameExpression(tokenlist->isCPP(), false, tok->astOperand1(), tok->astOperand2(), tokenlist->getProject()->library, true, true, &val.errorPath)) {
+        ErrorPath errorPath = val.errorPath;
+        if (isSameExpression(tokenlist->isCPP(), false, tok->astOperand1(), tok->astOperand2(), tokenlist->getProject()->library, true, true, &errorPath)) {
+            val.errorPath = errorPath;
             setTokenValue(tok, val, tokenlist->getProject());
         }
     }
@@ -1844,7 +1849,7 @@ static bool evalAssignment(ValueFlow::Value &lhsValue, const std::string &assign
             return false;
     } else if (lhsValue.isFloatValue()) {
         if (assign == "=")
-            lhsValue.intvalue = rhsValue.intvalue;
+            lhsValue.floatValue = rhsValue.intvalue;
         else if (assign == "+=")
             lhsValue.floatValue += rhsValue.intvalue;
         else if (assign == "-=")
@@ -2121,14 +2126,20 @@ struct ValueFlowAnalyzer : Analyzer {
                 value->errorPath.emplace_back(tok, info);
             } else {
                 // TODO: Don't set to zero
-                value->intvalue = 0;
+                if (value->isFloatValue())
+                    value->floatValue = 0;
+                else
+                    value->intvalue = 0;
             }
         } else if (tok->astParent()->tokType() == Token::eIncDecOp) {
             bool inc = tok->astParent()->str() == "++";
             std::string opName(inc ? "incremented" : "decremented");
             if (d == Direction::Reverse)
                 inc = !inc;
-            value->intvalue += (inc ? 1 : -1);
+            if (value->isFloatValue())
+                value->floatValue += (inc ? 1.0 : -1.0);
+            else
+                value->intvalue += (inc ? 1 : -1);
             const std::string info(tok->str() + " is " + opName + "', new value is " + value->infoString());
             value->errorPath.emplace_back(tok, info);
         }
@@ -2828,7 +2839,7 @@ std::vector<LifetimeToken> getLifetimeTokens(const Token* tok, bool escape, Valu
                     continue;
                 if (v.tokvalue == tok)
                     continue;
-                errorPath.insert(errorPath.end(), v.errorPath.begin(), v.errorPath.end());
+                errorPath.splice(errorPath.end(), ErrorPath(v.errorPath));
                 return getLifetimeTokens(v.tokvalue, escape, std::move(errorPath), depth - 1);
             }
         } else {
@@ -4788,17 +4799,17 @@ static void valueFlowForLoop(TokenList *tokenlist, SymbolDatabase* symboldatabas
             ProgramMemory mem1, mem2, memAfter;
             if (valueFlowForLoop2(tok, &mem1, &mem2, &memAfter)) {
                 ProgramMemory::Map::const_iterator it;
-                for (it = mem1.values.begin(); it != mem1.values.end(); ++it) {
+                for (it = mem1.values->begin(); it != mem1.values->end(); ++it) {
                     if (!it->second.isIntValue())
                         continue;
                     valueFlowForLoopSimplify(bodyStart, it->first, false, it->second.intvalue, tokenlist, errorLogger);
                 }
-                for (it = mem2.values.begin(); it != mem2.values.end(); ++it) {
+                for (it = mem2.values->begin(); it != mem2.values->end(); ++it) {
                     if (!it->second.isIntValue())
                         continue;
                     valueFlowForLoopSimplify(bodyStart, it->first, false, it->second.intvalue, tokenlist, errorLogger);
                 }
-                for (it = memAfter.values.begin(); it != memAfter.values.end(); ++it) {
+                for (it = memAfter.values->begin(); it != memAfter.values->end(); ++it) {
                     if (!it->second.isIntValue())
                         continue;
                     valueFlowForLoopSimplifyAfter(tok, it->first, it->second.intvalue, tokenlist, errorLogger);
@@ -6410,7 +6421,6 @@ ValueFlow::Value::Value(const Token* c, long long val)
       conditional(false),
       intvalue(val),
       tokvalue(nullptr),
-      floatValue(0.0),
       varvalue(val),
       condition(c),
       varId(0U),
@@ -6489,11 +6499,14 @@ static std::size_t getTotalValues(TokenList *tokenlist)
     return n;
 }
 
-void ValueFlow::setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger)
+void ValueFlow::setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, FileBudget *budget)
 {
     for (Token *tok = tokenlist->front(); tok; tok = tok->next())
         tok->clearValueFlow();
 
+    if (Settings::terminated() || (budget && budget->exhausted("ValueFlow")))
+        return;
+
     const Project* project = tokenlist->getProject();
     const Settings* settings = tokenlist->getSettings();
 
@@ -6509,11 +6522,27 @@ void ValueFlow::setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase,
     valueFlowLifetime(tokenlist, symboldatabase, errorLogger, project);
     valueFlowBitAnd(tokenlist);
     valueFlowSameExpressions(tokenlist);
-    valueFlowFwdAnalysis(tokenlist);
+    if (Settings::terminated())
+        return;
+
+    // With a low budget, the forward analysis is skipped and the number of iterations is reduced
+    FileBudget::Tier tier = budget ? budget->check("ValueFlow") : FileBudget::FULL;
+    if (tier < FileBudget::MINIMAL)
+        valueFlowFwdAnalysis(tokenlist);
 
     std::size_t values = 0;
     std::size_t n = 4;
     while (n > 0 && values < getTotalValues(tokenlist)) {
+        // The passes poll as well, see valueFlowGenericForward()
+        if (Settings::terminated())
+            return;
+        if (budget) {
+            tier = budget->check(("ValueFlow (iteration " + std::to_string(5 - n) + ")").c_str());
+            if (tier >= FileBudget::MINIMAL)
+                break;
+            if (tier == FileBudget::REDUCED)
+                n = 1;
+        }
         values = getTotalValues(tokenlist);
         valueFlowPointerAliasDeref(tokenlist);
         valueFlowArrayBool(tokenlist);
@@ -6544,7 +6573,8 @@ void ValueFlow::setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase,
         n--;
     }
 
-    valueFlowDynamicBufferSize(tokenlist, symboldatabase, errorLogger);
+    if (tier < FileBudget::EXHAUSTED && !Settings::terminated())
+        valueFlowDynamicBufferSize(tokenlist, symboldatabase, errorLogger);
 }
 
 
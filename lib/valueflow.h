@@ -34,6 +34,7 @@
 #include <vector>
 
 class ErrorLogger;
+class FileBudget;
 class Project;
 class SymbolDatabase;
 class Token;
@@ -73,7 +74,6 @@ namespace ValueFlow {
               conditional(false),
               intvalue(val),
               tokvalue(nullptr),
-              floatValue(0.0),
               varvalue(val),
               condition(nullptr),
               varId(0U),
@@ -251,22 +251,25 @@ namespace ValueFlow {
         /** Conditional value */
         bool conditional;
 
-        /** int value */
-        long long intvalue;
+        /** Numeric payload, valueType tells which member is active */
+        union {
+            /** int value */
+            long long intvalue;
+
+            /** float value */
+            double floatValue;
+        };
 
         /** token value - the token that has the value. this is used for pointer aliases, strings, etc. */
         const Token *tokvalue;
 
-        /** float value */
-        double floatValue;
-
         /** For calculated values - variable value that calculated value depends on */
         long long varvalue;
 
         /** Condition that this value depends on */
         const Token *condition;
 
-        ErrorPath errorPath;
+        SharedErrorPath errorPath;
 
         /** For calculated values - varId that calculated value depends on */
         unsigned int varId;
@@ -346,8 +349,8 @@ namespace ValueFlow {
     /// Constant folding of expression. This can be used before the full ValueFlow has been executed (ValueFlow::setValues).
     const ValueFlow::Value * valueFlowConstantFoldAST(Token *expr, const Project* project);
 
-    /// Perform valueflow analysis.
-    void setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger);
+    /// Perform valueflow analysis. If a budget is given, the analysis is reduced when the budget runs low.
+    void setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, FileBudget *budget = nullptr);
 
     std::string eitherTheConditionIsRedundant(const Token *condition);
 
@@ -0,0 +1,188 @@
+// C++ code without known bugs, used as corpus by the benchmarks
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+template<class T>
+class Matrix {
+public:
+    Matrix(std::size_t rows, std::size_t cols) : mRows(rows), mCols(cols), mData(rows * cols) {}
+
+    T& at(std::size_t row, std::size_t col) {
+        return mData[row * mCols + col];
+    }
+    const T& at(std::size_t row, std::size_t col) const {
+        return mData[row * mCols + col];
+    }
+
+    std::size_t rows() const {
+        return mRows;
+    }
+    std::size_t cols() const {
+        return mCols;
+    }
+
+    Matrix operator*(const Matrix& other) const {
+        Matrix result(mRows, other.mCols);
+        for (std::size_t i = 0; i < mRows; ++i) {
+            for (std::size_t j = 0; j < other.mCols; ++j) {
+                T sum = T();
+                for (std::size_t k = 0; k < mCols; ++k)
+                    sum += at(i, k) * other.at(k, j);
+                result.at(i, j) = sum;
+            }
+        }
+        return result;
+    }
+
+private:
+    std::size_t mRows;
+    std::size_t mCols;
+    std::vector<T> mData;
+};
+
+class Node {
+public:
+    explicit Node(const std::string& name) : mName(name), mParent(nullptr) {}
+    virtual ~Node() {}
+
+    const std::string& name() const {
+        return mName;
+    }
+
+    Node* addChild(const std::string& name) {
+        mChildren.emplace_back(new Node(name));
+        mChildren.back()->mParent = this;
+        return mChildren.back().get();
+    }
+
+    const Node* find(const std::string& name) const {
+        if (mName == name)
+            return this;
+        for (const std::unique_ptr<Node>& child : mChildren) {
+            const Node* found = child->find(name);
+            if (found)
+                return found;
+        }
+        return nullptr;
+    }
+
+    int depth() const {
+        int d = 0;
+        for (const Node* node = mParent; node; node = node->mParent)
+            ++d;
+        return d;
+    }
+
+    virtual std::string describe() const {
+        return mName + " (" + std::to_string(mChildren.size()) + " children)";
+    }
+
+private:
+    std::string mName;
+    Node* mParent;
+    std::vector<std::unique_ptr<Node>> mChildren;
+};
+
+class FileNode : public Node {
+public:
+    FileNode(const std::string& name, std::size_t size) : Node(name), mSize(size) {}
+
+    std::string describe() const override {
+        return name() + " (" + std::to_string(mSize) + " bytes)";
+    }
+
+private:
+    std::size_t mSize;
+};
+
+class Buffer {
+public:
+    explicit Buffer(std::size_t size) : mSize(size), mData(new char[size]) {
+        std::memset(mData, 0, size);
+    }
+    Buffer(const Buffer& other) : mSize(other.mSize), mData(new char[other.mSize]) {
+        std::memcpy(mData, other.mData, mSize);
+    }
+    Buffer& operator=(const Buffer& other) {
+        if (this != &other) {
+            char* data = new char[other.mSize];
+            std::memcpy(data, other.mData, other.mSize);
+            delete[] mData;
+            mData = data;
+            mSize = other.mSize;
+        }
+        return *this;
+    }
+    ~Buffer() {
+        delete[] mData;
+    }
+
+    void fill(char c, std::size_t count) {
+        std::memset(mData, c, std::min(count, mSize));
+    }
+
+    std::size_t size() const {
+        return mSize;
+    }
+
+private:
+    std::size_t mSize;
+    char* mData;
+};
+
+std::map<std::string, int> countWords(const std::list<std::string>& words)
+{
+    std::map<std::string, int> counts;
+    for (const std::string& word : words) {
+        if (word.empty())
+            continue;
+        ++counts[word];
+    }
+    return counts;
+}
+
+std::vector<int> topValues(std::vector<int> values, std::size_t n)
+{
+    std::sort(values.begin(), values.end(), [](int a, int b) {
+        return a > b;
+    });
+    if (values.size() > n)
+        values.resize(n);
+    return values;
+}
+
+int classes()
+{
+    Matrix<double> a(3, 3);
+    Matrix<double> b(3, 3);
+    for (std::size_t i = 0; i < 3; ++i) {
+        a.at(i, i) = 1.0;
+        b.at(i, 2 - i) = 2.0;
+    }
+    const Matrix<double> c = a * b;
+
+    Node root("root");
+    Node* src = root.addChild("src");
+    src->addChild("main.cpp");
+    const Node* found = root.find("main.cpp");
+
+    Buffer buffer(64);
+    buffer.fill('x', 16);
+    Buffer copy(buffer);
+
+    std::list<std::string> words;
+    words.push_back("alpha");
+    words.push_back("beta");
+    words.push_back("alpha");
+    const std::map<std::string, int> counts = countWords(words);
+
+    const std::vector<int> top = topValues({5, 3, 9, 1}, 2);
+
+    return static_cast<int>(c.at(0, 2)) + (found ? found->depth() : 0) + static_cast<int>(copy.size()) + counts.at("alpha") + top[0];
+}
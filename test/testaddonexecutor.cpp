@@ -0,0 +1,196 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "addonexecutor.h"
+#include "testsuite.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+class TestAddonExecutor : public TestFixture {
+public:
+    TestAddonExecutor() : TestFixture("TestAddonExecutor") {
+    }
+
+private:
+    void run() override {
+        TEST_CASE(readResults);
+        TEST_CASE(readInvalidOutput);
+        TEST_CASE(readUnterminatedLine);
+#ifndef _WIN32
+        TEST_CASE(executeTasks);
+        TEST_CASE(timeout);
+        TEST_CASE(missingExecutable);
+#endif
+    }
+
+    static std::string result(const char id[], int line) {
+        return std::string("{\"file\": \"test.c\", \"linenr\": ") + std::to_string(line) +
+               ", \"column\": 3, \"severity\": \"style\", \"message\": \"Message\", \"addon\": \"test\", \"errorId\": \"" + id + "\"}";
+    }
+
+    void readResults() {
+        std::vector<ErrorMessage> messages;
+        AddonOutputReader reader([&](const ErrorMessage& msg) {
+            messages.push_back(msg);
+        });
+
+        // A result is handled as soon as its line is complete
+        const std::string output = "Checking test.c.dump...\n" + result("first", 1) + "\n" + result("second", 2) + "\n";
+        const std::string::size_type split = output.find("second");
+        reader.feed(output.data(), split);
+        ASSERT_EQUALS(1U, messages.size());
+        reader.feed(output.data() + split, output.size() - split);
+        reader.finish();
+
+        ASSERT_EQUALS(2U, messages.size());
+        ASSERT_EQUALS("test-first", messages[0].id);
+        ASSERT_EQUALS("test-second", messages[1].id);
+        ASSERT_EQUALS("Message", messages[1].shortMessage());
+        ASSERT_EQUALS("test.c", messages[1].file0);
+        ASSERT_EQUALS(1U, messages[1].callStack.size());
+        ASSERT_EQUALS(2, messages[1].callStack.front().line);
+        ASSERT_EQUALS(3, messages[1].callStack.front().column);
+        ASSERT_EQUALS(true, reader.invalidOutput().empty());
+    }
+
+    void readInvalidOutput() {
+        std::vector<ErrorMessage> messages;
+        AddonOutputReader reader([&](const ErrorMessage& msg) {
+            messages.push_back(msg);
+        });
+
+        const std::string output = result("first", 1) + "\nTraceback (most recent call last):\n" + result("second", 2) + "\n{\"file\": 1}\n";
+        reader.feed(output.data(), output.size());
+        reader.finish();
+
+        // Results after a failure are part of its output
+        ASSERT_EQUALS(1U, messages.size());
+        ASSERT_EQUALS("Traceback (most recent call last):\n" + result("second", 2) + "\n{\"file\": 1}", reader.invalidOutput());
+
+        AddonOutputReader malformed([&](const ErrorMessage& msg) {
+            messages.push_back(msg);
+        });
+        malformed.feed("{\"file\": 1}\n", 12);
+        malformed.finish();
+        ASSERT_EQUALS("{\"file\": 1}", malformed.invalidOutput());
+    }
+
+    void readUnterminatedLine() {
+        std::vector<ErrorMessage> messages;
+        AddonOutputReader reader([&](const ErrorMessage& msg) {
+            messages.push_back(msg);
+        });
+
+        const std::string output = result("last", 1);
+        reader.feed(output.data(), output.size());
+        ASSERT_EQUALS(0U, messages.size());
+        reader.finish();
+        ASSERT_EQUALS(1U, messages.size());
+    }
+
+#ifndef _WIN32
+    static AddonExecutor::Command shell(const std::string& script) {
+        return AddonExecutor::Command{"sh", {"-c", script}};
+    }
+
+    void executeTasks() {
+        // The callbacks of different tasks are called concurrently
+        std::mutex sync;
+        std::vector<std::string> ids;
+        std::vector<std::string> failures;
+        unsigned int done = 0;
+
+        {
+            AddonExecutor executor(2, std::chrono::seconds(0));
+            for (const char* name : { "a", "b" }) {
+                AddonExecutor::Task task;
+                task.commands.push_back(shell("echo '" + result(name, 1) + "'"));
+                task.commands.push_back(shell("echo 'Checking " + std::string(name) + ".dump'; echo '" + result(name, 2) + "'"));
+                task.report = [&](const ErrorMessage& msg) {
+                    std::lock_guard<std::mutex> lock(sync);
+                    ids.push_back(msg.id);
+                };
+                task.failed = [&](const std::string& msg) {
+                    std::lock_guard<std::mutex> lock(sync);
+                    failures.push_back(msg);
+                };
+                task.done = [&]() {
+                    std::lock_guard<std::mutex> lock(sync);
+                    ++done;
+                };
+                executor.submit(std::move(task));
+            }
+            executor.wait();
+            std::lock_guard<std::mutex> lock(sync);
+            ASSERT_EQUALS(2U, done);
+        }
+
+        ASSERT_EQUALS(0U, failures.size());
+        ASSERT_EQUALS(4U, ids.size());
+        ASSERT_EQUALS(2, std::count(ids.cbegin(), ids.cend(), "test-a"));
+        ASSERT_EQUALS(2, std::count(ids.cbegin(), ids.cend(), "test-b"));
+    }
+
+    void timeout() {
+        std::vector<std::string> failures;
+        bool done = false;
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        {
+            AddonExecutor executor(1, std::chrono::seconds(1));
+            AddonExecutor::Task task;
+            task.commands.push_back(shell("sleep 30"));
+            task.failed = [&](const std::string& msg) {
+                failures.push_back(msg);
+            };
+            task.done = [&]() {
+                done = true;
+            };
+            executor.submit(std::move(task));
+        }
+
+        ASSERT(std::chrono::steady_clock::now() - start < std::chrono::seconds(20));
+        ASSERT_EQUALS(true, done);
+        ASSERT_EQUALS(1U, failures.size());
+        ASSERT_EQUALS("Addon timed out after 1 seconds (command: 'sh -c \"sleep 30\"')", failures[0]);
+    }
+
+    void missingExecutable() {
+        std::vector<std::string> failures;
+        {
+            AddonExecutor executor(1, std::chrono::seconds(0));
+            AddonExecutor::Task task;
+            task.commands.push_back(AddonExecutor::Command{"lcppc-missing-addon-interpreter", {"addon.py"}});
+            task.failed = [&](const std::string& msg) {
+                failures.push_back(msg);
+            };
+            executor.submit(std::move(task));
+        }
+
+        ASSERT_EQUALS(1U, failures.size());
+        ASSERT_EQUALS("Failed to execute addon (command: 'lcppc-missing-addon-interpreter addon.py')", failures[0]);
+    }
+#endif
+};
+
+REGISTER_TEST(TestAddonExecutor)
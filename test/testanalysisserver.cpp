@@ -0,0 +1,234 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "analysisserver.h"
+#include "importproject.h"
+#include "mathlib.h"
+#include "settings.h"
+#include "testsuite.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Input and output of the server, so that the test decides when a request
+ * arrives: an input step is handed out once the output contains a text,
+ * and the worker can be held at an output line until its job is cancelled.
+ */
+class Conversation {
+public:
+    Conversation() : mSteps(0), mIn(*this), mOut(*this), in(&mIn), out(&mOut) {}
+
+    /** Input that is read after the output contains 'after' */
+    void input(const std::string& after, const std::string& text) {
+        mInput.emplace_back(after, text);
+    }
+
+    /** Writing a line with this text waits until the running request is cancelled */
+    void holdOutput(const std::string& text) {
+        mHold = text;
+    }
+
+    std::string output() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mOutput;
+    }
+
+private:
+    class InputBuf : public std::streambuf {
+    public:
+        explicit InputBuf(Conversation& c) : mConversation(c) {}
+    protected:
+        int_type underflow() override {
+            if (!mConversation.next(mCurrent))
+                return traits_type::eof();
+            setg(&mCurrent[0], &mCurrent[0], &mCurrent[0] + mCurrent.size());
+            return traits_type::to_int_type(mCurrent[0]);
+        }
+    private:
+        Conversation& mConversation;
+        std::string mCurrent;
+    };
+
+    class OutputBuf : public std::streambuf {
+    public:
+        explicit OutputBuf(Conversation& c) : mConversation(c) {}
+    protected:
+        int_type overflow(int_type c) override {
+            if (c != traits_type::eof())
+                mConversation.put(traits_type::to_char_type(c));
+            return traits_type::not_eof(c);
+        }
+    private:
+        Conversation& mConversation;
+    };
+
+    bool next(std::string& text) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (mSteps == mInput.size())
+            return false;
+        const std::pair<std::string, std::string>& step = mInput[mSteps++];
+        mCondition.wait(lock, [&]() {
+            return mOutput.find(step.first) != std::string::npos;
+        });
+        text = step.second;
+        return !text.empty();
+    }
+
+    void put(char c) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mOutput += c;
+        mCondition.notify_all();
+        if (c != '\n' || mHold.empty())
+            return;
+        const std::string::size_type line = mOutput.rfind('\n', mOutput.size() - 2);
+        if (mOutput.find(mHold, line == std::string::npos ? 0 : line) == std::string::npos)
+            return;
+        // The line is written by the worker thread, in the scope of the cancellation token of its request
+        lock.unlock();
+        while (!Settings::terminated())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::vector<std::pair<std::string, std::string>> mInput;
+    std::size_t mSteps;
+    std::string mHold;
+    std::string mOutput;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    InputBuf mIn;
+    OutputBuf mOut;
+
+public:
+    std::istream in;
+    std::ostream out;
+};
+
+class TestAnalysisServer : public TestFixture {
+public:
+    TestAnalysisServer() : TestFixture("TestAnalysisServer") {
+    }
+
+private:
+    void run() override {
+        TEST_CASE(requests);
+        TEST_CASE(malformedRequest);
+    }
+
+    static void writeFile(const char name[], const std::string& content) {
+        std::ofstream fout(name);
+        fout << content;
+    }
+
+    void requests() const {
+        Settings settings;
+        Project project;
+        ImportProject importProject;
+        settings.output.setEnabled(Output::status, true);
+        AnalysisServer server(settings, project, importProject);
+
+        writeFile("testanalysisserver.h", "#define INDEX 1\n");
+        writeFile("testanalysisserver.c",
+                  "#include \"testanalysisserver.h\"\n"
+                  "void f() {\n"
+                  "    int a[2];\n"
+                  "    a[INDEX + 1] = 0;\n"
+                  "}\n");
+
+        // Exit code and output of a run
+        const auto serve = [&](Conversation& conversation) {
+            const int ret = server.run(conversation.in, conversation.out);
+            return MathLib::toString(ret) + '\n' + conversation.output();
+        };
+        const std::string started = "{\"event\":\"started\",\"file\":\"testanalysisserver.c\"}\n";
+        const std::string checking = "{\"event\":\"log\",\"message\":\"Checking testanalysisserver.c...\"}\n";
+        const std::string finding = "{\"event\":\"finding\",\"file\":\"testanalysisserver.c\",\"location\":\"testanalysisserver.c\",\"line\":4,\"column\":6,"
+                                    "\"severity\":\"error\",\"inconclusive\":false,\"id\":\"arrayIndexOutOfBounds\",\"message\":\"Array 'a[2]' accessed at index 2, which is out of bounds.\"}\n";
+        const auto done = [](bool cancelled, bool cached) {
+            return std::string("{\"event\":\"done\",\"file\":\"testanalysisserver.c\",\"cancelled\":") + (cancelled ? "true" : "false") +
+                   ",\"cached\":" + (cached ? "true" : "false") + "}\n";
+        };
+
+        Conversation check;
+        check.input("", "check testanalysisserver.c\n");
+        ASSERT_EQUALS("0\n" + started + checking + finding + done(false, false), serve(check));
+
+        // Unchanged file => the results are replayed
+        Conversation recheck;
+        recheck.input("", "check testanalysisserver.c\n");
+        ASSERT_EQUALS("0\n" + started + finding + done(false, true), serve(recheck));
+
+        // A header that is written again with the same tokens keeps the results
+        writeFile("testanalysisserver.h", "#define INDEX 1 // same tokens\n");
+        Conversation headerWritten;
+        headerWritten.input("", "check testanalysisserver.c\n");
+        ASSERT_EQUALS("0\n" + started + finding + done(false, true), serve(headerWritten));
+
+        // A changed header invalidates the results
+        writeFile("testanalysisserver.h", "#define INDEX 0\n");
+        Conversation headerChanged;
+        headerChanged.input("", "check testanalysisserver.c\n");
+        ASSERT_EQUALS("0\n" + started + checking + done(false, false), serve(headerChanged));
+
+        // The running request is cancelled, its results are not cached
+        writeFile("testanalysisserver.h", "#define INDEX 1\n");
+        Conversation cancel;
+        cancel.input("", "check testanalysisserver.c\n");
+        cancel.input("Checking", "cancel testanalysisserver.c\n");
+        cancel.holdOutput("Checking");
+        ASSERT_EQUALS("0\n" + started + checking + done(true, false), serve(cancel));
+
+        // quit cancels the running request and ignores the rest of the input
+        const std::string code = "void g() { int b[2]; b[2] = 0; }\n";
+        Conversation quit;
+        quit.input("", "buffer " + MathLib::toString(code.size()) + " testanalysisserver.c\n" + code);
+        quit.input("Checking", "quit\ncheck testanalysisserver.c\n");
+        quit.holdOutput("Checking");
+        ASSERT_EQUALS("0\n" + started + checking + done(true, false), serve(quit));
+
+        std::remove("testanalysisserver.c");
+        std::remove("testanalysisserver.h");
+    }
+
+    void malformedRequest() const {
+        Settings settings;
+        Project project;
+        ImportProject importProject;
+        AnalysisServer server(settings, project, importProject);
+
+        Conversation conversation;
+        conversation.input("", "check\nlint test.c\nbuffer x test.c\ncheck test.c\n");
+        ASSERT_EQUALS(EXIT_FAILURE, server.run(conversation.in, conversation.out));
+        ASSERT_EQUALS("{\"event\":\"error\",\"message\":\"Missing argument in request 'check'\"}\n"
+                      "{\"event\":\"error\",\"message\":\"Unknown request 'lint'\"}\n"
+                      "{\"event\":\"error\",\"message\":\"Malformed request 'buffer x test.c'\"}\n",
+                      conversation.output());
+    }
+};
+
+REGISTER_TEST(TestAnalysisServer)
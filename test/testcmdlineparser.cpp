@@ -75,6 +75,8 @@ private:
         TEST_CASE(includes2);
         TEST_CASE(includesFile);
         TEST_CASE(configExcludesFile);
+        TEST_CASE(dumpFormat);
+        TEST_CASE(dumpFormatInvalid);
         TEST_CASE(enabledAll);
         TEST_CASE(enabledStyle);
         TEST_CASE(enabledPerformance);
@@ -106,6 +108,20 @@ private:
         TEST_CASE(maxConfigsMissingCount);
         TEST_CASE(maxConfigsInvalid);
         TEST_CASE(maxConfigsTooSmall);
+        TEST_CASE(maxFileTime);
+        TEST_CASE(maxFileTimeInvalid);
+        TEST_CASE(maxFileTimeNegative);
+        TEST_CASE(addonJobs);
+        TEST_CASE(addonJobsNegative);
+        TEST_CASE(addonTimeout);
+        TEST_CASE(addonTimeoutInvalid);
+        TEST_CASE(addonTimeoutNegative);
+        TEST_CASE(maxFileMemory);
+        TEST_CASE(maxFileMemoryNegative);
+        TEST_CASE(maxFileMemoryJobs);
+        TEST_CASE(server);
+        TEST_CASE(projectFile);
+        TEST_CASE(projectFileWithSources);
         TEST_CASE(reportProgressTest); // "Test" suffix to avoid hiding the parent's reportProgress
         TEST_CASE(stdc99);
         TEST_CASE(stdcpp11);
@@ -129,6 +145,7 @@ private:
         TEST_CASE(xmlverinvalid);
         TEST_CASE(doc);
         TEST_CASE(showtime);
+        TEST_CASE(perfReport);
         TEST_CASE(errorlist1);
         TEST_CASE(errorlistverbose1);
         TEST_CASE(errorlistverbose2);
@@ -458,6 +475,24 @@ private:
         ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
     }
 
+    void dumpFormat() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--dump", "--dump-format=binary", "file.cpp"};
+        settings.dump = false;
+        settings.dumpFormat = Settings::DUMP_XML;
+        ASSERT(defParser.parseFromArgs(4, argv));
+        ASSERT(settings.dump);
+        ASSERT_EQUALS(Settings::DUMP_BINARY, settings.dumpFormat);
+        settings.dump = false;
+        settings.dumpFormat = Settings::DUMP_XML;
+    }
+
+    void dumpFormatInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--dump-format=json", "file.cpp"};
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
     void enabledAll() {
         REDIRECT;
         const char * const argv[] = {"cppcheck", "--severity=all", "file.cpp"};
@@ -709,6 +744,117 @@ private:
         ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
     }
 
+    void maxFileTime() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--max-file-time=60", "file.cpp"};
+        settings.maxFileTime = 0;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT_EQUALS(60, settings.maxFileTime);
+    }
+
+    void maxFileTimeInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--max-file-time=e", "file.cpp"};
+        // Fails since invalid time given for --max-file-time=
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
+    void maxFileTimeNegative() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--max-file-time=-1", "file.cpp"};
+        // Fails since a negative time would wrap around
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
+    void addonJobs() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--addon-jobs=3", "file.cpp"};
+        settings.addonJobs = 0;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT_EQUALS(3, settings.addonJobs);
+    }
+
+    void addonJobsNegative() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--addon-jobs=-1", "file.cpp"};
+        // Fails since a negative number would wrap around
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
+    void addonTimeout() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--addon-timeout=30", "file.cpp"};
+        settings.addonTimeout = 0;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT_EQUALS(30, settings.addonTimeout);
+    }
+
+    void addonTimeoutInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--addon-timeout=e", "file.cpp"};
+        // Fails since invalid time given for --addon-timeout=
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
+    void addonTimeoutNegative() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--addon-timeout=-1", "file.cpp"};
+        // Fails since a negative time would wrap around
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
+    void maxFileMemory() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--max-file-memory=2048", "file.cpp"};
+        settings.maxFileMemory = 0;
+        settings.jobs = 1;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT_EQUALS(2048, settings.maxFileMemory);
+        settings.maxFileMemory = 0;
+    }
+
+    void maxFileMemoryNegative() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--max-file-memory=-1", "file.cpp"};
+        // Fails since a negative size would wrap around
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
+    void maxFileMemoryJobs() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--max-file-memory=2048", "-j2", "file.cpp"};
+        CmdLineParser parser(&settings, &project);
+        // Fails since the memory of the other threads would count
+        ASSERT_EQUALS(false, parser.parseFromArgs(4, argv));
+        settings.maxFileMemory = 0;
+        settings.jobs = 1;
+    }
+
+    void server() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--server"};
+        CmdLineParser parser(&settings, &project);
+        // No files needed, they are given by the requests
+        ASSERT(parser.parseFromArgs(2, argv));
+        ASSERT_EQUALS(true, parser.getServerMode());
+    }
+
+    void projectFile() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--project=build/compile_commands.json"};
+        CmdLineParser parser(&settings, &project);
+        ASSERT(parser.parseFromArgs(2, argv));
+        ASSERT_EQUALS("build/compile_commands.json", parser.getProjectFile());
+    }
+
+    void projectFileWithSources() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--project=compile_commands.json", "file.cpp"};
+        CmdLineParser parser(&settings, &project);
+        // Files are taken from the compilation database
+        ASSERT_EQUALS(false, parser.parseFromArgs(3, argv));
+    }
+
     void reportProgressTest() {
         REDIRECT;
         const char * const argv[] = {"cppcheck", "--report-progress", "file.cpp"};
@@ -922,6 +1068,17 @@ private:
         ASSERT(settings.showtime == Settings::SHOWTIME_SUMMARY);
     }
 
+    void perfReport() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--perf-report=perf.json", "file.cpp"};
+        settings.perfReport.clear();
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT_EQUALS("perf.json", settings.perfReport);
+
+        const char * const argv2[] = {"cppcheck", "--perf-report=", "file.cpp"};
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv2));
+    }
+
     void errorlist1() {
         REDIRECT;
         const char * const argv[] = {"cppcheck", "--errorlist"};
@@ -17,14 +17,25 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "binarydump.h"
 #include "check.h"
 #include "cppcheck.h"
+#include "ctu.h"
 #include "errorlogger.h"
+#include "perfreport.h"
+#include "settings.h"
 #include "testsuite.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
 #include <list>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 
@@ -38,11 +49,15 @@ private:
     class ErrorLogger2 : public ErrorLogger {
     public:
         std::vector<std::string> id;
+        std::vector<Severity::SeverityType> severity;
+        std::vector<int> line;
 
         void reportOut(const std::string & /*outmsg*/) override {}
 
         void reportErr(const ErrorMessage &msg) override {
             id.push_back(msg.id);
+            severity.push_back(msg.severity);
+            line.push_back(msg.callStack.empty() ? 0 : msg.callStack.back().line);
         }
     };
 
@@ -50,6 +65,12 @@ private:
         TEST_CASE(instancesSorted);
         TEST_CASE(classInfoFormat);
         TEST_CASE(getErrorMessages);
+        TEST_CASE(severities);
+        TEST_CASE(plannedChecks);
+        TEST_CASE(performanceReport);
+        TEST_CASE(analyzerFileReused);
+        TEST_CASE(binaryDump);
+        TEST_CASE(cancellationToken);
     }
 
     void instancesSorted() const {
@@ -104,6 +125,227 @@ private:
         ASSERT(foundPurgedConfiguration);
         ASSERT(foundTooManyConfigs);
     }
+
+    void severities() const {
+        Settings settings;
+        Project project;
+        project.severity.fill();
+        for (const Check *check : Check::instances()) {
+            ErrorLogger2 errorLogger;
+            const Context ctx(&errorLogger, &settings, &project);
+            check->getErrorMessages(ctx);
+            for (std::size_t i = 0; i < errorLogger.id.size(); ++i)
+                ASSERT_EQUALS_MSG(true, check->severities().isEnabled(errorLogger.severity[i]), check->name() + ": " + errorLogger.id[i]);
+        }
+    }
+
+    static bool isPlanned(CppCheck &cppCheck, const std::string &name) {
+        for (const Check *check : cppCheck.plannedChecks()) {
+            if (check->name() == name)
+                return true;
+        }
+        return false;
+    }
+
+    void plannedChecks() const {
+        ErrorLogger2 errorLogger;
+        Settings settings;
+        {
+            Project project;
+            CppCheck cppCheck(errorLogger, settings, project, true);
+            ASSERT_EQUALS(true, isPlanned(cppCheck, "NullPointer"));
+            ASSERT_EQUALS(false, isPlanned(cppCheck, "64BitPortability"));
+        }
+        {
+            Project project;
+            project.severity.enable(Severity::portability);
+            project.checks.setEnabled("NullPointer", false);
+            CppCheck cppCheck(errorLogger, settings, project, true);
+            ASSERT_EQUALS(false, isPlanned(cppCheck, "NullPointer"));
+            ASSERT_EQUALS(true, isPlanned(cppCheck, "64BitPortability"));
+        }
+        {
+            Project project;
+            project.nomsg.addSuppressionLine("*");
+            CppCheck cppCheck(errorLogger, settings, project, true);
+            ASSERT_EQUALS(0U, cppCheck.plannedChecks().size());
+        }
+        {
+            Project project;
+            project.nomsg.addSuppressionLine("*:file.c");
+            CppCheck cppCheck(errorLogger, settings, project, true);
+            ASSERT_EQUALS(true, isPlanned(cppCheck, "NullPointer"));
+        }
+    }
+
+    void performanceReport() const {
+        ErrorLogger2 errorLogger;
+        Settings settings;
+        Project project;
+        std::ostringstream out;
+        PerformanceReport report(out);
+        CppCheck cppCheck(errorLogger, settings, project, true);
+        cppCheck.setPerformanceReport(&report);
+
+        const char code[] = "#ifdef A\n"
+                            "int a;\n"
+                            "#endif\n"
+                            "void f() { int x = 0; }\n";
+        CTU::CTUInfo ctu("test.c", sizeof(code) - 1, emptyString);
+        cppCheck.check(&ctu, code);
+
+        const std::string line = out.str();
+        ASSERT_EQUALS(1, std::count(line.cbegin(), line.cend(), '\n'));
+        ASSERT_EQUALS(0U, line.find("{\"file\":\"test.c\",\"size\":47,\"cached\":false,"));
+        ASSERT(line.find(",\"memoryGrowth\":") != std::string::npos);
+        ASSERT(line.find(",\"rawTokens\":19,") != std::string::npos);
+        ASSERT(line.find(",\"configurations\":2,\"checkedConfigurations\":2,") != std::string::npos);
+        ASSERT(line.find("\"CppCheck::checkCTU\":{\"self\":") != std::string::npos);
+        ASSERT(line.find("\"Preprocessor::preprocess\":{") != std::string::npos);
+        ASSERT(line.find("\"NullPointer::runChecks\":{") != std::string::npos);
+
+        // Nothing is recorded without report
+        cppCheck.setPerformanceReport(nullptr);
+        cppCheck.check(&ctu, code);
+        ASSERT_EQUALS(line, out.str());
+
+        // The memory of the process can not be attributed to one of the files checked in parallel
+        settings.jobs = 2;
+        out.str("");
+        cppCheck.setPerformanceReport(&report);
+        cppCheck.check(&ctu, code);
+        ASSERT_EQUALS(std::string::npos, out.str().find("memoryGrowth"));
+        ASSERT(out.str().find(",\"rawTokens\":19,") != std::string::npos);
+    }
+
+    void analyzerFileReused() const {
+        ErrorLogger2 errorLogger;
+        Settings settings;
+        Project project;
+        project.buildDir = ".";
+        std::ostringstream out;
+        PerformanceReport report(out);
+        CppCheck cppCheck(errorLogger, settings, project, true);
+        cppCheck.setPerformanceReport(&report);
+
+        const char analyzerfile[] = "testcppcheck-reuse.a1";
+        const auto check = [&](const std::string& code) {
+            out.str("");
+            CTU::CTUInfo ctu("test.c", code.size(), analyzerfile);
+            ctu.analyzerfileExists = true;
+            cppCheck.check(&ctu, code);
+            return out.str().find("\"cached\":true") != std::string::npos;
+        };
+
+        ASSERT_EQUALS(false, check("void f() { int x = 0; }\n"));
+        // Comments do not change the tokens
+        ASSERT_EQUALS(true, check("void f() { int x = 0; } // zero\n"));
+        // Moved tokens are reported at other positions
+        ASSERT_EQUALS(false, check("void f() {\n    int x = 0;\n}\n"));
+        errorLogger.line.clear();
+        ASSERT_EQUALS(false, check("void f() {\n    int a[2];\n    a[2] = 0;\n}\n"));
+        ASSERT_EQUALS(false, check("\nvoid f() {\n    int a[2];\n    a[2] = 0;\n}\n"));
+        ASSERT_EQUALS(true, check("\nvoid f() {\n    int a[2];\n    a[2] = 0;\n}\n"));
+        // The replayed finding is at its new line
+        ASSERT_EQUALS(3U, errorLogger.line.size());
+        ASSERT_EQUALS(3, errorLogger.line[0]);
+        ASSERT_EQUALS(4, errorLogger.line[1]);
+        ASSERT_EQUALS(4, errorLogger.line[2]);
+        ASSERT_EQUALS(false, check("void f() { int x = 1; }\n"));
+        // The results depend on the platform
+        project.platform(cppcheck::Platform::Win64);
+        ASSERT_EQUALS(false, check("void f() { int x = 1; }\n"));
+        ASSERT_EQUALS(true, check("void f() { int x = 1; }\n"));
+
+        std::remove(analyzerfile);
+    }
+
+    void binaryDump() const {
+        ErrorLogger2 errorLogger;
+        Settings settings;
+        settings.dump = true;
+        settings.dumpFormat = Settings::DUMP_BINARY;
+        settings.dumpFile = "testcppcheck-binary.dump";
+        Project project;
+        CppCheck cppCheck(errorLogger, settings, project, true);
+        const std::string code("int x = 1;\n");
+        CTU::CTUInfo ctu("test.c", code.size(), emptyString);
+        cppCheck.check(&ctu, code);
+
+        std::ifstream fin(settings.dumpFile, std::ios::binary);
+        const std::string data((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+        fin.close();
+        std::remove(settings.dumpFile.c_str());
+        const auto number = [&data](std::size_t pos, std::size_t size) {
+            std::uint64_t value = 0;
+            for (std::size_t i = size; i > 0; --i)
+                value = (value << 8) | static_cast<unsigned char>(data[pos + i - 1]);
+            return value;
+        };
+
+        ASSERT(data.size() > 16);
+        ASSERT_EQUALS(std::string(BinaryDump::magic), data.substr(0, 8));
+        ASSERT_EQUALS(BinaryDump::version, number(8, 4));
+
+        // Sections are 8 byte aligned and fill the file
+        std::string tags;
+        std::size_t tokens = 0;
+        std::size_t pos = 16;
+        while (pos + 16 <= data.size()) {
+            const std::string tag = data.substr(pos, 4);
+            const std::size_t size = number(pos + 8, 8);
+            ASSERT_EQUALS(0, size % 8);
+            if (tag == "CONF") {
+                // INFO and DIRS come first
+                std::size_t sub = pos + 16;
+                sub += 16 + number(sub + 8, 8);
+                sub += 16 + number(sub + 8, 8);
+                ASSERT_EQUALS("TOKS", data.substr(sub, 4));
+                tokens = number(sub + 16, 4);
+            }
+            tags += tag + ' ';
+            pos += 16 + size;
+        }
+        ASSERT_EQUALS(data.size(), pos);
+        ASSERT_EQUALS("PLAT RAWT SUPP CONF STRS ", tags);
+        // int x ; x = 1 ;
+        ASSERT_EQUALS(7, tokens);
+    }
+
+    void cancellationToken() const {
+        CancellationToken token;
+        {
+            const CancellationToken::Scope scope(&token);
+            ASSERT_EQUALS(false, Settings::terminated());
+            token.cancel();
+            ASSERT_EQUALS(true, Settings::terminated());
+
+            // Other threads go on
+            bool terminated = true;
+            std::thread([&terminated]() {
+                terminated = Settings::terminated();
+            }).join();
+            ASSERT_EQUALS(false, terminated);
+        }
+        ASSERT_EQUALS(false, Settings::terminated());
+
+        Settings settings;
+        Project project;
+        const char code[] = "void f() { int *p = 0; *p = 0; }\n";
+
+        ErrorLogger2 cancelledLogger;
+        CppCheck cancelled(cancelledLogger, settings, project, true);
+        cancelled.setCancellationToken(&token);
+        CTU::CTUInfo ctu1("test.c", sizeof(code) - 1, emptyString);
+        cancelled.check(&ctu1, code);
+        ASSERT(cancelledLogger.id.empty());
+
+        ErrorLogger2 errorLogger;
+        CppCheck cppCheck(errorLogger, settings, project, true);
+        CTU::CTUInfo ctu2("test.c", sizeof(code) - 1, emptyString);
+        cppCheck.check(&ctu2, code);
+        ASSERT(std::find(errorLogger.id.cbegin(), errorLogger.id.cend(), "nullPointer") != errorLogger.id.cend());
+    }
 };
 
 REGISTER_TEST(TestCppcheck)
@@ -60,6 +60,8 @@ private:
         TEST_CASE(SerializeSanitize);
         TEST_CASE(SerializeFileLocation);
 
+        TEST_CASE(SharedErrorPathCopy);
+
         TEST_CASE(suppressUnmatchedSuppressions);
     }
 
@@ -309,6 +311,33 @@ private:
         ASSERT_EQUALS("abcd:/,", msg2.callStack.front().getinfo());
     }
 
+    void SharedErrorPathCopy() const {
+        SharedErrorPath path1;
+        ASSERT_EQUALS(true, path1.empty());
+        path1.emplace_back(nullptr, "first");
+        SharedErrorPath path2 = path1;
+        path2.emplace_back(nullptr, "second");
+        path1.emplace_back(nullptr, "other");
+
+        // Appending to a copy leaves the original unchanged
+        const ErrorPath errorPath1 = path1;
+        const ErrorPath errorPath2 = path2;
+        ASSERT_EQUALS(2U, path1.size());
+        ASSERT_EQUALS(2U, errorPath2.size());
+        ASSERT_EQUALS("first", errorPath1.front().second);
+        ASSERT_EQUALS("other", errorPath1.back().second);
+        ASSERT_EQUALS("first", errorPath2.front().second);
+        ASSERT_EQUALS("second", path2.back().second);
+
+        const SharedErrorPath path3 = errorPath2;
+        ASSERT_EQUALS(2U, path3.size());
+        ASSERT_EQUALS("second", path3.back().second);
+
+        path2.clear();
+        ASSERT_EQUALS(true, path2.empty());
+        ASSERT_EQUALS(2U, path3.size());
+    }
+
     void suppressUnmatchedSuppressions() {
         std::list<Suppressions::Suppression> suppressions;
 
@@ -44,6 +44,7 @@ private:
 
         TEST_CASE(isDirectory);
         TEST_CASE(recursiveAddFiles);
+        TEST_CASE(recursiveAddFilesIgnored);
         TEST_CASE(fileExists);
     }
 
@@ -78,6 +79,24 @@ private:
         ASSERT(files.find("lib/tokenize.h") == files.end());
     }
 
+    void recursiveAddFilesIgnored() const {
+        std::map<std::string, std::size_t> files;
+        std::vector<std::string> masks = { "lib/", "main.cpp" };
+        PathMatch matcher(masks);
+        FileLister::recursiveAddFiles(files, "cli", matcher);
+        FileLister::recursiveAddFiles(files, "lib", matcher);
+        FileLister::recursiveAddFiles(files, "test", matcher);
+
+        ASSERT(files.find("cli/cppcheckexecutor.cpp") != files.end());
+        ASSERT(files.find("cli/main.cpp") == files.end());
+        ASSERT(files.find("lib/token.cpp") == files.end());
+
+        // The size of the file is looked up
+        std::ifstream fin("test/testfilelister.cpp", std::ios::binary | std::ios::ate);
+        ASSERT(files.find("test/testfilelister.cpp") != files.end());
+        ASSERT_EQUALS(static_cast<std::size_t>(fin.tellg()), files["test/testfilelister.cpp"]);
+    }
+
     void fileExists() const {
         ASSERT_EQUALS(false, FileLister::fileExists("lib"));
         ASSERT_EQUALS(true, FileLister::fileExists("readme.txt"));
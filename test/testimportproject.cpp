@@ -0,0 +1,154 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "importproject.h"
+#include "settings.h"
+#include "testsuite.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+class TestImportProject : public TestFixture {
+public:
+    TestImportProject() : TestFixture("TestImportProject") {
+    }
+
+private:
+    void run() override {
+        TEST_CASE(splitCommand);
+        TEST_CASE(parseCommand);
+        TEST_CASE(parseCommandLanguage);
+        TEST_CASE(parseCommandMsvc);
+        TEST_CASE(importCompileCommandsArguments);
+        TEST_CASE(importCompileCommandsCommand);
+        TEST_CASE(importCompileCommandsInvalid);
+        TEST_CASE(addProjectSettings);
+    }
+
+    void splitCommand() const {
+        const std::vector<std::string> args = ImportProject::splitCommand("gcc -DX=\"a b\" '-DY=1'  -I\\ dir  file.c");
+        ASSERT_EQUALS(5U, args.size());
+        ASSERT_EQUALS("gcc", args[0]);
+        ASSERT_EQUALS("-DX=a b", args[1]);
+        ASSERT_EQUALS("-DY=1", args[2]);
+        ASSERT_EQUALS("-I dir", args[3]);
+        ASSERT_EQUALS("file.c", args[4]);
+    }
+
+    void parseCommand() const {
+        FileSettings fs;
+        ImportProject::parseCommand(ImportProject::splitCommand("/usr/bin/gcc -DA -D B=2 -UC -Iinc -I /abs/inc -isystem sys -include cfg.h -c file.c"), "/home/src/", fs);
+        ASSERT_EQUALS("A=1;B=2", fs.defines);
+        ASSERT_EQUALS(1U, fs.undefs.size());
+        ASSERT_EQUALS(true, fs.undefs.count("C") == 1);
+        ASSERT_EQUALS(3U, fs.includePaths.size());
+        ASSERT_EQUALS("/home/src/inc/", fs.includePaths[0]);
+        ASSERT_EQUALS("/abs/inc/", fs.includePaths[1]);
+        ASSERT_EQUALS("/home/src/sys/", fs.includePaths[2]);
+        ASSERT_EQUALS(1U, fs.userIncludes.size());
+        ASSERT_EQUALS("/home/src/cfg.h", fs.userIncludes[0]);
+        ASSERT_EQUALS(Project::None, fs.language);
+    }
+
+    void parseCommandLanguage() const {
+        FileSettings fs1;
+        ImportProject::parseCommand(ImportProject::splitCommand("g++ -c file.c"), "/src/", fs1);
+        ASSERT_EQUALS(Project::CPP, fs1.language);
+
+        FileSettings fs2;
+        ImportProject::parseCommand(ImportProject::splitCommand("clang -x c++ -c file.h"), "/src/", fs2);
+        ASSERT_EQUALS(Project::CPP, fs2.language);
+
+        FileSettings fs3;
+        ImportProject::parseCommand(ImportProject::splitCommand("clang++ -xc -c file.inc"), "/src/", fs3);
+        ASSERT_EQUALS(Project::C, fs3.language);
+    }
+
+    void parseCommandMsvc() const {
+        FileSettings fs;
+        ImportProject::parseCommand(ImportProject::splitCommand("cl.exe /DWIN32 /D_DEBUG /Iinclude /TP /c file.c"), "/src/", fs);
+        ASSERT_EQUALS("WIN32=1;_DEBUG=1", fs.defines);
+        ASSERT_EQUALS(1U, fs.includePaths.size());
+        ASSERT_EQUALS("/src/include/", fs.includePaths[0]);
+        ASSERT_EQUALS(Project::CPP, fs.language);
+
+        // /DEBUG and the options after /link are linker options
+        FileSettings fs2;
+        ImportProject::parseCommand(ImportProject::splitCommand("cl /DEBUG /D X /DEBUG:FULL /c file.c /link /DY"), "/src/", fs2);
+        ASSERT_EQUALS("X=1", fs2.defines);
+
+        // GCC has no such option
+        FileSettings fs3;
+        ImportProject::parseCommand(ImportProject::splitCommand("gcc -DEBUG -c file.c"), "/src/", fs3);
+        ASSERT_EQUALS("EBUG=1", fs3.defines);
+    }
+
+    void importCompileCommandsArguments() const {
+        std::istringstream istr("[{\"directory\": \"/src\", \"arguments\": [\"gcc\", \"-DX\", \"-Iinc\", \"-c\", \"a.c\"], \"file\": \"a.c\"},"
+                                " {\"directory\": \"/src\", \"arguments\": [\"gcc\", \"-DY\", \"-c\", \"a.c\"], \"file\": \"a.c\"}]");
+        ImportProject importer;
+        ASSERT_EQUALS("", importer.importCompileCommands(istr));
+        ASSERT_EQUALS(1U, importer.fileSettings.size());
+        const FileSettings *fs = importer.getFileSettings("/src/a.c");
+        ASSERT(fs != nullptr);
+        // first command of a file wins
+        ASSERT_EQUALS("X=1", fs->defines);
+        ASSERT_EQUALS("/src/inc/", fs->includePaths[0]);
+        ASSERT(importer.getFileSettings("/src/b.c") == nullptr);
+    }
+
+    void importCompileCommandsCommand() const {
+        std::istringstream istr("[{\"directory\": \"/src/build/\", \"command\": \"c++ -DNAME=\\\\\\\"x\\\\\\\" -c ../b.cpp\", \"file\": \"../b.cpp\"}]");
+        ImportProject importer;
+        ASSERT_EQUALS("", importer.importCompileCommands(istr));
+        const FileSettings *fs = importer.getFileSettings("/src/b.cpp");
+        ASSERT(fs != nullptr);
+        ASSERT_EQUALS("NAME=\"x\"", fs->defines);
+        ASSERT_EQUALS(Project::CPP, fs->language);
+    }
+
+    void importCompileCommandsInvalid() const {
+        std::istringstream istr1("{\"directory\": \"/src\"}");
+        ImportProject importer;
+        ASSERT_EQUALS(false, importer.importCompileCommands(istr1).empty());
+
+        std::istringstream istr2("[{\"directory\": ");
+        ASSERT_EQUALS(false, importer.importCompileCommands(istr2).empty());
+    }
+
+    void addProjectSettings() const {
+        std::istringstream istr("[{\"directory\": \"/src\", \"command\": \"gcc -DX -Iinc -c a.c\", \"file\": \"a.c\"}]");
+        ImportProject importer;
+        ASSERT_EQUALS("", importer.importCompileCommands(istr));
+
+        Project project;
+        project.userDefines = "Z=1";
+        project.includePaths.emplace_back("cmdline/");
+        importer.addProjectSettings(project);
+
+        const FileSettings *fs = importer.getFileSettings("/src/a.c");
+        ASSERT(fs != nullptr);
+        ASSERT_EQUALS("Z=1;X=1", fs->defines);
+        ASSERT_EQUALS(2U, fs->includePaths.size());
+        ASSERT_EQUALS("cmdline/", fs->includePaths[0]);
+        ASSERT_EQUALS("/src/inc/", fs->includePaths[1]);
+    }
+};
+
+REGISTER_TEST(TestImportProject)
@@ -17,6 +17,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "path.h"
 #include "pathmatch.h"
 #include "testsuite.h"
 
@@ -69,6 +70,8 @@ private:
         TEST_CASE(filemaskpath2);
         TEST_CASE(filemaskpath3);
         TEST_CASE(filemaskpath4);
+        TEST_CASE(manymasks);
+        TEST_CASE(absolutemask);
     }
 
     // Test empty PathMatch
@@ -203,6 +206,31 @@ private:
     void filemaskpath4() const {
         ASSERT(!srcFooCppMatcher.match("bar/foo.cpp"));
     }
+
+    // Masks sharing prefixes and suffixes
+    void manymasks() const {
+        std::vector<std::string> masks = { "src/", "srcfiles/", "sr/", "foo.cpp", "afoo.cpp", "o.c", "lib/foo.h" };
+        PathMatch match(masks);
+        ASSERT(match.match("proj/srcfiles/bar.cpp"));
+        ASSERT(match.match("proj/sr/bar.cpp"));
+        ASSERT(!match.match("proj/srcf/bar.cpp"));
+        ASSERT(!match.match("proj/s/bar.cpp"));
+        ASSERT(match.match("proj/bfoo.cpp"));
+        ASSERT(match.match("proj/foo.c"));
+        ASSERT(!match.match("proj/foo.cc"));
+        ASSERT(match.match("lib/foo.h"));
+        ASSERT(!match.match("lib/bar.h"));
+        // Directory masks do not match file names
+        ASSERT(!match.match("proj/src"));
+    }
+
+    void absolutemask() const {
+        std::vector<std::string> masks(1, Path::fromNativeSeparators(Path::getCurrentPath()) + "/src/");
+        PathMatch match(masks);
+        ASSERT(match.match("src/foo.cpp"));
+        ASSERT(match.match(masks[0] + "foo.cpp"));
+        ASSERT(!match.match("lib/foo.cpp"));
+    }
 };
 
 REGISTER_TEST(TestPathMatch)
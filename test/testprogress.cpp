@@ -0,0 +1,110 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "progress.h"
+#include "testsuite.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TestProgress : public TestFixture {
+public:
+    TestProgress() : TestFixture("TestProgress") {
+    }
+
+private:
+    void run() override {
+        TEST_CASE(counters);
+        TEST_CASE(finished);
+        TEST_CASE(interval);
+    }
+
+    void counters() {
+        std::vector<ProgressStatus> reports;
+        const std::string file1("file1.c");
+        const std::string file2("file2.c");
+
+        ProgressMonitor monitor;
+        monitor.setTotal(2, 300);
+        monitor.addTotal(1, 100);
+        monitor.start(2, std::chrono::hours(1), [&](const ProgressStatus& status) {
+            reports.push_back(status);
+        });
+        monitor.worker(0).startFile(&file1);
+        monitor.worker(0).progress("Tokenize", 40);
+        monitor.worker(1).startFile(&file2);
+        monitor.worker(1).fileDone(100);
+        monitor.stop();
+
+        // Only the last report is made before the interval has passed
+        ASSERT_EQUALS(1U, reports.size());
+        const ProgressStatus& status = reports.back();
+        ASSERT_EQUALS(true, status.done);
+        ASSERT_EQUALS(1U, status.files);
+        ASSERT_EQUALS(3U, status.totalFiles);
+        ASSERT_EQUALS(100U, status.bytes);
+        ASSERT_EQUALS(400U, status.totalBytes);
+        ASSERT(status.bytesPerSecond > 0);
+        ASSERT(status.eta > 0);
+        ASSERT_EQUALS(1U, status.active.size());
+        ASSERT_EQUALS(file1, status.active[0].file);
+        ASSERT_EQUALS("Tokenize", std::string(status.active[0].stage));
+        ASSERT_EQUALS(40U, status.active[0].value);
+    }
+
+    void finished() {
+        std::vector<ProgressStatus> reports;
+        const std::string file("file.c");
+
+        ProgressMonitor monitor;
+        monitor.setTotal(1, 10);
+        monitor.start(1, std::chrono::hours(1), [&](const ProgressStatus& status) {
+            reports.push_back(status);
+        });
+        monitor.worker(0).startFile(&file);
+        monitor.worker(0).fileDone(10);
+        monitor.stop();
+
+        ASSERT_EQUALS(1U, reports.size());
+        ASSERT_EQUALS(1U, reports.back().files);
+        ASSERT_EQUALS(0.0, reports.back().eta);
+        ASSERT(reports.back().active.empty());
+    }
+
+    void interval() {
+        std::vector<ProgressStatus> reports;
+
+        ProgressMonitor monitor;
+        monitor.setTotal(1, 10);
+        monitor.start(1, std::chrono::milliseconds(1), [&](const ProgressStatus& status) {
+            reports.push_back(status);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        monitor.stop();
+
+        ASSERT(reports.size() > 1U);
+        ASSERT_EQUALS(false, reports.front().done);
+        ASSERT_EQUALS(true, reports.back().done);
+        // Nothing is checked, so the remaining time is unknown
+        ASSERT(reports.back().eta < 0);
+    }
+};
+
+REGISTER_TEST(TestProgress)
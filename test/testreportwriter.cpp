@@ -0,0 +1,226 @@
+/*
+ * LCppC - A tool for static C/C++ code analysis
+ * Copyright (C) 2020 LCppC project.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "errortypes.h"
+#include "reportwriter.h"
+#include "settings.h"
+#include "testsuite.h"
+
+#include <list>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TestReportWriter : public TestFixture {
+public:
+    TestReportWriter() : TestFixture("TestReportWriter") {
+    }
+
+private:
+    Settings settings;
+
+    void run() override {
+        settings.templateFormat = "{file}:{line}:{id}";
+
+        TEST_CASE(unordered);
+        TEST_CASE(sequenceOrder);
+        TEST_CASE(sequenceOrderThreads);
+        TEST_CASE(skipTo);
+        TEST_CASE(duplicates);
+        TEST_CASE(xml);
+        TEST_CASE(xmlEmpty);
+        TEST_CASE(discard);
+        TEST_CASE(sarif);
+        TEST_CASE(sarifUri);
+        TEST_CASE(jsonLines);
+    }
+
+    static ErrorMessage message(const std::string& file, int line, const std::string& id = "id", const std::string& text = "message") {
+        std::list<ErrorMessage::FileLocation> callStack;
+        callStack.emplace_back(file, line, 1);
+        return ErrorMessage(callStack, file, Severity::error, text, id, Certainty::safe);
+    }
+
+    void unordered() {
+        TextReportSink sink(settings);
+        std::ostringstream out;
+        ReportWriter writer(sink, out, false);
+        writer.report(message("a.c", 1));
+        writer.report(message("b.c", 2));
+        writer.finish();
+        ASSERT_EQUALS("a.c:1:id\nb.c:2:id\n", out.str());
+    }
+
+    void sequenceOrder() {
+        TextReportSink sink(settings);
+        std::ostringstream out;
+        ReportWriter writer(sink, out, false);
+        const std::size_t first = writer.reserve(3);
+        ASSERT_EQUALS(0U, first);
+        writer.report(message("c.c", 3), 2);
+        writer.report(message("b.c", 2), 1);
+        writer.done(1);
+        writer.done(2);
+        writer.report(message("a.c", 1), 0);
+        writer.done(0);
+        writer.report(message("z.c", 9));
+        writer.finish();
+        ASSERT_EQUALS("a.c:1:id\nb.c:2:id\nc.c:3:id\nz.c:9:id\n", out.str());
+    }
+
+    void sequenceOrderThreads() {
+        TextReportSink sink(settings);
+        std::ostringstream out;
+        ReportWriter writer(sink, out, false);
+        const std::size_t first = writer.reserve(40);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&writer, first, t]() {
+                for (int i = 9; i >= 0; --i) {
+                    const std::size_t sequence = first + i * 4 + t;
+                    writer.report(message("f" + std::to_string(sequence), 1), sequence);
+                    writer.report(message("f" + std::to_string(sequence), 2), sequence);
+                    writer.done(sequence);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        writer.finish();
+
+        std::string expected;
+        for (std::size_t sequence = first; sequence < first + 40; ++sequence)
+            expected += "f" + std::to_string(sequence) + ":1:id\nf" + std::to_string(sequence) + ":2:id\n";
+        ASSERT_EQUALS(expected, out.str());
+    }
+
+    void skipTo() {
+        TextReportSink sink(settings);
+        std::ostringstream out;
+        ReportWriter writer(sink, out, false);
+        writer.reserve(2);
+        // 0 is never done, e.g. because checking was terminated
+        writer.report(message("b.c", 2), 1);
+        writer.done(1);
+        writer.skipTo(2);
+        writer.report(message("z.c", 9));
+        writer.reserve(1);
+        writer.report(message("c.c", 3), 2);
+        writer.finish();
+        ASSERT_EQUALS("b.c:2:id\nz.c:9:id\nc.c:3:id\n", out.str());
+    }
+
+    void duplicates() {
+        TextReportSink sink(settings);
+        std::ostringstream out;
+        ReportWriter writer(sink, out, false);
+        writer.reserve(2);
+        writer.report(message("a.c", 1), 1);
+        writer.report(message("a.c", 1), 0);
+        writer.done(0);
+        writer.done(1);
+        writer.finish();
+        ASSERT_EQUALS("a.c:1:id\n", out.str());
+    }
+
+    void xml() {
+        XmlReportSink sink;
+        std::ostringstream out;
+        ReportWriter writer(sink, out, false);
+        writer.report(message("a.c", 1));
+        writer.finish();
+        ASSERT_EQUALS(ErrorMessage::getXMLHeader() + '\n' + message("a.c", 1).toXML() + '\n' + ErrorMessage::getXMLFooter() + '\n', out.str());
+    }
+
+    void xmlEmpty() {
+        XmlReportSink sink;
+        std::ostringstream out;
+        ReportWriter writer(sink, out, false);
+        writer.finish();
+        ASSERT_EQUALS(ErrorMessage::getXMLHeader() + '\n' + ErrorMessage::getXMLFooter() + '\n', out.str());
+    }
+
+    void discard() {
+        // Nothing is written before the first message
+        XmlReportSink sink;
+        std::ostringstream out;
+        {
+            ReportWriter writer(sink, out, false);
+            writer.discard();
+        }
+        ASSERT_EQUALS("", out.str());
+
+        // A started report is completed
+        std::ostringstream started;
+        ReportWriter writer(sink, started, false);
+        writer.report(message("a.c", 1));
+        writer.discard();
+        ASSERT_EQUALS(ErrorMessage::getXMLHeader() + '\n' + message("a.c", 1).toXML() + '\n' + ErrorMessage::getXMLFooter() + '\n', started.str());
+    }
+
+    void sarif() {
+        SarifReportSink sink(settings);
+        std::ostringstream out;
+        {
+            ReportWriter writer(sink, out, false);
+            std::list<ErrorMessage::FileLocation> callStack;
+            callStack.emplace_back("a.c", "called here", 3, 5);
+            callStack.emplace_back("b.c", 7, 0);
+            ErrorMessage msg(callStack, "a.c", Severity::style, "x \"y\"", "someId", Certainty::inconclusive, CWE(398U));
+            writer.report(msg);
+            writer.report(message("c.c", 0, "other"));
+        }
+        const std::string sarif = out.str();
+        ASSERT_EQUALS(0U, sarif.find("{\"$schema\":\"https://json.schemastore.org/sarif-2.1.0.json\",\"version\":\"2.1.0\",\"runs\":[{\"results\":[\n"));
+        ASSERT(sarif.find("{\"ruleId\":\"someId\",\"level\":\"warning\",\"message\":{\"text\":\"x \\\"y\\\"\"},"
+                          "\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":\"b.c\"},\"region\":{\"startLine\":7}}}],"
+                          "\"relatedLocations\":[{\"id\":0,\"physicalLocation\":{\"artifactLocation\":{\"uri\":\"a.c\"},\"region\":{\"startLine\":3,\"startColumn\":5}},\"message\":{\"text\":\"called here\"}}],"
+                          "\"properties\":{\"severity\":\"style\",\"inconclusive\":true,\"cwe\":398}},\n") != std::string::npos);
+        // Line 0 has no region
+        ASSERT(sarif.find("{\"ruleId\":\"other\",\"level\":\"error\",\"message\":{\"text\":\"message\"},"
+                          "\"locations\":[{\"physicalLocation\":{\"artifactLocation\":{\"uri\":\"c.c\"}}}],"
+                          "\"properties\":{\"severity\":\"error\"}}\n],\"tool\":") != std::string::npos);
+        ASSERT(sarif.find("\"rules\":[\n{\"id\":\"other\",\"shortDescription\":{\"text\":\"message\"}},\n{\"id\":\"someId\",") != std::string::npos);
+        ASSERT_EQUALS(true, sarif.compare(sarif.size() - 7, 7, "]}}}]}\n") == 0);
+    }
+
+    void sarifUri() const {
+        ASSERT_EQUALS("src/a.c", SarifReportSink::toUri("src/a.c"));
+        ASSERT_EQUALS("my%20dir/a%23b.c", SarifReportSink::toUri("my dir/a#b.c"));
+        ASSERT_EQUALS("%C3%A4.c", SarifReportSink::toUri("\xC3\xA4.c"));
+    }
+
+    void jsonLines() {
+        JsonLinesReportSink sink(settings);
+        std::ostringstream out;
+        ReportWriter writer(sink, out, false);
+        std::list<ErrorMessage::FileLocation> callStack;
+        callStack.emplace_back("a.c", "note", 3, 5);
+        callStack.emplace_back("b.c", 7, 2);
+        writer.report(ErrorMessage(callStack, "a.c", Severity::warning, "text\nverbose", "someId", Certainty::safe, CWE(1U)));
+        writer.report(message("c.c", 1));
+        writer.finish();
+        ASSERT_EQUALS("{\"id\":\"someId\",\"severity\":\"warning\",\"inconclusive\":false,\"message\":\"text\",\"cwe\":1,"
+                      "\"locations\":[{\"file\":\"b.c\",\"line\":7,\"column\":2},{\"file\":\"a.c\",\"line\":3,\"column\":5,\"info\":\"note\"}]}\n"
+                      "{\"id\":\"id\",\"severity\":\"error\",\"inconclusive\":false,\"message\":\"message\",\"locations\":[{\"file\":\"c.c\",\"line\":1,\"column\":1}]}\n",
+                      out.str());
+    }
+};
+
+REGISTER_TEST(TestReportWriter)
@@ -201,6 +201,7 @@ private:
         TEST_CASE(template157); // #9854
         TEST_CASE(template158); // daca crash
         TEST_CASE(template159); // #9886
+        TEST_CASE(template160); // out of line members and indexed instantiations
         TEST_CASE(template_specialization_1);  // #7868 - template specialization template <typename T> struct S<C<T>> {..};
         TEST_CASE(template_specialization_2);  // #7868 - template specialization template <typename T> struct S<C<T>> {..};
         TEST_CASE(template_enum);  // #6299 Syntax error in complex enum declaration (including template)
@@ -4041,6 +4042,19 @@ private:
         ASSERT_EQUALS(exp, tok(code));
     }
 
+    void template160() { // out of line members and indexed instantiations
+        const char code[] = "template <class T> struct A { T a; };\n"
+                            "template <class T> struct B { T f(); };\n"
+                            "template <class T> T B<T>::f() { return T(); }\n"
+                            "A<int> a1; B<int> b1; A<char> a2; B<char> b2; A<int> a3;";
+        const char exp[]  = "struct A<int> ; struct A<char> ; struct B<int> ; struct B<char> ; "
+                            "A<int> a1 ; B<int> b1 ; A<char> a2 ; B<char> b2 ; A<int> a3 ; "
+                            "struct B<int> { int f ( ) ; } ; int B<int> :: f ( ) { return int ( ) ; } "
+                            "struct B<char> { char f ( ) ; } ; char B<char> :: f ( ) { return char ( ) ; } "
+                            "struct A<int> { int a ; } ; struct A<char> { char a ; } ;";
+        ASSERT_EQUALS(exp, tok(code));
+    }
+
     void template_specialization_1() {  // #7868 - template specialization template <typename T> struct S<C<T>> {..};
         const char code[] = "template <typename T> struct C {};\n"
                             "template <typename T> struct S {a};\n"
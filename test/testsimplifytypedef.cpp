@@ -183,6 +183,7 @@ private:
         TEST_CASE(simplifyTypedefFunction10); // #5191
 
         TEST_CASE(simplifyTypedefShadow);  // #4445 - shadow variable
+        TEST_CASE(simplifyTypedefShadowScope);
     }
 
     std::string tok(const char code[], bool simplify = true, Project::PlatformType type = Project::Native, bool debugwarnings = true) {
@@ -3251,6 +3252,15 @@ private:
         ASSERT_EQUALS("struct xyz { int x ; } ; void f ( ) { int abc ; int xyz ; }",
                       tok(code,false));
     }
+
+    void simplifyTypedefShadowScope() { // global typedef is used again after the shadowing scope
+        const char code[] = "typedef int A;\n"
+                            "namespace N { typedef char A; A a1; }\n"
+                            "void f() { float A; A = 1; }\n"
+                            "A a2;";
+        ASSERT_EQUALS("namespace N { char a1 ; } void f ( ) { float A ; A = 1 ; } int a2 ;",
+                      tok(code,false));
+    }
 };
 
 REGISTER_TEST(TestSimplifyTypedef)
@@ -32,6 +32,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <list>
 #include <map>
 #include <set>
@@ -84,7 +85,7 @@ private:
     }
 
     static const Scope *findFunctionScopeByToken(const SymbolDatabase * db, const Token *tok) {
-        std::list<Scope>::const_iterator scope;
+        SegmentedList<Scope>::const_iterator scope;
 
         for (scope = db->scopeList.begin(); scope != db->scopeList.end(); ++scope) {
             if (scope->type == Scope::eFunction) {
@@ -387,6 +388,7 @@ private:
         TEST_CASE(findFunctionContainer);
         TEST_CASE(findFunctionExternC);
         TEST_CASE(findFunctionGlobalScope); // ::foo
+        TEST_CASE(findFunctionInBase);
 
         TEST_CASE(overloadedFunction1);
 
@@ -1778,7 +1780,7 @@ private:
         if (db) {
             bool seen_something = false;
             for (const Scope & scope : db->scopeList) {
-                for (std::list<Function>::const_iterator func = scope.functionList.begin(); func != scope.functionList.end(); ++func) {
+                for (SegmentedList<Function>::const_iterator func = scope.functionList.begin(); func != scope.functionList.end(); ++func) {
                     ASSERT_EQUALS("Sub", func->token->str());
                     ASSERT_EQUALS(true, func->hasBody());
                     ASSERT_EQUALS(Function::eConstructor, func->type);
@@ -2051,10 +2053,10 @@ private:
 
         ASSERT(db && db->scopeList.size() == 1);
         if (db && db->scopeList.size() == 1) {
-            std::list<Scope>::const_iterator it = db->scopeList.begin();
+            SegmentedList<Scope>::const_iterator it = db->scopeList.begin();
             ASSERT(it->varlist.size() == 1);
             if (it->varlist.size() == 1) {
-                std::list<Variable>::const_iterator var = it->varlist.begin();
+                SegmentedList<Variable>::const_iterator var = it->varlist.begin();
                 ASSERT(var->name() == "i");
                 ASSERT(var->typeStartToken()->str() == "int");
             }
@@ -2066,10 +2068,10 @@ private:
 
         ASSERT(db && db->scopeList.size() == 1);
         if (db && db->scopeList.size() == 1) {
-            std::list<Scope>::const_iterator it = db->scopeList.begin();
+            SegmentedList<Scope>::const_iterator it = db->scopeList.begin();
             ASSERT(it->varlist.size() == 1);
             if (it->varlist.size() == 1) {
-                std::list<Variable>::const_iterator var = it->varlist.begin();
+                SegmentedList<Variable>::const_iterator var = it->varlist.begin();
                 ASSERT(var->name() == "array");
                 ASSERT(var->typeStartToken()->str() == "int");
             }
@@ -2081,10 +2083,10 @@ private:
 
         ASSERT(db && db->scopeList.size() == 1);
         if (db && db->scopeList.size() == 1) {
-            std::list<Scope>::const_iterator it = db->scopeList.begin();
+            SegmentedList<Scope>::const_iterator it = db->scopeList.begin();
             ASSERT(it->varlist.size() == 1);
             if (it->varlist.size() == 1) {
-                std::list<Variable>::const_iterator var = it->varlist.begin();
+                SegmentedList<Variable>::const_iterator var = it->varlist.begin();
                 ASSERT(var->name() == "array");
                 ASSERT(var->typeStartToken()->str() == "int");
             }
@@ -2423,7 +2425,7 @@ private:
         if (db) {
             ASSERT_EQUALS(3, db->scopeList.size());
             if (db->scopeList.size() == 3) {
-                std::list<Scope>::const_iterator scope = db->scopeList.begin();
+                SegmentedList<Scope>::const_iterator scope = db->scopeList.begin();
                 ++scope;
                 ASSERT_EQUALS((unsigned int)Scope::eClass, (unsigned int)scope->type);
                 ASSERT_EQUALS(1, scope->functionList.size());
@@ -2447,7 +2449,7 @@ private:
         if (db) {
             ASSERT_EQUALS(3, db->scopeList.size());
             if (db->scopeList.size() == 3) {
-                std::list<Scope>::const_iterator scope = db->scopeList.begin();
+                SegmentedList<Scope>::const_iterator scope = db->scopeList.begin();
                 ++scope;
                 ASSERT_EQUALS((unsigned int)Scope::eClass, (unsigned int)scope->type);
                 ASSERT_EQUALS(1, scope->functionList.size());
@@ -3040,7 +3042,7 @@ private:
         ASSERT(db && db->typeList.size() == 5);
         if (!db || db->typeList.size() < 5)
             return;
-        std::list<Type>::const_iterator i = db->typeList.begin();
+        SegmentedList<Type>::const_iterator i = db->typeList.begin();
         const Type* Foo = &(*i++);
         const Type* Bar = &(*i++);
         const Type* Sub = &(*i++);
@@ -3109,7 +3111,7 @@ private:
         ASSERT(db && db->typeList.size() == 3);
         if (!db || db->typeList.size() != 3)
             return;
-        std::list<Type>::const_iterator i = db->typeList.begin();
+        SegmentedList<Type>::const_iterator i = db->typeList.begin();
         const Type* Fred = &(*i++);
         const Type* Wilma = &(*i++);
         const Type* Barney = &(*i++);
@@ -3199,7 +3201,7 @@ private:
             ASSERT(db->getVariableFromVarId(i) != nullptr);
 
         ASSERT_EQUALS(4U, db->scopeList.size());
-        std::list<Scope>::const_iterator scope = db->scopeList.begin();
+        SegmentedList<Scope>::const_iterator scope = db->scopeList.begin();
         ASSERT_EQUALS(Scope::eGlobal, scope->type);
         ++scope;
         ASSERT_EQUALS(Scope::eStruct, scope->type);
@@ -3217,7 +3219,7 @@ private:
 
         ASSERT(db != nullptr);
         ASSERT_EQUALS(4U, db->scopeList.size());
-        std::list<Scope>::const_iterator scope = db->scopeList.begin();
+        SegmentedList<Scope>::const_iterator scope = db->scopeList.begin();
         ASSERT_EQUALS(Scope::eGlobal, scope->type);
         ++scope;
         ASSERT_EQUALS(Scope::eStruct, scope->type);
@@ -3425,7 +3427,7 @@ private:
         if (db) {
             ASSERT(db->scopeList.size() == 4U);
             if (db->scopeList.size() == 4U) {
-                std::list<Scope>::const_iterator it = db->scopeList.begin();
+                SegmentedList<Scope>::const_iterator it = db->scopeList.begin();
                 ASSERT(it->type == Scope::eGlobal);
                 ASSERT((++it)->type == Scope::eFunction);
                 ASSERT((++it)->type == Scope::eIf);
@@ -3449,7 +3451,7 @@ private:
         if (db) {
             ASSERT(db->typeList.size() == 3U);
             if (db->typeList.size() == 3U) {
-                std::list<Type>::const_iterator it = db->typeList.begin();
+                SegmentedList<Type>::const_iterator it = db->typeList.begin();
                 const Type * classB = &(*it);
                 const Type * classC = &(*(++it));
                 const Type * classA = &(*(++it));
@@ -4861,7 +4863,7 @@ private:
         ASSERT_EQUALS(3U, db->scopeList.size());
 
         // Assert that all enum values are known
-        std::list<Scope>::const_iterator scope = db->scopeList.begin();
+        SegmentedList<Scope>::const_iterator scope = db->scopeList.begin();
 
         // Offsets
         ++scope;
@@ -4950,7 +4952,7 @@ private:
         ASSERT_EQUALS(2U, db->scopeList.size());
 
         // Assert that all enum values are known
-        std::list<Scope>::const_iterator scope = db->scopeList.begin();
+        SegmentedList<Scope>::const_iterator scope = db->scopeList.begin();
 
         ++scope;
         ASSERT_EQUALS((unsigned int)Scope::eEnum, (unsigned int)scope->type);
@@ -5242,7 +5244,7 @@ private:
                       "};");
         ASSERT(db && db->scopeList.back().functionList.size() == 4);
         if (db && db->scopeList.back().functionList.size() == 4) {
-            std::list<Function>::const_iterator it = db->scopeList.back().functionList.begin();
+            SegmentedList<Function>::const_iterator it = db->scopeList.back().functionList.begin();
             ASSERT((it++)->isPure());
             ASSERT((it++)->isPure());
             ASSERT(!(it++)->isPure());
@@ -6283,6 +6285,25 @@ private:
         ASSERT(a->function());
     }
 
+    void findFunctionInBase() {
+        GET_SYMBOL_DB("struct A { void f(int); void g(); };\n"
+                      "struct B : A { void f(int, int); };\n"
+                      "struct C : B { void h() { f(1); f(1, 2); g(); unknown(); } };\n"
+                      "void A::g() { f(3); }");
+        ASSERT_EQUALS(true, db != nullptr);
+
+        const Token *f1 = Token::findsimplematch(tokenizer.tokens(), "f ( 1 ) ;");
+        ASSERT(f1 && f1->function() && f1->function()->tokenDef->linenr() == 1);
+        const Token *f2 = Token::findsimplematch(tokenizer.tokens(), "f ( 1 , 2 ) ;");
+        ASSERT(f2 && f2->function() && f2->function()->tokenDef->linenr() == 2);
+        const Token *g = Token::findsimplematch(tokenizer.tokens(), "g ( ) ;");
+        ASSERT(g && g->function() && g->function()->tokenDef->linenr() == 1);
+        const Token *unknown = Token::findsimplematch(tokenizer.tokens(), "unknown ( ) ;");
+        ASSERT(unknown && !unknown->function());
+        const Token *f3 = Token::findsimplematch(tokenizer.tokens(), "f ( 3 ) ;");
+        ASSERT(f3 && f3->function() && f3->function()->tokenDef->linenr() == 1);
+    }
+
     void findFunctionGlobalScope() {
         GET_SYMBOL_DB("struct S {\n"
                       "    void foo();\n"
@@ -6711,7 +6732,7 @@ private:
 
         ASSERT(db && db->scopeList.size() == 3);
         if (db && db->scopeList.size() == 3) {
-            std::list<Scope>::const_iterator scope = db->scopeList.begin();
+            SegmentedList<Scope>::const_iterator scope = db->scopeList.begin();
             ASSERT_EQUALS(Scope::eGlobal, scope->type);
             ++scope;
             ASSERT_EQUALS(Scope::eFunction, scope->type);
@@ -6732,7 +6753,7 @@ private:
 
         ASSERT(db && db->scopeList.size() == 3);
         if (db && db->scopeList.size() == 3) {
-            std::list<Scope>::const_iterator scope = db->scopeList.begin();
+            SegmentedList<Scope>::const_iterator scope = db->scopeList.begin();
             ASSERT_EQUALS(Scope::eGlobal, scope->type);
             ++scope;
             ASSERT_EQUALS(Scope::eFunction, scope->type);
@@ -6749,7 +6770,7 @@ private:
 
         ASSERT(db && db->scopeList.size() == 3);
         if (db && db->scopeList.size() == 3) {
-            std::list<Scope>::const_iterator scope = db->scopeList.begin();
+            SegmentedList<Scope>::const_iterator scope = db->scopeList.begin();
             ASSERT_EQUALS(Scope::eGlobal, scope->type);
             ++scope;
             ASSERT_EQUALS(Scope::eFunction, scope->type);
@@ -6782,7 +6803,7 @@ private:
 
         ASSERT(db && db->scopeList.size() == 3);
         if (db && db->scopeList.size() == 3) {
-            std::list<Scope>::const_iterator scope = db->scopeList.begin();
+            SegmentedList<Scope>::const_iterator scope = db->scopeList.begin();
             ASSERT_EQUALS(Scope::eGlobal, scope->type);
             ++scope;
             ASSERT_EQUALS(Scope::eClass, scope->type);
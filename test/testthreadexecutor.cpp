@@ -17,15 +17,22 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "progress.h"
+#include "reportwriter.h"
 #include "settings.h"
 #include "testsuite.h"
 #include "threadexecutor.h"
 
+#include <chrono>
 #include <cstddef>
+#include <list>
 #include <map>
 #include <ostream>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 class TestThreadExecutor : public TestFixture {
 public:
@@ -69,6 +76,8 @@ private:
         TEST_CASE(no_errors_equal_amount_files);
         TEST_CASE(one_error_less_files);
         TEST_CASE(one_error_several_files);
+        TEST_CASE(check_while_discovering);
+        TEST_CASE(progress);
     }
 
     void deadlock_with_many_errors() {
@@ -133,6 +142,91 @@ private:
               "  return 0;\n"
               "}");
     }
+
+    void check_while_discovering() {
+        Settings s;
+        s.jobs = 2;
+        s.templateFormat = "{file}:{line}:{id}";
+        std::list<CTU::CTUInfo> ctus;
+        ThreadExecutor executor(ctus, s, project, *this);
+        TextReportSink sink(s);
+        std::ostringstream out;
+        ReportWriter writer(sink, out, false);
+        executor.setReportWriter(&writer);
+        for (int i = 0; i < 10; ++i) {
+            executor.addFileContent("file_" + std::to_string(i) + ".cpp",
+                                    "int main()\n"
+                                    "{\n"
+                                    "  {char *a = malloc(10);}\n"
+                                    "  return 0;\n"
+                                    "}");
+        }
+
+        // Files are found in reverse order while the first ones are checked
+        executor.startDiscovery();
+        std::thread discovery([&executor]() {
+            for (int i = 9; i >= 0; --i) {
+                std::list<CTU::CTUInfo> found;
+                found.emplace_back("file_" + std::to_string(i) + ".cpp", 1, emptyString);
+                executor.addCTUs(found);
+            }
+            executor.finishDiscovery();
+        });
+        ASSERT_EQUALS(10, executor.checkSync());
+        discovery.join();
+        writer.finish();
+
+        // Messages and CTUs are in the order of the file names
+        std::string expected;
+        for (int i = 0; i < 10; ++i)
+            expected += "file_" + std::to_string(i) + ".cpp:4:memleak\n";
+        ASSERT_EQUALS(expected, out.str());
+        ASSERT_EQUALS(10U, ctus.size());
+        ASSERT_EQUALS("file_0.cpp", ctus.front().sourcefile);
+        ASSERT_EQUALS("file_9.cpp", ctus.back().sourcefile);
+    }
+
+    class ProgressLogger : public ErrorLogger {
+    public:
+        std::vector<ProgressStatus> statuses;
+
+        void reportOut(const std::string &outmsg) override {
+            (void)outmsg;
+        }
+        void reportErr(const ErrorMessage &msg) override {
+            (void)msg;
+        }
+        void reportProgressStatus(const ProgressStatus &status) override {
+            statuses.push_back(status);
+        }
+    };
+
+    void progress() {
+        Settings s;
+        s.jobs = 2;
+        s.output.enable(Output::progress);
+        std::list<CTU::CTUInfo> ctus;
+        for (int i = 0; i < 4; ++i)
+            ctus.emplace_back("file_" + std::to_string(i) + ".cpp", 10, emptyString);
+        ProgressLogger logger;
+        ThreadExecutor executor(ctus, s, project, logger);
+        executor.setProgressInterval(std::chrono::milliseconds(1));
+        for (const CTU::CTUInfo& ctu : ctus)
+            executor.addFileContent(ctu.sourcefile, "int main() { return 0; }");
+        ASSERT_EQUALS(0, executor.checkSync());
+
+        // The last report is made when all files are checked
+        ASSERT(!logger.statuses.empty());
+        const ProgressStatus& last = logger.statuses.back();
+        ASSERT_EQUALS(true, last.done);
+        ASSERT_EQUALS(4U, last.files);
+        ASSERT_EQUALS(4U, last.totalFiles);
+        ASSERT_EQUALS(40U, last.bytes);
+        ASSERT_EQUALS(40U, last.totalBytes);
+        ASSERT(last.active.empty());
+        for (std::size_t i = 1; i < logger.statuses.size(); ++i)
+            ASSERT(logger.statuses[i - 1].files <= logger.statuses[i].files);
+    }
 };
 
 REGISTER_TEST(TestThreadExecutor)
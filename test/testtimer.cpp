@@ -22,6 +22,9 @@
 
 #include <cmath>
 #include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
 
 class TestTimer : public TestFixture {
 public:
@@ -32,6 +35,10 @@ private:
 
     void run() override {
         TEST_CASE(result);
+        TEST_CASE(budget);
+        TEST_CASE(budgetTiers);
+        TEST_CASE(budgetExhaustedAtOnce);
+        TEST_CASE(record);
     }
 
     void result() const {
@@ -42,6 +49,76 @@ private:
         t1.mClocks = CLOCKS_PER_SEC * 5 / 2;
         ASSERT(std::fabs(t1.seconds()-2.5) < 0.01);
     }
+
+    void budget() const {
+        FileBudget unlimited(0, 0);
+        ASSERT_EQUALS(false, unlimited.isLimited());
+        ASSERT_EQUALS(FileBudget::FULL, unlimited.check("phase"));
+        ASSERT(unlimited.cuts().empty());
+
+        FileBudget limited(3600, 0);
+        ASSERT_EQUALS(true, limited.isLimited());
+        ASSERT_EQUALS(FileBudget::FULL, limited.check("phase"));
+        ASSERT_EQUALS(false, limited.exhausted("phase"));
+        ASSERT(limited.cuts().empty());
+    }
+
+    void budgetTiers() const {
+        FileBudget budget(3600, 0);
+        ASSERT_EQUALS(FileBudget::FULL, budget.update(499, "Tokenizer"));
+        ASSERT_EQUALS(FileBudget::REDUCED, budget.update(500, "SymbolDatabase"));
+        // The tier is never raised again
+        ASSERT_EQUALS(FileBudget::REDUCED, budget.update(100, "ValueFlow"));
+        ASSERT_EQUALS(FileBudget::MINIMAL, budget.update(750, "ValueFlow"));
+        ASSERT_EQUALS(FileBudget::EXHAUSTED, budget.update(1000, "CheckOther"));
+        ASSERT_EQUALS(true, budget.exhausted("CheckStl"));
+        ASSERT_EQUALS(FileBudget::EXHAUSTED, budget.tier());
+
+        const std::vector<std::pair<FileBudget::Tier, std::string>>& cuts = budget.cuts();
+        ASSERT_EQUALS(3U, cuts.size());
+        ASSERT_EQUALS(FileBudget::REDUCED, cuts[0].first);
+        ASSERT_EQUALS("SymbolDatabase", cuts[0].second);
+        ASSERT_EQUALS(FileBudget::MINIMAL, cuts[1].first);
+        ASSERT_EQUALS("ValueFlow", cuts[1].second);
+        ASSERT_EQUALS(FileBudget::EXHAUSTED, cuts[2].first);
+        ASSERT_EQUALS("CheckOther", cuts[2].second);
+    }
+
+    void budgetExhaustedAtOnce() const {
+        // Tiers that are skipped are not recorded
+        FileBudget budget(1, 0);
+        ASSERT_EQUALS(FileBudget::EXHAUSTED, budget.update(2500, "Tokenizer"));
+        ASSERT_EQUALS(1U, budget.cuts().size());
+        ASSERT_EQUALS(FileBudget::EXHAUSTED, budget.cuts()[0].first);
+
+        // The limit in milliseconds does not overflow, 2^29 * 1000 wraps around to 0 in 32 bits
+        FileBudget large(536870912U, 0);
+        ASSERT_EQUALS(true, large.isLimited());
+        ASSERT_EQUALS(FileBudget::FULL, large.check("Tokenizer"));
+        ASSERT(large.cuts().empty());
+    }
+
+    void record() const {
+        PhaseTimes phaseTimes;
+        Timer::record(&phaseTimes);
+        {
+            Timer outer("outer", Settings::SHOWTIME_NONE);
+            for (int i = 0; i < 2; ++i)
+                Timer inner("inner", Settings::SHOWTIME_NONE);
+        }
+        Timer::record(nullptr);
+        {
+            Timer ignored("ignored", Settings::SHOWTIME_NONE);
+        }
+
+        ASSERT_EQUALS(2U, phaseTimes.mPhases.size());
+        const PhaseTimes::Data& outer = phaseTimes.mPhases["outer"];
+        const PhaseTimes::Data& inner = phaseTimes.mPhases["inner"];
+        ASSERT_EQUALS(1U, outer.mNumberOfResults);
+        ASSERT_EQUALS(2U, inner.mNumberOfResults);
+        ASSERT(std::fabs(outer.mAdditionalSeconds - inner.fullSeconds()) < 1e-9);
+        ASSERT(outer.fullSeconds() >= inner.fullSeconds());
+    }
 };
 
 REGISTER_TEST(TestTimer)
@@ -24,6 +24,7 @@
 #include "tokenize.h"
 #include "tokenlist.h"
 
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -84,6 +85,7 @@ private:
         TEST_CASE(matchOp);
         TEST_CASE(matchConstOp);
         TEST_CASE(matchBracket);
+        TEST_CASE(matchPatternChanged);
 
         TEST_CASE(isArithmeticalOp);
         TEST_CASE(isOp);
@@ -112,6 +114,7 @@ private:
         TEST_CASE(expressionString);
 
         TEST_CASE(hasKnownIntValue);
+        TEST_CASE(valueFlags);
     }
 
     void nextprevious() const {
@@ -801,6 +804,19 @@ private:
         ASSERT_EQUALS(false, Token::Match(bracket1.tokens(), "( @c"));
     }
 
+    void matchPatternChanged() const {
+        // Parsed patterns are cached by address, the same buffer might hold another pattern later
+        givenACodeSampleToTokenize code("a = 1 ;");
+        char pattern[32] = "%name% =";
+        ASSERT_EQUALS(true, Token::Match(code.tokens(), pattern));
+        std::strcpy(pattern, "%num% =");
+        ASSERT_EQUALS(false, Token::Match(code.tokens(), pattern));
+        std::strcpy(pattern, "a|b [=;] !!;");
+        ASSERT_EQUALS(true, Token::Match(code.tokens(), pattern));
+        std::strcpy(pattern, "a|b [=;] !!1");
+        ASSERT_EQUALS(false, Token::Match(code.tokens(), pattern));
+    }
+
 
     void isArithmeticalOp() const {
         std::vector<std::string>::const_iterator test_op, test_ops_end = arithmeticalOps.end();
@@ -1145,6 +1161,33 @@ private:
         ASSERT_EQUALS(true, token.addValue(v2));
         ASSERT_EQUALS(false, token.hasKnownIntValue());
     }
+
+    void valueFlags() {
+        ValueFlow::Value known(3);
+        known.setKnown();
+        ValueFlow::Value impossible(5);
+        impossible.setImpossible();
+
+        Token token;
+        ASSERT_EQUALS(false, token.hasKnownValue());
+        ASSERT_EQUALS(true, token.addValue(impossible));
+        ASSERT_EQUALS(false, token.hasKnownIntValue());
+        ASSERT_EQUALS(true, token.isImpossibleIntValue(5));
+        ASSERT_EQUALS(false, token.isImpossibleIntValue(3));
+
+        ASSERT_EQUALS(true, token.addValue(known));
+        ASSERT_EQUALS(true, token.hasKnownIntValue());
+        ASSERT_EQUALS(3, token.getKnownIntValue());
+
+        token.removeValues([](const ValueFlow::Value& v) {
+            return v.isKnown();
+        });
+        ASSERT_EQUALS(false, token.hasKnownValue());
+
+        token.clearValueFlow();
+        ASSERT_EQUALS(true, token.values().empty());
+        ASSERT_EQUALS(false, token.isImpossibleIntValue(5));
+    }
 };
 
 REGISTER_TEST(TestToken)
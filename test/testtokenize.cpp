@@ -412,6 +412,8 @@ private:
 
         TEST_CASE(cppcast);
 
+        TEST_CASE(analysisLayers);
+
         TEST_CASE(checkHeader1);
     }
 
@@ -6469,6 +6471,26 @@ private:
         }
     }
 
+    void analysisLayers() {
+        const char code[] = "void f() { int x = 1; int y = x + 2; }";
+
+        Tokenizer tokenizer(&settings0, &project0, this);
+        tokenizer.setAnalysisLayer(Tokenizer::AnalysisLayer::Symbols);
+        std::istringstream istr(code);
+        tokenizer.tokenize(istr, "test.cpp");
+        ASSERT(tokenizer.getAnalysisLayer() == Tokenizer::AnalysisLayer::Symbols);
+        ASSERT(tokenizer.getSymbolDatabase() != nullptr);
+
+        const Token *plus = Token::findsimplematch(tokenizer.tokens(), "+");
+        ASSERT(plus && plus->astOperand1());
+        ASSERT_EQUALS(true, plus->values().empty());
+
+        tokenizer.buildAnalysisLayers(Tokenizer::AnalysisLayer::ValueFlow);
+        ASSERT(tokenizer.getAnalysisLayer() == Tokenizer::AnalysisLayer::ValueFlow);
+        ASSERT_EQUALS(true, plus->hasKnownIntValue());
+        ASSERT_EQUALS(3, plus->values().front().intvalue);
+    }
+
     std::string checkHeaders(const char code[], bool f) {
         // Clear the error buffer..
         errout.str("");
@@ -17,10 +17,15 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "segmentedlist.h"
 #include "testutils.h"
 #include "testsuite.h"
 #include "utils.h"
 
+#include <set>
+#include <string>
+#include <vector>
+
 const Settings givenACodeSampleToTokenize::settings;
 const Project givenACodeSampleToTokenize::project;
 
@@ -33,6 +38,9 @@ private:
     void run() override {
         TEST_CASE(isValidGlobPattern);
         TEST_CASE(matchglob);
+        TEST_CASE(toJsonString);
+        TEST_CASE(copyOnWrite);
+        TEST_CASE(segmentedList);
     }
 
     void isValidGlobPattern() {
@@ -71,6 +79,68 @@ private:
         ASSERT_EQUALS(true, ::matchglob("?y?", "xyz"));
         ASSERT_EQUALS(true, ::matchglob("?/?/?", "x/y/z"));
     }
+
+    void toJsonString() {
+        ASSERT_EQUALS("\"abc\"", ::toJsonString("abc"));
+        ASSERT_EQUALS("\"a\\\"b\\\\c\"", ::toJsonString("a\"b\\c"));
+        ASSERT_EQUALS("\"a\\nb\\tc\\u0001\"", ::toJsonString("a\nb\tc\x01"));
+    }
+
+    void copyOnWrite() {
+        CopyOnWrite<std::set<int>> s1;
+        ASSERT_EQUALS(true, s1->empty());
+        s1.write().insert(1);
+
+        CopyOnWrite<std::set<int>> s2 = s1;
+        ASSERT_EQUALS(true, s2.shares(s1));
+        s2.write().insert(2);
+        ASSERT_EQUALS(false, s2.shares(s1));
+        ASSERT_EQUALS(1U, s1->size());
+        ASSERT_EQUALS(2U, s2->size());
+
+        s1.swap(s2);
+        ASSERT_EQUALS(2U, s1->size());
+        s1.clear();
+        ASSERT_EQUALS(true, s1->empty());
+        ASSERT_EQUALS(1U, s2->size());
+    }
+
+    void segmentedList() const {
+        SegmentedList<std::string> list;
+        ASSERT_EQUALS(true, list.begin() == list.end());
+
+        std::vector<const std::string *> addresses;
+        for (int i = 0; i < 1000; ++i)
+            addresses.push_back(&list.emplace_back(std::to_string(i)));
+        ASSERT_EQUALS(1000U, list.size());
+        ASSERT_EQUALS("0", list.front());
+        ASSERT_EQUALS("999", list.back());
+
+        // Elements never move
+        int i = 0;
+        for (const std::string &s : list) {
+            ASSERT_EQUALS(true, &s == addresses[i]);
+            ASSERT_EQUALS(std::to_string(i), s);
+            ++i;
+        }
+        ASSERT_EQUALS(1000, i);
+
+        SegmentedList<std::string>::const_iterator it = list.end();
+        --it;
+        ASSERT_EQUALS("999", *it);
+
+        for (i = 0; i < 998; ++i)
+            list.pop_back();
+        ASSERT_EQUALS(2U, list.size());
+        ASSERT_EQUALS("1", list.back());
+        list.push_back("x");
+
+        const SegmentedList<std::string> copy(list);
+        std::string all;
+        for (SegmentedList<std::string>::const_iterator it2 = copy.cbegin(); it2 != copy.cend(); ++it2)
+            all += *it2;
+        ASSERT_EQUALS("01x", all);
+    }
 };
 
 REGISTER_TEST(TestUtils)
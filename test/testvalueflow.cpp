@@ -249,7 +249,7 @@ private:
 
             std::ostringstream ostr;
             for (const ValueFlow::Value &v : tok->values()) {
-                for (const ValueFlow::Value::ErrorPathItem &ep : v.errorPath) {
+                for (const ValueFlow::Value::ErrorPathItem &ep : ErrorPath(v.errorPath)) {
                     const Token *eptok = ep.first;
                     const std::string &msg = ep.second;
                     ostr << eptok->linenr() << ',' << msg << '\n';
@@ -2711,6 +2711,22 @@ private:
                "}";
         ASSERT_EQUALS(true, testValueOfX(code, 4U, 123.45F + 67, 0.01F));
 
+        code = "void f() {\n"
+               "    double x = 1.5;\n"
+               "    x = 3;\n"
+               "    return x;\n"
+               "}";
+        ASSERT_EQUALS(true, testValueOfX(code, 4U, 3));
+        ASSERT_EQUALS(false, testValueOfX(code, 4U, 1.5F, 0.01F));
+        ASSERT_EQUALS(false, testValueOfX(code, 4U, 0.0F, 0.01F));
+
+        code = "void f() {\n"
+               "    double x = 1.5;\n"
+               "    x++;\n"
+               "    return x;\n"
+               "}";
+        ASSERT_EQUALS(true, testValueOfX(code, 4U, 2.5F, 0.01F));
+
         code = "void f() {\n"
                "    int x = 123;\n"
                "    x >>= 1;\n"
@@ -76,12 +76,14 @@ static void getDeps(const std::string &filename, std::vector<std::string> &depfi
         /*
          * Recursively search for includes in other directories.
          * Files are searched according to the following priority:
-         * [test, tools] -> cli -> lib -> externals
+         * [test, bench, tools] -> cli -> lib -> externals
          */
         if (filename.compare(0, 4, "cli/") == 0)
             getDeps("lib" + filename.substr(filename.find('/')), depfiles);
         else if (filename.compare(0, 5, "test/") == 0)
             getDeps("cli" + filename.substr(filename.find('/')), depfiles);
+        else if (filename.compare(0, 6, "bench/") == 0)
+            getDeps("cli" + filename.substr(filename.find('/')), depfiles);
         else if (filename.compare(0, 6, "tools/") == 0)
             getDeps("cli" + filename.substr(filename.find('/')), depfiles);
         else if (filename.compare(0, 4, "lib/") == 0) {
@@ -193,6 +195,9 @@ int main()
     std::vector<std::string> testfiles;
     getCppFiles(testfiles, "test/", false);
 
+    std::vector<std::string> benchfiles;
+    getCppFiles(benchfiles, "bench/", false);
+
     std::vector<std::string> toolsfiles;
     getCppFiles(toolsfiles, "tools/", false);
 
@@ -394,6 +399,7 @@ int main()
     fout << "CLIOBJ =      " << objfiles(clifiles) << "\n\n";
     fout << "GUIOBJ =      " << objfiles(guifiles) << "\n\n";
     fout << "TESTOBJ =     " << objfiles(testfiles) << "\n\n";
+    fout << "BENCHOBJ =    " << objfiles(benchfiles) << "\n\n";
 
     fout << ".PHONY: run-dmake tags\n\n";
     fout << "\n###### Targets\n\n";
@@ -404,10 +410,14 @@ int main()
     fout << "all:\tlcppc lcppc-gui testrunner\n\n";
     fout << "cli:\tlcppc\n\n";
     fout << "gui:\tlcppc-gui\n\n";
-    fout << "testrunner: $(TESTOBJ) $(LIBOBJ) $(EXTOBJ) cli/cmdlineparser.o cli/cppcheckexecutor.o\n";
+    fout << "testrunner: $(TESTOBJ) $(LIBOBJ) $(EXTOBJ) cli/analysisserver.o cli/cmdlineparser.o cli/cppcheckexecutor.o\n";
     fout << "\t$(CXX) $(CPPFLAGS) $(CXXFLAGS) -o $@ $^ $(LIBS) $(LDFLAGS) $(RDYNAMIC)\n\n";
     fout << "test:\ttestrunner\n";
     fout << "\t./testrunner\n\n";
+    fout << "benchrunner: $(BENCHOBJ) $(LIBOBJ) $(EXTOBJ)\n";
+    fout << "\t$(CXX) $(CPPFLAGS) $(CXXFLAGS) -o $@ $^ $(LIBS) $(LDFLAGS) $(RDYNAMIC)\n\n";
+    fout << "bench:\tbenchrunner\n";
+    fout << "\t./benchrunner\n\n";
     fout << "check:\tall\n";
     fout << "\t./testrunner -q\n\n";
     fout << "checkcfg:\tlcppc validateCFG\n";
@@ -419,7 +429,7 @@ int main()
     fout << "generate_cfg_tests: tools/generate_cfg_tests.o $(EXTOBJ)\n";
     fout << "\tg++ -isystem externals/tinyxml2 -o generate_cfg_tests tools/generate_cfg_tests.o $(EXTOBJ)\n";
     fout << "clean:\n";
-    fout << "\trm -f build/*.o lib/*.o lib/*.gch cli/*.o test/*.o tools/*.o externals/*/*.o testrunner dmake lcppc lcppc.exe lcppc.1\n\n";
+    fout << "\trm -f build/*.o lib/*.o lib/*.gch cli/*.o test/*.o bench/*.o tools/*.o externals/*/*.o testrunner benchrunner dmake lcppc lcppc.exe lcppc.1\n\n";
     fout << "man:\tman/cppcheck.1\n\n";
     fout << "man/cppcheck.1:\t$(MAN_SOURCE)\n\n";
     fout << "\t$(XP) $(DB2MAN) $(MAN_SOURCE)\n\n";
@@ -502,6 +512,7 @@ int main()
     compilefiles(fout, clifiles, "${INCLUDE_FOR_CLI}", true, false);
     compilefiles(fout, guifiles, "${INCLUDE_FOR_GUI}", true, true);
     compilefiles(fout, testfiles, "${INCLUDE_FOR_TEST}", true, false);
+    compilefiles(fout, benchfiles, "${INCLUDE_FOR_TEST}", true, false);
     compilefiles(fout, extfiles, "", false, false);
     compilefiles(fout, toolsfiles, "${INCLUDE_FOR_LIB}", true, false);
 